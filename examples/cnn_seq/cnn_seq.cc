@@ -17,13 +17,19 @@
 // Network topology:
 //   Input [1, T=16] → Conv1D(8 filters, k=5, Tanh) → MaxPool1D(4) → FC [12→16→2]
 //
-// Usage: cnn_seq [epochs=500] [lr=0.005] [samples=100]
+// Usage: cnn_seq [epochs=500] [lr=0.005] [samples=100] [batch=1]
+//        cnn_seq --bench     time Conv1DLayer forward+backward per algorithm
+//
+// batch=1 trains per sample with ConvNet::train(); batch>1 uses
+// ConvNet::trainBatch() on shuffled mini-batches (gradients averaged, so a
+// larger lr is usually needed).
 //
 
 #define _USE_MATH_DEFINES
 #include "nu_convnet.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -53,26 +59,87 @@ double accuracy(
     nu::ConvNet& cnn, const std::vector<std::vector<double>>& Xs, const std::vector<int>& labels)
 {
     int correct = 0;
+    const auto outs = cnn.predictBatch(Xs);
     for (size_t i = 0; i < Xs.size(); ++i) {
-        const auto out = cnn.predict(Xs[i]);
-        const int pred = (out[0] > out[1]) ? 0 : 1;
+        const int pred = (outs[i][0] > outs[i][1]) ? 0 : 1;
         if (pred == labels[i])
             ++correct;
     }
     return 100.0 * correct / static_cast<double>(Xs.size());
 }
 
+// Microseconds per sample for one forward+backward pass of a Conv1DLayer,
+// either one sample at a time or as a single batched call over `batch` samples.
+double timeConv(size_t inCh, size_t inLen, size_t outCh, size_t k, nu::ConvAlgorithm algo,
+    Eigen::Index batch)
+{
+    nu::Conv1DLayer layer(inCh, inLen, outCh, k, nu::Activation::Tanh, 1e-6, algo);
+    const Eigen::MatrixXd X
+        = Eigen::MatrixXd::Random(static_cast<Eigen::Index>(inCh * inLen), batch);
+    const Eigen::MatrixXd G
+        = Eigen::MatrixXd::Constant(static_cast<Eigen::Index>(layer.outputSize()), batch, 0.01);
+    const std::vector<double> x(X.col(0).data(), X.col(0).data() + X.rows());
+    const std::vector<double> g(G.col(0).data(), G.col(0).data() + G.rows());
+
+    const double flops = 6.0 * static_cast<double>(inCh * k * outCh * layer.outLength());
+    const int reps = std::max(2, static_cast<int>(2e8 / (flops * static_cast<double>(batch))));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        if (batch == 1) {
+            layer.forward(x);
+            layer.backward(g, 1e-6);
+        } else {
+            layer.forwardBatch(X);
+            layer.backwardBatch(G, 1e-6);
+        }
+    }
+    const std::chrono::duration<double, std::micro> dt = std::chrono::steady_clock::now() - t0;
+    return dt.count() / (reps * static_cast<double>(batch));
+}
+
+void benchConv()
+{
+    struct Shape {
+        size_t inCh, inLen, outCh, k;
+    };
+    const Shape shapes[]
+        = { { 1, T, 8, 5 }, { 1, 256, 16, 7 }, { 16, 128, 32, 5 }, { 64, 128, 64, 3 } };
+
+    std::cout << "Conv1DLayer forward+backward, us/sample (Tanh)\n";
+    std::cout << std::setw(20) << "shape" << std::setw(10) << "im2col" << std::setw(10)
+              << "direct" << std::setw(12) << "im2col/32" << std::setw(12) << "direct/32"
+              << "\n";
+    for (const auto& s : shapes) {
+        const std::string name = std::to_string(s.inCh) + "x" + std::to_string(s.inLen) + " -> "
+            + std::to_string(s.outCh) + " k" + std::to_string(s.k);
+        std::cout << std::setw(20) << name << std::fixed << std::setprecision(2);
+        for (Eigen::Index batch : { Eigen::Index(1), Eigen::Index(32) })
+            for (auto algo : { nu::ConvAlgorithm::Im2Col, nu::ConvAlgorithm::Direct })
+                std::cout << std::setw(batch == 1 ? 10 : 12)
+                          << timeConv(s.inCh, s.inLen, s.outCh, s.k, algo, batch);
+        std::cout << "\n";
+    }
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        benchConv();
+        return 0;
+    }
+
     const int EPOCHS = argc > 1 ? std::stoi(argv[1]) : 500;
     const double LR = argc > 2 ? std::stod(argv[2]) : 0.005;
     const int N_TRAIN = argc > 3 ? std::stoi(argv[3]) : 100; // per class
+    const size_t BATCH = argc > 4 ? std::stoul(argv[4]) : 1;
 
     std::cout << "ConvNet frequency-classification demo\n";
     std::cout << "  T=" << T << "  classes: 1-cycle sine vs 2-cycle sine\n";
-    std::cout << "  epochs=" << EPOCHS << "  lr=" << LR << "  n_train=" << N_TRAIN << "/class\n\n";
+    std::cout << "  epochs=" << EPOCHS << "  lr=" << LR << "  n_train=" << N_TRAIN
+              << "/class  batch=" << BATCH << "\n\n";
 
     std::mt19937 rng(42);
     constexpr double NOISE = 0.15;
@@ -117,13 +184,30 @@ int main(int argc, char* argv[])
               << "Train acc%" << std::setw(11) << "Test acc%\n";
     std::cout << std::string(43, '-') << "\n";
 
+    std::vector<std::vector<double>> batchX, batchT;
+    std::chrono::duration<double> trainTime{ 0.0 };
+
     for (int ep = 1; ep <= EPOCHS; ++ep) {
         std::shuffle(idx.begin(), idx.end(), rng);
         double totalLoss = 0.0;
-        for (size_t j : idx) {
-            const auto& tgt = (trainY[j] == 0) ? T0 : T1;
-            totalLoss += cnn.train(trainX[j], tgt);
+        const auto t0 = std::chrono::steady_clock::now();
+        if (BATCH <= 1) {
+            for (size_t j : idx) {
+                const auto& tgt = (trainY[j] == 0) ? T0 : T1;
+                totalLoss += cnn.train(trainX[j], tgt);
+            }
+        } else {
+            for (size_t b = 0; b < idx.size(); b += BATCH) {
+                batchX.clear();
+                batchT.clear();
+                for (size_t j = b; j < std::min(idx.size(), b + BATCH); ++j) {
+                    batchX.push_back(trainX[idx[j]]);
+                    batchT.push_back((trainY[idx[j]] == 0) ? T0 : T1);
+                }
+                totalLoss += cnn.trainBatch(batchX, batchT) * static_cast<double>(batchX.size());
+            }
         }
+        trainTime += std::chrono::steady_clock::now() - t0;
         if (ep % REPORT == 0) {
             const double trainAcc = accuracy(cnn, trainX, trainY);
             const double testAcc = accuracy(cnn, testX, testY);
@@ -134,5 +218,6 @@ int main(int argc, char* argv[])
     }
 
     std::cout << "\nFinal test accuracy: " << accuracy(cnn, testX, testY) << "%\n";
+    std::cout << "Training time: " << std::setprecision(3) << trainTime.count() << " s\n";
     return 0;
 }
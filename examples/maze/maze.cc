@@ -8,6 +8,7 @@
 
 // Maze example.
 
+#include "nu_dense_qmap.h"
 #include "nu_e_greedy_policy.h"
 #include "nu_qlearn.h"
 #include "nu_sarsa.h"
@@ -311,9 +312,20 @@ constexpr bool useEGreedyPolicy = true;
 using Policy = std::conditional<useEGreedyPolicy, nu::EGreedyPolicy<Action, Agent>,
     nu::SoftmaxPolicy<Action, Agent>>::type;
 
+// Cells and moves index a dense [cells x moves] Q-table.
+struct MazeQIndex {
+    size_t state(const State& s) const noexcept
+    {
+        return size_t(s.get_y()) * Envirnoment::_X + size_t(s.get_x());
+    }
+    size_t action(const Action& a) const noexcept { return size_t(a.get()); }
+};
+
+using QMap = nu::DenseQMap<State, Action, 4, MazeQIndex>;
+
 constexpr bool useSarsa = true;
-using Learner = std::conditional<useSarsa, nu::Sarsa<Action, State, Agent, Policy>,
-    nu::QLearn<Action, State, Agent, Policy>>::type;
+using Learner = std::conditional<useSarsa, nu::Sarsa<Action, State, Agent, Policy, void, QMap>,
+    nu::QLearn<Action, State, Agent, Policy, void, QMap>>::type;
 
 struct Simulator {
     template <class Render>
@@ -368,10 +380,11 @@ struct App {
     Envirnoment env;
     State goal{ 44, 29 };
     Render render;
-    Learner learner;
+    Learner learner{ QMap(Envirnoment::_X * Envirnoment::_Y) };
     Simulator simulator;
 
     static constexpr int episodies{ 100000 };
+    static constexpr size_t warmupEpisodes{ 2000 };
     static constexpr int timeout{ 3000 };
     static constexpr double greward{ 1000 };
 
@@ -384,6 +397,12 @@ struct App {
             std::cout << std::endl;
         };
 
+        // Warm-up: episodes run on every hardware thread, sharing the
+        // Q-table (Hogwild).
+        std::cout << "Learning (" << warmupEpisodes << " parallel episodes)... " << std::endl;
+        learner.learnParallel(
+            warmupEpisodes, [this](size_t) { return Agent(env, State(1, 1), goal); });
+
         std::cout << "Learning... " << std::endl;
 
         for (int episode = 0; episode < episodies; ++episode) {
@@ -20,10 +20,14 @@ See also http://yann.lecun.com/exdb/mnist/
 
 Extra flags vs. the classic build:
   --matrix / -M        Use MlpMatrixNN (Eigen-backed) instead of MlpNN
-  --batch  / -b <N>    Mini-batch size (requires --matrix; default 1 = online SGD)
+  --batch  / -b <N>    Mini-batch size (requires --matrix or --cnn; default 1 = online SGD)
+  --cnn    / -C        Train a small ConvNet on the 1x28x28 images instead of an MLP:
+                       Conv2D(8, 5x5) -> MaxPool(2x2) -> Conv2D(16, 5x5) -> MaxPool(2x2)
+                       -> FC(256 -> 10), about 6K weights versus 238K for 784-300-10
 */
 
 #include "mnist.h"
+#include "nu_convnet.h"
 #include "nu_mlpmatrixnn.h"
 #include "nu_mlpnn.h"
 
@@ -65,7 +69,7 @@ static bool process_cl(int argc, char* argv[], std::string& files_path, std::str
     std::string& save_file_name, bool& skip_training, double& learningRate, bool& change_lr,
     double& momentum, bool& change_m, int& epoch, std::vector<size_t>& hidden_layer,
     bool& use_cross_entropy, nu::Activation& activation, bool& use_matrix, size_t& batch_size,
-    bool& use_opencl)
+    bool& use_opencl, bool& use_cnn)
 {
     for (int pidx = 1; pidx < argc; ++pidx) {
         const std::string arg = argv[pidx];
@@ -182,6 +186,10 @@ static bool process_cl(int argc, char* argv[], std::string& files_path, std::str
             use_matrix = true; // OpenCL requires --matrix
             continue;
         }
+        if (arg == "--cnn" || arg == "-C") {
+            use_cnn = true;
+            continue;
+        }
 
         return false;
     }
@@ -238,14 +246,16 @@ static void usage(const char* appname)
            " default: sigmoid)\n"
         << "\t[--matrix|-M]                        Use MlpMatrixNN (Eigen) instead of MlpNN\n"
         << "\t[--opencl|-g]                        Use MlpMatrixNN with ArrayFire/OpenCL GPU\n"
-        << "\t[--batch|-b <size>]                  Mini-batch size for --matrix (default: 1)\n"
+        << "\t[--batch|-b <size>]                  Mini-batch size, --matrix/--cnn (default: 1)\n"
+        << "\t[--cnn|-C]                           Use a 2D ConvNet instead of an MLP\n"
         << "\n"
         << "Notes:\n"
         << "  --activation applies to all hidden layers; output layer is always Sigmoid.\n"
         << "  --use_cross_entropy is recommended together with Sigmoid hidden/output layers.\n"
-        << "  --batch requires --matrix; batch=1 is online SGD (same as no --batch).\n"
+        << "  --batch requires --matrix or --cnn; batch=1 is online SGD (same as no --batch).\n"
+        << "  --cnn ignores --hidden_layer/--activation/--momentum/--use_cross_entropy.\n"
         << "  --opencl implies --matrix; requires a build with NUNN_HAS_ARRAYFIRE.\n"
-        << "  --save/--load are not available in --matrix mode.\n";
+        << "  --save/--load are not available in --matrix and --cnn modes.\n";
 }
 
 // ── Test functions ────────────────────────────────────────────────────────────
@@ -327,6 +337,56 @@ static double test_net_mat(std::unique_ptr<nu::MlpMatrixNN>& net,
     return static_cast<double>(err_cnt) / static_cast<double>(cnt);
 }
 
+// Evaluate ConvNet on the test set, in batches of EVAL_BATCH images.
+static double test_net_cnn(nu::ConvNet& net, const TrainingData::data_t& test_data,
+    double& mean_square_error, double& entropy_cost)
+{
+    constexpr Eigen::Index EVAL_BATCH = 500;
+    size_t cnt = 0, err_cnt = 0;
+    mean_square_error = 0.0;
+    entropy_cost = 0.0;
+
+    Eigen::MatrixXd X(static_cast<Eigen::Index>(net.inputSize()), EVAL_BATCH);
+    std::vector<const DigitData*> items;
+    items.reserve(EVAL_BATCH);
+
+    auto flush = [&] {
+        const auto B = static_cast<Eigen::Index>(items.size());
+        const Eigen::MatrixXd Y = net.predictBatch(X.leftCols(B));
+        for (Eigen::Index j = 0; j < B; ++j) {
+            nu::Vector nv_target;
+            items[static_cast<size_t>(j)]->labelToTarget(nv_target);
+            const nu::Vector outputs(
+                std::vector<double>(Y.col(j).data(), Y.col(j).data() + Y.rows()));
+            mean_square_error += nu::cf::calcMSE(outputs, nv_target);
+            entropy_cost += nu::cf::calcCrossEntropy(outputs, nv_target);
+
+            Eigen::Index predicted = 0;
+            Y.col(j).maxCoeff(&predicted);
+            if (items[static_cast<size_t>(j)]->getLabel() != static_cast<int>(predicted))
+                ++err_cnt;
+            ++cnt;
+        }
+        items.clear();
+    };
+
+    for (const auto& item : test_data) {
+        nu::Vector nv_inputs;
+        item->toVect(nv_inputs);
+        X.col(static_cast<Eigen::Index>(items.size()))
+            = Eigen::Map<const Eigen::VectorXd>(nv_inputs.to_stdvec().data(), X.rows());
+        items.push_back(item.get());
+        if (items.size() == static_cast<size_t>(EVAL_BATCH))
+            flush();
+    }
+    if (!items.empty())
+        flush();
+
+    mean_square_error /= cnt;
+    entropy_cost /= cnt;
+    return static_cast<double>(err_cnt) / static_cast<double>(cnt);
+}
+
 // ── Save (MlpNN only) ─────────────────────────────────────────────────────────
 
 static bool save_the_net(const std::string& filename, nu::MlpNN& net)
@@ -356,6 +416,7 @@ int main(int argc, char* argv[])
     bool use_ce = false;
     bool use_matrix = false;
     bool use_opencl = false;
+    bool use_cnn = false;
     size_t batch_size = 1;
     bool change_lr = false;
     bool change_m = false;
@@ -366,7 +427,7 @@ int main(int argc, char* argv[])
     if (argc > 1) {
         if (!process_cl(argc, argv, files_path, load_file_name, save_file_name, skip_training,
                 learningRate, change_lr, momentum, change_m, epoch_cnt, hidden_layer, use_ce,
-                hidden_activation, use_matrix, batch_size, use_opencl)) {
+                hidden_activation, use_matrix, batch_size, use_opencl, use_cnn)) {
             usage(argv[0]);
             return 1;
         }
@@ -375,12 +436,12 @@ int main(int argc, char* argv[])
     if (hidden_layer.empty())
         hidden_layer.push_back(HIDDEN_LAYER_SIZE);
 
-    if (batch_size > 1 && !use_matrix) {
-        std::cerr << "Warning: --batch requires --matrix; ignoring --batch.\n";
+    if (batch_size > 1 && !use_matrix && !use_cnn) {
+        std::cerr << "Warning: --batch requires --matrix or --cnn; ignoring --batch.\n";
         batch_size = 1;
     }
-    if (use_matrix && (!load_file_name.empty() || !save_file_name.empty()))
-        std::cerr << "Notice: --load/--save are not supported in --matrix mode; ignoring.\n";
+    if ((use_matrix || use_cnn) && (!load_file_name.empty() || !save_file_name.empty()))
+        std::cerr << "Notice: --load/--save are not supported in --matrix/--cnn mode; ignoring.\n";
 
 #ifdef _WIN32
     ::system("cls");
@@ -394,15 +455,16 @@ int main(int argc, char* argv[])
     for (int i = 0; const auto& hl : hidden_layer)
         std::cout << "NN hidden neurons L" << ++i << "       : " << hl << "\n";
 
-    const char* backend_name = use_opencl ? "MlpMatrixNN (ArrayFire/OpenCL)"
-        : use_matrix                      ? "MlpMatrixNN (Eigen)"
-                                          : "MlpNN";
+    const char* backend_name = use_cnn ? "ConvNet (Conv2D/MaxPool2D + MlpMatrixNN head)"
+        : use_opencl                   ? "MlpMatrixNN (ArrayFire/OpenCL)"
+        : use_matrix                   ? "MlpMatrixNN (Eigen)"
+                                       : "MlpNN";
     std::cout << "Hidden activation          : " << nu::act::name(hidden_activation) << "\n"
               << "Cost function              : " << (use_ce ? "cross-entropy" : "MSE") << "\n"
               << "Net Learning rate  ( LR )  : " << learningRate << "\n"
               << "Net Momentum       ( M )   : " << momentum << "\n"
               << "Backend                    : " << backend_name << "\n";
-    if (use_matrix)
+    if (use_matrix || use_cnn)
         std::cout << "Mini-batch size            : " << batch_size
                   << (batch_size == 1 ? " (online SGD)" : "") << "\n";
 
@@ -419,9 +481,125 @@ int main(int argc, char* argv[])
         [[maybe_unused]] auto n_of_test_items = test_set.load();
         const auto& test_data = test_set.data();
 
+        // ── ConvNet path ──────────────────────────────────────────────────────
+
+        if (use_cnn) {
+            if (skip_training) {
+                std::cerr << "Error: --skip_training is not supported in --cnn mode.\n";
+                return 1;
+            }
+
+            TrainingData trainingSet(training_labels_fn, training_images_fn);
+            [[maybe_unused]] auto n = trainingSet.load();
+            const auto& data = trainingSet.data();
+            assert(!data.empty());
+
+            std::cout << "Test labels file: " << testing_labels_fn << "\n"
+                      << "Test images file: " << testing_images_fn << "\n";
+
+            const auto dy = static_cast<size_t>(data.front()->get_dy());
+            const auto dx = static_cast<size_t>(data.front()->get_dx());
+
+            using LC = nu::MlpMatrixNN::LayerConfig;
+            nu::ConvNet net(1, dy, dx);
+            net.addConv2D(8, 5, 5, nu::Activation::ReLU, learningRate)
+                .addMaxPool2D(2, 2)
+                .addConv2D(16, 5, 5, nu::Activation::ReLU, learningRate)
+                .addMaxPool2D(2, 2);
+            net.setFCHead(
+                { LC(net.flatFeatureSize()), LC(OUTPUT_LAYER_SIZE, nu::Activation::Sigmoid) },
+                learningRate);
+
+            const size_t n_weights = 8 * (5 * 5 + 1) + 16 * (8 * 5 * 5 + 1)
+                + (net.flatFeatureSize() + 1) * OUTPUT_LAYER_SIZE;
+            std::cout << "Trainable weights          : " << n_weights << "\n";
+
+            const auto B = static_cast<Eigen::Index>(batch_size);
+            Eigen::MatrixXd batch_in(static_cast<Eigen::Index>(net.inputSize()), B);
+            Eigen::MatrixXd batch_tgt(static_cast<Eigen::Index>(OUTPUT_LAYER_SIZE), B);
+
+            double prev_loss = -1.0;
+            double best_ber = 100.0;
+            int best_epoch = 0;
+            std::cout << "\n";
+
+            for (int epoch = 0; epoch < epoch_cnt; ++epoch) {
+                locate(1);
+                std::cout << "Learning epoch " << epoch + 1 << " of " << epoch_cnt
+                          << " ( LR = " << learningRate << " )\n\n";
+
+                size_t cnt = 0;
+                Eigen::Index fill = 0;
+                trainingSet.reshuffle();
+                const auto t0 = std::chrono::steady_clock::now();
+
+                for (const auto& item : trainingSet.data()) {
+                    nu::Vector nv_in, nv_tgt;
+                    item->toVect(nv_in);
+                    item->labelToTarget(nv_tgt);
+                    const auto& in = nv_in.to_stdvec();
+                    const auto& tgt = nv_tgt.to_stdvec();
+                    batch_in.col(fill) = Eigen::Map<const Eigen::VectorXd>(in.data(), in.size());
+                    batch_tgt.col(fill) = Eigen::Map<const Eigen::VectorXd>(tgt.data(), tgt.size());
+
+                    if (++fill == B) {
+                        net.trainBatch(batch_in, batch_tgt);
+                        cnt += batch_size;
+                        fill = 0;
+
+                        if (cnt % (120 * batch_size) < batch_size) {
+                            locate(1);
+                            std::cout << "Completed "
+                                      << (double(cnt) / trainingSet.data().size()) * 100.0
+                                      << "%   \n";
+                        }
+                    }
+                }
+                // Flush remainder
+                if (fill > 0) {
+                    net.trainBatch(batch_in.leftCols(fill), batch_tgt.leftCols(fill));
+                    cnt += static_cast<size_t>(fill);
+                }
+
+                const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - t0)
+                                            .count();
+
+                const auto te0 = std::chrono::steady_clock::now();
+                double epochMSE{}, epochCE{};
+                const auto err_rate = test_net_cnn(net, test_data, epochMSE, epochCE);
+                const auto eval_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - te0)
+                                         .count();
+                const double delta_loss = (prev_loss >= 0.0) ? (epochMSE - prev_loss) : 0.0;
+                prev_loss = epochMSE;
+
+                std::cout << "Error rate   : " << err_rate * 100.0 << "%     \n"
+                          << "MSE          : " << epochMSE * 100.0 << "%     \n"
+                          << "Cross-entropy: " << epochCE * 100.0 << "%     \n"
+                          << "dLoss/depoch : " << std::showpos << delta_loss * 100.0
+                          << std::noshowpos << "%     \n"
+                          << "Success rate : " << (1.0 - err_rate) * 100.0 << "%    \n"
+                          << "Epoch time   : " << elapsed_ms << " ms  \n"
+                          << "Throughput   : "
+                          << (elapsed_ms > 0 ? static_cast<long long>(cnt) * 1000LL / elapsed_ms
+                                             : 0LL)
+                          << " samples/s  \n"
+                          << "Test time    : " << eval_ms << " ms  \n";
+
+                if (err_rate < best_ber) {
+                    best_ber = err_rate;
+                    best_epoch = epoch;
+                }
+
+                std::cout << "BER          : " << best_ber * 100.0 << "%    \n"
+                          << "Epoch BER    : " << best_epoch + 1 << "    \n\n";
+            }
+        }
+
         // ── MlpNN path ────────────────────────────────────────────────────────
 
-        if (!use_matrix) {
+        else if (!use_matrix) {
             std::unique_ptr<nu::MlpNN> net;
 
             if (!skip_training) {
@@ -67,7 +67,8 @@ int main()
             { 0, { 4 } }, { 1, { 3, 5 } }, { 2, { 3 } }, { 3, { 1, 2, 4 } }, { 4, { 0, 3, 5 } },
             { 5, { 1, 4, 5 } } });
 
-    ql.learn(NumberOfEpisodies);
+    // Episodes run on every hardware thread, updating the Q-matrix in place.
+    ql.learn(NumberOfEpisodies, nu::ParallelLearnConfig());
 
 #ifdef _DEBUG
     auto& q = ql.get_q_mtx();
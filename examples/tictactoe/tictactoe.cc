@@ -25,9 +25,11 @@
 #include <time.h>
 #include <vector>
 
+#include "nu_game_search.h"
 #include "nu_mlpnn.h"
+#include "nu_tictactoe.h"
 
-constexpr std::string_view PROG_VERSION{ "1.55" };
+constexpr std::string_view PROG_VERSION{ "1.56" };
 constexpr auto TICTACTOE_SIDE{ 3 };
 constexpr auto TICTACTOE_CELLS{ TICTACTOE_SIDE * TICTACTOE_SIDE };
 
@@ -224,7 +226,7 @@ private:
     }
 
 public:
-    virtual void draw(const grid_t& grid, bool show_nums)
+    virtual void draw(const nu::TicTacToe& board, bool show_nums)
     {
         char ch = '0';
 
@@ -232,7 +234,7 @@ public:
 
         for (int y = 0; y < TICTACTOE_SIDE; ++y) {
             for (int x = 0; x < TICTACTOE_SIDE; ++x) {
-                int symbol = grid.at(x, y);
+                int symbol = board.at(y * TICTACTOE_SIDE + x);
                 ++ch;
 
                 auto& cell = _rows[(y + 1) * 3 - 1][2 + x * 4];
@@ -663,8 +665,6 @@ public:
     {
         _build_pos_coll();
 
-        renderer_t rend;
-
         for (auto& item : _pos_coll) {
 
             int o_cnt = 0;
@@ -690,24 +690,25 @@ public:
 
 class game_t {
 private:
-    grid_t _grid;
+    nu::TicTacToe _board;
     renderer_t& _renderer;
     nu::MlpNN& _nn;
+    nu::Mcts<nu::TicTacToe>* _search = nullptr;
     bool _computer_alone = false;
 
-    void _show_verdict(grid_t::symbol_t symbol, grid_t::symbol_t computer_symbol)
+    void _show_verdict(nu::TicTacToe::Symbol symbol, nu::TicTacToe::Symbol computer_symbol)
     {
         if (computer_symbol == symbol)
             std::cout << "Artificial Intelligence beats Man :-)" << std::endl;
 
         switch (symbol) {
-        case grid_t::X:
+        case nu::TicTacToe::X:
             std::cout << "X wins !" << std::endl << std::endl << std::endl;
             break;
-        case grid_t::O:
+        case nu::TicTacToe::O:
             std::cout << "O wins !" << std::endl << std::endl << std::endl;
             break;
-        case grid_t::EMPTY:
+        case nu::TicTacToe::Empty:
         default:
             std::cout << "X and O have tied the game" << std::endl;
             break;
@@ -715,17 +716,34 @@ private:
     }
 
 public:
-    game_t(renderer_t& renderer, nu::MlpNN& nn, bool computer_alone = false) noexcept
+    // With a search, the computer plays the move most visited by the MCTS
+    // (network outputs as priors) instead of the network's best legal move.
+    game_t(renderer_t& renderer, nu::MlpNN& nn, nu::Mcts<nu::TicTacToe>* search = nullptr,
+        bool computer_alone = false) noexcept
         : _renderer(renderer)
         , _nn(nn)
+        , _search(search)
         , _computer_alone(computer_alone)
     {
     }
 
-    void play_computer(grid_t::symbol_t symbol)
+    void play_computer()
     {
-        nu::Vector inputs, outputs;
-        nn_io_converter_t::getInputVector(_grid, symbol, inputs);
+        if (_search) {
+            const int move = _search->search(_board);
+            std::cout << "Search: move " << move + 1 << " visited "
+                      << int(_search->policy()[size_t(move)] * 1000) / 10.0 << "% of "
+                      << _search->treeSize() << " nodes" << std::endl;
+            _board.play(move);
+            return;
+        }
+
+        Eigen::VectorXd encoded(nu::TicTacToe::inputSize);
+        _board.encode(encoded);
+
+        nu::Vector inputs(encoded.size()), outputs;
+        for (size_t i = 0; i < inputs.size(); ++i)
+            inputs[i] = encoded(Eigen::Index(i));
 
         _nn.setInputVector(inputs);
         _nn.feedForward();
@@ -742,22 +760,19 @@ public:
                 std::cout << "Neuron " << m.second + 1 << " -> " << rate << "%" << std::endl;
         }
 
-        int move = 0;
-
-        // Find best matching move (e.g. starting from higher rate move
+        // Best matching legal move (e.g. starting from higher rate move
         // check if game grid cell is empty, upon empty do the move.
         // If cell is not empty, search for next one...)
+        const auto legal = _board.legalMoves();
         for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
-            move = it->second;
-
-            if (_grid.at(move) == grid_t::EMPTY) {
-                _grid.at(move) = symbol;
+            if ((legal >> it->second) & 1) {
+                _board.play(it->second);
                 break;
             }
         }
     }
 
-    bool play_human(grid_t::symbol_t symbol)
+    bool play_human()
     {
         std::string choice;
 
@@ -778,55 +793,46 @@ public:
 
         --move;
 
-        if (_grid.at(move) != grid_t::EMPTY) {
+        if (_board.at(move) != nu::TicTacToe::Empty) {
             std::cout << "Move not allowed, please change your choice." << std::endl;
 
             return false;
         }
 
-        _grid.at(move) = symbol;
+        _board.play(move);
 
         return true;
     }
 
     void play(bool init_flg)
     {
-        grid_t::symbol_t winner = grid_t::EMPTY;
-        bool completed = false;
-        bool toggle = init_flg;
-        bool swap_nn_player = true;
+        // The human (or the first computer player) is X.
+        _board = nu::TicTacToe(init_flg ? nu::TicTacToe::X : nu::TicTacToe::O);
 
-        auto comp_symb = grid_t::EMPTY;
+        auto comp_symb = nu::TicTacToe::Empty;
 
         do {
-            if (toggle) {
+            if (_board.turn() == nu::TicTacToe::X) {
                 if (!_computer_alone) {
-                    _renderer.draw(_grid, !_computer_alone);
-                    while (!play_human(grid_t::X))
+                    _renderer.draw(_board, !_computer_alone);
+                    while (!play_human())
                         ;
                 } else {
-                    swap_nn_player = !swap_nn_player;
-                    comp_symb = grid_t::X;
-                    play_computer(grid_t::X);
+                    comp_symb = nu::TicTacToe::X;
+                    play_computer();
                 }
             } else {
-                comp_symb = grid_t::O;
-                play_computer(grid_t::O);
+                comp_symb = nu::TicTacToe::O;
+                play_computer();
             }
 
-            _renderer.draw(_grid, false);
-
-            toggle = !toggle;
-
-            winner = _grid.get_winner_symbol();
+            _renderer.draw(_board, false);
 
-            completed = _grid.is_completed();
+        } while (!_board.over());
 
-        } while (winner == grid_t::EMPTY && !completed);
+        _renderer.draw(_board, false);
 
-        _renderer.draw(_grid, false);
-
-        _show_verdict(winner, comp_symb);
+        _show_verdict(_board.winner(), comp_symb);
     }
 };
 
@@ -846,6 +852,7 @@ static void usage(const char* appname)
               << "\t[--epoch_cnt|-e <count>] " << std::endl
               << "\t[--stop_on_err_tr|-x <error rate>] " << std::endl
               << "\t[[--hidden_layer|-hl <size> [--hidden_layer|--hl <size] ... ]  " << std::endl
+              << "\t[--search|-S <simulations>] " << std::endl
               << std::endl
               << "Where:" << std::endl
               << "--version or -v " << std::endl
@@ -870,14 +877,17 @@ static void usage(const char* appname)
               << "\tset error rate threshold (default " << TRAINING_ERR_THRESHOLD << ")"
               << std::endl
               << "--hidden_layer or -hl" << std::endl
-              << "\tset hidden layer size (n. of neurons)" << std::endl;
+              << "\tset hidden layer size (n. of neurons)" << std::endl
+              << "--search or -S" << std::endl
+              << "\tpick the computer moves by a Monte Carlo tree search of the given" << std::endl
+              << "\tsimulations per move, using the net outputs as move priors" << std::endl;
 }
 
 
 static bool process_cl(int argc, char* argv[], std::string& files_path, std::string& load_file_name,
     std::string& save_file_name, bool& skip_training, double& learningRate, bool& change_lr,
     double& momentum, bool& change_m, int& epoch, double& threshold,
-    std::vector<size_t>& hidden_layer, bool& use_cross_entropy)
+    std::vector<size_t>& hidden_layer, bool& use_cross_entropy, int& simulations)
 {
     int pidx = 1;
 
@@ -963,6 +973,17 @@ static bool process_cl(int argc, char* argv[], std::string& files_path, std::str
             continue;
         }
 
+        if ((arg == "--search" || arg == "-S") && (pidx + 1) < argc) {
+            try {
+                simulations = std::stoi(argv[++pidx]);
+            } catch (...) {
+                return false;
+            }
+            if (simulations < 0)
+                return false;
+            continue;
+        }
+
         if ((arg == "--hidden_layer" || arg == "-hl") && (pidx + 1) < argc) {
             try {
                 hidden_layer.push_back(std::stoi(argv[++pidx]));
@@ -1008,13 +1029,14 @@ int main(int argc, char* argv[])
     bool change_lr = false;
     bool change_m = false;
     bool use_cross_entropy = false;
+    int simulations = 0;
 
     double threshold = TRAINING_ERR_THRESHOLD;
 
     if (argc > 1) {
         if (!process_cl(argc, argv, files_path, load_file_name, save_file_name, skip_training,
                 learningRate, change_lr, momentum, change_m, epoch_cnt, threshold, hidden_layer,
-                use_cross_entropy)) {
+                use_cross_entropy, simulations)) {
             usage(argv[0]);
             return 1;
         }
@@ -1151,12 +1173,20 @@ int main(int argc, char* argv[])
         }
     }
 
+    // The net is not trained any further: its evaluations are cached across
+    // moves and games.
+    nu::NetEvaluator<nu::TicTacToe> evaluator(nu::batchFn(*net));
+    std::unique_ptr<nu::Mcts<nu::TicTacToe>> search;
+    if (simulations > 0)
+        search = std::make_unique<nu::Mcts<nu::TicTacToe>>(
+            evaluator, nu::MctsConfig { size_t(simulations) });
+
     while (1) {
         bool turn_for_beginning = true;
 
         while (1) {
             turn_for_beginning = !turn_for_beginning;
-            game_t game(renderer, *net);
+            game_t game(renderer, *net, search.get());
             game.play(turn_for_beginning);
 
             std::string what;
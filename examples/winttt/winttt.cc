@@ -24,6 +24,7 @@
 #include "stdafx.h"
 
 #include "nu_mlpnn.h"
+#include "nu_tictactoe.h"
 
 #include <fstream>
 #include <list>
@@ -1026,31 +1027,32 @@ static void ExpertAlgo(grid_t& new_grid, grid_t::symbol_t symbol)
     }
 }
 
+// The net keeps learning from the expert moves while playing, so its answers
+// are not cached across moves: one batched forward pass per move.
 static void NetAnswer(nu::MlpNN& nn, grid_t& grid, grid_t::symbol_t symbol)
 {
     try {
-        nu::Vector inputs, outputs;
-        nn_io_converter_t::getInputVector(grid, symbol, inputs);
+        nu::TicTacToe board;
+        for (int cell = 0; cell < TICTACTOE_CELLS; ++cell)
+            board.set(cell, nu::TicTacToe::Symbol(grid.at(cell)));
+        board.setTurn(nu::TicTacToe::Symbol(symbol));
 
-        nn.setInputVector(inputs);
-        nn.feedForward();
-        nn.copyOutputVector(outputs);
+        Eigen::VectorXd inputs(nu::TicTacToe::inputSize);
+        board.encode(inputs);
+        const Eigen::VectorXd outputs = nn.feedForwardBatch(inputs);
 
         int i = 0;
         std::map<double, int> moves;
         for (auto output : outputs)
             moves.insert(std::make_pair(output, i++));
 
-        int move = 0;
-
         // Find best matching move (e.g. starting from higher rate move
-        // check if game grid cell is empty, upon empty do the move.
-        // If cell is not empty, search for next one...)
+        // check if the move is legal, upon legal do the move.
+        // If it is not, search for next one...)
+        const auto legal = board.legalMoves();
         for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
-            move = it->second;
-
-            if (grid.at(move) == grid_t::EMPTY) {
-                grid.at(move) = symbol;
+            if ((legal >> it->second) & 1) {
+                grid.at(it->second) = symbol;
                 break;
             }
         }
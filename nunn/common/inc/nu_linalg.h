@@ -0,0 +1,50 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Small dense linear-algebra helpers shared by the closed-form solvers.
+//
+// solveSpdOrMinNorm(A, B) solves A X = B for a symmetric positive
+// semi-definite A (normal equations, kernel Gram matrices). It tries a
+// Cholesky factorisation first and falls back to a complete orthogonal
+// decomposition when A is singular or too close to it for Cholesky to be
+// trusted; for a numerically singular A that is the minimum-norm solution.
+//
+// Usage:
+//   Eigen::MatrixXd G = H * H.transpose();
+//   G.diagonal().array() += ridge;
+//   const Eigen::MatrixXd W = nu::solveSpdOrMinNorm(G, H * T.transpose());
+//
+
+#pragma once
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+#include <Eigen/QR>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nu {
+
+// Cholesky is accepted only when every pivot L_ii exceeds 1e-7 * sqrt(s),
+// with s = max(1, max_i |A_ii|), i.e. when A is non-singular to about 1e-14
+// relative to its largest diagonal entry. Below that LLT may still report
+// success (collinear features, coincident kernel centres) while its pivots
+// are rounding noise; the rank-revealing decomposition handles those.
+inline Eigen::MatrixXd solveSpdOrMinNorm(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B)
+{
+    constexpr double MIN_PIVOT = 1e-7;
+    Eigen::LLT<Eigen::MatrixXd> llt(A);
+    const double scale = std::max(1.0, A.diagonal().cwiseAbs().maxCoeff());
+    const bool ok = llt.info() == Eigen::Success
+        && llt.matrixLLT().diagonal().minCoeff() > MIN_PIVOT * std::sqrt(scale);
+    if (ok)
+        return llt.solve(B);
+    return A.completeOrthogonalDecomposition().solve(B);
+}
+
+} // namespace nu
@@ -0,0 +1,204 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Minimal fork/join helpers over std::thread.
+//
+// parallelFor(n, nThreads, fn) splits [0, n) into nThreads contiguous ranges
+// and calls fn(begin, end, tid) once per range; range 0 runs on the calling
+// thread. The first exception thrown by any range is rethrown after all
+// threads have joined.
+//
+// WorkerPool keeps its threads for its lifetime, for callers that fork many
+// short jobs (e.g. one per lockstep step): pool.parallelFor(n, fn) splits the
+// work the same way, without creating or joining threads.
+//
+// Usage:
+//   const size_t nt = nu::resolveThreads(threads, N, 1024);
+//   std::vector<double> partial(nt, 0.0);
+//   nu::parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+//       for (size_t i = b; i < e; ++i)
+//           partial[t] += f(i);
+//   });
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nu {
+
+// Worker count for `work` items: requested (0 = hardware concurrency), capped
+// so that every thread gets at least minPerThread items. Never returns 0.
+inline size_t resolveThreads(size_t requested, size_t work, size_t minPerThread = 1) noexcept
+{
+    size_t n = requested;
+    if (n == 0)
+        n = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t byWork = std::max<size_t>(1, work / std::max<size_t>(1, minPerThread));
+    return std::max<size_t>(1, std::min(n, byWork));
+}
+
+template <class Fn> void parallelFor(size_t n, size_t nThreads, Fn&& fn)
+{
+    nThreads = std::max<size_t>(1, std::min(nThreads, n));
+    if (nThreads == 1) {
+        fn(size_t(0), n, size_t(0));
+        return;
+    }
+
+    std::exception_ptr error;
+    std::mutex errorMtx;
+    auto run = [&](size_t t) {
+        try {
+            fn(n * t / nThreads, n * (t + 1) / nThreads, t);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMtx);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads - 1);
+    for (size_t t = 1; t < nThreads; ++t)
+        workers.emplace_back(run, t);
+    run(0);
+    for (auto& w : workers)
+        w.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+// Fixed set of threads running parallelFor() jobs. The calling thread takes
+// range 0, so a pool of size() threads holds size() - 1 workers; each job
+// ends with all of its ranges done. One job at a time: parallelFor() must not
+// be called concurrently, nor from inside a job.
+class WorkerPool {
+public:
+    // threads: total threads including the caller (0 = hardware concurrency).
+    explicit WorkerPool(size_t threads)
+    {
+        const size_t n = threads != 0 ? threads : resolveThreads(0, SIZE_MAX);
+        _workers.reserve(n - 1);
+        for (size_t w = 1; w < n; ++w)
+            _workers.emplace_back([this, w] { _loop(w); });
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _start.notify_all();
+        for (auto& w : _workers)
+            w.join();
+    }
+
+    size_t size() const noexcept { return _workers.size() + 1; }
+
+    // As nu::parallelFor(n, nThreads, fn), with nThreads capped by size().
+    template <class Fn> void parallelFor(size_t n, size_t nThreads, Fn&& fn)
+    {
+        nThreads = std::max<size_t>(1, std::min({ nThreads, n, size() }));
+        if (nThreads == 1) {
+            fn(size_t(0), n, size_t(0));
+            return;
+        }
+
+        auto range = [&](size_t t) { fn(n * t / nThreads, n * (t + 1) / nThreads, t); };
+        using Range = decltype(range);
+        _run(nThreads, [](void* ctx, size_t t) { (*static_cast<Range*>(ctx))(t); }, &range);
+    }
+
+    template <class Fn> void parallelFor(size_t n, Fn&& fn)
+    {
+        parallelFor(n, size(), std::forward<Fn>(fn));
+    }
+
+private:
+    using Job = void (*)(void*, size_t);
+
+    void _run(size_t nThreads, Job job, void* ctx)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _job = job;
+            _ctx = ctx;
+            _active = nThreads;
+            _remaining = nThreads - 1;
+            _error = nullptr;
+            ++_generation;
+        }
+        _start.notify_all();
+
+        _call(job, ctx, 0);
+
+        std::unique_lock<std::mutex> lock(_mtx);
+        _done.wait(lock, [this] { return _remaining == 0; });
+        if (_error)
+            std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+
+    void _call(Job job, void* ctx, size_t t)
+    {
+        try {
+            job(ctx, t);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (!_error)
+                _error = std::current_exception();
+        }
+    }
+
+    void _loop(size_t w)
+    {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(_mtx);
+        for (;;) {
+            _start.wait(lock, [&] { return _stop || _generation != seen; });
+            if (_stop)
+                return;
+            seen = _generation;
+            if (w >= _active)
+                continue; // not part of this job
+
+            const Job job = _job;
+            void* const ctx = _ctx;
+            lock.unlock();
+            _call(job, ctx, w);
+            lock.lock();
+            if (--_remaining == 0)
+                _done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _mtx;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    Job _job = nullptr;
+    void* _ctx = nullptr;
+    size_t _active = 0;
+    size_t _remaining = 0;
+    std::uint64_t _generation = 0;
+    std::exception_ptr _error;
+    bool _stop = false;
+};
+
+} // namespace nu
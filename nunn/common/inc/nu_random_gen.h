@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 namespace nu {
@@ -23,6 +24,13 @@ struct RandomGenerator {
 
     double operator()() { return _distribution(_engine); }
 
+    // Restarts the sequence from a given seed.
+    void seed(std::uint32_t s)
+    {
+        _engine.seed(s);
+        _distribution.reset();
+    }
+
 private:
     Engine _engine;
     Distribution _distribution;
@@ -13,6 +13,11 @@
 //
 // Training objective: minimise MSE(reconstruct(x), x)  — i.e., target = input.
 //
+// Encoder and decoder are the two halves of a single MlpMatrixNN: encode()
+// runs only the encoder layers and decode() only the decoder layers, over
+// the one copy of the weights that training updates. The *Batch methods take
+// one sample per column; train() can run mini-batches through trainBatch().
+//
 // Usage:
 //   nu::Autoencoder ae(784, {128, 32}, nu::Activation::Tanh, 0.005);
 //   ae.train(dataset, 500);
@@ -40,29 +45,45 @@ public:
     Autoencoder(size_t inputDim, std::vector<size_t> encoderSizes,
         Activation act = Activation::Tanh, double lr = 0.01);
 
-    // Encode x → latent vector (bottleneck activation).
-    std::vector<double> encode(const std::vector<double>& x);
+    // Encode x → latent vector (bottleneck activation); the decoder is not run.
+    std::vector<double> encode(const std::vector<double>& x) const;
 
     // Decode latent vector z → reconstructed input.
-    // Uses decoder weights synced from the last train() or reshuffleWeights() call.
-    std::vector<double> decode(const std::vector<double>& z);
+    std::vector<double> decode(const std::vector<double>& z) const;
 
     // encode then decode — equivalent to a full forward pass.
-    std::vector<double> reconstruct(const std::vector<double>& x);
+    std::vector<double> reconstruct(const std::vector<double>& x) const;
 
     // MSE between x and reconstruct(x).
-    double reconstructionMSE(const std::vector<double>& x);
-
-    // Train on dataset (one sample per entry; target = input) for `epochs` passes.
-    // Returns mean reconstruction MSE over the final epoch.
-    // Syncs decoder weights once after all epochs.
-    double train(const std::vector<std::vector<double>>& dataset, size_t epochs);
+    double reconstructionMSE(const std::vector<double>& x) const;
+
+    // Batched forms: X [inputDim × B] → Z [latentDim × B] and back.
+    // Throw std::invalid_argument if the row count does not match.
+    Eigen::MatrixXd encodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+    Eigen::MatrixXd decodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& Z) const;
+    Eigen::MatrixXd reconstructBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Per-sample reconstruction MSE of X [inputDim × B] (e.g. anomaly scores).
+    Eigen::VectorXd reconstructionErrors(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Train on dataset (one sample per entry; target = input) for `epochs` passes,
+    // in dataset order. batchSize = 1 is online SGD (backPropagate per sample);
+    // larger sizes average the gradient over consecutive batches via
+    // MlpMatrixNN::trainBatch (the last batch may be smaller).
+    // Returns mean reconstruction MSE over the final epoch (measured before
+    // each update).
+    // Throws std::invalid_argument if batchSize is 0 or a sample size mismatches.
+    double train(
+        const std::vector<std::vector<double>>& dataset, size_t epochs, size_t batchSize = 1);
+
+    // Matrix form: X [inputDim × N], one sample per column.
+    double train(const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs, size_t batchSize = 64);
 
     size_t getInputSize() const noexcept { return _inputDim; }
     size_t getLatentSize() const noexcept { return _latentSize; }
     double getLearningRate() const noexcept { return _net.getLearningRate(); }
 
-    // Reinitialise all weights and sync decoder.
+    // Reinitialise all weights.
     void reshuffleWeights();
 
 private:
@@ -70,10 +91,9 @@ private:
     size_t _latentSize;
     size_t _encoderLayerCount;
 
-    MlpMatrixNN _net; // full autoencoder — trained end-to-end
-    MlpMatrixNN _decNet; // decoder-only — weights synced from _net for decode()
-
-    void _syncDecoder();
+    // Full autoencoder: layers [0, _encoderLayerCount) are the encoder, the
+    // remaining ones the decoder.
+    MlpMatrixNN _net;
 };
 
 } // namespace nu
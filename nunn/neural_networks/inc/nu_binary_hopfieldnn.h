@@ -0,0 +1,174 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+/**
+ * @file nu_binary_hopfieldnn.h
+ * @brief Bit-packed Hopfield Neural Network for bipolar (+1/-1) patterns.
+ *
+ * BinaryHopfieldNN stores the same Hebbian weights as HopfieldNN,
+ * W_ij = sum_p x_i^p x_j^p (i != j), but as small saturating integers held
+ * in weightBits two's-complement bit-planes, and keeps the neuron states
+ * packed one bit per neuron (1 for +1, 0 for -1) in 64-bit words.
+ *
+ * For a bit-plane row r and a packed state s, sum_j r_j s_j over bipolar s
+ * equals 2 popcount(r & s) - popcount(r), so a local field costs weightBits
+ * AND/popcount passes over N / 64 words instead of N multiply-adds. With the
+ * default 8 bit-planes the weights take N^2 bytes, one eighth of the double
+ * matrix of HopfieldNN.
+ *
+ * Weights saturate at +/-(2^(weightBits-1) - 1). Hebbian weights of random
+ * patterns grow as sqrt(M), so 8 bits hold them exactly well beyond the
+ * 0.138 N capacity of networks of a few thousand neurons.
+ *
+ * Inputs are binarised: a component greater than zero is +1, any other value
+ * is -1. A zero local field leaves the neuron unchanged. Recall follows the
+ * HopfieldNN recall modes; in Blocked mode the block is one 64-neuron word.
+ *
+ * load() and save() use the HopfieldNN text format, so a trained HopfieldNN
+ * can be converted by saving it and loading the stream here (weights are
+ * rounded, and scaled down uniformly if they exceed the integer range).
+ */
+
+#pragma once
+
+#include "nu_hopfieldnn.h"
+#include "nu_vector.h"
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace nu {
+
+class BinaryHopfieldNN {
+public:
+    using FpVector = Vector;
+    using RecallMode = HopfieldNN::RecallMode;
+    using SizeMismatchException = HopfieldNN::SizeMismatchException;
+    using InvalidSStreamFormatException = HopfieldNN::InvalidSStreamFormatException;
+
+    /**
+     * @brief Constructs a network of inputSize neurons.
+     * @param weightBits Bits per weight, in [2, 16]; throws
+     *        std::invalid_argument otherwise.
+     */
+    explicit BinaryHopfieldNN(size_t inputSize = 0, unsigned weightBits = 8);
+
+    //! Loads a network saved in the HopfieldNN text format.
+    explicit BinaryHopfieldNN(std::stringstream& ss) { load(ss); }
+
+    size_t getInputSize() const noexcept { return _n; }
+    unsigned getWeightBits() const noexcept { return _bits; }
+
+    //! Maximum number of storable patterns (0.138 N), as HopfieldNN.
+    size_t getCapacity() const noexcept
+    {
+        return static_cast<size_t>(0.138 * static_cast<double>(_n));
+    }
+
+    size_t getPatternsCount() const noexcept { return _patternSize; }
+
+    //! Bytes held by the packed weights and states.
+    size_t getMemoryBytes() const noexcept
+    {
+        return (_planes.size() + _s.size()) * sizeof(uint64_t)
+            + _rowPop.size() * sizeof(int32_t);
+    }
+
+    //! Adds a pattern (binarised) to the network.
+    void addPattern(const FpVector& input_pattern);
+
+    //! Adds the (binarised) columns of a [N x M] matrix as M patterns.
+    void addPatterns(const Eigen::Ref<const Eigen::MatrixXd>& patterns);
+
+    //! Recalls a pattern from a key; the output holds +1/-1 values.
+    void recall(const FpVector& input_pattern, FpVector& output_pattern);
+
+    //! Recalls the columns of a [N x B] matrix of keys.
+    Eigen::MatrixXd recall(const Eigen::Ref<const Eigen::MatrixXd>& keys);
+
+    void setRecallMode(RecallMode mode) noexcept { _mode = mode; }
+    RecallMode getRecallMode() const noexcept { return _mode; }
+
+    //! Caps the steps (sweeps in Blocked mode) of a Synchronous or Blocked
+    //! recall (>= 1). Default: 100.
+    void setMaxIterations(size_t maxIterations);
+    size_t getMaxIterations() const noexcept { return _maxIterations; }
+
+    size_t getLastIterations() const noexcept { return _lastIterations; }
+    bool lastRecallConverged() const noexcept { return _lastConverged; }
+
+    //! Weight W_ij as an integer.
+    int weight(size_t i, size_t j) const noexcept;
+
+    //! Loads a network from the HopfieldNN text format.
+    std::stringstream& load(std::stringstream& ss);
+
+    //! Saves the network in the HopfieldNN text format.
+    std::stringstream& save(std::stringstream& ss) const;
+
+    void clear() noexcept;
+
+private:
+    static constexpr std::string_view ID_ANN = "HopfieldNN";
+    static constexpr std::string_view ID_WEIGHTS = "Weights";
+    static constexpr std::string_view ID_NEURON_ST = "NeuronStates";
+
+    void _resize(size_t inputSize, unsigned weightBits);
+
+    int _maxWeight() const noexcept { return (1 << (_bits - 1)) - 1; }
+
+    const uint64_t* _row(size_t i) const noexcept { return &_planes[i * _bits * _words]; }
+
+    void _unpackRow(size_t i, int32_t* w) const noexcept;
+    void _packRow(size_t i, const int32_t* w) noexcept;
+
+    void _pack(const double* x, uint64_t* s) const noexcept;
+    void _unpack(const uint64_t* s, double* x) const noexcept;
+
+    int64_t _field(size_t i, const uint64_t* s) const noexcept;
+
+    void _run(uint64_t* s);
+    void _recallAsynchronous(uint64_t* s);
+    void _recallSynchronous(uint64_t* s);
+    void _recallBlocked(uint64_t* s);
+
+    size_t _n = 0;
+    size_t _words = 0;
+    unsigned _bits = 8;
+
+    // Row i, plane b occupies _words words at (i * _bits + b) * _words.
+    // Plane b carries bit b of the two's-complement weights.
+    std::vector<uint64_t> _planes;
+    std::vector<int32_t> _rowPop; // popcount of each row plane
+    std::vector<uint64_t> _s;     // packed neuron states
+    size_t _patternSize = 0;
+
+    RecallMode _mode = RecallMode::Asynchronous;
+    size_t _maxIterations = 100;
+    size_t _lastIterations = 0;
+    bool _lastConverged = true;
+
+    std::mt19937 _rndgen;
+};
+
+inline std::stringstream& operator>>(std::stringstream& ss, BinaryHopfieldNN& net)
+{
+    return net.load(ss);
+}
+
+inline std::stringstream& operator<<(std::stringstream& ss, const BinaryHopfieldNN& net)
+{
+    return net.save(ss);
+}
+
+} // namespace nu
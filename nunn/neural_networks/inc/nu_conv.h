@@ -5,9 +5,11 @@
 // Licensed under the MIT License.
 // See COPYING file in the project root for full license information.
 //
-// 1D convolutional and max-pooling layers for building ConvNet pipelines.
-// Vectors use channel-major flat layout: all values of channel 0 first,
-// then channel 1, etc.
+// 1D and 2D convolutional and max-pooling layers for building ConvNet
+// pipelines. Vectors use channel-major flat layout: all values of channel 0
+// first, then channel 1, etc.; 2D maps are row-major within a channel (CHW).
+// Batched entry points take one sample per column ([sampleSize × N],
+// column-major), matching the MlpMatrixNN::trainBatch convention.
 //
 
 #pragma once
@@ -21,24 +23,47 @@
 
 namespace nu {
 
+// Row-major matrix used for patch (im2col) buffers, so that every patch row
+// and every output channel row is a contiguous run of doubles.
+using ConvRowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Lowering strategy for Conv1DLayer.
+enum class ConvAlgorithm {
+    Auto, // Direct for small inCh*K, Im2Col otherwise
+    Im2Col, // patch matrix + one GEMM per call (batched over all samples)
+    Direct, // per-tap AXPY over contiguous input rows; no patch buffer
+};
+
 // ── Abstract base layer ───────────────────────────────────────────────────────
 
-class IConvLayer1D {
+class IConvLayer {
 public:
-    virtual ~IConvLayer1D() = default;
+    virtual ~IConvLayer() = default;
 
     // Forward pass; returns reference to internal output buffer.
     virtual const std::vector<double>& forward(const std::vector<double>& in) = 0;
 
     // Backward pass; lr is used only by layers that have trainable parameters.
-    // Returns the gradient w.r.t. the layer input (grad_in).
-    virtual std::vector<double> backward(const std::vector<double>& gradOut, double lr) = 0;
+    // Returns reference to the internal gradient w.r.t. the layer input (grad_in).
+    virtual const std::vector<double>& backward(const std::vector<double>& gradOut, double lr)
+        = 0;
+
+    // Batched forward over one sample per column: [inputSize × N] → [outputSize × N].
+    virtual const Eigen::MatrixXd& forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in) = 0;
+
+    // Batched backward for the last forwardBatch(); parameter gradients are
+    // averaged over the N samples. Returns grad_in [inputSize × N].
+    virtual const Eigen::MatrixXd& backwardBatch(const Eigen::MatrixXd& gradOut, double lr) = 0;
 
     virtual size_t outChannels() const noexcept = 0;
+
+    // Spatial size of one output channel (outHeight * outWidth for 2D layers).
     virtual size_t outLength() const noexcept = 0;
     size_t outputSize() const noexcept { return outChannels() * outLength(); }
 };
 
+using IConvLayer1D = IConvLayer;
+
 // ── Conv1DLayer ───────────────────────────────────────────────────────────────
 //
 // 1D convolution with valid padding and stride 1.
@@ -47,31 +72,72 @@ public:
 //   outLength = inLength - kernelSize + 1
 //
 // Activation applied element-wise after the convolution.
+//
+// Im2Col lowers a batch of N samples to a single GEMM
+//   Y [outCh × N*outLen] = W [outCh × inCh*K] * Xcol [inCh*K × N*outLen]
+// and scatters the input gradient back with col2im. Direct skips the patch
+// buffer and accumulates one AXPY per (outCh, inCh, k) tap, which is cheaper
+// when inCh*K is too small for the GEMM to amortise the im2col copy.
+// Batches are processed in cache-sized blocks of samples. All work buffers
+// are members and are reused across calls of the same N.
 
-class Conv1DLayer : public IConvLayer1D {
+class Conv1DLayer : public IConvLayer {
 public:
+    // Auto selects Direct when inCh*K <= DIRECT_MAX_TAPS.
+    static constexpr size_t DIRECT_MAX_TAPS = 8;
+
     Conv1DLayer(size_t inChannels, size_t inLength, size_t outChannels, size_t kernelSize,
-        Activation act = Activation::ReLU, double lr = 0.01);
+        Activation act = Activation::ReLU, double lr = 0.01,
+        ConvAlgorithm algo = ConvAlgorithm::Auto);
 
     const std::vector<double>& forward(const std::vector<double>& in) override;
-    std::vector<double> backward(const std::vector<double>& gradOut, double lr) override;
+    const std::vector<double>& backward(const std::vector<double>& gradOut, double lr) override;
+
+    // in [inCh*inLen × N] → [outCh*outLen × N]
+    const Eigen::MatrixXd& forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in) override;
+    const Eigen::MatrixXd& backwardBatch(const Eigen::MatrixXd& gradOut, double lr) override;
 
     size_t outChannels() const noexcept override { return _outCh; }
     size_t outLength() const noexcept override { return _outLen; }
 
+    // Resolved algorithm (never Auto). setAlgorithm() takes effect on the next forward.
+    ConvAlgorithm getAlgorithm() const noexcept { return _algo; }
+    void setAlgorithm(ConvAlgorithm algo) noexcept;
+
+    const Eigen::MatrixXd& getWeights() const noexcept { return _W; }
+    const Eigen::VectorXd& getBias() const noexcept { return _b; }
+    void setWeights(const Eigen::MatrixXd& W);
+    void setBias(const Eigen::VectorXd& b);
+
     void reshuffleWeights();
 
 private:
     size_t _inCh, _inLen, _outCh, _K, _outLen;
     Activation _act;
     double _lr;
+    ConvAlgorithm _algo;
 
     Eigen::MatrixXd _W; // [outCh × inCh*K]
     Eigen::VectorXd _b; // [outCh]
-    Eigen::MatrixXd _Xcol; // [inCh*K × outLen] — saved in forward for backward
-    Eigen::MatrixXd _Yact; // [outCh × outLen]  — activation output, for backward
+    Eigen::MatrixXd _dW; // [outCh × inCh*K]  — weight gradient
+
+    // Work buffers, sized on first use for a given batch size N.
+    Eigen::Index _N = 0; // batch size of the last forward
+    Eigen::MatrixXd _Xin; // [inCh*inLen × N]     — input of the last forward
+    ConvRowMatrix _Xcol; // [inCh*K × nb*outLen] — im2col patches of one block (Im2Col)
+    ConvRowMatrix _Yact; // [outCh × N*outLen]   — activation output, for backward
+    ConvRowMatrix _dY; // [outCh × N*outLen]   — pre-activation gradient
+    ConvRowMatrix _dXcol; // [inCh*K × nb*outLen] — patch gradient of one block (Im2Col)
+    Eigen::MatrixXd _outBatch; // [outCh*outLen × N]
+    Eigen::MatrixXd _gradInBatch; // [inCh*inLen × N]
 
     std::vector<double> _out; // flat output [outCh * outLen]
+    std::vector<double> _gradIn; // flat grad_in [inCh * inLen]
+
+    Eigen::Index _blockSamples() const noexcept;
+    void _im2col(Eigen::Index n0, Eigen::Index n1);
+    void _forward();
+    void _backward(const double* gradOut, double* gradIn, Eigen::Index N, double lr);
 };
 
 // ── MaxPool1DLayer ────────────────────────────────────────────────────────────
@@ -81,12 +147,15 @@ private:
 //   output layout: [channels × outLength]
 //   outLength = inLength / poolSize  (integer floor; remainder is discarded)
 
-class MaxPool1DLayer : public IConvLayer1D {
+class MaxPool1DLayer : public IConvLayer {
 public:
     MaxPool1DLayer(size_t channels, size_t inLength, size_t poolSize);
 
     const std::vector<double>& forward(const std::vector<double>& in) override;
-    std::vector<double> backward(const std::vector<double>& gradOut, double lr) override;
+    const std::vector<double>& backward(const std::vector<double>& gradOut, double lr) override;
+
+    const Eigen::MatrixXd& forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in) override;
+    const Eigen::MatrixXd& backwardBatch(const Eigen::MatrixXd& gradOut, double lr) override;
 
     size_t outChannels() const noexcept override { return _ch; }
     size_t outLength() const noexcept override { return _outLen; }
@@ -95,6 +164,110 @@ private:
     size_t _ch, _inLen, _P, _outLen;
     std::vector<size_t> _maxIdx; // index of selected max per output cell
     std::vector<double> _out; // flat output [ch * outLen]
+    std::vector<double> _gradIn; // flat grad_in [ch * inLen]
+
+    Eigen::Matrix<Eigen::Index, Eigen::Dynamic, Eigen::Dynamic> _maxIdxBatch; // [ch*outLen × N]
+    Eigen::MatrixXd _outBatch; // [ch*outLen × N]
+    Eigen::MatrixXd _gradInBatch; // [ch*inLen × N]
+};
+
+// ── Conv2DLayer ───────────────────────────────────────────────────────────────
+//
+// 2D convolution with valid padding and stride 1.
+//   input  layout: [inChannels × inHeight × inWidth]   (flat, CHW)
+//   output layout: [outChannels × outHeight × outWidth]
+//   outHeight = inHeight - kernelHeight + 1, outWidth = inWidth - kernelWidth + 1
+//
+// A batch of N samples (one per column, i.e. NCHW in memory) is lowered to
+//   Y [outCh × N*outH*outW] = W [outCh × inCh*kH*kW] * Xcol [inCh*kH*kW × N*outH*outW]
+// in cache-sized blocks of samples, like Conv1DLayer's Im2Col path.
+
+class Conv2DLayer : public IConvLayer {
+public:
+    Conv2DLayer(size_t inChannels, size_t inHeight, size_t inWidth, size_t outChannels,
+        size_t kernelHeight, size_t kernelWidth, Activation act = Activation::ReLU,
+        double lr = 0.01);
+
+    const std::vector<double>& forward(const std::vector<double>& in) override;
+    const std::vector<double>& backward(const std::vector<double>& gradOut, double lr) override;
+
+    // in [inCh*inH*inW × N] → [outCh*outH*outW × N]
+    const Eigen::MatrixXd& forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in) override;
+    const Eigen::MatrixXd& backwardBatch(const Eigen::MatrixXd& gradOut, double lr) override;
+
+    size_t outChannels() const noexcept override { return _outCh; }
+    size_t outLength() const noexcept override { return _outH * _outW; }
+    size_t outHeight() const noexcept { return _outH; }
+    size_t outWidth() const noexcept { return _outW; }
+
+    // Weight column ci*kH*kW + i*kW + j holds tap (i, j) of input channel ci.
+    const Eigen::MatrixXd& getWeights() const noexcept { return _W; }
+    const Eigen::VectorXd& getBias() const noexcept { return _b; }
+    void setWeights(const Eigen::MatrixXd& W);
+    void setBias(const Eigen::VectorXd& b);
+
+    void reshuffleWeights();
+
+private:
+    size_t _inCh, _inH, _inW, _outCh, _kH, _kW, _outH, _outW;
+    Activation _act;
+    double _lr;
+
+    Eigen::MatrixXd _W; // [outCh × inCh*kH*kW]
+    Eigen::VectorXd _b; // [outCh]
+    Eigen::MatrixXd _dW; // [outCh × inCh*kH*kW]
+
+    Eigen::Index _N = 0; // batch size of the last forward
+    Eigen::MatrixXd _Xin; // [inCh*inH*inW × N]
+    ConvRowMatrix _Xcol; // [inCh*kH*kW × nb*outH*outW] — patches of one block
+    ConvRowMatrix _Yact; // [outCh × N*outH*outW]
+    ConvRowMatrix _dY; // [outCh × N*outH*outW]
+    ConvRowMatrix _dXcol; // [inCh*kH*kW × nb*outH*outW]
+    Eigen::MatrixXd _outBatch; // [outCh*outH*outW × N]
+    Eigen::MatrixXd _gradInBatch; // [inCh*inH*inW × N]
+
+    std::vector<double> _out;
+    std::vector<double> _gradIn;
+
+    Eigen::Index _blockSamples() const noexcept;
+    void _im2col(Eigen::Index n0, Eigen::Index n1);
+    void _forward();
+    void _backward(const double* gradOut, double* gradIn, Eigen::Index N, double lr);
+};
+
+// ── MaxPool2DLayer ────────────────────────────────────────────────────────────
+//
+// Non-overlapping 2D max pooling over poolHeight × poolWidth windows.
+//   input  layout: [channels × inHeight × inWidth]   (flat, CHW)
+//   output layout: [channels × outHeight × outWidth]
+//   outHeight = inHeight / poolHeight, outWidth = inWidth / poolWidth
+//   (integer floor; the remainder rows/columns are discarded)
+
+class MaxPool2DLayer : public IConvLayer {
+public:
+    MaxPool2DLayer(
+        size_t channels, size_t inHeight, size_t inWidth, size_t poolHeight, size_t poolWidth);
+
+    const std::vector<double>& forward(const std::vector<double>& in) override;
+    const std::vector<double>& backward(const std::vector<double>& gradOut, double lr) override;
+
+    const Eigen::MatrixXd& forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in) override;
+    const Eigen::MatrixXd& backwardBatch(const Eigen::MatrixXd& gradOut, double lr) override;
+
+    size_t outChannels() const noexcept override { return _ch; }
+    size_t outLength() const noexcept override { return _outH * _outW; }
+    size_t outHeight() const noexcept { return _outH; }
+    size_t outWidth() const noexcept { return _outW; }
+
+private:
+    size_t _ch, _inH, _inW, _pH, _pW, _outH, _outW;
+
+    Eigen::Matrix<Eigen::Index, Eigen::Dynamic, Eigen::Dynamic> _maxIdx; // [ch*outH*outW × N]
+    Eigen::MatrixXd _outBatch; // [ch*outH*outW × N]
+    Eigen::MatrixXd _gradInBatch; // [ch*inH*inW × N]
+
+    std::vector<double> _out;
+    std::vector<double> _gradIn;
 };
 
 } // namespace nu
@@ -5,7 +5,7 @@
 // Licensed under the MIT License.
 // See COPYING file in the project root for full license information.
 //
-// ConvNet: builder for 1D convolutional networks.
+// ConvNet: builder for 1D and 2D convolutional networks.
 //
 // Usage pattern:
 //   nu::ConvNet cnn(1, 16);                        // 1 channel, 16 time steps
@@ -17,6 +17,15 @@
 //   double loss = cnn.train(input, target);
 //   auto   out  = cnn.predict(input);
 //
+// Mini-batch training and batched inference run every conv/pool layer and
+// the FC head once per batch (one sample per column):
+//   double loss = cnn.trainBatch(inputs, targets);
+//   auto   outs = cnn.predictBatch(inputs);
+//
+// Image inputs use the three-argument constructor and the 2D layers:
+//   nu::ConvNet cnn(1, 28, 28);                     // 1 channel, 28×28 pixels
+//   cnn.addConv2D(8, 5, 5).addMaxPool2D(2, 2);      // → 8 × 12 × 12
+//
 
 #pragma once
 
@@ -34,14 +43,26 @@ public:
     // inLength:   number of time steps (samples) per channel
     ConvNet(size_t inChannels, size_t inLength);
 
+    // 2D input: inChannels maps of inHeight × inWidth (CHW flat layout).
+    ConvNet(size_t inChannels, size_t inHeight, size_t inWidth);
+
     // Append a Conv1DLayer.
     // lr: SGD learning rate for this layer's weights.
+    // Throws std::logic_error if the current feature maps are 2D.
     ConvNet& addConv1D(
         size_t outChannels, size_t kernelSize, Activation act = Activation::ReLU, double lr = 0.01);
 
     // Append a MaxPool1DLayer.
+    // Throws std::logic_error if the current feature maps are 2D.
     ConvNet& addMaxPool1D(size_t poolSize);
 
+    // Append a Conv2DLayer with a kernelHeight × kernelWidth kernel.
+    ConvNet& addConv2D(size_t outChannels, size_t kernelHeight, size_t kernelWidth,
+        Activation act = Activation::ReLU, double lr = 0.01);
+
+    // Append a MaxPool2DLayer with a poolHeight × poolWidth window.
+    ConvNet& addMaxPool2D(size_t poolHeight, size_t poolWidth);
+
     // Set the fully-connected head. Must be called after all conv/pool layers.
     // fcLayers[0].size must equal flatFeatureSize().
     // lr: learning rate for the FC network.
@@ -56,24 +77,49 @@ public:
     // Throws std::logic_error if setFCHead() has not been called.
     double train(const std::vector<double>& input, const std::vector<double>& target);
 
+    // Batched forward; one output vector per input.
+    // Throws std::logic_error if setFCHead() has not been called.
+    std::vector<std::vector<double>> predictBatch(const std::vector<std::vector<double>>& inputs);
+
+    // Matrix form: X [inputSize × B] → [outputSize × B], one sample per column.
+    Eigen::MatrixXd predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X);
+
+    // Mini-batch step: forward + backward over the whole batch, with gradients
+    // averaged over the batch in every layer. Returns the pre-update batch MSE.
+    // Throws std::logic_error if setFCHead() has not been called.
+    // Throws std::invalid_argument on empty or mismatched batch.
+    double trainBatch(const std::vector<std::vector<double>>& inputs,
+        const std::vector<std::vector<double>>& targets);
+
+    // Matrix form: X [inputSize × B], T [outputSize × B], one sample per column.
+    double trainBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X, const Eigen::Ref<const Eigen::MatrixXd>& T);
+
     // Size of the flattened feature vector after all conv/pool layers (= FC input size).
     size_t flatFeatureSize() const noexcept;
 
-    // Size of each input sample (inChannels * inLength).
-    size_t inputSize() const noexcept { return _inCh * _inLen; }
+    // Size of each input sample (inChannels * inHeight * inWidth).
+    size_t inputSize() const noexcept { return _inCh * _inH * _inW; }
 
     // Number of outputs (from FC head).
     size_t outputSize() const noexcept;
 
 private:
-    size_t _inCh, _inLen;
-    size_t _curCh, _curLen; // tracked as layers are appended
+    size_t _inCh, _inH, _inW; // 1D inputs have _inH == 1
+    size_t _curCh, _curH, _curW; // tracked as layers are appended
 
-    std::vector<std::unique_ptr<IConvLayer1D>> _layers;
+    std::vector<std::unique_ptr<IConvLayer>> _layers;
     std::unique_ptr<MlpMatrixNN> _fc;
 
+    Eigen::MatrixXd _fcGrad; // FC input gradient of the last trainBatch [flat × B]
+
     // Run conv/pool forward; returns reference to the last layer's output.
     const std::vector<double>& _forwardConv(const std::vector<double>& input);
+
+    // Batched conv/pool forward; X itself when there are no conv/pool layers.
+    Eigen::Ref<const Eigen::MatrixXd> _forwardConvBatch(const Eigen::Ref<const Eigen::MatrixXd>& X);
+
+    static Eigen::MatrixXd _toColumns(const std::vector<std::vector<double>>& v, size_t rows);
 };
 
 } // namespace nu
@@ -15,6 +15,24 @@
  * memory systems with binary threshold nodes. They are guaranteed to converge
  * to a local minimum, but convergence to one of the stored patterns is not
  * guaranteed.
+ *
+ * Recall modes:
+ *  - Asynchronous: one randomly chosen neuron is updated at a time until no
+ *    neuron has changed for 10 * N consecutive updates (the classic scheme).
+ *  - Synchronous: all neurons are updated at once, s <- sgn(W s), one
+ *    matrix-vector product per step. The iteration stops at a fixed point or
+ *    when the state repeats the one two steps back (synchronous dynamics
+ *    with symmetric weights settle into cycles of length at most two).
+ *  - Blocked: neurons are swept in contiguous blocks of getBlockSize(), each
+ *    block updated at once from the current state, s_b <- sgn(W_b s); the
+ *    iteration stops after a sweep that changes nothing.
+ * A zero local field leaves the neuron unchanged in the Synchronous and
+ * Blocked modes. All modes stop after getMaxIterations() steps (sweeps).
+ *
+ * Batched use: addPatterns(P) stores the columns of P [N x M] with a single
+ * rank-M update W += P P^T; recall(K) recalls the columns of K [N x B] with
+ * one matrix-matrix product per step, dropping queries from the product as
+ * soon as they have converged.
  */
 
 #pragma once
@@ -22,6 +40,7 @@
 #include "nu_stepf.h"
 #include "nu_vector.h"
 
+#include <Eigen/Core>
 #include <list>
 #include <random>
 #include <stdexcept>
@@ -43,6 +62,8 @@ class HopfieldNN {
 public:
     using FpVector = Vector;
 
+    enum class RecallMode { Asynchronous, Synchronous, Blocked };
+
     class SizeMismatchException : public std::runtime_error {
     public:
         SizeMismatchException()
@@ -88,9 +109,47 @@ public:
     //! Adds a specified pattern to the network.
     void addPattern(const FpVector& input_pattern);
 
+    /**
+     * @brief Adds the columns of a [N x M] matrix as M patterns.
+     *
+     * Equivalent to M calls to addPattern(), performed as one symmetric
+     * rank-M update of the weight matrix.
+     */
+    void addPatterns(const Eigen::Ref<const Eigen::MatrixXd>& patterns);
+
     //! Attempts to recall a pattern using a given input pattern.
     void recall(const FpVector& input_pattern, FpVector& output_pattern);
 
+    /**
+     * @brief Recalls the columns of a [N x B] matrix of keys.
+     *
+     * Uses the Synchronous or Blocked dynamics with matrix-matrix products;
+     * in Asynchronous mode the keys are recalled one by one.
+     * @return The [N x B] matrix of recalled patterns.
+     */
+    Eigen::MatrixXd recall(const Eigen::Ref<const Eigen::MatrixXd>& keys);
+
+    //! Selects the update scheme used by recall(). Default: Asynchronous.
+    void setRecallMode(RecallMode mode) noexcept { _mode = mode; }
+    RecallMode getRecallMode() const noexcept { return _mode; }
+
+    //! Sets the number of neurons updated together in Blocked mode (>= 1).
+    void setBlockSize(size_t blockSize);
+    size_t getBlockSize() const noexcept { return _blockSize; }
+
+    //! Caps the steps (sweeps in Blocked mode) of a Synchronous or Blocked
+    //! recall (>= 1). Default: 100.
+    void setMaxIterations(size_t maxIterations);
+    size_t getMaxIterations() const noexcept { return _maxIterations; }
+
+    //! Steps taken by the last Synchronous or Blocked recall (the maximum
+    //! over the keys of a batch).
+    size_t getLastIterations() const noexcept { return _lastIterations; }
+
+    //! True if every key of the last Synchronous or Blocked recall reached a
+    //! fixed point (false if any ended in a two-cycle or hit the cap).
+    bool lastRecallConverged() const noexcept { return _lastConverged; }
+
     //! Loads network configuration from a stringstream.
     HopfieldNN(std::stringstream& ss) { load(ss); }
 
@@ -130,13 +189,26 @@ private:
 
     StepFunction step_f = StepFunction(0, -1, 1);
 
+    using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    Eigen::Map<RowMatrix> _weights() noexcept;
+
     void _propagate() noexcept;
     bool _propagateNeuron(size_t i) noexcept;
 
+    void _recallSynchronous(Eigen::Ref<Eigen::MatrixXd> S);
+    void _recallBlocked(Eigen::Ref<Eigen::MatrixXd> S);
+
     FpVector _s; // Neuron states
     FpVector _w; // Weights matrix
     size_t _patternSize = 0;
 
+    RecallMode _mode = RecallMode::Asynchronous;
+    size_t _blockSize = 64;
+    size_t _maxIterations = 100;
+    size_t _lastIterations = 0;
+    bool _lastConverged = true;
+
     std::mt19937 _rndgen;
 };
 
@@ -5,27 +5,54 @@
 // Licensed under the MIT License.
 // See COPYING file in the project root for full license information.
 //
-// k-Means clustering (Lloyd's algorithm with k-means++ initialisation).
+// k-Means clustering (Lloyd iterations with k-means++ / k-means|| seeding).
 //
 // Algorithm:
-//   1. k-means++ seed selection: choose first centroid uniformly at random;
-//      each subsequent centroid is chosen with probability proportional to
+//   1. Seeding. k-means++: choose first centroid uniformly at random; each
+//      subsequent centroid is chosen with probability proportional to
 //      D(x)^2 = squared distance to the nearest already-chosen centroid.
+//      k-means|| (large N): a few rounds that each oversample ~2k candidates
+//      in parallel with the same D(x)^2 weighting, then weighted k-means++
+//      over the candidates.
 //   2. E-step: assign each sample to its nearest centroid.
 //   3. M-step: recompute centroids as cluster means.
 //   4. Repeat until max centroid shift < tol or maxIter reached.
 //      Empty clusters keep their previous centroid (stable behaviour).
 //
-// Complexity per iteration: O(N * k * d)
+// The E-step is exact for every algorithm; they differ only in how many
+// distances they evaluate:
+//   Lloyd   — all N*k per iteration, as blocked GEMMs (|x|^2 - 2 x.c + |c|^2)
+//   Hamerly — one upper and one lower bound per sample, O(N) extra memory
+//   Elkan   — one upper and k lower bounds per sample, O(N*k) extra memory
+// The bounds are maintained with the triangle inequality as centroids move,
+// so samples whose assignment provably cannot change are skipped.
+// Assignment and the centroid reduction run on setThreads() workers.
+//
+// Data is held as a contiguous row-major [N × d] matrix (one sample per row);
+// the std::vector overloads copy into one.
+//
+// Mini-batch / streaming mode (Sculley, "Web-scale k-means clustering"):
+// each batch is assigned to the current centroids, and centroid c moves to
+//   (v_c * c + Σ batch members) / (v_c + n_c),   v_c += n_c
+// where v_c counts the samples c has absorbed so far. partialFit() feeds one
+// chunk at a time and never holds more than the current chunk plus a seeding
+// buffer of initSize rows; setDecay() ages v_c so old data is forgotten and
+// the step size stays bounded away from zero on drifting streams.
 //
 // Usage:
 //   KMeans km(3);
 //   km.fit(X);
 //   auto labels = km.predict(X);
 //   double wsse  = km.inertia(X);
+//
+//   KMeans stream(3);
+//   while (readChunk(chunk))
+//       stream.partialFit(chunk);
 
 #pragma once
 
+#include <Eigen/Core>
+#include <initializer_list>
 #include <random>
 #include <stdexcept>
 #include <vector>
@@ -34,6 +61,24 @@ namespace nu {
 
 class KMeans {
 public:
+    // Row-major [N × d] sample matrix, one sample per row.
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    enum class Algorithm {
+        Auto, // Elkan when d >= 64 and N*k <= 2^24 bounds, Hamerly otherwise
+        Lloyd,
+        Hamerly,
+        Elkan,
+    };
+
+    enum class Init {
+        Auto, // k-means|| when N >= PARALLEL_INIT_MIN_SAMPLES, k-means++ otherwise
+        PlusPlus,
+        Parallel, // k-means||
+    };
+
+    static constexpr size_t PARALLEL_INIT_MIN_SAMPLES = 100000;
+
     struct NotFittedException : std::runtime_error {
         NotFittedException()
             : std::runtime_error("KMeans: call fit() before predict()")
@@ -54,46 +99,131 @@ public:
     // seed     — RNG seed for k-means++ initialisation
     explicit KMeans(size_t k, size_t maxIter = 300, double tol = 1e-4, unsigned seed = 42) noexcept;
 
-    // Fit the model to X using k-means++ seeding.
+    // Fit the model to X (see setInit() for the seeding).
     // Throws SizeMismatchException if X is empty, any sample is empty,
     // sample sizes are inconsistent, or k > N.
     void fit(const std::vector<std::vector<double>>& X);
 
+    // Matrix form: X [N × d], one sample per row; X is not copied.
+    void fit(const Eigen::Ref<const Matrix>& X);
+
+    // Mini-batch k-means over an in-memory X: seeds on a random subsample,
+    // then updates from random batches of batchSize rows. Stops when the
+    // exponentially weighted batch inertia has not improved for 10 batches,
+    // when the largest centroid shift stays below tol for 10 batches, or
+    // after maxIter passes over the data. numIterations() counts batches.
+    // Throws SizeMismatchException like fit().
+    void fitMiniBatch(const Eigen::Ref<const Matrix>& X, size_t batchSize = 1024);
+
+    // One streaming update. Until the model is fitted, rows are buffered and
+    // the centroids are seeded with k-means++ once initSize rows have arrived
+    // (the buffered rows then form the first batch). After fit() or
+    // fitMiniBatch() the update continues from the fitted centroids.
+    // Throws SizeMismatchException if the row size differs from earlier data.
+    void partialFit(const Eigen::Ref<const Matrix>& batch);
+    void partialFit(const std::vector<std::vector<double>>& batch);
+
+    // Forget any fitted state or buffered rows.
+    void reset() noexcept;
+
     // Index of the nearest centroid for a single sample.
     // Throws NotFittedException / SizeMismatchException.
     size_t predict(const std::vector<double>& x) const;
 
+    // Brace-initialised single sample, e.g. predict({ 1.0, 2.0 }).
+    size_t predict(std::initializer_list<double> x) const
+    {
+        return predict(std::vector<double>(x));
+    }
+
     // Batch predict.
     std::vector<size_t> predict(const std::vector<std::vector<double>>& X) const;
+    std::vector<size_t> predict(const Eigen::Ref<const Matrix>& X) const;
 
     // Within-cluster sum of squared distances to centroids (WCSS / inertia).
     // Throws NotFittedException.
     double inertia(const std::vector<std::vector<double>>& X) const;
+    double inertia(const Eigen::Ref<const Matrix>& X) const;
 
     // Learned centroids — valid only after fit().
     // Throws NotFittedException.
     const std::vector<std::vector<double>>& centroids() const;
 
+    // Centroids as a row-major [k × d] matrix.
+    // Throws NotFittedException.
+    const Matrix& centroidMatrix() const;
+
+    // Algorithm / seeding / worker count used by the next fit().
+    // threads = 0 uses std::thread::hardware_concurrency(); small inputs run
+    // on fewer threads. Results are independent of the thread count up to
+    // floating-point summation order in the centroid means.
+    void setAlgorithm(Algorithm algo) noexcept { _algo = algo; }
+    void setInit(Init init) noexcept { _init = init; }
+    void setThreads(size_t threads) noexcept { _threads = threads; }
+    Algorithm algorithm() const noexcept { return _algo; }
+    Init init() const noexcept { return _init; }
+    size_t threads() const noexcept { return _threads; }
+
+    // Streaming options. decay in (0, 1] multiplies every v_c before each
+    // batch (1 = plain running mean); initSize = 0 means 3k rows.
+    // setDecay() throws std::invalid_argument outside (0, 1].
+    void setDecay(double decay);
+    void setInitSize(size_t rows) noexcept { _initSize = rows; }
+    double decay() const noexcept { return _decay; }
+    size_t initSize() const noexcept { return _initSize ? _initSize : 3 * _k; }
+
+    // Samples absorbed per centroid (v_c): cluster sizes after fit(), decayed
+    // running counts after partialFit().
+    const std::vector<double>& clusterCounts() const noexcept { return _counts; }
+
     bool isFitted() const noexcept { return _fitted; }
     size_t k() const noexcept { return _k; }
     size_t maxIterations() const noexcept { return _maxIter; }
     double tolerance() const noexcept { return _tol; }
     size_t numIterations() const noexcept { return _nIter; }
 
+    // Sample-to-centroid distances evaluated by the E-steps of the last fit().
+    size_t distanceEvaluations() const noexcept { return _nDist; }
+
 private:
     size_t _k;
     size_t _maxIter;
     double _tol;
     unsigned _seed;
+    Algorithm _algo = Algorithm::Auto;
+    Init _init = Init::Auto;
+    size_t _threads = 0;
 
-    std::vector<std::vector<double>> _centroids;
+    Matrix _C; // [k × d]
+    std::vector<std::vector<double>> _centroids; // copy of _C for centroids()
     bool _fitted = false;
     size_t _nIter = 0;
+    size_t _nDist = 0;
+
+    std::vector<double> _counts; // v_c
+    double _decay = 1.0;
+    size_t _initSize = 0;
+    Matrix _pending; // rows buffered by partialFit() before seeding
+
+    Algorithm _resolveAlgorithm(size_t N, size_t D) const noexcept;
+    size_t _workers(size_t N) const noexcept;
+
+    void _initPlusPlus(const Eigen::Ref<const Matrix>& X, std::mt19937& rng);
+    void _initParallel(const Eigen::Ref<const Matrix>& X, std::mt19937& rng);
+
+    void _fitLloyd(const Eigen::Ref<const Matrix>& X);
+    void _fitHamerly(const Eigen::Ref<const Matrix>& X);
+    void _fitElkan(const Eigen::Ref<const Matrix>& X);
+
+    // M-step over the given labels; returns per-centroid shifts in `shift`.
+    void _updateCentroids(const Eigen::Ref<const Matrix>& X, const std::vector<size_t>& labels,
+        Eigen::VectorXd& shift);
+    void _syncCentroids();
 
-    void _initPlusPlus(const std::vector<std::vector<double>>& X, std::mt19937& rng);
-    static double _sqDist(const std::vector<double>& a, const std::vector<double>& b) noexcept;
-    static size_t _nearest(
-        const std::vector<double>& x, const std::vector<std::vector<double>>& cents) noexcept;
+    // Mini-batch update with one batch; returns the largest centroid shift.
+    // batchInertia, if given, receives the batch's squared distances before the update.
+    double _miniBatchStep(const Eigen::Ref<const Matrix>& batch, double* batchInertia = nullptr);
+    void _checkFitInput(const Eigen::Ref<const Matrix>& X) const;
 };
 
 } // namespace nu
@@ -7,12 +7,22 @@
 //
 // Linear Regression model.
 //
-// Supports two training methods:
-//   OLS            — closed-form Ordinary Least Squares via QR decomposition.
-//                    Exact solution in one pass; requires the system to be
-//                    well-conditioned.
+// Supports four training methods:
+//   OLS             — closed-form Ordinary Least Squares via QR decomposition.
+//                     Exact solution in one pass; requires the system to be
+//                     well-conditioned.
 //   GradientDescent — iterative MSE minimisation; connects directly to the
-//                    backpropagation framework used by MLP networks.
+//                     backpropagation framework used by MLP networks.
+//   NormalEquations — Cholesky solve of the centred normal equations built from
+//                     streaming sufficient statistics (see Accumulator):
+//                     O(N*D^2) time, O(D^2) memory, one pass over the data.
+//   MiniBatchSGD    — shuffled mini-batch gradient descent; maxIterations()
+//                     counts epochs, setBatchSize() sets the batch.
+//
+// All methods minimise the same objective
+//   sum_i (w^T x_i + b - y_i)^2 + ridge * |w|^2
+// (setRidge(), default 0; the intercept is never penalised), so they agree
+// on the solution up to convergence.
 //
 // Model: y_hat = w^T x + b
 //
@@ -21,11 +31,21 @@
 //   lr.fit(X_train, y_train);
 //   double pred = lr.predict(x_new);
 //   double r2   = lr.rSquared(X_test, y_test);
+//
+//   // Streaming: one accumulator per thread / shard, merged, then solved.
+//   LinearRegression::Accumulator a(D), b(D);
+//   a.add(chunk0, y0);
+//   b.add(chunk1, y1);
+//   a.merge(b);
+//   LinearRegression lr;
+//   lr.fit(a);
 
 #pragma once
 
+#include <Eigen/Cholesky>
 #include <Eigen/Core>
 #include <Eigen/QR>
+#include <initializer_list>
 #include <stdexcept>
 #include <vector>
 
@@ -33,7 +53,10 @@ namespace nu {
 
 class LinearRegression {
 public:
-    enum class Method { OLS, GradientDescent };
+    enum class Method { OLS, GradientDescent, NormalEquations, MiniBatchSGD };
+
+    // Row-major [N × D] sample matrix, one sample per row.
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
     struct NotFittedException : std::runtime_error {
         NotFittedException()
@@ -49,10 +72,43 @@ public:
         }
     };
 
-    // method       — OLS (default) or GradientDescent
-    // learningRate — step size for GradientDescent (ignored for OLS)
-    // maxIter      — maximum epochs for GradientDescent (ignored for OLS)
-    // tolerance    — stop GradientDescent when weight change < tol
+    // Least-squares sufficient statistics: sample count, feature / target
+    // means and the centred cross-products Sxx = sum (x - mx)(x - mx)^T,
+    // Sxy = sum (x - mx)(y - my). Chunks and accumulators combine with
+    // Chan's pairwise update, so the result does not depend on how rows were
+    // split and large offsets do not cancel. Memory is O(D^2).
+    class Accumulator {
+    public:
+        explicit Accumulator(size_t nFeatures = 0);
+
+        // Add a chunk X [n × D], y [n]. The first chunk fixes D when the
+        // accumulator was built with nFeatures = 0.
+        // Throws SizeMismatchException on inconsistent shapes.
+        void add(const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y);
+
+        // Fold in another accumulator (e.g. from another thread).
+        void merge(const Accumulator& other);
+
+        void reset() noexcept;
+
+        size_t count() const noexcept { return _n; }
+        size_t nFeatures() const noexcept { return size_t(_meanX.size()); }
+
+    private:
+        friend class LinearRegression;
+
+        size_t _n = 0;
+        Eigen::VectorXd _meanX; // [D]
+        double _meanY = 0.0;
+        Eigen::MatrixXd _sxx; // [D × D], lower triangle maintained
+        Eigen::VectorXd _sxy; // [D]
+    };
+
+    // method       — OLS (default), GradientDescent, NormalEquations or MiniBatchSGD
+    // learningRate — step size for the gradient methods
+    // maxIter      — maximum epochs for the gradient methods
+    // tolerance    — stop a gradient method when the weight change over an
+    //                epoch is < tol
     explicit LinearRegression(Method method = Method::OLS, double learningRate = 0.01,
         size_t maxIter = 10000, double tolerance = 1e-9) noexcept;
 
@@ -61,14 +117,42 @@ public:
     // Throws SizeMismatchException if dimensions are inconsistent.
     void fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y);
 
+    // Matrix form: X [N × F] row-major, no copy for NormalEquations / MiniBatchSGD.
+    // NormalEquations accumulates row blocks on setThreads() workers.
+    void fit(const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y);
+
+    // Solve the normal equations from accumulated statistics (any method).
+    // Throws SizeMismatchException if the accumulator is empty.
+    void fit(const Accumulator& stats);
+
+    // Streaming fit: add a chunk to the model's own statistics and re-solve
+    // (O(n*D^2 + D^3) per call). A NormalEquations fit() or fit(Accumulator)
+    // seeds the statistics, so partialFit() continues from that data; the
+    // other methods keep none, and partialFit() after them starts afresh.
+    void partialFit(const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y);
+
+    // Statistics behind the current normal-equations solution: those of the
+    // last NormalEquations fit() or fit(Accumulator) plus every partialFit()
+    // chunk since. Empty after a fit() with any other method.
+    const Accumulator& statistics() const noexcept { return _stats; }
+
     // Predict for a single sample.
     // Throws NotFittedException if called before fit().
     // Throws SizeMismatchException if x.size() != inputSize().
     double predict(const std::vector<double>& x) const;
 
+    // Brace-initialised single sample, e.g. predict({ 1.5 }).
+    double predict(std::initializer_list<double> x) const
+    {
+        return predict(std::vector<double>(x));
+    }
+
     // Predict for a batch of samples.
     std::vector<double> predict(const std::vector<std::vector<double>>& X) const;
 
+    // Matrix form: X [N × F] -> [N] in one GEMV.
+    Eigen::VectorXd predict(const Eigen::Ref<const Matrix>& X) const;
+
     // Mean Squared Error on (X, y).
     double mse(const std::vector<std::vector<double>>& X, const std::vector<double>& y) const;
 
@@ -89,15 +173,33 @@ public:
     size_t maxIterations() const noexcept { return _maxIter; }
     double tolerance() const noexcept { return _tol; }
 
+    double ridge() const noexcept { return _ridge; }
+    size_t batchSize() const noexcept { return _batchSize; }
+
     void setLearningRate(double lr) noexcept { _lr = lr; }
     void setMaxIterations(size_t n) noexcept { _maxIter = n; }
     void setTolerance(double tol) noexcept { _tol = tol; }
 
+    // L2 penalty on the weights (>= 0). Throws std::invalid_argument if negative.
+    void setRidge(double lambda);
+    // Mini-batch size for MiniBatchSGD (>= 1, default 32).
+    void setBatchSize(size_t n) noexcept { _batchSize = n ? n : 1; }
+    // Seed of the MiniBatchSGD shuffle.
+    void setSeed(unsigned seed) noexcept { _seed = seed; }
+    // Workers for NormalEquations accumulation (0 = hardware concurrency).
+    void setThreads(size_t threads) noexcept { _threads = threads; }
+
 private:
     Method _method;
     double _lr;
     size_t _maxIter;
     double _tol;
+    double _ridge = 0.0;
+    size_t _batchSize = 32;
+    unsigned _seed = 42;
+    size_t _threads = 0;
+
+    Accumulator _stats; // partialFit() stream
 
     Eigen::VectorXd _w; // [F] feature weights
     double _b = 0.0; // intercept
@@ -107,10 +209,13 @@ private:
     mutable std::vector<double> _coefCache;
     mutable bool _cacheValid = false;
 
-    void _fitOLS(const Eigen::MatrixXd& X, const Eigen::VectorXd& y);
-    void _fitGD(const Eigen::MatrixXd& X, const Eigen::VectorXd& y);
+    void _fitOLS(const Eigen::Ref<const Matrix>& X, const Eigen::VectorXd& y);
+    void _fitGD(const Eigen::Ref<const Matrix>& X, const Eigen::VectorXd& y);
+    void _fitNormal(const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y);
+    void _fitSGD(const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y);
+    void _solve(const Accumulator& stats);
 
-    static Eigen::MatrixXd toEigenMatrix(const std::vector<std::vector<double>>& X);
+    static Matrix toEigenMatrix(const std::vector<std::vector<double>>& X);
     static Eigen::VectorXd toEigenVector(const std::vector<double>& v);
 };
 
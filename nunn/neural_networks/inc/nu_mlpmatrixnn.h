@@ -9,6 +9,8 @@
 // Mirrors the MlpNN public interface; can be used as a drop-in replacement.
 // Weights are stored as dense matrices [out × in] per layer, enabling
 // efficient SIMD on CPU and a clean path to GPU backends (ArrayFire/OpenCL).
+// Every layer's W and b are views into one contiguous parameter buffer, so
+// whole-network copies and blends are single vectorised passes.
 //
 
 #pragma once
@@ -87,6 +89,12 @@ public:
         double momentum = 0.0, CostFunction cf = CostFunction::MSE,
         ComputeBackend backend = ComputeBackend::Eigen);
 
+    // Copies rebind the layer views to the copy's own parameter buffer.
+    MlpMatrixNN(const MlpMatrixNN& other);
+    MlpMatrixNN(MlpMatrixNN&& other) noexcept = default;
+    MlpMatrixNN& operator=(const MlpMatrixNN& other);
+    MlpMatrixNN& operator=(MlpMatrixNN&& other) noexcept = default;
+
     // ── Forward / backward — single sample ───────────────────────────────────
 
     void setInputVector(const std::vector<double>& input);
@@ -94,6 +102,27 @@ public:
     void backPropagate(const std::vector<double>& target);
     void copyOutputVector(std::vector<double>& out) const;
 
+    // ── Forward — batch ───────────────────────────────────────────────────────
+
+    // Batched inference: X [inputSize × B] (one sample per column) → [outputSize × B].
+    // Leaves the single-sample state (getLayerOutput, copyOutputVector) untouched.
+    // Throws std::invalid_argument if X.rows() != getInputSize().
+    [[nodiscard]] Eigen::MatrixXd feedForwardBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Same, evaluated into caller storage: out is resized only when its shape
+    // changes, so a caller looping over equal-sized batches reuses it.
+    void feedForwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& out) const;
+
+    // Batched forward through neuron layers [firstLayer, lastLayer) only:
+    // X [layer firstLayer input size × B] → [layer lastLayer-1 output size × B].
+    // Lets a caller run a contiguous sub-network (e.g. the encoder or decoder
+    // half of an autoencoder) over the same weights.
+    // Throws std::out_of_range on an empty or out-of-bounds range and
+    // std::invalid_argument if X has the wrong number of rows.
+    [[nodiscard]] Eigen::MatrixXd feedForwardBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X, size_t firstLayer, size_t lastLayer) const;
+
     // ── Mini-batch SGD ────────────────────────────────────────────────────────
 
     // Run one mini-batch training step (forward + backward + weight update).
@@ -101,10 +130,17 @@ public:
     // targets[i] — corresponding target of size getOutputSize()
     // Batch must be non-empty and inputs.size() == targets.size().
     // Gradients are averaged over the batch before the weight update.
+    // Returns the batch MSE measured before the update.
     // Throws std::invalid_argument on empty or mismatched batch.
-    void trainBatch(const std::vector<std::vector<double>>& inputs,
+    double trainBatch(const std::vector<std::vector<double>>& inputs,
         const std::vector<std::vector<double>>& targets);
 
+    // Matrix form: X [inputSize × B], T [outputSize × B], one sample per column.
+    // If inputGrad is non-null it receives W[0]^T * delta[0] for every sample
+    // ([inputSize × B], pre-update weights, same convention as getInputGradient()).
+    double trainBatch(const Eigen::Ref<const Eigen::MatrixXd>& X,
+        const Eigen::Ref<const Eigen::MatrixXd>& T, Eigen::MatrixXd* inputGrad = nullptr);
+
     // ── Metrics ───────────────────────────────────────────────────────────────
 
     [[nodiscard]] double calcMSE(const std::vector<double>& target) const;
@@ -134,19 +170,37 @@ public:
     [[nodiscard]] const Eigen::VectorXd& getLayerOutput(size_t layer) const;
     [[nodiscard]] Eigen::MatrixXd getLayerW(size_t layer) const;
     [[nodiscard]] Eigen::VectorXd getLayerB(size_t layer) const;
+    // Throw std::invalid_argument if the shape differs from the layer's.
     void setLayerW(size_t layer, const Eigen::MatrixXd& W);
     void setLayerB(size_t layer, const Eigen::VectorXd& b);
 
+    // ── Parameter buffer ──────────────────────────────────────────────────────
+
+    // Zero-copy view of every weight and bias: for each layer in order, W
+    // (column-major) then b.
+    [[nodiscard]] const Eigen::VectorXd& parameters() const noexcept { return _params; }
+
+    // Copies other's parameters (one block copy). Optimizer state is kept.
+    // Throws std::invalid_argument if other has a different topology.
+    void copyParameters(const MlpMatrixNN& other);
+
+    // Polyak averaging in place: params = tau * other + (1 - tau) * params.
+    // Throws std::invalid_argument if other has a different topology or tau
+    // is not in [0, 1].
+    void blendParameters(const MlpMatrixNN& other, double tau);
+
     void reshuffleWeights();
 
-    // Returns dL/d_input = W[0]^T * delta[0] after backPropagate() (Eigen path only).
+    // Returns W[0]^T * delta[0] after backPropagate() (Eigen path only); with
+    // delta = t - a this is -dL/d_input.
     // Used by ConvNet to propagate gradients back through conv/pool layers.
     [[nodiscard]] Eigen::VectorXd getInputGradient() const;
 
 private:
     struct Layer {
-        Eigen::MatrixXd W; // [out_size × in_size]  weight matrix
-        Eigen::VectorXd b; // [out_size]             bias vector
+        // Views into _params, bound by _bindParams().
+        Eigen::Map<Eigen::MatrixXd> W{ nullptr, 0, 0 }; // [out_size × in_size] weight matrix
+        Eigen::Map<Eigen::VectorXd> b{ nullptr, 0 }; // [out_size]            bias vector
         Eigen::VectorXd a; // [out_size]             activation output (host mirror)
         Eigen::VectorXd delta; // [out_size]             error signal (Eigen path)
         Eigen::MatrixXd dW; // [out_size × in_size]   SGD/momentum accumulator for W
@@ -169,6 +223,7 @@ private:
     };
 
     std::vector<Layer> _layers;
+    Eigen::VectorXd _params; // W and b of every layer (see parameters())
     Eigen::VectorXd _input;
     size_t _inputSize = 0;
     double _lr = 0.1;
@@ -182,6 +237,12 @@ private:
     double _adamEps = 1e-8;
     size_t _adamT = 0; // step counter (incremented on each weight update)
 
+    // Points each layer's W and b at its slice of _params (shapes from dW, db).
+    void _bindParams() noexcept;
+    void _checkSameTopology(const MlpMatrixNN& other, const char* what) const;
+    // Re-uploads W and b to the device arrays (OpenCL backend only).
+    void _uploadParams();
+
     static void _validateCostFunction(CostFunction cf, Activation outAct)
     {
         if (cf == CostFunction::CrossEntropy && outAct != Activation::Sigmoid)
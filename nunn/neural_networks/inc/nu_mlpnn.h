@@ -31,6 +31,7 @@
 #include "nu_trainer.h"
 #include "nu_vector.h"
 
+#include <Eigen/Core>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -166,6 +167,13 @@ public:
     void backPropagate(const FpVector& targetVector, FpVector& outputVector);
     void backPropagate(const FpVector& targetVector);
 
+    //! Batched inference: X [inputSize x B] (one sample per column) ->
+    //! [outputSize x B], one matrix product per layer. The weights are packed
+    //! into a matrix per call; the single-sample state is left untouched.
+    //! Throws SizeMismatchException if X.rows() != getInputSize().
+    [[nodiscard]] Eigen::MatrixXd feedForwardBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
     // ── Serialization ─────────────────────────────────────────────────────────
 
     std::stringstream& load(std::stringstream& ss);
@@ -13,14 +13,46 @@
 //   3. Principal components = first nComponents columns of V (rows of V^T).
 //   4. Explained variance per component = S_i^2 / (N-1) / total_variance.
 //
+// Solvers for step 2:
+//   Full       — exact divide-and-conquer SVD of a centred copy of X.
+//   Randomized — Halko, Martinsson & Tropp: range finder with l = k + p
+//                Gaussian probes and q power iterations, then an exact SVD of
+//                the small [l × D] projection. X is never copied or centred
+//                in place; every pass is a row-blocked GEMM over X, split
+//                across setThreads() workers. Memory O(N*l + D*l).
+//   Auto       — Randomized when min(N, D) > 500 and k < 0.8 * min(N, D).
+//
+// Incremental fitting (Ross et al., as in scikit-learn's IncrementalPCA):
+// partialFit(batch) stacks [diag(S) V^T; batch - batch_mean; mean correction]
+// and keeps the top k of its SVD, so the state is O(k*D) whatever the number
+// of batches; only one batch is resident at a time. A model from fit() is a
+// valid starting state, so fit(head) then partialFit(tail) extends it.
+//
+// Components are sign-normalised: the largest-magnitude entry of each is
+// positive, so all solvers agree on orientation.
+//
 // Projection: z = V_k^T * (x - mu)   [nComponents-dimensional]
 // Reconstruction: x_hat = V_k * z + mu
 //
+// With setWhiten(true) each z_i is further divided by sqrt(var_i), so the
+// projected data has unit variance per component. Whitening is folded into
+// the projection at fit time (P = diag(1/sigma) V_k^T), so transforming a
+// batch is one GEMM Z = (X - 1 mu^T) P^T per row block of X. Each block is
+// centred in a cache-sized buffer before the GEMM: expanding the product to
+// X P^T - 1 (P mu)^T would cancel catastrophically when |mu| dwarfs the
+// spread of the data.
+//
 // Usage:
 //   Pca pca(2);
 //   pca.fit(X);
 //   auto Z    = pca.transform(X);        // N x 2 projections
 //   auto Xhat = pca.inverseTransform(Z); // approximate reconstruction
+//
+//   Pca::Matrix Zm = pca.transform(Xm);  // Xm [N × D] -> Zm [N × 2], one GEMM
+//
+//   Pca stream(16);
+//   while (readChunk(chunk))            // chunk [rows × D], rows >= 16
+//       stream.partialFit(chunk);
 
 #pragma once
 
@@ -33,6 +65,12 @@ namespace nu {
 
 class Pca {
 public:
+    // Row-major [N × D] sample matrix, one sample per row.
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    using MatrixF = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    enum class Solver { Auto, Full, Randomized };
+
     struct NotFittedException : std::runtime_error {
         NotFittedException()
             : std::runtime_error("Pca: call fit() before transform()")
@@ -48,13 +86,43 @@ public:
     };
 
     // nComponents — number of principal components to retain (>= 1).
-    explicit Pca(size_t nComponents) noexcept;
+    // seed        — RNG seed for the randomized solver's probes.
+    explicit Pca(size_t nComponents, unsigned seed = 42) noexcept;
 
     // Fit: centre X, run thin SVD, store nComponents right singular vectors.
     // Requires nComponents <= min(nSamples, nFeatures).
     // Throws SizeMismatchException on empty / inconsistent data or out-of-range nComponents.
     void fit(const std::vector<std::vector<double>>& X);
 
+    // Matrix form: X [N × D], one sample per row; X is not copied by the
+    // randomized solver.
+    void fit(const Eigen::Ref<const Matrix>& X);
+
+    // Incremental update with one batch [rows × D]. The first batch needs
+    // rows >= nComponents and D >= nComponents; later batches may be any size.
+    // After fit(), partialFit() continues from the fitted model, as if the
+    // fit() data had been the first batch; call reset() to start afresh.
+    // Throws SizeMismatchException on a bad batch.
+    void partialFit(const Eigen::Ref<const Matrix>& batch);
+    void partialFit(const std::vector<std::vector<double>>& batch);
+
+    // Forget the fitted model and any incremental state.
+    void reset() noexcept;
+
+    // Solver used by fit(); randomized options (defaults 10 and 4).
+    void setSolver(Solver solver) noexcept { _solver = solver; }
+    void setOversampling(size_t p) noexcept { _oversampling = p; }
+    void setPowerIterations(size_t q) noexcept { _powerIters = q; }
+    // Workers for the passes over X (0 = hardware concurrency).
+    void setThreads(size_t threads) noexcept { _threads = threads; }
+    Solver solver() const noexcept { return _solver; }
+
+    // Scale projections to unit variance per component (default false).
+    // Applies to every transform / inverseTransform overload; components with
+    // zero variance are left unscaled.
+    void setWhiten(bool whiten);
+    bool whiten() const noexcept { return _whiten; }
+
     // Project a single sample into the component space.
     // Returns a vector of length nComponents.
     // Throws NotFittedException / SizeMismatchException.
@@ -63,10 +131,21 @@ public:
     // Batch transform — returns one row per input sample.
     std::vector<std::vector<double>> transform(const std::vector<std::vector<double>>& X) const;
 
+    // Matrix transform: X [N × D] -> Z [N × nComponents]. The out-parameter
+    // forms write into caller storage (which may be a Map over a raw buffer);
+    // the float form halves the output bandwidth, computing in double.
+    // Throws NotFittedException / SizeMismatchException.
+    Matrix transform(const Eigen::Ref<const Matrix>& X) const;
+    void transform(const Eigen::Ref<const Matrix>& X, Eigen::Ref<Matrix> Z) const;
+    void transform(const Eigen::Ref<const Matrix>& X, Eigen::Ref<MatrixF> Z) const;
+
     // Reconstruct an approximate original sample from a projected vector.
     // Throws NotFittedException / SizeMismatchException.
     std::vector<double> inverseTransform(const std::vector<double>& z) const;
 
+    // Matrix form: Z [N × nComponents] -> X_hat [N × D].
+    Matrix inverseTransform(const Eigen::Ref<const Matrix>& Z) const;
+
     // Fraction of total variance captured by each retained component.
     // Valid only after fit(); throws NotFittedException otherwise.
     const std::vector<double>& explainedVarianceRatio() const;
@@ -78,15 +157,47 @@ public:
     size_t inputDim() const noexcept { return _dim; }
     bool isFitted() const noexcept { return _fitted; }
 
+    // Samples the model has been fitted on (summed over partialFit() calls).
+    size_t samplesSeen() const noexcept { return _nSeen; }
+
+    // Fitted parameters; throw NotFittedException before fit().
+    const Eigen::VectorXd& mean() const;
+    const Eigen::MatrixXd& components() const; // [nComp × D]
+    const Eigen::VectorXd& singularValues() const; // [nComp], descending
+
 private:
     size_t _nComp;
+    unsigned _seed;
     size_t _dim = 0;
     bool _fitted = false;
 
+    Solver _solver = Solver::Auto;
+    size_t _oversampling = 10;
+    size_t _powerIters = 4;
+    size_t _threads = 0;
+    bool _whiten = false;
+
     Eigen::VectorXd _mean; // [D]           per-feature mean
     Eigen::MatrixXd _components; // [nComp x D]   principal components (rows)
+    Eigen::VectorXd _S; // [nComp]       singular values of the centred data
     std::vector<double> _explVar; // [nComp]       explained variance ratios
     double _totalExplVar = 0.0;
+
+    // Fused projection, rebuilt by _updateProjection().
+    Eigen::MatrixXd _projT; // [D × nComp]   P^T = V_k diag(scale)
+    Eigen::MatrixXd _unproj; // [nComp × D]   diag(1/scale) V_k^T
+
+    size_t _nSeen = 0;
+    double _totalSS = 0.0; // Σ |x - mean|^2 over all samples seen
+
+    void _fitFull(const Eigen::Ref<const Matrix>& X);
+    void _fitRandomized(const Eigen::Ref<const Matrix>& X);
+
+    // Stores the top nComp of S / V (V: [D × r]) and derives explained variance.
+    void _setModel(const Eigen::VectorXd& S, const Eigen::MatrixXd& V);
+    void _updateProjection();
+    void _checkTransform(Eigen::Index rows, Eigen::Index cols, Eigen::Index outRows,
+        Eigen::Index outCols) const;
 };
 
 } // namespace nu
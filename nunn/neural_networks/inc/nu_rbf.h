@@ -13,10 +13,22 @@
 //
 // Training procedure:
 //   1. Call fitCenters(dataset): fixes center positions c_j (random-subset
-//      sampling from data) and widths sigma_j = d_max / sqrt(2 * nc),
-//      where d_max is the maximum pairwise distance between centers.
+//      sampling from data, or k-means centroids with CenterInit::KMeans) and
+//      widths sigma_j = d_max / sqrt(2 * nc), where d_max is the maximum
+//      pairwise distance between centers (from the centers' Gram matrix).
 //   2. Call train(): updates only W_out / b_out via online SGD;
 //      centers and widths are never modified after fitCenters().
+//      Or call fitLeastSquares(): solves W_out / b_out in closed form,
+//        [W b] = T H_1^T (H_1 H_1^T + lambda I')^-1,  H_1 = [H; 1]
+//      where H [nc x N] holds the hidden activations and I' leaves the bias
+//      unpenalised. H_1 H_1^T and T H_1^T are accumulated block by block, so
+//      memory is O(nc^2) whatever N; one Cholesky solve replaces the epochs.
+//      In Softmax mode this is a least-squares fit of the pre-activations to
+//      the (one-hot) targets; train() can refine it under cross-entropy.
+//
+// Batched inference: forwardBatch(X [inputSize x B]) computes all squared
+// distances as ||c||^2 - 2 C X + ||x||^2 (one GEMM) and the outputs as a
+// second GEMM.
 //
 // Output mode (RnnOutput, from nu_rnn.h):
 //   Linear  — identity activation, MSE loss
@@ -34,6 +46,8 @@ namespace nu {
 
 class Rbf {
 public:
+    enum class CenterInit { Random, KMeans };
+
     // inputSize  — dimensionality of each input vector x
     // numCenters — number of RBF hidden units (centers)
     // outputSize — dimensionality of the output vector y
@@ -43,16 +57,41 @@ public:
     Rbf(size_t inputSize, size_t numCenters, size_t outputSize, double lr = 0.01,
         RnnOutput outMode = RnnOutput::Linear);
 
-    // Sample numCenters vectors from data as RBF centers and set widths
-    // heuristically: sigma = d_max / sqrt(2 * numCenters).
+    // Choose numCenters RBF centers from data and set widths heuristically:
+    // sigma = d_max / sqrt(2 * numCenters).
+    //   Random — sample numCenters data vectors (with replacement)
+    //   KMeans — centroids of a k-means++ / Hamerly run over the data
+    //            (needs at least numCenters samples)
     // Must be called before train() or forward().
     // Throws std::invalid_argument if data is empty or has wrong input size.
-    void fitCenters(const std::vector<std::vector<double>>& data);
+    void fitCenters(
+        const std::vector<std::vector<double>>& data, CenterInit init = CenterInit::Random);
 
     // Forward pass: compute output for a single input x.
     // Throws std::runtime_error if fitCenters() has not been called.
     std::vector<double> forward(const std::vector<double>& x) const;
 
+    // Batched forward: X [inputSize x B] -> [outputSize x B].
+    // Throws std::runtime_error before fitCenters(), std::invalid_argument on
+    // a size mismatch.
+    Eigen::MatrixXd forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+    std::vector<std::vector<double>> forwardBatch(
+        const std::vector<std::vector<double>>& inputs) const;
+
+    // Hidden activations for a batch: X [inputSize x B] -> H [numCenters x B].
+    Eigen::MatrixXd hiddenBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Closed-form ridge solve of the output layer (see header comment).
+    // lambda >= 0 is the L2 penalty on W_out. Returns the mean loss on the
+    // training set (same measure as train()).
+    // Throws std::runtime_error before fitCenters(), std::invalid_argument on
+    // empty / mismatched data or negative lambda.
+    double fitLeastSquares(const std::vector<std::vector<double>>& inputs,
+        const std::vector<std::vector<double>>& targets, double lambda = 1e-8);
+    // X [inputSize x N], T [outputSize x N].
+    double fitLeastSquares(const Eigen::Ref<const Eigen::MatrixXd>& X,
+        const Eigen::Ref<const Eigen::MatrixXd>& T, double lambda = 1e-8);
+
     // Train output weights via online SGD for `epochs` passes over (inputs, targets).
     // Returns mean loss of the final epoch.
     // Throws std::runtime_error if fitCenters() has not been called.
@@ -87,6 +126,8 @@ private:
     Eigen::VectorXd _hidden(const Eigen::VectorXd& x) const;
     Eigen::VectorXd _applyOutput(const Eigen::VectorXd& pre) const;
     void _initOutputWeights();
+    void _setWidths();
+    double _loss(const Eigen::MatrixXd& Y, const Eigen::Ref<const Eigen::MatrixXd>& T) const;
 
     static Eigen::VectorXd _softmax(const Eigen::VectorXd& z);
 };
@@ -26,6 +26,21 @@
 //   Deltab  = lr * (v0 - vk)
 //   Deltac  = lr * (h0_prob - hk_prob)
 //
+// Mini-batch training (trainBatch / trainMiniBatch):
+//   The same update on V [nVisible × B], one sample per column, averaged over
+//   the batch: every Gibbs step is one GEMM, sigmoids and Bernoulli draws are
+//   element-wise over the whole [units × B] matrix. With setThreads() the
+//   columns are split across workers, each running its own chains and
+//   returning a partial gradient that is summed before the update.
+//   setPersistent(true) selects PCD (Tieleman 2008): the negative phase
+//   continues a persistent hidden chain per batch column instead of
+//   restarting from the data.
+//
+// Sampling uses a Philox counter-based RNG (nu_counter_rng.h). Each draw
+// over a batch uses a fresh stream whose positions are the column-major
+// element indices, so the per-thread column blocks read disjoint ranges and
+// the result does not depend on the thread count.
+//
 // Internal storage:
 //   _W [nh x nv]   weight matrix
 //   _b [nv]        visible bias
@@ -34,7 +49,10 @@
 
 #pragma once
 
+#include "nu_counter_rng.h"
+
 #include <Eigen/Core>
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -69,6 +87,33 @@ public:
     // Throws std::invalid_argument if dataset is empty or size mismatches.
     void train(const std::vector<std::vector<double>>& dataset, size_t epochs, size_t cdK = 1);
 
+    // One CD-k (or PCD-k) update on V [nVisible × B], gradient averaged over B.
+    // Throws std::invalid_argument if V.rows() != nVisible() or B == 0.
+    void trainBatch(const Eigen::Ref<const Eigen::MatrixXd>& V, size_t k = 1);
+
+    // Mini-batch training: columns shuffled each epoch, batches of batchSize.
+    // X is [nVisible × N]; the vector form packs the dataset once.
+    // Throws std::invalid_argument if the dataset is empty or size mismatches.
+    void trainMiniBatch(const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs,
+        size_t batchSize = 64, size_t cdK = 1);
+    void trainMiniBatch(const std::vector<std::vector<double>>& dataset, size_t epochs,
+        size_t batchSize = 64, size_t cdK = 1);
+
+    // Batched conditionals: [nVisible × B] -> [nHidden × B] and back.
+    Eigen::MatrixXd hiddenProbsBatch(const Eigen::Ref<const Eigen::MatrixXd>& V) const;
+    Eigen::MatrixXd visibleProbsBatch(const Eigen::Ref<const Eigen::MatrixXd>& H) const;
+
+    // Persistent contrastive divergence for the batch trainers (default off).
+    // Changing it, or the batch size, restarts the chains.
+    void setPersistent(bool persistent) noexcept;
+    bool persistent() const noexcept { return _persistent; }
+
+    // Workers for the batch trainers (0 = hardware concurrency).
+    void setThreads(size_t threads) noexcept { _threads = threads; }
+
+    void setLearningRate(double lr) noexcept { _lr = lr; }
+    double learningRate() const noexcept { return _lr; }
+
     // Soft reconstruction v -> P(h|v) -> P(v|h).  No sampling; returns probs.
     // Throws std::invalid_argument if v.size() != nVisible().
     std::vector<double> reconstruct(const std::vector<double>& v) const;
@@ -78,6 +123,7 @@ public:
 
     // Mean MSE between each input and its soft reconstruction.
     double reconstructionError(const std::vector<std::vector<double>>& dataset) const;
+    double reconstructionError(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
 
     size_t nVisible() const noexcept { return _nv; }
     size_t nHidden() const noexcept { return _nh; }
@@ -88,8 +134,14 @@ private:
     Eigen::MatrixXd _W; // [nh x nv]
     Eigen::VectorXd _b; // visible bias [nv]
     Eigen::VectorXd _c; // hidden bias  [nh]
-    std::mt19937 _rng;
-    std::uniform_real_distribution<double> _udist;
+    std::mt19937 _rng; // weight init and shuffling
+    unsigned _seed;
+    CounterRng _sampler; // online Gibbs draws
+    uint64_t _draws = 0; // batch draw streams used so far
+
+    bool _persistent = false;
+    Eigen::MatrixXd _chainH; // [nh × B] persistent hidden states
+    size_t _threads = 0;
 
     static Eigen::VectorXd _sigmoid(const Eigen::VectorXd& x);
     Eigen::VectorXd _sample(const Eigen::VectorXd& probs);
@@ -21,9 +21,26 @@
 //     lr(t)    = lr_0    * exp(-t / T)
 //     sigma(t) = sigma_0 * exp(-t / T)
 //
+// Batch training (Kohonen's batch SOM, trainBatch):
+//   Per epoch, every sample is assigned to its BMU; with S_j = sum of the
+//   samples mapped to neuron j and n_j their count,
+//     w_i = sum_j h(i, j) S_j / sum_j h(i, j) n_j
+//   No learning rate; only sigma decays. BMUs come from
+//     argmin_i ||w_i||^2 - 2 w_i . x
+//   as a GEMM over blocks of samples, split across setThreads() workers.
+//   The Gaussian factorises over grid rows and columns, so the smoothing is
+//   two 1-D passes: O(neurons * window * d) instead of O(neurons^2 * d).
+//
+// Neighbourhood truncation:
+//   h is treated as zero beyond truncation() * sigma grid steps along a row
+//   or column (default 4, where h < 3.4e-4). Online updates then touch only
+//   that window of neurons. setNeighborhoodTruncation(0) restores the full
+//   neighbourhood.
+//
 // Internal storage:
-//   _W   [rows*cols x inputDim]  — flat weight matrix (row-major neuron index)
-//   _pos [rows*cols x 2]         — grid coordinates (row, col) of each neuron
+//   _W      [rows*cols x inputDim]  — flat weight matrix (row-major neuron index)
+//   _pos    [rows*cols x 2]         — grid coordinates (row, col) of each neuron
+//   _wNorm2 [rows*cols]             — cached ||w_i||^2 for the BMU search
 //
 
 #pragma once
@@ -37,6 +54,9 @@ namespace nu {
 
 class Som {
 public:
+    // Row-major [N × inputDim] sample matrix, one sample per row.
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
     // rows, cols   — grid dimensions
     // inputDim     — dimensionality of each input vector
     // lr           — initial learning rate (eta_0); default 0.5
@@ -62,8 +82,27 @@ public:
     void train(const std::vector<std::vector<double>>& dataset, size_t epochs,
         double finalLr = 0.01, double finalRadius = 0.5);
 
+    // Batch SOM training for epochs passes (radius sigma_0 -> finalRadius).
+    // Throws std::invalid_argument if the dataset is empty or input size mismatches.
+    void trainBatch(const Eigen::Ref<const Matrix>& X, size_t epochs, double finalRadius = 0.5);
+    void trainBatch(
+        const std::vector<std::vector<double>>& dataset, size_t epochs, double finalRadius = 0.5);
+
+    // Flat BMU index (row * cols() + col) of every sample in X.
+    // Throws std::invalid_argument if X.cols() != inputDim().
+    std::vector<size_t> bmuBatch(const Eigen::Ref<const Matrix>& X) const;
+
     // Mean Euclidean distance from each sample to its BMU weight vector.
     double quantizationError(const std::vector<std::vector<double>>& dataset) const;
+    double quantizationError(const Eigen::Ref<const Matrix>& X) const;
+
+    // Neighbourhood cut-off in units of sigma (0 = no truncation).
+    // Throws std::invalid_argument if negative.
+    void setNeighborhoodTruncation(double sigmas);
+    double truncation() const noexcept { return _truncate; }
+
+    // Workers for trainBatch / bmuBatch (0 = hardware concurrency).
+    void setThreads(size_t threads) noexcept { _threads = threads; }
 
     // Weight vector of neuron at grid position (r, c) as a std::vector<double>.
     // Throws std::out_of_range if r >= rows() or c >= cols().
@@ -81,10 +120,19 @@ private:
     double _lr0, _r0;
     Eigen::MatrixXd _W; // [rows*cols x inputDim]
     Eigen::MatrixXd _pos; // [rows*cols x 2]
+    Eigen::VectorXd _wNorm2; // [rows*cols]
     std::mt19937 _rng;
+    double _truncate = 4.0;
+    size_t _threads = 0;
 
     size_t _idx(size_t r, size_t c) const noexcept { return r * _cols + c; }
-    size_t _bmuFlat(const Eigen::VectorXd& x) const;
+    size_t _bmuFlat(const Eigen::Ref<const Eigen::VectorXd>& x) const;
+
+    // Half-width of the truncated window and its 1-D Gaussian g[0..R].
+    std::vector<double> _kernel(double radius) const;
+
+    // One batch-SOM epoch at the given radius.
+    void _batchEpoch(const Eigen::Ref<const Matrix>& X, double radius);
 };
 
 } // namespace nu
@@ -31,10 +31,24 @@
 //   All gradients are computed with original weights (no in-place aliasing),
 //   then parameters are updated in a single step at the end of trainStep().
 //
+// Batches:
+//   Every pass works on [dim x B] matrices, one sample per column: each layer
+//   is one GEMM, activations and the reparameterization are element-wise
+//   over the batch, and trainBatch() averages the gradients over B. The
+//   single-sample methods are the B = 1 case of the batch code.
+//   Noise comes from a Philox counter-based generator (nu_counter_rng.h)
+//   filled a whole [nz x B] block at a time.
+//
+// Optimizer: plain SGD (default) or Adam (Kingma & Ba, 2015) via
+// setOptimizer(); Adam keeps first/second moments for all 10 parameters.
+//
 
 #pragma once
 
+#include "nu_counter_rng.h"
+
 #include <Eigen/Core>
+#include <array>
 #include <random>
 #include <utility>
 #include <vector>
@@ -43,6 +57,8 @@ namespace nu {
 
 class Vae {
 public:
+    enum class Optimizer { SGD, Adam };
+
     // inputDim  -- visible / output dimension
     // hiddenDim -- encoder and decoder hidden layer width
     // latentDim -- size of latent vector z
@@ -80,6 +96,49 @@ public:
 
     // Mean binary cross-entropy between each input and its deterministic reconstruction.
     double reconstructionError(const std::vector<std::vector<double>>& dataset) const;
+    double reconstructionError(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // ── Batched interface: one sample per column ─────────────────────────────
+
+    // X [inputDim x B] -> {mu, logvar}, each [latentDim x B].
+    // Throws std::invalid_argument if X.rows() != inputDim().
+    std::pair<Eigen::MatrixXd, Eigen::MatrixXd> encodeBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Z [latentDim x B] -> reconstructions [inputDim x B].
+    // Throws std::invalid_argument if Z.rows() != latentDim().
+    Eigen::MatrixXd decodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& Z) const;
+
+    // X [inputDim x B] -> decode(mu) [inputDim x B].
+    Eigen::MatrixXd reconstructBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // n samples decoded from the prior: [inputDim x n].
+    Eigen::MatrixXd generateBatch(size_t n);
+
+    // One update on X [inputDim x B], gradients averaged over the batch.
+    // Returns the batch means {L_recon, klWeight*L_KL}.
+    // Throws std::invalid_argument if X.rows() != inputDim() or B == 0.
+    std::pair<double, double> trainBatch(
+        const Eigen::Ref<const Eigen::MatrixXd>& X, double klWeight = 1.0);
+
+    // Mini-batch training with the KL annealing of train(): columns shuffled
+    // each epoch and split into batches of batchSize (the last one may be
+    // smaller). X is [inputDim x N]; the vector form packs the dataset once.
+    // Throws std::invalid_argument if the dataset is empty or size mismatches.
+    void trainMiniBatch(const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs,
+        size_t batchSize = 64, double warmupFrac = 0.5);
+    void trainMiniBatch(const std::vector<std::vector<double>>& dataset, size_t epochs,
+        size_t batchSize = 64, double warmupFrac = 0.5);
+
+    // ── Optimizer ─────────────────────────────────────────────────────────────
+
+    // Switch optimizer; resets the Adam moments and step counter.
+    void setOptimizer(
+        Optimizer opt, double beta1 = 0.9, double beta2 = 0.999, double eps = 1e-8) noexcept;
+    Optimizer optimizer() const noexcept { return _optimizer; }
+
+    void setLearningRate(double lr) noexcept { _lr = lr; }
+    double learningRate() const noexcept { return _lr; }
 
     size_t inputDim() const noexcept { return _nx; }
     size_t hiddenDim() const noexcept { return _nh; }
@@ -103,16 +162,29 @@ private:
     Eigen::MatrixXd _W_out; // [nx x nh]
     Eigen::VectorXd _b_out; // [nx]
 
-    std::mt19937 _rng;
-    std::normal_distribution<double> _ndist;
-
-    static Eigen::VectorXd _relu(const Eigen::VectorXd& x);
-    static Eigen::VectorXd _sigmoid(const Eigen::VectorXd& x);
-    Eigen::VectorXd _sampleNormal(size_t n);
+    std::mt19937 _rng;    // weight init, shuffling
+    CounterRng _noise;    // reparameterization and prior samples
+
+    Optimizer _optimizer = Optimizer::SGD;
+    double _beta1 = 0.9;
+    double _beta2 = 0.999;
+    double _adamEps = 1e-8;
+    size_t _adamT = 0;
+    // Adam moments, one per parameter in declaration order (vectors as n x 1)
+    std::array<Eigen::MatrixXd, 10> _adamM, _adamV;
+
+    static Eigen::MatrixXd _relu(const Eigen::MatrixXd& x);
+    static Eigen::MatrixXd _sigmoid(const Eigen::MatrixXd& x);
+    static Eigen::MatrixXd _outer(
+        const Eigen::Ref<const Eigen::MatrixXd>& D, const Eigen::Ref<const Eigen::MatrixXd>& A);
+    Eigen::MatrixXd _sampleNormal(size_t rows, size_t cols);
     Eigen::VectorXd _toEigen(const std::vector<double>& v, size_t expectedSize) const;
 
-    // Decoder forward (shared between decode(), reconstruct(), generate())
-    Eigen::VectorXd _decodeEigen(const Eigen::VectorXd& z) const;
+    // Encoder hidden layer, [nh x B]
+    Eigen::MatrixXd _encodeHidden(const Eigen::Ref<const Eigen::MatrixXd>& X) const;
+
+    // Applies one SGD or Adam step to parameter k.
+    template <class Param, class Grad> void _step(Param& p, const Grad& g, size_t k);
 };
 
 } // namespace nu
@@ -8,6 +8,7 @@
 
 #include "nu_autoencoder.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace nu {
@@ -37,70 +38,97 @@ static std::vector<MlpMatrixNN::LayerConfig> fullTopology(
     return cfg;
 }
 
-static std::vector<MlpMatrixNN::LayerConfig> decoderTopology(
-    size_t inputDim, const std::vector<size_t>& encoderSizes, Activation act)
-{
-    // [bottleneck, ..., e0, inputDim]
-    std::vector<MlpMatrixNN::LayerConfig> cfg;
-    cfg.emplace_back(encoderSizes.back()); // bottleneck = decoder input
-    for (int i = static_cast<int>(encoderSizes.size()) - 2; i >= 0; --i)
-        cfg.emplace_back(encoderSizes[static_cast<size_t>(i)], act);
-    cfg.emplace_back(inputDim, Activation::Linear);
-    return cfg;
-}
-
 // ── Construction ──────────────────────────────────────────────────────────────
 
 Autoencoder::Autoencoder(
     size_t inputDim, std::vector<size_t> encoderSizes, Activation act, double lr)
     : _inputDim(inputDim)
-    , _latentSize(validateAndGetLatent(encoderSizes)) // throws if empty, before _net/_decNet
+    , _latentSize(validateAndGetLatent(encoderSizes)) // throws if empty, before _net
     , _encoderLayerCount(encoderSizes.size())
     , _net(fullTopology(inputDim, encoderSizes, act), lr)
-    , _decNet(decoderTopology(inputDim, encoderSizes, act), lr)
 {
-    _syncDecoder();
 }
 
 // ── Forward ───────────────────────────────────────────────────────────────────
 
-std::vector<double> Autoencoder::encode(const std::vector<double>& x)
+static std::vector<double> toStd(const Eigen::MatrixXd& m)
+{
+    return std::vector<double>(m.data(), m.data() + m.size());
+}
+
+static Eigen::Map<const Eigen::VectorXd> toEigen(const std::vector<double>& v)
+{
+    return Eigen::Map<const Eigen::VectorXd>(v.data(), static_cast<Eigen::Index>(v.size()));
+}
+
+Eigen::MatrixXd Autoencoder::encodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (static_cast<size_t>(X.rows()) != _inputDim)
+        throw std::invalid_argument("Autoencoder: input size mismatch");
+    return _net.feedForwardBatch(X, 0, _encoderLayerCount);
+}
+
+Eigen::MatrixXd Autoencoder::decodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& Z) const
+{
+    if (static_cast<size_t>(Z.rows()) != _latentSize)
+        throw std::invalid_argument("Autoencoder: latent size mismatch");
+    return _net.feedForwardBatch(Z, _encoderLayerCount, _net.numLayers());
+}
+
+Eigen::MatrixXd Autoencoder::reconstructBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (static_cast<size_t>(X.rows()) != _inputDim)
+        throw std::invalid_argument("Autoencoder: input size mismatch");
+    return _net.feedForwardBatch(X);
+}
+
+Eigen::VectorXd Autoencoder::reconstructionErrors(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    return (reconstructBatch(X) - X).colwise().squaredNorm().transpose()
+        / static_cast<double>(_inputDim);
+}
+
+std::vector<double> Autoencoder::encode(const std::vector<double>& x) const
 {
-    _net.setInputVector(x);
-    _net.feedForward();
-    const Eigen::VectorXd& z = _net.getLayerOutput(_encoderLayerCount - 1);
-    return std::vector<double>(z.data(), z.data() + z.size());
+    return toStd(encodeBatch(toEigen(x)));
 }
 
-std::vector<double> Autoencoder::decode(const std::vector<double>& z)
+std::vector<double> Autoencoder::decode(const std::vector<double>& z) const
 {
-    _decNet.setInputVector(z);
-    _decNet.feedForward();
-    std::vector<double> out;
-    _decNet.copyOutputVector(out);
-    return out;
+    return toStd(decodeBatch(toEigen(z)));
 }
 
-std::vector<double> Autoencoder::reconstruct(const std::vector<double>& x)
+std::vector<double> Autoencoder::reconstruct(const std::vector<double>& x) const
 {
-    _net.setInputVector(x);
-    _net.feedForward();
-    std::vector<double> out;
-    _net.copyOutputVector(out);
-    return out;
+    return toStd(reconstructBatch(toEigen(x)));
 }
 
-double Autoencoder::reconstructionMSE(const std::vector<double>& x)
+double Autoencoder::reconstructionMSE(const std::vector<double>& x) const
 {
-    _net.setInputVector(x);
-    _net.feedForward();
-    return _net.calcMSE(x);
+    return reconstructionErrors(toEigen(x))(0);
 }
 
 // ── Training ──────────────────────────────────────────────────────────────────
 
-double Autoencoder::train(const std::vector<std::vector<double>>& dataset, size_t epochs)
+double Autoencoder::train(
+    const std::vector<std::vector<double>>& dataset, size_t epochs, size_t batchSize)
 {
+    if (batchSize == 0)
+        throw std::invalid_argument("Autoencoder::train: batchSize must be > 0");
+    if (dataset.empty())
+        return 0.0;
+
+    if (batchSize > 1) {
+        Eigen::MatrixXd X(static_cast<Eigen::Index>(_inputDim),
+            static_cast<Eigen::Index>(dataset.size()));
+        for (size_t j = 0; j < dataset.size(); ++j) {
+            if (dataset[j].size() != _inputDim)
+                throw std::invalid_argument("Autoencoder::train: input size mismatch");
+            X.col(static_cast<Eigen::Index>(j)) = toEigen(dataset[j]);
+        }
+        return train(X, epochs, batchSize);
+    }
+
     double lastMSE = 0.0;
     for (size_t ep = 0; ep < epochs; ++ep) {
         double total = 0.0;
@@ -112,7 +140,29 @@ double Autoencoder::train(const std::vector<std::vector<double>>& dataset, size_
         }
         lastMSE = total / static_cast<double>(dataset.size());
     }
-    _syncDecoder();
+    return lastMSE;
+}
+
+double Autoencoder::train(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs, size_t batchSize)
+{
+    if (batchSize == 0)
+        throw std::invalid_argument("Autoencoder::train: batchSize must be > 0");
+    if (static_cast<size_t>(X.rows()) != _inputDim)
+        throw std::invalid_argument("Autoencoder::train: input size mismatch");
+
+    const Eigen::Index N = X.cols();
+    const auto B = static_cast<Eigen::Index>(batchSize);
+    double lastMSE = 0.0;
+    for (size_t ep = 0; ep < epochs; ++ep) {
+        double total = 0.0;
+        for (Eigen::Index start = 0; start < N; start += B) {
+            const Eigen::Index len = std::min(B, N - start);
+            const auto batch = X.middleCols(start, len);
+            total += _net.trainBatch(batch, batch) * static_cast<double>(len); // target = input
+        }
+        lastMSE = N > 0 ? total / static_cast<double>(N) : 0.0;
+    }
     return lastMSE;
 }
 
@@ -121,16 +171,6 @@ double Autoencoder::train(const std::vector<std::vector<double>>& dataset, size_
 void Autoencoder::reshuffleWeights()
 {
     _net.reshuffleWeights();
-    _syncDecoder();
-}
-
-void Autoencoder::_syncDecoder()
-{
-    const size_t n = _decNet.numLayers();
-    for (size_t i = 0; i < n; ++i) {
-        _decNet.setLayerW(i, _net.getLayerW(_encoderLayerCount + i));
-        _decNet.setLayerB(i, _net.getLayerB(_encoderLayerCount + i));
-    }
 }
 
 } // namespace nu
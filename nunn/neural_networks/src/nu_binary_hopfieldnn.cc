@@ -0,0 +1,450 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_binary_hopfieldnn.h"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <string>
+
+namespace nu {
+
+namespace {
+
+// Rows of the Hebbian Gram matrix computed per GEMM in addPatterns().
+constexpr Eigen::Index HEBB_BLOCK = 256;
+
+using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+inline bool getBit(const uint64_t* s, size_t i) noexcept { return (s[i >> 6] >> (i & 63)) & 1; }
+
+inline void setBit(uint64_t* s, size_t i, bool v) noexcept
+{
+    const uint64_t m = uint64_t(1) << (i & 63);
+    s[i >> 6] = v ? (s[i >> 6] | m) : (s[i >> 6] & ~m);
+}
+
+// popcount(a & b) summed over n words. Without a hardware popcount (the
+// default x86-64 target) std::popcount is a library call per word; the SWAR
+// form below accumulates per-byte counts of up to 31 words before one
+// horizontal sum, and vectorises.
+inline int64_t popcountAnd(const uint64_t* a, const uint64_t* b, size_t n) noexcept
+{
+#if defined(__POPCNT__) || defined(__ARM_NEON) || defined(_M_ARM64)
+    int64_t c = 0;
+    for (size_t k = 0; k < n; ++k)
+        c += std::popcount(a[k] & b[k]);
+    return c;
+#else
+    constexpr uint64_t m1 = 0x5555555555555555ull;
+    constexpr uint64_t m2 = 0x3333333333333333ull;
+    constexpr uint64_t m4 = 0x0f0f0f0f0f0f0f0full;
+    constexpr uint64_t m8 = 0x00ff00ff00ff00ffull;
+
+    int64_t total = 0;
+    for (size_t k = 0; k < n;) {
+        const size_t end = std::min(n, k + 31);
+        uint64_t acc = 0;
+        for (; k < end; ++k) {
+            uint64_t x = a[k] & b[k];
+            x -= (x >> 1) & m1;
+            x = (x & m2) + ((x >> 2) & m2);
+            acc += (x + (x >> 4)) & m4;
+        }
+        acc = (acc & m8) + ((acc >> 8) & m8);
+        total += static_cast<int64_t>((acc * 0x0001000100010001ull) >> 48);
+    }
+    return total;
+#endif
+}
+
+} // namespace
+
+BinaryHopfieldNN::BinaryHopfieldNN(size_t inputSize, unsigned weightBits)
+{
+    _resize(inputSize, weightBits);
+
+    std::random_device rd;
+    _rndgen.seed(rd());
+}
+
+void BinaryHopfieldNN::_resize(size_t inputSize, unsigned weightBits)
+{
+    if (weightBits < 2 || weightBits > 16)
+        throw std::invalid_argument("BinaryHopfieldNN: weightBits must be in [2, 16]");
+
+    _n = inputSize;
+    _bits = weightBits;
+    _words = (inputSize + 63) / 64;
+    _planes.assign(_n * _bits * _words, 0);
+    _rowPop.assign(_n * _bits, 0);
+    _s.assign(_words, 0);
+    _patternSize = 0;
+}
+
+void BinaryHopfieldNN::clear() noexcept
+{
+    std::fill(_planes.begin(), _planes.end(), 0);
+    std::fill(_rowPop.begin(), _rowPop.end(), 0);
+    std::fill(_s.begin(), _s.end(), 0);
+    _patternSize = 0;
+}
+
+void BinaryHopfieldNN::setMaxIterations(size_t maxIterations)
+{
+    if (maxIterations == 0)
+        throw std::invalid_argument("BinaryHopfieldNN: max iterations must be positive");
+    _maxIterations = maxIterations;
+}
+
+// ── Packing ──────────────────────────────────────────────────────────────────
+
+void BinaryHopfieldNN::_unpackRow(size_t i, int32_t* w) const noexcept
+{
+    std::fill(w, w + _n, 0);
+    const uint64_t* r = _row(i);
+    for (unsigned b = 0; b < _bits; ++b, r += _words) {
+        const int32_t c = (b + 1 == _bits) ? -(int32_t(1) << b) : (int32_t(1) << b);
+        for (size_t k = 0; k < _words; ++k) {
+            for (uint64_t x = r[k]; x; x &= x - 1)
+                w[k * 64 + size_t(std::countr_zero(x))] += c;
+        }
+    }
+}
+
+void BinaryHopfieldNN::_packRow(size_t i, const int32_t* w) noexcept
+{
+    uint64_t* r = &_planes[i * _bits * _words];
+    std::fill(r, r + _bits * _words, 0);
+
+    const auto mask = static_cast<uint32_t>((uint64_t(1) << _bits) - 1);
+    for (size_t j = 0; j < _n; ++j) {
+        const uint32_t v = static_cast<uint32_t>(w[j]) & mask;
+        for (uint32_t x = v; x; x &= x - 1) {
+            const unsigned b = unsigned(std::countr_zero(x));
+            r[b * _words + (j >> 6)] |= uint64_t(1) << (j & 63);
+        }
+    }
+
+    for (unsigned b = 0; b < _bits; ++b) {
+        int32_t pop = 0;
+        for (size_t k = 0; k < _words; ++k)
+            pop += std::popcount(r[b * _words + k]);
+        _rowPop[i * _bits + b] = pop;
+    }
+}
+
+void BinaryHopfieldNN::_pack(const double* x, uint64_t* s) const noexcept
+{
+    std::fill(s, s + _words, 0);
+    for (size_t i = 0; i < _n; ++i) {
+        if (x[i] > 0.0)
+            s[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+}
+
+void BinaryHopfieldNN::_unpack(const uint64_t* s, double* x) const noexcept
+{
+    for (size_t i = 0; i < _n; ++i)
+        x[i] = getBit(s, i) ? 1.0 : -1.0;
+}
+
+int BinaryHopfieldNN::weight(size_t i, size_t j) const noexcept
+{
+    const uint64_t* r = _row(i);
+    int w = 0;
+    for (unsigned b = 0; b < _bits; ++b, r += _words) {
+        if (getBit(r, j))
+            w += (b + 1 == _bits) ? -(1 << b) : (1 << b);
+    }
+    return w;
+}
+
+// ── Storage ──────────────────────────────────────────────────────────────────
+
+void BinaryHopfieldNN::addPattern(const FpVector& input_pattern)
+{
+    if (input_pattern.size() != _n) {
+        throw SizeMismatchException();
+    }
+
+    addPatterns(Eigen::Map<const Eigen::VectorXd>(
+        input_pattern.to_stdvec().data(), static_cast<Eigen::Index>(_n)));
+}
+
+void BinaryHopfieldNN::addPatterns(const Eigen::Ref<const Eigen::MatrixXd>& patterns)
+{
+    if (static_cast<size_t>(patterns.rows()) != _n) {
+        throw SizeMismatchException();
+    }
+
+    // Binarised patterns; the Gram matrix P P^T holds exact integers.
+    const Eigen::MatrixXd P = patterns.unaryExpr([](double v) { return v > 0.0 ? 1.0 : -1.0; });
+
+    const auto n = static_cast<Eigen::Index>(_n);
+    const int32_t wMax = _maxWeight();
+    std::vector<int32_t> w(_n);
+    RowMatrix G;
+
+    for (Eigen::Index r0 = 0; r0 < n; r0 += HEBB_BLOCK) {
+        const Eigen::Index len = std::min(HEBB_BLOCK, n - r0);
+        G.noalias() = P.middleRows(r0, len) * P.transpose();
+
+        for (Eigen::Index r = 0; r < len; ++r) {
+            const auto i = static_cast<size_t>(r0 + r);
+            _unpackRow(i, w.data());
+            for (size_t j = 0; j < _n; ++j) {
+                if (j == i)
+                    continue;
+                const auto g = static_cast<int32_t>(G(r, Eigen::Index(j)));
+                w[j] = std::clamp(w[j] + g, -wMax, wMax);
+            }
+            _packRow(i, w.data());
+        }
+    }
+
+    _patternSize += static_cast<size_t>(patterns.cols());
+}
+
+// ── Recall ───────────────────────────────────────────────────────────────────
+
+// h_i = sum_b c_b (2 popcount(plane_b & s) - popcount(plane_b)), with
+// c_b = 2^b and c_top = -2^top (two's complement).
+int64_t BinaryHopfieldNN::_field(size_t i, const uint64_t* s) const noexcept
+{
+    const uint64_t* r = _row(i);
+    const int32_t* pop = &_rowPop[i * _bits];
+    int64_t h = 0;
+    for (unsigned b = 0; b < _bits; ++b, r += _words) {
+        const int64_t c = popcountAnd(r, s, _words);
+        const int64_t sum = (2 * c - pop[b]) * (int64_t(1) << b);
+        h += (b + 1 == _bits) ? -sum : sum;
+    }
+    return h;
+}
+
+void BinaryHopfieldNN::_run(uint64_t* s)
+{
+    switch (_mode) {
+    case RecallMode::Asynchronous:
+        _recallAsynchronous(s);
+        break;
+    case RecallMode::Synchronous:
+        _recallSynchronous(s);
+        break;
+    case RecallMode::Blocked:
+        _recallBlocked(s);
+        break;
+    }
+}
+
+void BinaryHopfieldNN::recall(const FpVector& input_pattern, FpVector& output_pattern)
+{
+    if (input_pattern.size() != _n) {
+        throw SizeMismatchException();
+    }
+
+    _pack(input_pattern.to_stdvec().data(), _s.data());
+    _run(_s.data());
+
+    output_pattern = FpVector(_n);
+    _unpack(_s.data(), output_pattern.to_stdvec().data());
+}
+
+Eigen::MatrixXd BinaryHopfieldNN::recall(const Eigen::Ref<const Eigen::MatrixXd>& keys)
+{
+    if (static_cast<size_t>(keys.rows()) != _n) {
+        throw SizeMismatchException();
+    }
+
+    Eigen::MatrixXd S(keys.rows(), keys.cols());
+    Eigen::VectorXd key(keys.rows());
+    size_t maxIterations = 0;
+    bool converged = true;
+
+    for (Eigen::Index j = 0; j < keys.cols(); ++j) {
+        key = keys.col(j);
+        _pack(key.data(), _s.data());
+        _run(_s.data());
+
+        maxIterations = std::max(maxIterations, _lastIterations);
+        converged = converged && _lastConverged;
+        _unpack(_s.data(), S.col(j).data());
+    }
+
+    if (_mode != RecallMode::Asynchronous) {
+        _lastIterations = maxIterations;
+        _lastConverged = converged;
+    }
+
+    return S;
+}
+
+void BinaryHopfieldNN::_recallAsynchronous(uint64_t* s)
+{
+    if (_n == 0)
+        return;
+
+    std::uniform_int_distribution<size_t> dist(0, _n - 1);
+    size_t it = 0, last_it = 0;
+
+    do {
+        ++it;
+        const size_t i = dist(_rndgen);
+        const int64_t h = _field(i, s);
+        if (h != 0 && (h > 0) != getBit(s, i)) {
+            setBit(s, i, h > 0);
+            last_it = it;
+        }
+    } while (it - last_it < 10 * _n);
+}
+
+void BinaryHopfieldNN::_recallSynchronous(uint64_t* s)
+{
+    std::vector<uint64_t> prev(s, s + _words), next(_words);
+
+    _lastIterations = 0;
+    _lastConverged = false;
+
+    for (size_t it = 1; it <= _maxIterations; ++it) {
+        std::copy(s, s + _words, next.begin());
+        for (size_t i = 0; i < _n; ++i) {
+            const int64_t h = _field(i, s);
+            if (h != 0)
+                setBit(next.data(), i, h > 0);
+        }
+        _lastIterations = it;
+
+        const bool fixed = std::equal(next.begin(), next.end(), s);
+        const bool cycle = !fixed && it > 1 && next == prev;
+
+        std::copy(s, s + _words, prev.begin());
+        std::copy(next.begin(), next.end(), s);
+
+        if (fixed) {
+            _lastConverged = true;
+            return;
+        }
+        if (cycle)
+            return;
+    }
+}
+
+void BinaryHopfieldNN::_recallBlocked(uint64_t* s)
+{
+    _lastIterations = 0;
+    _lastConverged = false;
+
+    for (size_t sweep = 1; sweep <= _maxIterations; ++sweep) {
+        bool changed = false;
+
+        for (size_t k = 0; k < _words; ++k) {
+            uint64_t word = s[k];
+            const size_t end = std::min(_n, (k + 1) * 64);
+            for (size_t i = k * 64; i < end; ++i) {
+                const int64_t h = _field(i, s);
+                if (h != 0) {
+                    const uint64_t m = uint64_t(1) << (i & 63);
+                    word = (h > 0) ? (word | m) : (word & ~m);
+                }
+            }
+            changed = changed || word != s[k];
+            s[k] = word;
+        }
+        _lastIterations = sweep;
+
+        if (!changed) {
+            _lastConverged = true;
+            return;
+        }
+    }
+}
+
+// ── Serialisation ────────────────────────────────────────────────────────────
+
+std::stringstream& BinaryHopfieldNN::load(std::stringstream& ss)
+{
+    std::string id;
+    ss >> id;
+    if (id != ID_ANN) {
+        throw InvalidSStreamFormatException();
+    }
+
+    size_t patterns = 0;
+    ss >> patterns;
+
+    ss >> id;
+    if (id != ID_NEURON_ST) {
+        throw InvalidSStreamFormatException();
+    }
+
+    FpVector states;
+    ss >> states;
+
+    ss >> id;
+    if (id != ID_WEIGHTS) {
+        throw InvalidSStreamFormatException();
+    }
+
+    FpVector weights;
+    ss >> weights;
+
+    const size_t n = states.size();
+    if (!ss || weights.size() != n * n) {
+        throw InvalidSStreamFormatException();
+    }
+
+    _resize(n, _bits);
+
+    const auto& wd = weights.to_stdvec();
+    double maxAbs = 0.0;
+    for (double v : wd)
+        maxAbs = std::max(maxAbs, std::abs(v));
+
+    const int32_t wMax = _maxWeight();
+    const double scale = maxAbs > wMax ? wMax / maxAbs : 1.0;
+
+    std::vector<int32_t> w(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j)
+            w[j] = static_cast<int32_t>(std::lround(wd[i * n + j] * scale));
+        _packRow(i, w.data());
+    }
+
+    _pack(states.to_stdvec().data(), _s.data());
+    _patternSize = patterns;
+
+    std::random_device rd;
+    _rndgen.seed(rd());
+
+    return ss;
+}
+
+std::stringstream& BinaryHopfieldNN::save(std::stringstream& ss) const
+{
+    FpVector states(_n);
+    _unpack(_s.data(), states.to_stdvec().data());
+
+    FpVector weights(_n * _n);
+    std::vector<int32_t> w(_n);
+    for (size_t i = 0; i < _n; ++i) {
+        _unpackRow(i, w.data());
+        std::copy(w.begin(), w.end(), weights.to_stdvec().begin() + std::ptrdiff_t(i * _n));
+    }
+
+    ss << ID_ANN << "\n" << _patternSize << "\n" << ID_NEURON_ST << "\n";
+    ss << states;
+    ss << ID_WEIGHTS << "\n";
+    ss << weights;
+
+    return ss;
+}
+
+} // namespace nu
@@ -8,6 +8,7 @@
 
 #include "nu_conv.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -18,7 +19,7 @@ namespace nu {
 // ── Conv1DLayer ───────────────────────────────────────────────────────────────
 
 Conv1DLayer::Conv1DLayer(size_t inChannels, size_t inLength, size_t outChannels, size_t kernelSize,
-    Activation act, double lr)
+    Activation act, double lr, ConvAlgorithm algo)
     : _inCh(inChannels)
     , _inLen(inLength)
     , _outCh(outChannels)
@@ -26,22 +27,44 @@ Conv1DLayer::Conv1DLayer(size_t inChannels, size_t inLength, size_t outChannels,
     , _outLen(inLength >= kernelSize ? inLength - kernelSize + 1 : 0)
     , _act(act)
     , _lr(lr)
+    , _algo(algo)
     , _W(Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(outChannels),
           static_cast<Eigen::Index>(inChannels * kernelSize)))
     , _b(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(outChannels)))
-    , _Xcol(Eigen::MatrixXd::Zero(
-          static_cast<Eigen::Index>(inChannels * kernelSize), static_cast<Eigen::Index>(_outLen)))
-    , _Yact(Eigen::MatrixXd::Zero(
-          static_cast<Eigen::Index>(outChannels), static_cast<Eigen::Index>(_outLen)))
+    , _dW(Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(outChannels),
+          static_cast<Eigen::Index>(inChannels * kernelSize)))
     , _out(outChannels * _outLen, 0.0)
+    , _gradIn(inChannels * inLength, 0.0)
 {
     if (inChannels == 0 || outChannels == 0 || kernelSize == 0)
         throw std::invalid_argument("Conv1DLayer: dimensions must be > 0");
     if (inLength < kernelSize)
         throw std::invalid_argument("Conv1DLayer: inLength must be >= kernelSize");
+    setAlgorithm(algo);
     reshuffleWeights();
 }
 
+void Conv1DLayer::setAlgorithm(ConvAlgorithm algo) noexcept
+{
+    if (algo == ConvAlgorithm::Auto)
+        algo = (_inCh * _K <= DIRECT_MAX_TAPS) ? ConvAlgorithm::Direct : ConvAlgorithm::Im2Col;
+    _algo = algo;
+}
+
+void Conv1DLayer::setWeights(const Eigen::MatrixXd& W)
+{
+    if (W.rows() != _W.rows() || W.cols() != _W.cols())
+        throw std::invalid_argument("Conv1DLayer::setWeights: expected [outCh × inCh*K]");
+    _W = W;
+}
+
+void Conv1DLayer::setBias(const Eigen::VectorXd& b)
+{
+    if (b.size() != _b.size())
+        throw std::invalid_argument("Conv1DLayer::setBias: expected [outCh]");
+    _b = b;
+}
+
 void Conv1DLayer::reshuffleWeights()
 {
     std::mt19937 rng(std::random_device{}());
@@ -57,69 +80,188 @@ void Conv1DLayer::reshuffleWeights()
     _b.setZero();
 }
 
-const std::vector<double>& Conv1DLayer::forward(const std::vector<double>& in)
+// Samples per cache block: each block's patch, output and gradient columns are
+// processed end to end (im2col → GEMM → activation, and the reverse in
+// backward) while they are still resident, instead of streaming the whole
+// batch through memory once per stage.
+Eigen::Index Conv1DLayer::_blockSamples() const noexcept
 {
-    assert(in.size() == _inCh * _inLen);
+    constexpr size_t BLOCK_DOUBLES = 32 * 1024; // ~256 KiB per block buffer
+    const size_t rows = std::max(_inCh * _K, _outCh);
+    return static_cast<Eigen::Index>(std::max<size_t>(1, BLOCK_DOUBLES / (rows * _outLen)));
+}
 
-    // Build im2col matrix: _Xcol [inCh*K × outLen]
-    for (size_t t = 0; t < _outLen; ++t)
-        for (size_t ci = 0; ci < _inCh; ++ci)
-            for (size_t k = 0; k < _K; ++k)
-                _Xcol(static_cast<Eigen::Index>(ci * _K + k), static_cast<Eigen::Index>(t))
-                    = in[ci * _inLen + t + k];
+// im2col of samples [n0, n1) of the saved input into _Xcol [inCh*K × nb*outLen].
+// Patch row (ci, k) of sample n is the contiguous input run starting at
+// ci*inLen + k, so each row segment is a straight copy.
+void Conv1DLayer::_im2col(Eigen::Index n0, Eigen::Index n1)
+{
+    const auto inLen = static_cast<Eigen::Index>(_inLen);
+    const auto L = static_cast<Eigen::Index>(_outLen);
+    const auto K = static_cast<Eigen::Index>(_K);
+    const auto Cin = static_cast<Eigen::Index>(_inCh);
 
-    // Y_pre = W * Xcol + b (broadcast)  [outCh × outLen]
-    Eigen::MatrixXd Ypre = _W * _Xcol;
-    Ypre.colwise() += _b;
+    _Xcol.resize(Cin * K, (n1 - n0) * L);
+    for (Eigen::Index n = n0; n < n1; ++n) {
+        const double* x = _Xin.col(n).data();
+        for (Eigen::Index ci = 0; ci < Cin; ++ci)
+            for (Eigen::Index k = 0; k < K; ++k)
+                _Xcol.row(ci * K + k).segment((n - n0) * L, L)
+                    = Eigen::Map<const Eigen::RowVectorXd>(x + ci * inLen + k, L);
+    }
+}
+
+// Convolves the N samples held in _Xin (one per column).
+// Column n*outLen + t of the patch / output matrices belongs to sample n, step t.
+void Conv1DLayer::_forward()
+{
+    using RowMap = Eigen::Map<const Eigen::RowVectorXd>;
+    const auto inSz = static_cast<Eigen::Index>(_inCh * _inLen);
+    const auto inLen = static_cast<Eigen::Index>(_inLen);
+    const auto L = static_cast<Eigen::Index>(_outLen);
+    const auto K = static_cast<Eigen::Index>(_K);
+    const auto Cin = static_cast<Eigen::Index>(_inCh);
+    const auto Cout = static_cast<Eigen::Index>(_outCh);
+    const Eigen::Index NB = _blockSamples();
+    const Eigen::Index N = _Xin.cols();
+    const double* in = _Xin.data();
 
-    // Apply activation; save _Yact for backward.
-    _Yact = Ypre.unaryExpr([a = _act](double x) { return act::forward(a, x); });
+    _N = N;
+    _Yact.resize(Cout, N * L);
 
-    // Flatten to output vector.
-    for (size_t co = 0; co < _outCh; ++co)
-        for (size_t t = 0; t < _outLen; ++t)
-            _out[co * _outLen + t]
-                = _Yact(static_cast<Eigen::Index>(co), static_cast<Eigen::Index>(t));
+    for (Eigen::Index n0 = 0; n0 < N; n0 += NB) {
+        const Eigen::Index n1 = std::min(N, n0 + NB);
+        auto Y = _Yact.middleCols(n0 * L, (n1 - n0) * L);
 
-    return _out;
+        if (_algo == ConvAlgorithm::Im2Col) {
+            // Y_pre = W * Xcol + b (broadcast)  [outCh × nb*outLen]
+            _im2col(n0, n1);
+            Y.noalias() = _W * _Xcol;
+            Y.colwise() += _b;
+        } else {
+            // Direct: y[co] = b[co] + Σ_{ci,k} W(co, ci*K+k) · x[ci][k .. k+outLen)
+            for (Eigen::Index n = n0; n < n1; ++n) {
+                for (Eigen::Index co = 0; co < Cout; ++co) {
+                    auto y = _Yact.row(co).segment(n * L, L);
+                    y.setConstant(_b(co));
+                    for (Eigen::Index ci = 0; ci < Cin; ++ci)
+                        for (Eigen::Index k = 0; k < K; ++k)
+                            y += _W(co, ci * K + k) * RowMap(in + n * inSz + ci * inLen + k, L);
+                }
+            }
+        }
+
+        // Apply activation in place; _Yact is kept for backward.
+        Y = Y.unaryExpr([a = _act](double x) { return act::forward(a, x); });
+    }
 }
 
-std::vector<double> Conv1DLayer::backward(const std::vector<double>& gradOut, double lr)
+void Conv1DLayer::_backward(const double* gradOut, double* gradIn, Eigen::Index N, double lr)
 {
-    assert(gradOut.size() == _outCh * _outLen);
+    using RowMap = Eigen::Map<const Eigen::RowVectorXd>;
+    using MutRowMap = Eigen::Map<Eigen::RowVectorXd>;
+    assert(N == _N && "Conv1DLayer: backward batch size differs from last forward");
+    const auto inSz = static_cast<Eigen::Index>(_inCh * _inLen);
+    const auto outSz = static_cast<Eigen::Index>(_outCh * _outLen);
+    const auto inLen = static_cast<Eigen::Index>(_inLen);
+    const auto L = static_cast<Eigen::Index>(_outLen);
+    const auto K = static_cast<Eigen::Index>(_K);
+    const auto Cin = static_cast<Eigen::Index>(_inCh);
+    const auto Cout = static_cast<Eigen::Index>(_outCh);
+    const Eigen::Index NB = _blockSamples();
+
+    _dY.resize(Cout, N * L);
+    _dW.setZero();
+    std::fill(gradIn, gradIn + N * inSz, 0.0);
 
-    // Unflatten incoming gradient.
-    Eigen::MatrixXd dYact(static_cast<Eigen::Index>(_outCh), static_cast<Eigen::Index>(_outLen));
-    for (size_t co = 0; co < _outCh; ++co)
-        for (size_t t = 0; t < _outLen; ++t)
-            dYact(static_cast<Eigen::Index>(co), static_cast<Eigen::Index>(t))
-                = gradOut[co * _outLen + t];
+    for (Eigen::Index n0 = 0; n0 < N; n0 += NB) {
+        const Eigen::Index n1 = std::min(N, n0 + NB);
+        const Eigen::Index c0 = n0 * L, nc = (n1 - n0) * L;
+        auto dY = _dY.middleCols(c0, nc);
 
-    // Activation backward: chain rule through activation.
-    const Eigen::MatrixXd dY
-        = dYact.cwiseProduct(_Yact.unaryExpr([a = _act](double y) { return act::backward(a, y); }));
+        // Unflatten incoming gradient and chain through the activation.
+        for (Eigen::Index n = n0; n < n1; ++n)
+            for (Eigen::Index co = 0; co < Cout; ++co)
+                _dY.row(co).segment(n * L, L) = RowMap(gradOut + n * outSz + co * L, L);
+        dY = dY.cwiseProduct(_Yact.middleCols(c0, nc).unaryExpr(
+            [a = _act](double y) { return act::backward(a, y); }));
 
-    // Weight gradients.
-    const Eigen::MatrixXd dW = dY * _Xcol.transpose(); // [outCh × inCh*K]
-    const Eigen::VectorXd db = dY.rowwise().sum(); // [outCh]
+        // Input gradient is computed before the update, while W is still unchanged.
+        if (_algo == ConvAlgorithm::Im2Col) {
+            // Patches of a single-block batch are still in _Xcol from forward.
+            if (N > NB)
+                _im2col(n0, n1);
+            _dW.noalias() += dY * _Xcol.transpose(); // [outCh × inCh*K]
+            _dXcol.resize(Cin * K, nc);
+            _dXcol.noalias() = _W.transpose() * dY; // [inCh*K × nb*outLen]
 
-    // Input gradient (before update, while W is still unchanged).
-    const Eigen::MatrixXd dXcol = _W.transpose() * dY; // [inCh*K × outLen]
+            // col2im: patch row (ci, k) accumulates onto input run ci*inLen + k.
+            for (Eigen::Index n = n0; n < n1; ++n)
+                for (Eigen::Index ci = 0; ci < Cin; ++ci)
+                    for (Eigen::Index k = 0; k < K; ++k)
+                        MutRowMap(gradIn + n * inSz + ci * inLen + k, L)
+                            += _dXcol.row(ci * K + k).segment((n - n0) * L, L);
+        } else {
+            for (Eigen::Index n = n0; n < n1; ++n) {
+                for (Eigen::Index co = 0; co < Cout; ++co) {
+                    const auto dy = _dY.row(co).segment(n * L, L);
+                    for (Eigen::Index ci = 0; ci < Cin; ++ci) {
+                        for (Eigen::Index k = 0; k < K; ++k) {
+                            const Eigen::Index off = n * inSz + ci * inLen + k;
+                            _dW(co, ci * K + k) += dy.dot(RowMap(_Xin.data() + off, L));
+                            MutRowMap(gradIn + off, L) += _W(co, ci * K + k) * dy;
+                        }
+                    }
+                }
+            }
+        }
+    }
 
-    // SGD update.
+    // SGD update with gradients averaged over the batch.
     const double useLr = (lr > 0.0) ? lr : _lr;
-    _W -= useLr * dW;
-    _b -= useLr * db;
+    const double lrN = useLr / static_cast<double>(N);
+    _W -= lrN * _dW;
+    _b -= lrN * _dY.rowwise().sum();
+}
+
+const std::vector<double>& Conv1DLayer::forward(const std::vector<double>& in)
+{
+    assert(in.size() == _inCh * _inLen);
+    _Xin = Eigen::Map<const Eigen::MatrixXd>(in.data(), static_cast<Eigen::Index>(in.size()), 1);
+    _forward();
+    // With N = 1 the row-major [outCh × outLen] buffer is already channel-major flat.
+    std::copy(_Yact.data(), _Yact.data() + _Yact.size(), _out.begin());
+    return _out;
+}
 
-    // Col2im: accumulate dXcol → grad_in [inCh * inLen]
-    std::vector<double> gradIn(_inCh * _inLen, 0.0);
-    for (size_t t = 0; t < _outLen; ++t)
-        for (size_t ci = 0; ci < _inCh; ++ci)
-            for (size_t k = 0; k < _K; ++k)
-                gradIn[ci * _inLen + t + k]
-                    += dXcol(static_cast<Eigen::Index>(ci * _K + k), static_cast<Eigen::Index>(t));
+const std::vector<double>& Conv1DLayer::backward(const std::vector<double>& gradOut, double lr)
+{
+    assert(gradOut.size() == _outCh * _outLen);
+    _backward(gradOut.data(), _gradIn.data(), 1, lr);
+    return _gradIn;
+}
+
+const Eigen::MatrixXd& Conv1DLayer::forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in)
+{
+    assert(static_cast<size_t>(in.rows()) == _inCh * _inLen);
+    const Eigen::Index N = in.cols();
+    const auto L = static_cast<Eigen::Index>(_outLen);
+    _Xin = in;
+    _forward();
 
-    return gradIn;
+    _outBatch.resize(static_cast<Eigen::Index>(_outCh * _outLen), N);
+    for (Eigen::Index n = 0; n < N; ++n)
+        for (Eigen::Index co = 0; co < static_cast<Eigen::Index>(_outCh); ++co)
+            _outBatch.col(n).segment(co * L, L) = _Yact.row(co).segment(n * L, L).transpose();
+    return _outBatch;
+}
+
+const Eigen::MatrixXd& Conv1DLayer::backwardBatch(const Eigen::MatrixXd& gradOut, double lr)
+{
+    assert(static_cast<size_t>(gradOut.rows()) == _outCh * _outLen);
+    _gradInBatch.resize(static_cast<Eigen::Index>(_inCh * _inLen), gradOut.cols());
+    _backward(gradOut.data(), _gradInBatch.data(), gradOut.cols(), lr);
+    return _gradInBatch;
 }
 
 // ── MaxPool1DLayer ────────────────────────────────────────────────────────────
@@ -131,6 +273,7 @@ MaxPool1DLayer::MaxPool1DLayer(size_t channels, size_t inLength, size_t poolSize
     , _outLen(poolSize > 0 ? inLength / poolSize : 0)
     , _maxIdx(channels * (poolSize > 0 ? inLength / poolSize : 0), 0)
     , _out(channels * (poolSize > 0 ? inLength / poolSize : 0), 0.0)
+    , _gradIn(channels * inLength, 0.0)
 {
     if (channels == 0 || inLength == 0 || poolSize == 0)
         throw std::invalid_argument("MaxPool1DLayer: dimensions must be > 0");
@@ -160,14 +303,350 @@ const std::vector<double>& MaxPool1DLayer::forward(const std::vector<double>& in
     return _out;
 }
 
-std::vector<double> MaxPool1DLayer::backward(const std::vector<double>& gradOut, double /*lr*/)
+const std::vector<double>& MaxPool1DLayer::backward(
+    const std::vector<double>& gradOut, double /*lr*/)
 {
     assert(gradOut.size() == _ch * _outLen);
-    std::vector<double> gradIn(_ch * _inLen, 0.0);
+    std::fill(_gradIn.begin(), _gradIn.end(), 0.0);
     for (size_t c = 0; c < _ch; ++c)
         for (size_t w = 0; w < _outLen; ++w)
-            gradIn[_maxIdx[c * _outLen + w]] += gradOut[c * _outLen + w];
-    return gradIn;
+            _gradIn[_maxIdx[c * _outLen + w]] += gradOut[c * _outLen + w];
+    return _gradIn;
+}
+
+const Eigen::MatrixXd& MaxPool1DLayer::forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in)
+{
+    assert(static_cast<size_t>(in.rows()) == _ch * _inLen);
+    const Eigen::Index N = in.cols();
+    const auto outSz = static_cast<Eigen::Index>(_ch * _outLen);
+    _outBatch.resize(outSz, N);
+    _maxIdxBatch.resize(outSz, N);
+
+    for (Eigen::Index n = 0; n < N; ++n) {
+        for (size_t c = 0; c < _ch; ++c) {
+            for (size_t w = 0; w < _outLen; ++w) {
+                const auto base = static_cast<Eigen::Index>(c * _inLen + w * _P);
+                const auto o = static_cast<Eigen::Index>(c * _outLen + w);
+                Eigen::Index p = 0;
+                _outBatch(o, n)
+                    = in.col(n).segment(base, static_cast<Eigen::Index>(_P)).maxCoeff(&p);
+                _maxIdxBatch(o, n) = base + p;
+            }
+        }
+    }
+    return _outBatch;
+}
+
+const Eigen::MatrixXd& MaxPool1DLayer::backwardBatch(const Eigen::MatrixXd& gradOut, double /*lr*/)
+{
+    assert(gradOut.rows() == _maxIdxBatch.rows() && gradOut.cols() == _maxIdxBatch.cols());
+    _gradInBatch.setZero(static_cast<Eigen::Index>(_ch * _inLen), gradOut.cols());
+    for (Eigen::Index n = 0; n < gradOut.cols(); ++n)
+        for (Eigen::Index o = 0; o < gradOut.rows(); ++o)
+            _gradInBatch(_maxIdxBatch(o, n), n) += gradOut(o, n);
+    return _gradInBatch;
+}
+
+// ── Conv2DLayer ───────────────────────────────────────────────────────────────
+
+Conv2DLayer::Conv2DLayer(size_t inChannels, size_t inHeight, size_t inWidth, size_t outChannels,
+    size_t kernelHeight, size_t kernelWidth, Activation act, double lr)
+    : _inCh(inChannels)
+    , _inH(inHeight)
+    , _inW(inWidth)
+    , _outCh(outChannels)
+    , _kH(kernelHeight)
+    , _kW(kernelWidth)
+    , _outH(inHeight >= kernelHeight ? inHeight - kernelHeight + 1 : 0)
+    , _outW(inWidth >= kernelWidth ? inWidth - kernelWidth + 1 : 0)
+    , _act(act)
+    , _lr(lr)
+    , _W(Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(outChannels),
+          static_cast<Eigen::Index>(inChannels * kernelHeight * kernelWidth)))
+    , _b(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(outChannels)))
+    , _dW(Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(outChannels),
+          static_cast<Eigen::Index>(inChannels * kernelHeight * kernelWidth)))
+    , _out(outChannels * _outH * _outW, 0.0)
+    , _gradIn(inChannels * inHeight * inWidth, 0.0)
+{
+    if (inChannels == 0 || outChannels == 0 || kernelHeight == 0 || kernelWidth == 0)
+        throw std::invalid_argument("Conv2DLayer: dimensions must be > 0");
+    if (inHeight < kernelHeight || inWidth < kernelWidth)
+        throw std::invalid_argument("Conv2DLayer: input must be at least as large as the kernel");
+    reshuffleWeights();
+}
+
+void Conv2DLayer::setWeights(const Eigen::MatrixXd& W)
+{
+    if (W.rows() != _W.rows() || W.cols() != _W.cols())
+        throw std::invalid_argument("Conv2DLayer::setWeights: expected [outCh × inCh*kH*kW]");
+    _W = W;
+}
+
+void Conv2DLayer::setBias(const Eigen::VectorXd& b)
+{
+    if (b.size() != _b.size())
+        throw std::invalid_argument("Conv2DLayer::setBias: expected [outCh]");
+    _b = b;
+}
+
+void Conv2DLayer::reshuffleWeights()
+{
+    std::mt19937 rng(std::random_device{}());
+    const double fan_in = static_cast<double>(_inCh * _kH * _kW);
+    const double scale = (_act == Activation::ReLU || _act == Activation::LeakyReLU)
+        ? std::sqrt(2.0 / fan_in)
+        : std::sqrt(1.0 / fan_in);
+    std::normal_distribution<double> dist(0.0, scale);
+    for (Eigen::Index r = 0; r < _W.rows(); ++r)
+        for (Eigen::Index c = 0; c < _W.cols(); ++c)
+            _W(r, c) = dist(rng);
+    _b.setZero();
+}
+
+Eigen::Index Conv2DLayer::_blockSamples() const noexcept
+{
+    constexpr size_t BLOCK_DOUBLES = 32 * 1024;
+    const size_t rows = std::max(_inCh * _kH * _kW, _outCh);
+    return static_cast<Eigen::Index>(
+        std::max<size_t>(1, BLOCK_DOUBLES / (rows * _outH * _outW)));
+}
+
+// Patch row (ci, i, j) of output row oh is the contiguous input run starting
+// at ci*inH*inW + (oh+i)*inW + j, so im2col is outH straight copies per row.
+void Conv2DLayer::_im2col(Eigen::Index n0, Eigen::Index n1)
+{
+    const auto inW = static_cast<Eigen::Index>(_inW);
+    const auto inHW = static_cast<Eigen::Index>(_inH * _inW);
+    const auto OH = static_cast<Eigen::Index>(_outH);
+    const auto OW = static_cast<Eigen::Index>(_outW);
+    const auto kH = static_cast<Eigen::Index>(_kH);
+    const auto kW = static_cast<Eigen::Index>(_kW);
+    const auto Cin = static_cast<Eigen::Index>(_inCh);
+
+    _Xcol.resize(Cin * kH * kW, (n1 - n0) * OH * OW);
+    for (Eigen::Index n = n0; n < n1; ++n) {
+        const double* x = _Xin.col(n).data();
+        const Eigen::Index c0 = (n - n0) * OH * OW;
+        for (Eigen::Index ci = 0; ci < Cin; ++ci)
+            for (Eigen::Index i = 0; i < kH; ++i)
+                for (Eigen::Index j = 0; j < kW; ++j) {
+                    auto row = _Xcol.row((ci * kH + i) * kW + j);
+                    for (Eigen::Index oh = 0; oh < OH; ++oh)
+                        row.segment(c0 + oh * OW, OW) = Eigen::Map<const Eigen::RowVectorXd>(
+                            x + ci * inHW + (oh + i) * inW + j, OW);
+                }
+    }
+}
+
+void Conv2DLayer::_forward()
+{
+    const auto OHW = static_cast<Eigen::Index>(_outH * _outW);
+    const auto Cout = static_cast<Eigen::Index>(_outCh);
+    const Eigen::Index NB = _blockSamples();
+    const Eigen::Index N = _Xin.cols();
+
+    _N = N;
+    _Yact.resize(Cout, N * OHW);
+
+    for (Eigen::Index n0 = 0; n0 < N; n0 += NB) {
+        const Eigen::Index n1 = std::min(N, n0 + NB);
+        auto Y = _Yact.middleCols(n0 * OHW, (n1 - n0) * OHW);
+        _im2col(n0, n1);
+        Y.noalias() = _W * _Xcol;
+        Y.colwise() += _b;
+        Y = Y.unaryExpr([a = _act](double x) { return act::forward(a, x); });
+    }
+}
+
+void Conv2DLayer::_backward(const double* gradOut, double* gradIn, Eigen::Index N, double lr)
+{
+    using RowMap = Eigen::Map<const Eigen::RowVectorXd>;
+    using MutRowMap = Eigen::Map<Eigen::RowVectorXd>;
+    assert(N == _N && "Conv2DLayer: backward batch size differs from last forward");
+    const auto inSz = static_cast<Eigen::Index>(_inCh * _inH * _inW);
+    const auto inW = static_cast<Eigen::Index>(_inW);
+    const auto inHW = static_cast<Eigen::Index>(_inH * _inW);
+    const auto OH = static_cast<Eigen::Index>(_outH);
+    const auto OW = static_cast<Eigen::Index>(_outW);
+    const Eigen::Index OHW = OH * OW;
+    const auto kH = static_cast<Eigen::Index>(_kH);
+    const auto kW = static_cast<Eigen::Index>(_kW);
+    const auto Cin = static_cast<Eigen::Index>(_inCh);
+    const auto Cout = static_cast<Eigen::Index>(_outCh);
+    const Eigen::Index outSz = Cout * OHW;
+    const Eigen::Index NB = _blockSamples();
+
+    _dY.resize(Cout, N * OHW);
+    _dW.setZero();
+    std::fill(gradIn, gradIn + N * inSz, 0.0);
+
+    for (Eigen::Index n0 = 0; n0 < N; n0 += NB) {
+        const Eigen::Index n1 = std::min(N, n0 + NB);
+        const Eigen::Index c0 = n0 * OHW, nc = (n1 - n0) * OHW;
+        auto dY = _dY.middleCols(c0, nc);
+
+        for (Eigen::Index n = n0; n < n1; ++n)
+            for (Eigen::Index co = 0; co < Cout; ++co)
+                _dY.row(co).segment(n * OHW, OHW) = RowMap(gradOut + n * outSz + co * OHW, OHW);
+        dY = dY.cwiseProduct(_Yact.middleCols(c0, nc).unaryExpr(
+            [a = _act](double y) { return act::backward(a, y); }));
+
+        if (N > NB)
+            _im2col(n0, n1);
+        _dW.noalias() += dY * _Xcol.transpose();
+        _dXcol.resize(Cin * kH * kW, nc);
+        _dXcol.noalias() = _W.transpose() * dY;
+
+        // col2im: the reverse of _im2col, accumulating overlapping taps.
+        for (Eigen::Index n = n0; n < n1; ++n) {
+            double* g = gradIn + n * inSz;
+            const Eigen::Index s0 = (n - n0) * OHW;
+            for (Eigen::Index ci = 0; ci < Cin; ++ci)
+                for (Eigen::Index i = 0; i < kH; ++i)
+                    for (Eigen::Index j = 0; j < kW; ++j) {
+                        const auto row = _dXcol.row((ci * kH + i) * kW + j);
+                        for (Eigen::Index oh = 0; oh < OH; ++oh)
+                            MutRowMap(g + ci * inHW + (oh + i) * inW + j, OW)
+                                += row.segment(s0 + oh * OW, OW);
+                    }
+        }
+    }
+
+    const double useLr = (lr > 0.0) ? lr : _lr;
+    const double lrN = useLr / static_cast<double>(N);
+    _W -= lrN * _dW;
+    _b -= lrN * _dY.rowwise().sum();
+}
+
+const std::vector<double>& Conv2DLayer::forward(const std::vector<double>& in)
+{
+    assert(in.size() == _inCh * _inH * _inW);
+    _Xin = Eigen::Map<const Eigen::MatrixXd>(in.data(), static_cast<Eigen::Index>(in.size()), 1);
+    _forward();
+    std::copy(_Yact.data(), _Yact.data() + _Yact.size(), _out.begin());
+    return _out;
+}
+
+const std::vector<double>& Conv2DLayer::backward(const std::vector<double>& gradOut, double lr)
+{
+    assert(gradOut.size() == _outCh * _outH * _outW);
+    _backward(gradOut.data(), _gradIn.data(), 1, lr);
+    return _gradIn;
+}
+
+const Eigen::MatrixXd& Conv2DLayer::forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in)
+{
+    assert(static_cast<size_t>(in.rows()) == _inCh * _inH * _inW);
+    const Eigen::Index N = in.cols();
+    const auto OHW = static_cast<Eigen::Index>(_outH * _outW);
+    _Xin = in;
+    _forward();
+
+    _outBatch.resize(static_cast<Eigen::Index>(_outCh) * OHW, N);
+    for (Eigen::Index n = 0; n < N; ++n)
+        for (Eigen::Index co = 0; co < static_cast<Eigen::Index>(_outCh); ++co)
+            _outBatch.col(n).segment(co * OHW, OHW)
+                = _Yact.row(co).segment(n * OHW, OHW).transpose();
+    return _outBatch;
+}
+
+const Eigen::MatrixXd& Conv2DLayer::backwardBatch(const Eigen::MatrixXd& gradOut, double lr)
+{
+    assert(static_cast<size_t>(gradOut.rows()) == _outCh * _outH * _outW);
+    _gradInBatch.resize(static_cast<Eigen::Index>(_inCh * _inH * _inW), gradOut.cols());
+    _backward(gradOut.data(), _gradInBatch.data(), gradOut.cols(), lr);
+    return _gradInBatch;
+}
+
+// ── MaxPool2DLayer ────────────────────────────────────────────────────────────
+
+MaxPool2DLayer::MaxPool2DLayer(
+    size_t channels, size_t inHeight, size_t inWidth, size_t poolHeight, size_t poolWidth)
+    : _ch(channels)
+    , _inH(inHeight)
+    , _inW(inWidth)
+    , _pH(poolHeight)
+    , _pW(poolWidth)
+    , _outH(poolHeight > 0 ? inHeight / poolHeight : 0)
+    , _outW(poolWidth > 0 ? inWidth / poolWidth : 0)
+    , _out(channels * _outH * _outW, 0.0)
+    , _gradIn(channels * inHeight * inWidth, 0.0)
+{
+    if (channels == 0 || inHeight == 0 || inWidth == 0 || poolHeight == 0 || poolWidth == 0)
+        throw std::invalid_argument("MaxPool2DLayer: dimensions must be > 0");
+    if (inHeight < poolHeight || inWidth < poolWidth)
+        throw std::invalid_argument("MaxPool2DLayer: input must be at least as large as the pool");
+}
+
+const Eigen::MatrixXd& MaxPool2DLayer::forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& in)
+{
+    assert(static_cast<size_t>(in.rows()) == _ch * _inH * _inW);
+    const Eigen::Index N = in.cols();
+    const auto inW = static_cast<Eigen::Index>(_inW);
+    const auto inHW = static_cast<Eigen::Index>(_inH * _inW);
+    const auto OH = static_cast<Eigen::Index>(_outH);
+    const auto OW = static_cast<Eigen::Index>(_outW);
+    const auto pH = static_cast<Eigen::Index>(_pH);
+    const auto pW = static_cast<Eigen::Index>(_pW);
+    const auto outSz = static_cast<Eigen::Index>(_ch) * OH * OW;
+    _outBatch.resize(outSz, N);
+    _maxIdx.resize(outSz, N);
+
+    for (Eigen::Index n = 0; n < N; ++n) {
+        const auto x = in.col(n);
+        Eigen::Index o = 0;
+        for (Eigen::Index c = 0; c < static_cast<Eigen::Index>(_ch); ++c) {
+            for (Eigen::Index oh = 0; oh < OH; ++oh) {
+                for (Eigen::Index ow = 0; ow < OW; ++ow, ++o) {
+                    // Scan the window one contiguous row segment at a time.
+                    const Eigen::Index base = c * inHW + oh * pH * inW + ow * pW;
+                    double maxVal = -std::numeric_limits<double>::max();
+                    Eigen::Index maxPos = base;
+                    for (Eigen::Index i = 0; i < pH; ++i) {
+                        Eigen::Index p = 0;
+                        const double v = x.segment(base + i * inW, pW).maxCoeff(&p);
+                        if (v > maxVal) {
+                            maxVal = v;
+                            maxPos = base + i * inW + p;
+                        }
+                    }
+                    _outBatch(o, n) = maxVal;
+                    _maxIdx(o, n) = maxPos;
+                }
+            }
+        }
+    }
+    return _outBatch;
+}
+
+const Eigen::MatrixXd& MaxPool2DLayer::backwardBatch(const Eigen::MatrixXd& gradOut, double /*lr*/)
+{
+    assert(gradOut.rows() == _maxIdx.rows() && gradOut.cols() == _maxIdx.cols());
+    _gradInBatch.setZero(static_cast<Eigen::Index>(_ch * _inH * _inW), gradOut.cols());
+    for (Eigen::Index n = 0; n < gradOut.cols(); ++n)
+        for (Eigen::Index o = 0; o < gradOut.rows(); ++o)
+            _gradInBatch(_maxIdx(o, n), n) += gradOut(o, n);
+    return _gradInBatch;
+}
+
+const std::vector<double>& MaxPool2DLayer::forward(const std::vector<double>& in)
+{
+    assert(in.size() == _ch * _inH * _inW);
+    const auto& Y = forwardBatch(
+        Eigen::Map<const Eigen::MatrixXd>(in.data(), static_cast<Eigen::Index>(in.size()), 1));
+    std::copy(Y.data(), Y.data() + Y.size(), _out.begin());
+    return _out;
+}
+
+const std::vector<double>& MaxPool2DLayer::backward(
+    const std::vector<double>& gradOut, double /*lr*/)
+{
+    assert(gradOut.size() == _out.size() && _maxIdx.cols() == 1);
+    std::fill(_gradIn.begin(), _gradIn.end(), 0.0);
+    for (Eigen::Index o = 0; o < _maxIdx.rows(); ++o)
+        _gradIn[static_cast<size_t>(_maxIdx(o, 0))] += gradOut[static_cast<size_t>(o)];
+    return _gradIn;
 }
 
 } // namespace nu
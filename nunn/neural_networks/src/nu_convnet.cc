@@ -15,30 +15,61 @@ namespace nu {
 // ── Construction ──────────────────────────────────────────────────────────────
 
 ConvNet::ConvNet(size_t inChannels, size_t inLength)
+    : ConvNet(inChannels, 1, inLength)
+{
+}
+
+ConvNet::ConvNet(size_t inChannels, size_t inHeight, size_t inWidth)
     : _inCh(inChannels)
-    , _inLen(inLength)
+    , _inH(inHeight)
+    , _inW(inWidth)
     , _curCh(inChannels)
-    , _curLen(inLength)
+    , _curH(inHeight)
+    , _curW(inWidth)
 {
-    if (inChannels == 0 || inLength == 0)
-        throw std::invalid_argument("ConvNet: inChannels and inLength must be > 0");
+    if (inChannels == 0 || inHeight == 0 || inWidth == 0)
+        throw std::invalid_argument("ConvNet: input dimensions must be > 0");
 }
 
 // ── Layer builders ────────────────────────────────────────────────────────────
 
 ConvNet& ConvNet::addConv1D(size_t outChannels, size_t kernelSize, Activation act, double lr)
 {
+    if (_curH != 1)
+        throw std::logic_error("ConvNet::addConv1D: feature maps are 2D, use addConv2D()");
     _layers.push_back(
-        std::make_unique<Conv1DLayer>(_curCh, _curLen, outChannels, kernelSize, act, lr));
+        std::make_unique<Conv1DLayer>(_curCh, _curW, outChannels, kernelSize, act, lr));
     _curCh = outChannels;
-    _curLen = _curLen - kernelSize + 1;
+    _curW = _curW - kernelSize + 1;
     return *this;
 }
 
 ConvNet& ConvNet::addMaxPool1D(size_t poolSize)
 {
-    _layers.push_back(std::make_unique<MaxPool1DLayer>(_curCh, _curLen, poolSize));
-    _curLen = _curLen / poolSize;
+    if (_curH != 1)
+        throw std::logic_error("ConvNet::addMaxPool1D: feature maps are 2D, use addMaxPool2D()");
+    _layers.push_back(std::make_unique<MaxPool1DLayer>(_curCh, _curW, poolSize));
+    _curW = _curW / poolSize;
+    return *this;
+}
+
+ConvNet& ConvNet::addConv2D(
+    size_t outChannels, size_t kernelHeight, size_t kernelWidth, Activation act, double lr)
+{
+    _layers.push_back(std::make_unique<Conv2DLayer>(
+        _curCh, _curH, _curW, outChannels, kernelHeight, kernelWidth, act, lr));
+    _curCh = outChannels;
+    _curH = _curH - kernelHeight + 1;
+    _curW = _curW - kernelWidth + 1;
+    return *this;
+}
+
+ConvNet& ConvNet::addMaxPool2D(size_t poolHeight, size_t poolWidth)
+{
+    _layers.push_back(
+        std::make_unique<MaxPool2DLayer>(_curCh, _curH, _curW, poolHeight, poolWidth));
+    _curH = _curH / poolHeight;
+    _curW = _curW / poolWidth;
     return *this;
 }
 
@@ -54,7 +85,7 @@ void ConvNet::setFCHead(const std::vector<MlpMatrixNN::LayerConfig>& fcLayers, d
 
 size_t ConvNet::flatFeatureSize() const noexcept
 {
-    return _curCh * _curLen;
+    return _curCh * _curH * _curW;
 }
 
 size_t ConvNet::outputSize() const noexcept
@@ -101,14 +132,109 @@ double ConvNet::train(const std::vector<double>& input, const std::vector<double
     _fc->backPropagate(target); // updates FC weights
 
     // 3. Get gradient w.r.t. the FC input (= flattened conv output).
+    //    getInputGradient() is W^T * delta with delta = t - a, i.e. -dL/dx;
+    //    the conv layers expect dL/dx.
     const Eigen::VectorXd ig = _fc->getInputGradient();
     std::vector<double> grad(ig.data(), ig.data() + ig.size());
+    for (auto& g : grad)
+        g = -g;
+
+    // 4. Backward through conv/pool layers in reverse; each layer returns a
+    //    reference to its own grad_in buffer.
+    const std::vector<double>* cur = &grad;
+    for (int i = static_cast<int>(_layers.size()) - 1; i >= 0; --i)
+        cur = &_layers[static_cast<size_t>(i)]->backward(*cur, 0.0);
+
+    return loss;
+}
+
+// ── Batched forward / train ───────────────────────────────────────────────────
+
+Eigen::MatrixXd ConvNet::_toColumns(const std::vector<std::vector<double>>& v, size_t rows)
+{
+    Eigen::MatrixXd M(static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(v.size()));
+    for (size_t j = 0; j < v.size(); ++j) {
+        if (v[j].size() != rows)
+            throw std::invalid_argument("ConvNet: sample size mismatch in batch");
+        M.col(static_cast<Eigen::Index>(j))
+            = Eigen::Map<const Eigen::VectorXd>(v[j].data(), static_cast<Eigen::Index>(rows));
+    }
+    return M;
+}
+
+Eigen::Ref<const Eigen::MatrixXd> ConvNet::_forwardConvBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X)
+{
+    if (_layers.empty())
+        return X;
+    const Eigen::MatrixXd* cur = &_layers.front()->forwardBatch(X);
+    for (size_t i = 1; i < _layers.size(); ++i)
+        cur = &_layers[i]->forwardBatch(*cur);
+    return *cur;
+}
+
+Eigen::MatrixXd ConvNet::predictBatch(const Eigen::Ref<const Eigen::MatrixXd>& X)
+{
+    if (!_fc)
+        throw std::logic_error("ConvNet::predictBatch: call setFCHead() before predictBatch()");
+    if (X.rows() != static_cast<Eigen::Index>(inputSize()))
+        throw std::invalid_argument("ConvNet::predictBatch: X must be [inputSize × B]");
+    return _fc->feedForwardBatch(_forwardConvBatch(X));
+}
+
+std::vector<std::vector<double>> ConvNet::predictBatch(
+    const std::vector<std::vector<double>>& inputs)
+{
+    if (!_fc)
+        throw std::logic_error("ConvNet::predictBatch: call setFCHead() before predictBatch()");
+    std::vector<std::vector<double>> out;
+    if (inputs.empty())
+        return out;
+    const Eigen::MatrixXd Y = predictBatch(_toColumns(inputs, inputSize()));
+    out.reserve(inputs.size());
+    for (Eigen::Index j = 0; j < Y.cols(); ++j)
+        out.emplace_back(Y.col(j).data(), Y.col(j).data() + Y.rows());
+    return out;
+}
 
-    // 4. Backward through conv/pool layers in reverse.
+double ConvNet::trainBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, const Eigen::Ref<const Eigen::MatrixXd>& T)
+{
+    if (!_fc)
+        throw std::logic_error("ConvNet::trainBatch: call setFCHead() before trainBatch()");
+    if (X.cols() == 0 || X.cols() != T.cols() || X.rows() != static_cast<Eigen::Index>(inputSize()))
+        throw std::invalid_argument(
+            "ConvNet::trainBatch: X must be [inputSize × B] with B > 0 and T must have B columns");
+
+    // 1. Forward through conv/pool layers, whole batch at once.
+    const auto flat = _forwardConvBatch(X);
+
+    // 2. Forward + backward + update of the FC head; also yields W^T * delta
+    //    per sample, which is -dL/dx (see train()).
+    const double loss = _fc->trainBatch(flat, T, &_fcGrad);
+    if (_layers.empty())
+        return loss;
+    _fcGrad = -_fcGrad;
+
+    // 3. Backward through conv/pool layers in reverse; each averages its
+    //    parameter gradients over the batch.
+    const Eigen::MatrixXd* cur = &_fcGrad;
     for (int i = static_cast<int>(_layers.size()) - 1; i >= 0; --i)
-        grad = _layers[static_cast<size_t>(i)]->backward(grad, 0.0);
+        cur = &_layers[static_cast<size_t>(i)]->backwardBatch(*cur, 0.0);
 
     return loss;
 }
 
+double ConvNet::trainBatch(const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets)
+{
+    if (!_fc)
+        throw std::logic_error("ConvNet::trainBatch: call setFCHead() before trainBatch()");
+    if (inputs.empty() || inputs.size() != targets.size())
+        throw std::invalid_argument(
+            "ConvNet::trainBatch: batch must be non-empty and inputs/targets must have the "
+            "same size");
+    return trainBatch(_toColumns(inputs, inputSize()), _toColumns(targets, outputSize()));
+}
+
 } // namespace nu
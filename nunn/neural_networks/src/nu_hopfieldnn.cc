@@ -7,6 +7,8 @@
 //
 
 #include "nu_hopfieldnn.h"
+
+#include <Eigen/Dense>
 #include <algorithm>
 #include <numeric>
 #include <random>
@@ -16,6 +18,36 @@
 
 namespace nu {
 
+namespace {
+
+// sgn(H) with ties resolved to the previous state.
+Eigen::MatrixXd threshold(const Eigen::MatrixXd& H, const Eigen::Ref<const Eigen::MatrixXd>& S)
+{
+    return (H.array() > 0.0).select(1.0, (H.array() < 0.0).select(-1.0, S.array())).matrix();
+}
+
+} // namespace
+
+Eigen::Map<HopfieldNN::RowMatrix> HopfieldNN::_weights() noexcept
+{
+    const auto n = static_cast<Eigen::Index>(getInputSize());
+    return Eigen::Map<RowMatrix>(_w.to_stdvec().data(), n, n);
+}
+
+void HopfieldNN::setBlockSize(size_t blockSize)
+{
+    if (blockSize == 0)
+        throw std::invalid_argument("HopfieldNN: block size must be positive");
+    _blockSize = blockSize;
+}
+
+void HopfieldNN::setMaxIterations(size_t maxIterations)
+{
+    if (maxIterations == 0)
+        throw std::invalid_argument("HopfieldNN: max iterations must be positive");
+    _maxIterations = maxIterations;
+}
+
 void HopfieldNN::clear() noexcept
 {
     std::fill(_s.begin(), _s.end(), 0.0); // Reset neuron states to all zeros
@@ -31,16 +63,30 @@ void HopfieldNN::addPattern(const FpVector& input_pattern)
         throw SizeMismatchException();
     }
 
-    for (size_t i = 0; i < size; ++i) {
-        for (size_t j = 0; j < size; ++j) {
-            if (i != j)
-                _w[i * size + j] += input_pattern[i] * input_pattern[j];
-        }
-    }
+    const Eigen::Map<const Eigen::VectorXd> p(
+        input_pattern.to_stdvec().data(), static_cast<Eigen::Index>(size));
+
+    // Rank-1 Hebbian update; the diagonal (self-connections) is left as is.
+    auto W = _weights();
+    W.noalias() += p * p.transpose();
+    W.diagonal() -= p.cwiseAbs2();
 
     ++_patternSize;
 }
 
+void HopfieldNN::addPatterns(const Eigen::Ref<const Eigen::MatrixXd>& patterns)
+{
+    if (static_cast<size_t>(patterns.rows()) != getInputSize()) {
+        throw SizeMismatchException();
+    }
+
+    auto W = _weights();
+    W.noalias() += patterns * patterns.transpose();
+    W.diagonal() -= patterns.rowwise().squaredNorm();
+
+    _patternSize += static_cast<size_t>(patterns.cols());
+}
+
 void HopfieldNN::recall(const FpVector& input_pattern, FpVector& output_pattern)
 {
     if (getInputSize() != input_pattern.size()) {
@@ -48,11 +94,160 @@ void HopfieldNN::recall(const FpVector& input_pattern, FpVector& output_pattern)
     }
 
     _s = input_pattern;
-    _propagate();
+
+    if (_mode == RecallMode::Asynchronous) {
+        _propagate();
+    } else {
+        Eigen::Map<Eigen::VectorXd> s(_s.to_stdvec().data(), static_cast<Eigen::Index>(_s.size()));
+        if (_mode == RecallMode::Synchronous)
+            _recallSynchronous(s);
+        else
+            _recallBlocked(s);
+    }
 
     output_pattern = _s;
 }
 
+Eigen::MatrixXd HopfieldNN::recall(const Eigen::Ref<const Eigen::MatrixXd>& keys)
+{
+    if (static_cast<size_t>(keys.rows()) != getInputSize()) {
+        throw SizeMismatchException();
+    }
+
+    Eigen::MatrixXd S = keys;
+
+    switch (_mode) {
+    case RecallMode::Synchronous:
+        _recallSynchronous(S);
+        break;
+    case RecallMode::Blocked:
+        _recallBlocked(S);
+        break;
+    case RecallMode::Asynchronous:
+        for (Eigen::Index j = 0; j < S.cols(); ++j) {
+            Eigen::Map<Eigen::VectorXd>(_s.to_stdvec().data(), S.rows()) = S.col(j);
+            _propagate();
+            S.col(j) = Eigen::Map<const Eigen::VectorXd>(_s.to_stdvec().data(), S.rows());
+        }
+        break;
+    }
+
+    return S;
+}
+
+// ── Synchronous / blocked dynamics ───────────────────────────────────────────
+
+// Only the queries still moving take part in each product: converged columns
+// are written back to S and dropped from the working set.
+
+void HopfieldNN::_recallSynchronous(Eigen::Ref<Eigen::MatrixXd> S)
+{
+    const auto W = _weights();
+
+    std::vector<Eigen::Index> active(static_cast<size_t>(S.cols()));
+    std::iota(active.begin(), active.end(), Eigen::Index(0));
+
+    Eigen::MatrixXd cur = S;
+    Eigen::MatrixXd prev;
+    Eigen::MatrixXd next;
+    Eigen::MatrixXd H;
+
+    _lastIterations = 0;
+    _lastConverged = true;
+
+    for (size_t it = 1; it <= _maxIterations && !active.empty(); ++it) {
+        H.noalias() = W * cur;
+        next = threshold(H, cur);
+        _lastIterations = it;
+
+        std::vector<Eigen::Index> keep;
+        for (Eigen::Index j = 0; j < next.cols(); ++j) {
+            const bool fixed = next.col(j) == cur.col(j);
+            const bool cycle = !fixed && it > 1 && next.col(j) == prev.col(j);
+            if (fixed || cycle) {
+                S.col(active[size_t(j)]) = next.col(j);
+                _lastConverged = _lastConverged && fixed;
+            } else {
+                keep.push_back(j);
+            }
+        }
+
+        if (keep.size() == active.size()) {
+            prev.swap(cur);
+            cur.swap(next);
+            continue;
+        }
+
+        std::vector<Eigen::Index> stillActive;
+        stillActive.reserve(keep.size());
+        for (auto j : keep)
+            stillActive.push_back(active[size_t(j)]);
+        active.swap(stillActive);
+
+        prev = cur(Eigen::all, keep);
+        cur = next(Eigen::all, keep);
+    }
+
+    for (size_t j = 0; j < active.size(); ++j)
+        S.col(active[j]) = cur.col(Eigen::Index(j));
+    if (!active.empty())
+        _lastConverged = false;
+}
+
+void HopfieldNN::_recallBlocked(Eigen::Ref<Eigen::MatrixXd> S)
+{
+    const auto W = _weights();
+    const Eigen::Index n = W.rows();
+    const auto bs = static_cast<Eigen::Index>(_blockSize);
+
+    std::vector<Eigen::Index> active(static_cast<size_t>(S.cols()));
+    std::iota(active.begin(), active.end(), Eigen::Index(0));
+
+    Eigen::MatrixXd cur = S;
+    Eigen::MatrixXd H;
+    Eigen::MatrixXd next;
+
+    _lastIterations = 0;
+    _lastConverged = true;
+
+    for (size_t sweep = 1; sweep <= _maxIterations && !active.empty(); ++sweep) {
+        std::vector<char> changed(active.size(), 0);
+
+        for (Eigen::Index r0 = 0; r0 < n; r0 += bs) {
+            const Eigen::Index len = std::min(bs, n - r0);
+            H.noalias() = W.middleRows(r0, len) * cur;
+            next = threshold(H, cur.middleRows(r0, len));
+            for (Eigen::Index j = 0; j < cur.cols(); ++j) {
+                if (!changed[size_t(j)] && next.col(j) != cur.col(j).segment(r0, len))
+                    changed[size_t(j)] = 1;
+            }
+            cur.middleRows(r0, len) = next;
+        }
+        _lastIterations = sweep;
+
+        std::vector<Eigen::Index> keep;
+        std::vector<Eigen::Index> stillActive;
+        for (size_t j = 0; j < active.size(); ++j) {
+            if (changed[j]) {
+                keep.push_back(Eigen::Index(j));
+                stillActive.push_back(active[j]);
+            } else {
+                S.col(active[j]) = cur.col(Eigen::Index(j));
+            }
+        }
+
+        if (keep.size() != active.size()) {
+            cur = Eigen::MatrixXd(cur(Eigen::all, keep));
+            active.swap(stillActive);
+        }
+    }
+
+    for (size_t j = 0; j < active.size(); ++j)
+        S.col(active[j]) = cur.col(Eigen::Index(j));
+    if (!active.empty())
+        _lastConverged = false;
+}
+
 void HopfieldNN::_propagate() noexcept
 {
     const size_t size = getInputSize();
@@ -116,12 +311,13 @@ std::stringstream& HopfieldNN::save(std::stringstream& ss) noexcept
 {
     ss.clear();
 
-    ss << ID_ANN << "\n"
-       << _patternSize << "\n"
-       << ID_NEURON_ST << "\n"
-       << _s << "\n"
-       << ID_WEIGHTS << "\n"
-       << _w;
+    // The vectors are written by separate statements so that the
+    // std::stringstream overload (size + values, as read by load()) is picked
+    // rather than the bracketed std::ostream one.
+    ss << ID_ANN << "\n" << _patternSize << "\n" << ID_NEURON_ST << "\n";
+    ss << _s;
+    ss << ID_WEIGHTS << "\n";
+    ss << _w;
 
     return ss;
 }
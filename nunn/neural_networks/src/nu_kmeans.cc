@@ -7,14 +7,133 @@
 //
 
 #include "nu_kmeans.h"
+#include "nu_parallel.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <numeric>
+#include <string>
 
 namespace nu {
 
+namespace {
+
+using Matrix = KMeans::Matrix;
+using RowMap = Eigen::Map<const Eigen::RowVectorXd>;
+
+constexpr size_t MIN_ROWS_PER_THREAD = 1024;
+constexpr Eigen::Index ASSIGN_BLOCK_ROWS = 256;
+constexpr size_t PARALLEL_INIT_ROUNDS = 5;
+
+// Nearest row of C for samples [b, e) of X, as blocked GEMMs:
+// |x - c|^2 = |x|^2 - 2 x.c + |c|^2. Ties go to the lower index. The
+// returned squared distance is recomputed exactly for the chosen centroid.
+void assignBlock(const Eigen::Ref<const Matrix>& X, const Matrix& C,
+    const Eigen::VectorXd& cNorm, size_t b, size_t e, size_t* labels, double* sqDist)
+{
+    Eigen::MatrixXd G;
+    for (auto r0 = static_cast<Eigen::Index>(b); r0 < static_cast<Eigen::Index>(e);
+         r0 += ASSIGN_BLOCK_ROWS) {
+        const Eigen::Index nb = std::min(ASSIGN_BLOCK_ROWS, static_cast<Eigen::Index>(e) - r0);
+        G.noalias() = X.middleRows(r0, nb) * C.transpose();
+        for (Eigen::Index r = 0; r < nb; ++r) {
+            Eigen::Index best = 0;
+            (cNorm.transpose() - 2.0 * G.row(r)).minCoeff(&best);
+            const auto i = static_cast<size_t>(r0 + r);
+            labels[i] = static_cast<size_t>(best);
+            if (sqDist)
+                sqDist[i] = (X.row(r0 + r) - C.row(best)).squaredNorm();
+        }
+    }
+}
+
+// Uniform in [0, 1) from (seed, round, index); independent of thread layout.
+double hashUniform(uint64_t seed, uint64_t round, uint64_t i) noexcept
+{
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (i + 1) + (round << 48);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+// Index sampled with probability proportional to w[i] (k-means++ step).
+size_t sampleProportional(const std::vector<double>& w, std::mt19937& rng)
+{
+    double total = 0.0;
+    for (double v : w)
+        total += v;
+    std::uniform_real_distribution<double> dist(0.0, total);
+    double r = dist(rng);
+    for (size_t i = 0; i < w.size(); ++i) {
+        r -= w[i];
+        if (r <= 0.0)
+            return i;
+    }
+    return w.size() - 1;
+}
+
+// Half the distance from each centroid to its nearest other centroid, and
+// the full centroid-to-centroid distance matrix.
+void centroidSeparation(const Matrix& C, Eigen::MatrixXd& cc, Eigen::VectorXd& s)
+{
+    const Eigen::Index k = C.rows();
+    cc.resize(k, k);
+    s.setConstant(k, std::numeric_limits<double>::infinity());
+    for (Eigen::Index a = 0; a < k; ++a) {
+        cc(a, a) = 0.0;
+        for (Eigen::Index b = a + 1; b < k; ++b) {
+            const double d = (C.row(a) - C.row(b)).norm();
+            cc(a, b) = cc(b, a) = d;
+            s(a) = std::min(s(a), 0.5 * d);
+            s(b) = std::min(s(b), 0.5 * d);
+        }
+    }
+}
+
+// Per-cluster sums and counts of X's rows under `labels`; per-thread
+// partials are reduced in thread order.
+void clusterSums(const Eigen::Ref<const Matrix>& X, const size_t* labels, size_t k, size_t nt,
+    Matrix& sum, std::vector<size_t>& count)
+{
+    const auto N = static_cast<size_t>(X.rows());
+    std::vector<Matrix> sums(nt, Matrix::Zero(static_cast<Eigen::Index>(k), X.cols()));
+    std::vector<std::vector<size_t>> counts(nt, std::vector<size_t>(k, 0));
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+        for (size_t i = b; i < e; ++i) {
+            const auto c = static_cast<Eigen::Index>(labels[i]);
+            sums[t].row(c) += X.row(static_cast<Eigen::Index>(i));
+            ++counts[t][labels[i]];
+        }
+    });
+    for (size_t t = 1; t < nt; ++t) {
+        sums[0] += sums[t];
+        for (size_t c = 0; c < k; ++c)
+            counts[0][c] += counts[t][c];
+    }
+    sum = std::move(sums[0]);
+    count = std::move(counts[0]);
+}
+
+// Packs samples into a row-major matrix; `who` prefixes the error messages.
+Matrix toMatrix(const std::vector<std::vector<double>>& X, const std::string& who)
+{
+    const size_t D = X[0].size();
+    if (D == 0)
+        throw KMeans::SizeMismatchException((who + ": samples have zero features").c_str());
+    Matrix M(static_cast<Eigen::Index>(X.size()), static_cast<Eigen::Index>(D));
+    for (size_t i = 0; i < X.size(); ++i) {
+        if (X[i].size() != D)
+            throw KMeans::SizeMismatchException((who + ": inconsistent sample sizes").c_str());
+        M.row(static_cast<Eigen::Index>(i)) = RowMap(X[i].data(), static_cast<Eigen::Index>(D));
+    }
+    return M;
+}
+
+} // namespace
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
 KMeans::KMeans(size_t k, size_t maxIter, double tol, unsigned seed) noexcept
@@ -27,124 +146,557 @@ KMeans::KMeans(size_t k, size_t maxIter, double tol, unsigned seed) noexcept
 
 // ── Helpers ───────────────────────────────────────────────────────────────────
 
-double KMeans::_sqDist(const std::vector<double>& a, const std::vector<double>& b) noexcept
+size_t KMeans::_workers(size_t N) const noexcept
 {
-    double d = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        const double diff = a[i] - b[i];
-        d += diff * diff;
-    }
-    return d;
+    return resolveThreads(_threads, N, MIN_ROWS_PER_THREAD);
 }
 
-size_t KMeans::_nearest(
-    const std::vector<double>& x, const std::vector<std::vector<double>>& cents) noexcept
+KMeans::Algorithm KMeans::_resolveAlgorithm(size_t N, size_t D) const noexcept
 {
-    size_t best = 0;
-    double bestD = std::numeric_limits<double>::max();
-    for (size_t i = 0; i < cents.size(); ++i) {
-        const double d = _sqDist(x, cents[i]);
-        if (d < bestD) {
-            bestD = d;
-            best = i;
-        }
-    }
-    return best;
+    if (_algo != Algorithm::Auto)
+        return _algo;
+    // Elkan's k lower bounds per sample prune best in high dimension, but
+    // cost N*k doubles; Hamerly keeps a single lower bound.
+    constexpr size_t ELKAN_MAX_BOUNDS = size_t(1) << 24; // 128 MiB
+    return (D >= 64 && N * _k <= ELKAN_MAX_BOUNDS) ? Algorithm::Elkan : Algorithm::Hamerly;
+}
+
+void KMeans::_syncCentroids()
+{
+    _centroids.assign(_k, std::vector<double>(static_cast<size_t>(_C.cols())));
+    for (size_t c = 0; c < _k; ++c)
+        Eigen::Map<Eigen::RowVectorXd>(_centroids[c].data(), _C.cols())
+            = _C.row(static_cast<Eigen::Index>(c));
 }
 
 // ── k-means++ initialisation ──────────────────────────────────────────────────
+//
+// D(x)^2 is kept per sample and lowered against each new centroid only, so
+// seeding costs O(N * k * d) instead of rescanning every chosen centroid.
 
-void KMeans::_initPlusPlus(const std::vector<std::vector<double>>& X, std::mt19937& rng)
+void KMeans::_initPlusPlus(const Eigen::Ref<const Matrix>& X, std::mt19937& rng)
 {
-    const size_t N = X.size();
-    _centroids.clear();
-    _centroids.reserve(_k);
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    _C.resize(static_cast<Eigen::Index>(_k), X.cols());
 
     std::uniform_int_distribution<size_t> unif(0, N - 1);
-    _centroids.push_back(X[unif(rng)]);
+    _C.row(0) = X.row(static_cast<Eigen::Index>(unif(rng)));
 
-    std::vector<double> D(N);
+    std::vector<double> D(N, std::numeric_limits<double>::max());
     for (size_t c = 1; c < _k; ++c) {
-        double total = 0.0;
-        for (size_t i = 0; i < N; ++i) {
-            D[i] = _sqDist(X[i], _centroids[_nearest(X[i], _centroids)]);
-            total += D[i];
-        }
-        // Sample index proportional to D[i]
-        std::uniform_real_distribution<double> dist(0.0, total);
-        double r = dist(rng);
-        size_t chosen = N - 1;
-        for (size_t i = 0; i < N; ++i) {
-            r -= D[i];
-            if (r <= 0.0) {
-                chosen = i;
-                break;
+        const auto last = _C.row(static_cast<Eigen::Index>(c - 1));
+        parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i)
+                D[i] = std::min(D[i], (X.row(static_cast<Eigen::Index>(i)) - last).squaredNorm());
+        });
+        _C.row(static_cast<Eigen::Index>(c))
+            = X.row(static_cast<Eigen::Index>(sampleProportional(D, rng)));
+    }
+}
+
+// ── k-means|| initialisation ──────────────────────────────────────────────────
+//
+// Bahmani et al.: PARALLEL_INIT_ROUNDS rounds, each keeping every sample
+// independently with probability min(1, 2k * D(x)^2 / phi). The candidates
+// are weighted by the number of samples closest to them and reduced to k
+// centroids with weighted k-means++.
+
+void KMeans::_initParallel(const Eigen::Ref<const Matrix>& X, std::mt19937& rng)
+{
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    const double ell = 2.0 * static_cast<double>(_k);
+
+    std::uniform_int_distribution<size_t> unif(0, N - 1);
+    std::vector<size_t> cand { unif(rng) };
+    std::vector<double> D(N, std::numeric_limits<double>::max());
+    std::vector<size_t> nearest(N, 0);
+    std::vector<size_t> lbl(N);
+    std::vector<double> d2(N);
+
+    Matrix newC;
+    Eigen::VectorXd newNorm;
+    size_t first = 0; // candidates [first, cand.size()) have not been applied to D yet
+
+    for (size_t round = 0; round <= PARALLEL_INIT_ROUNDS; ++round) {
+        newC.resize(static_cast<Eigen::Index>(cand.size() - first), X.cols());
+        for (size_t j = first; j < cand.size(); ++j)
+            newC.row(static_cast<Eigen::Index>(j - first))
+                = X.row(static_cast<Eigen::Index>(cand[j]));
+        newNorm = newC.rowwise().squaredNorm();
+        parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+            assignBlock(X, newC, newNorm, b, e, lbl.data(), d2.data());
+            for (size_t i = b; i < e; ++i) {
+                if (d2[i] < D[i]) {
+                    D[i] = d2[i];
+                    nearest[i] = first + lbl[i];
+                }
             }
+        });
+        first = cand.size();
+        if (round == PARALLEL_INIT_ROUNDS)
+            break;
+
+        const double phi = std::accumulate(D.begin(), D.end(), 0.0);
+        if (phi <= 0.0)
+            break;
+        for (size_t i = 0; i < N; ++i)
+            if (hashUniform(_seed, round, i) * phi < ell * D[i])
+                cand.push_back(i);
+        if (cand.size() == first)
+            break;
+    }
+
+    if (cand.size() <= _k) {
+        // Too few candidates (tiny or degenerate data): take them all and
+        // complete with plain k-means++ steps over the samples.
+        _C.resize(static_cast<Eigen::Index>(_k), X.cols());
+        for (size_t j = 0; j < cand.size(); ++j)
+            _C.row(static_cast<Eigen::Index>(j)) = X.row(static_cast<Eigen::Index>(cand[j]));
+        for (size_t c = cand.size(); c < _k; ++c) {
+            _C.row(static_cast<Eigen::Index>(c))
+                = X.row(static_cast<Eigen::Index>(sampleProportional(D, rng)));
+            const auto last = _C.row(static_cast<Eigen::Index>(c));
+            for (size_t i = 0; i < N; ++i)
+                D[i] = std::min(D[i], (X.row(static_cast<Eigen::Index>(i)) - last).squaredNorm());
         }
-        _centroids.push_back(X[chosen]);
+        return;
+    }
+
+    // Weighted k-means++ over the candidates.
+    const size_t M = cand.size();
+    std::vector<double> w(M, 0.0);
+    for (size_t i = 0; i < N; ++i)
+        w[nearest[i]] += 1.0;
+
+    _C.resize(static_cast<Eigen::Index>(_k), X.cols());
+    std::vector<double> Dc(M, std::numeric_limits<double>::max()), p(M);
+    for (size_t j = 0; j < M; ++j)
+        p[j] = w[j];
+    size_t chosen = sampleProportional(p, rng);
+    for (size_t c = 0; c < _k; ++c) {
+        _C.row(static_cast<Eigen::Index>(c)) = X.row(static_cast<Eigen::Index>(cand[chosen]));
+        if (c + 1 == _k)
+            break;
+        const auto last = _C.row(static_cast<Eigen::Index>(c));
+        for (size_t j = 0; j < M; ++j) {
+            const auto x = X.row(static_cast<Eigen::Index>(cand[j]));
+            Dc[j] = std::min(Dc[j], (x - last).squaredNorm());
+            p[j] = w[j] * Dc[j];
+        }
+        chosen = sampleProportional(p, rng);
     }
 }
 
-// ── fit ───────────────────────────────────────────────────────────────────────
+// ── M-step ────────────────────────────────────────────────────────────────────
 
-void KMeans::fit(const std::vector<std::vector<double>>& X)
+void KMeans::_updateCentroids(
+    const Eigen::Ref<const Matrix>& X, const std::vector<size_t>& labels, Eigen::VectorXd& shift)
+{
+    Matrix sum;
+    std::vector<size_t> count;
+    clusterSums(X, labels.data(), _k, _workers(static_cast<size_t>(X.rows())), sum, count);
+
+    const auto k = static_cast<Eigen::Index>(_k);
+    shift.setZero(k);
+    _counts.assign(_k, 0.0);
+    for (Eigen::Index c = 0; c < k; ++c) {
+        const size_t n = count[static_cast<size_t>(c)];
+        _counts[static_cast<size_t>(c)] = static_cast<double>(n);
+        if (n == 0)
+            continue; // Empty cluster: keep old centroid unchanged
+        const Eigen::RowVectorXd mean = sum.row(c) / static_cast<double>(n);
+        shift(c) = (mean - _C.row(c)).norm();
+        _C.row(c) = mean;
+    }
+}
+
+// ── Mini-batch / streaming ────────────────────────────────────────────────────
+
+double KMeans::_miniBatchStep(const Eigen::Ref<const Matrix>& batch, double* batchInertia)
+{
+    const auto N = static_cast<size_t>(batch.rows());
+    const size_t nt = _workers(N);
+    const Eigen::VectorXd cNorm = _C.rowwise().squaredNorm();
+    std::vector<size_t> labels(N);
+    std::vector<double> d2(batchInertia ? N : 0);
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+        assignBlock(batch, _C, cNorm, b, e, labels.data(), batchInertia ? d2.data() : nullptr);
+    });
+    _nDist += N * _k;
+    if (batchInertia)
+        *batchInertia = std::accumulate(d2.begin(), d2.end(), 0.0);
+
+    Matrix sum;
+    std::vector<size_t> count;
+    clusterSums(batch, labels.data(), _k, nt, sum, count);
+
+    double maxShift = 0.0;
+    for (size_t c = 0; c < _k; ++c) {
+        const double v = _counts[c] * _decay;
+        const auto n = static_cast<double>(count[c]);
+        _counts[c] = v + n;
+        if (count[c] == 0)
+            continue;
+        const auto r = static_cast<Eigen::Index>(c);
+        const Eigen::RowVectorXd next = (v * _C.row(r) + sum.row(r)) / (v + n);
+        maxShift = std::max(maxShift, (next - _C.row(r)).norm());
+        _C.row(r) = next;
+    }
+    return maxShift;
+}
+
+void KMeans::fitMiniBatch(const Eigen::Ref<const Matrix>& X, size_t batchSize)
+{
+    _checkFitInput(X);
+    if (batchSize == 0)
+        throw SizeMismatchException("KMeans::fitMiniBatch: batchSize must be > 0");
+    reset();
+
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t B = std::min(batchSize, N);
+    std::mt19937 rng(_seed);
+
+    // Seed on a random subsample of max(3 * batchSize, initSize()) rows.
+    const size_t nSeed = std::min(N, std::max(3 * B, initSize()));
+    std::vector<size_t> idx(N);
+    std::iota(idx.begin(), idx.end(), size_t(0));
+    for (size_t i = 0; i < nSeed; ++i)
+        std::swap(idx[i], idx[std::uniform_int_distribution<size_t>(i, N - 1)(rng)]);
+    Matrix buf(static_cast<Eigen::Index>(nSeed), X.cols());
+    for (size_t i = 0; i < nSeed; ++i)
+        buf.row(static_cast<Eigen::Index>(i)) = X.row(static_cast<Eigen::Index>(idx[i]));
+    if (_init == Init::Parallel || (_init == Init::Auto && nSeed >= PARALLEL_INIT_MIN_SAMPLES))
+        _initParallel(buf, rng);
+    else
+        _initPlusPlus(buf, rng);
+    _counts.assign(_k, 0.0);
+
+    // Stop when the centroids settle below tol, or when the exponentially
+    // weighted batch inertia has not improved for PATIENCE batches.
+    constexpr size_t PATIENCE = 10;
+    const size_t maxSteps = _maxIter * ((N + B - 1) / B);
+    const double alpha = std::min(1.0, 2.0 * static_cast<double>(B) / static_cast<double>(N + 1));
+    std::uniform_int_distribution<size_t> pick(0, N - 1);
+    buf.resize(static_cast<Eigen::Index>(B), X.cols());
+    double ewa = -1.0, best = std::numeric_limits<double>::max();
+    size_t settled = 0, noImprovement = 0;
+    for (size_t step = 0; step < maxSteps; ++step) {
+        ++_nIter;
+        for (Eigen::Index i = 0; i < buf.rows(); ++i)
+            buf.row(i) = X.row(static_cast<Eigen::Index>(pick(rng)));
+        double batchInertia = 0.0;
+        settled = (_miniBatchStep(buf, &batchInertia) < _tol) ? settled + 1 : 0;
+
+        batchInertia /= static_cast<double>(B);
+        ewa = (ewa < 0.0) ? batchInertia : (1.0 - alpha) * ewa + alpha * batchInertia;
+        if (ewa < best) {
+            best = ewa;
+            noImprovement = 0;
+        } else {
+            ++noImprovement;
+        }
+        if (settled >= PATIENCE || noImprovement >= PATIENCE)
+            break;
+    }
+
+    _syncCentroids();
+    _fitted = true;
+}
+
+void KMeans::partialFit(const Eigen::Ref<const Matrix>& batch)
 {
-    if (X.empty())
-        throw SizeMismatchException("KMeans::fit: dataset is empty");
-    const size_t N = X.size();
-    const size_t D = X[0].size();
-    if (D == 0)
-        throw SizeMismatchException("KMeans::fit: samples have zero features");
-    for (const auto& x : X)
-        if (x.size() != D)
-            throw SizeMismatchException("KMeans::fit: inconsistent sample sizes");
     if (_k == 0)
-        throw SizeMismatchException("KMeans::fit: k must be > 0");
-    if (_k > N)
-        throw SizeMismatchException("KMeans::fit: k > number of samples");
+        throw SizeMismatchException("KMeans::partialFit: k must be > 0");
+    if (batch.rows() == 0)
+        return;
+    if (batch.cols() == 0)
+        throw SizeMismatchException("KMeans::partialFit: samples have zero features");
+
+    if (_fitted) {
+        if (batch.cols() != _C.cols())
+            throw SizeMismatchException("KMeans::partialFit: input size mismatch");
+        ++_nIter;
+        _miniBatchStep(batch);
+        _syncCentroids();
+        return;
+    }
+
+    // Not seeded yet: buffer rows until initSize() have arrived.
+    if (_pending.rows() > 0 && batch.cols() != _pending.cols())
+        throw SizeMismatchException("KMeans::partialFit: input size mismatch");
+    const Eigen::Index old = _pending.rows();
+    _pending.conservativeResize(old + batch.rows(), batch.cols());
+    _pending.bottomRows(batch.rows()) = batch;
+    if (static_cast<size_t>(_pending.rows()) < std::max(_k, initSize()))
+        return;
 
     std::mt19937 rng(_seed);
-    _initPlusPlus(X, rng);
+    _initPlusPlus(_pending, rng);
+    _counts.assign(_k, 0.0);
+    _nIter = 1;
+    _nDist = 0;
+    _miniBatchStep(_pending);
+    _pending.resize(0, 0);
+    _syncCentroids();
+    _fitted = true;
+}
 
-    std::vector<size_t> labels(N, 0);
-    std::vector<std::vector<double>> newCentroids(_k, std::vector<double>(D, 0.0));
-    std::vector<size_t> counts(_k, 0);
+void KMeans::partialFit(const std::vector<std::vector<double>>& batch)
+{
+    if (batch.empty())
+        return;
+    partialFit(toMatrix(batch, "KMeans::partialFit"));
+}
 
+void KMeans::setDecay(double decay)
+{
+    if (!(decay > 0.0 && decay <= 1.0))
+        throw std::invalid_argument("KMeans::setDecay: decay must be in (0, 1]");
+    _decay = decay;
+}
+
+void KMeans::reset() noexcept
+{
+    _C.resize(0, 0);
+    _centroids.clear();
+    _counts.clear();
+    _pending.resize(0, 0);
+    _fitted = false;
     _nIter = 0;
+    _nDist = 0;
+}
+
+// ── Lloyd ─────────────────────────────────────────────────────────────────────
+
+void KMeans::_fitLloyd(const Eigen::Ref<const Matrix>& X)
+{
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    std::vector<size_t> labels(N, 0);
+    Eigen::VectorXd shift;
+
     for (size_t iter = 0; iter < _maxIter; ++iter) {
         ++_nIter;
+        const Eigen::VectorXd cNorm = _C.rowwise().squaredNorm();
+        parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+            assignBlock(X, _C, cNorm, b, e, labels.data(), nullptr);
+        });
+        _nDist += N * _k;
 
-        // E-step: assign each sample to its nearest centroid
-        for (size_t i = 0; i < N; ++i)
-            labels[i] = _nearest(X[i], _centroids);
-
-        // M-step: recompute centroids as cluster means
-        for (auto& c : newCentroids)
-            std::fill(c.begin(), c.end(), 0.0);
-        std::fill(counts.begin(), counts.end(), 0);
-
-        for (size_t i = 0; i < N; ++i) {
-            const size_t c = labels[i];
-            ++counts[c];
-            for (size_t d = 0; d < D; ++d)
-                newCentroids[c][d] += X[i][d];
-        }
-        for (size_t c = 0; c < _k; ++c) {
-            if (counts[c] > 0)
-                for (size_t d = 0; d < D; ++d)
-                    newCentroids[c][d] /= static_cast<double>(counts[c]);
-            // Empty cluster: keep old centroid unchanged
+        _updateCentroids(X, labels, shift);
+        if (shift.maxCoeff() < _tol)
+            break;
+    }
+}
+
+// ── Hamerly ───────────────────────────────────────────────────────────────────
+//
+// u[i] >= d(x_i, c_a(i)) and l[i] <= d(x_i, c_j) for every j != a(i).
+// Sample i keeps its centroid when u[i] <= max(l[i], s[a(i)]), where s[j] is
+// half the distance from c_j to its nearest other centroid.
+
+void KMeans::_fitHamerly(const Eigen::Ref<const Matrix>& X)
+{
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    const auto k = static_cast<Eigen::Index>(_k);
+    constexpr double INF = std::numeric_limits<double>::infinity();
+
+    std::vector<size_t> a(N, 0);
+    std::vector<double> u(N, 0.0), l(N, INF);
+    std::vector<size_t> nDist(nt, 0);
+
+    // Exact nearest and second nearest for sample i.
+    auto scan = [&](size_t i) {
+        const auto x = X.row(static_cast<Eigen::Index>(i));
+        double d1 = INF, d2 = INF;
+        size_t best = 0;
+        for (Eigen::Index j = 0; j < k; ++j) {
+            const double d = (x - _C.row(j)).squaredNorm();
+            if (d < d1) {
+                d2 = d1;
+                d1 = d;
+                best = static_cast<size_t>(j);
+            } else if (d < d2) {
+                d2 = d;
+            }
         }
+        a[i] = best;
+        u[i] = std::sqrt(d1);
+        l[i] = std::sqrt(d2);
+    };
 
-        // Convergence check: largest centroid shift
-        double maxShift = 0.0;
-        for (size_t c = 0; c < _k; ++c)
-            maxShift = std::max(maxShift, std::sqrt(_sqDist(newCentroids[c], _centroids[c])));
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+        for (size_t i = b; i < e; ++i)
+            scan(i);
+    });
+    _nDist += N * _k;
 
-        _centroids = newCentroids;
-        if (maxShift < _tol)
+    Eigen::VectorXd shift, s;
+    Eigen::MatrixXd cc;
+    for (size_t iter = 0; iter < _maxIter; ++iter) {
+        ++_nIter;
+        _updateCentroids(X, a, shift);
+        if (shift.maxCoeff() < _tol)
             break;
+
+        // Loosen the bounds by how far the centroids moved.
+        Eigen::Index far = 0;
+        const double p1 = shift.maxCoeff(&far);
+        double p2 = 0.0;
+        for (Eigen::Index j = 0; j < k; ++j)
+            if (j != far)
+                p2 = std::max(p2, shift(j));
+        centroidSeparation(_C, cc, s);
+
+        std::fill(nDist.begin(), nDist.end(), 0);
+        parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+            for (size_t i = b; i < e; ++i) {
+                const auto ai = static_cast<Eigen::Index>(a[i]);
+                u[i] += shift(ai);
+                l[i] -= (ai == far) ? p2 : p1;
+
+                const double m = std::max(s(ai), l[i]);
+                if (u[i] <= m)
+                    continue;
+                u[i] = (X.row(static_cast<Eigen::Index>(i)) - _C.row(ai)).norm();
+                ++nDist[t];
+                if (u[i] <= m)
+                    continue;
+                scan(i);
+                nDist[t] += _k;
+            }
+        });
+        _nDist += std::accumulate(nDist.begin(), nDist.end(), size_t(0));
     }
+}
+
+// ── Elkan ─────────────────────────────────────────────────────────────────────
+//
+// One lower bound per (sample, centroid) pair; a candidate centroid j is
+// only measured when u[i] > max(L(i, j), cc(a(i), j) / 2).
+
+void KMeans::_fitElkan(const Eigen::Ref<const Matrix>& X)
+{
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    const auto k = static_cast<Eigen::Index>(_k);
+
+    std::vector<size_t> a(N, 0);
+    std::vector<double> u(N, 0.0);
+    Matrix L(static_cast<Eigen::Index>(N), k);
+    std::vector<size_t> nDist(nt, 0);
+
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+        for (size_t i = b; i < e; ++i) {
+            const auto r = static_cast<Eigen::Index>(i);
+            for (Eigen::Index j = 0; j < k; ++j)
+                L(r, j) = (X.row(r) - _C.row(j)).norm();
+            Eigen::Index best = 0;
+            u[i] = L.row(r).minCoeff(&best);
+            a[i] = static_cast<size_t>(best);
+        }
+    });
+    _nDist += N * _k;
+
+    Eigen::VectorXd shift, s;
+    Eigen::MatrixXd cc;
+    for (size_t iter = 0; iter < _maxIter; ++iter) {
+        ++_nIter;
+        _updateCentroids(X, a, shift);
+        if (shift.maxCoeff() < _tol)
+            break;
+        centroidSeparation(_C, cc, s);
+
+        std::fill(nDist.begin(), nDist.end(), 0);
+        parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+            for (size_t i = b; i < e; ++i) {
+                const auto r = static_cast<Eigen::Index>(i);
+                auto Lr = L.row(r);
+                Lr = (Lr - shift.transpose()).cwiseMax(0.0);
+                auto ai = static_cast<Eigen::Index>(a[i]);
+                u[i] += shift(ai);
+                if (u[i] <= s(ai))
+                    continue;
+
+                bool stale = true;
+                for (Eigen::Index j = 0; j < k; ++j) {
+                    if (j == ai)
+                        continue;
+                    const double z = std::max(Lr(j), 0.5 * cc(ai, j));
+                    if (u[i] <= z)
+                        continue;
+                    if (stale) {
+                        u[i] = Lr(ai) = (X.row(r) - _C.row(ai)).norm();
+                        ++nDist[t];
+                        stale = false;
+                        if (u[i] <= z)
+                            continue;
+                    }
+                    const double d = Lr(j) = (X.row(r) - _C.row(j)).norm();
+                    ++nDist[t];
+                    if (d < u[i]) {
+                        ai = j;
+                        u[i] = d;
+                    }
+                }
+                a[i] = static_cast<size_t>(ai);
+            }
+        });
+        _nDist += std::accumulate(nDist.begin(), nDist.end(), size_t(0));
+    }
+}
+
+// ── fit ───────────────────────────────────────────────────────────────────────
+
+void KMeans::fit(const std::vector<std::vector<double>>& X)
+{
+    if (X.empty())
+        throw SizeMismatchException("KMeans::fit: dataset is empty");
+    fit(toMatrix(X, "KMeans::fit"));
+}
+
+void KMeans::_checkFitInput(const Eigen::Ref<const Matrix>& X) const
+{
+    if (X.rows() == 0)
+        throw SizeMismatchException("KMeans::fit: dataset is empty");
+    if (X.cols() == 0)
+        throw SizeMismatchException("KMeans::fit: samples have zero features");
+    if (_k == 0)
+        throw SizeMismatchException("KMeans::fit: k must be > 0");
+    if (_k > static_cast<size_t>(X.rows()))
+        throw SizeMismatchException("KMeans::fit: k > number of samples");
+}
+
+void KMeans::fit(const Eigen::Ref<const Matrix>& X)
+{
+    _checkFitInput(X);
+    reset();
+    const auto N = static_cast<size_t>(X.rows());
+
+    std::mt19937 rng(_seed);
+    const bool parallelInit = _init == Init::Parallel
+        || (_init == Init::Auto && N >= PARALLEL_INIT_MIN_SAMPLES);
+    if (parallelInit)
+        _initParallel(X, rng);
+    else
+        _initPlusPlus(X, rng);
+
+    switch (_resolveAlgorithm(N, static_cast<size_t>(X.cols()))) {
+    case Algorithm::Lloyd:
+        _fitLloyd(X);
+        break;
+    case Algorithm::Elkan:
+        _fitElkan(X);
+        break;
+    default:
+        _fitHamerly(X);
+        break;
+    }
+
+    _syncCentroids();
     _fitted = true;
 }
 
@@ -154,9 +706,11 @@ size_t KMeans::predict(const std::vector<double>& x) const
 {
     if (!_fitted)
         throw NotFittedException();
-    if (x.size() != _centroids[0].size())
+    if (x.size() != static_cast<size_t>(_C.cols()))
         throw SizeMismatchException("KMeans::predict: input size mismatch");
-    return _nearest(x, _centroids);
+    Eigen::Index best = 0;
+    (_C.rowwise() - RowMap(x.data(), _C.cols())).rowwise().squaredNorm().minCoeff(&best);
+    return static_cast<size_t>(best);
 }
 
 std::vector<size_t> KMeans::predict(const std::vector<std::vector<double>>& X) const
@@ -168,6 +722,21 @@ std::vector<size_t> KMeans::predict(const std::vector<std::vector<double>>& X) c
     return out;
 }
 
+std::vector<size_t> KMeans::predict(const Eigen::Ref<const Matrix>& X) const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    if (X.cols() != _C.cols())
+        throw SizeMismatchException("KMeans::predict: input size mismatch");
+    const auto N = static_cast<size_t>(X.rows());
+    const Eigen::VectorXd cNorm = _C.rowwise().squaredNorm();
+    std::vector<size_t> out(N);
+    parallelFor(N, _workers(N), [&](size_t b, size_t e, size_t) {
+        assignBlock(X, _C, cNorm, b, e, out.data(), nullptr);
+    });
+    return out;
+}
+
 // ── inertia ───────────────────────────────────────────────────────────────────
 
 double KMeans::inertia(const std::vector<std::vector<double>>& X) const
@@ -176,10 +745,31 @@ double KMeans::inertia(const std::vector<std::vector<double>>& X) const
         throw NotFittedException();
     double total = 0.0;
     for (const auto& x : X)
-        total += _sqDist(x, _centroids[predict(x)]);
+        total += (RowMap(x.data(), _C.cols()) - _C.row(static_cast<Eigen::Index>(predict(x))))
+                     .squaredNorm();
     return total;
 }
 
+double KMeans::inertia(const Eigen::Ref<const Matrix>& X) const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    if (X.cols() != _C.cols())
+        throw SizeMismatchException("KMeans::inertia: input size mismatch");
+    const auto N = static_cast<size_t>(X.rows());
+    const size_t nt = _workers(N);
+    const Eigen::VectorXd cNorm = _C.rowwise().squaredNorm();
+    std::vector<size_t> labels(N);
+    std::vector<double> d2(N);
+    std::vector<double> partial(nt, 0.0);
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+        assignBlock(X, _C, cNorm, b, e, labels.data(), d2.data());
+        for (size_t i = b; i < e; ++i)
+            partial[t] += d2[i];
+    });
+    return std::accumulate(partial.begin(), partial.end(), 0.0);
+}
+
 // ── centroids accessor ────────────────────────────────────────────────────────
 
 const std::vector<std::vector<double>>& KMeans::centroids() const
@@ -189,4 +779,11 @@ const std::vector<std::vector<double>>& KMeans::centroids() const
     return _centroids;
 }
 
+const KMeans::Matrix& KMeans::centroidMatrix() const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    return _C;
+}
+
 } // namespace nu
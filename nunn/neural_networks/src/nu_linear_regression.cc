@@ -7,13 +7,99 @@
 //
 
 #include "nu_linear_regression.h"
+#include "nu_linalg.h"
+#include "nu_parallel.h"
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <random>
 #include <stdexcept>
 #include <string>
 
 namespace nu {
 
+namespace {
+
+// Rows per Accumulator block: bounds the centred scratch copy to BLOCK x D.
+constexpr Eigen::Index ACCUMULATE_BLOCK = 4096;
+constexpr size_t MIN_ROWS_PER_THREAD = 16384;
+
+} // namespace
+
+// ── Accumulator ─────────────────────────────────────────────────────────────
+
+LinearRegression::Accumulator::Accumulator(size_t nFeatures)
+    : _meanX(Eigen::VectorXd::Zero(Eigen::Index(nFeatures)))
+    , _sxx(Eigen::MatrixXd::Zero(Eigen::Index(nFeatures), Eigen::Index(nFeatures)))
+    , _sxy(Eigen::VectorXd::Zero(Eigen::Index(nFeatures)))
+{
+}
+
+void LinearRegression::Accumulator::reset() noexcept
+{
+    _n = 0;
+    _meanX.setZero();
+    _meanY = 0.0;
+    _sxx.setZero();
+    _sxy.setZero();
+}
+
+void LinearRegression::Accumulator::add(
+    const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y)
+{
+    if (X.rows() != y.size())
+        throw SizeMismatchException(
+            "LinearRegression::Accumulator::add: X and y must have the same number of rows");
+    if (X.cols() == 0)
+        throw SizeMismatchException(
+            "LinearRegression::Accumulator::add: feature dimension must be > 0");
+    if (_n == 0 && _meanX.size() == 0)
+        *this = Accumulator(size_t(X.cols()));
+    else if (X.cols() != _meanX.size())
+        throw SizeMismatchException("LinearRegression::Accumulator::add: feature count mismatch");
+
+    Eigen::MatrixXd Xc;
+    Eigen::VectorXd yc;
+    for (Eigen::Index r = 0; r < X.rows(); r += ACCUMULATE_BLOCK) {
+        const Eigen::Index n = std::min(ACCUMULATE_BLOCK, X.rows() - r);
+        Accumulator block;
+        block._n = size_t(n);
+        block._meanX = X.middleRows(r, n).colwise().mean().transpose();
+        block._meanY = y.segment(r, n).mean();
+
+        Xc = X.middleRows(r, n).rowwise() - block._meanX.transpose();
+        yc = y.segment(r, n).array() - block._meanY;
+        block._sxx.setZero(X.cols(), X.cols());
+        block._sxx.selfadjointView<Eigen::Lower>().rankUpdate(Xc.transpose());
+        block._sxy.noalias() = Xc.transpose() * yc;
+        merge(block);
+    }
+}
+
+void LinearRegression::Accumulator::merge(const Accumulator& other)
+{
+    if (other._n == 0)
+        return;
+    if (_n == 0) {
+        *this = other;
+        return;
+    }
+    if (other._meanX.size() != _meanX.size())
+        throw SizeMismatchException("LinearRegression::Accumulator::merge: feature count mismatch");
+
+    const double na = double(_n), nb = double(other._n), n = na + nb;
+    const Eigen::VectorXd dx = other._meanX - _meanX;
+    const double dy = other._meanY - _meanY;
+    const double w = na * nb / n;
+
+    _sxx += other._sxx;
+    _sxx.selfadjointView<Eigen::Lower>().rankUpdate(dx, w);
+    _sxy += other._sxy + (w * dy) * dx;
+    _meanX += (nb / n) * dx;
+    _meanY += (nb / n) * dy;
+    _n += other._n;
+}
+
 LinearRegression::LinearRegression(
     Method method, double learningRate, size_t maxIter, double tolerance) noexcept
     : _method(method)
@@ -25,13 +111,14 @@ LinearRegression::LinearRegression(
 
 // ── static helpers ──────────────────────────────────────────────────────────
 
-Eigen::MatrixXd LinearRegression::toEigenMatrix(const std::vector<std::vector<double>>& X)
+LinearRegression::Matrix LinearRegression::toEigenMatrix(
+    const std::vector<std::vector<double>>& X)
 {
     if (X.empty())
-        return Eigen::MatrixXd(0, 0);
+        return Matrix(0, 0);
     const size_t N = X.size();
     const size_t F = X[0].size();
-    Eigen::MatrixXd M(N, F);
+    Matrix M(N, F);
     for (size_t i = 0; i < N; ++i)
         for (size_t j = 0; j < F; ++j)
             M(i, j) = X[i][j];
@@ -47,18 +134,24 @@ Eigen::VectorXd LinearRegression::toEigenVector(const std::vector<double>& v)
 
 // Solves the augmented normal equations [X|1]^T [X|1] w_aug = [X|1]^T y.
 // w_aug = [w0 ... wF-1  b] — bias is the last component.
-void LinearRegression::_fitOLS(const Eigen::MatrixXd& X, const Eigen::VectorXd& y)
+// Ridge appends the rows sqrt(ridge) * [I | 0] with zero targets.
+void LinearRegression::_fitOLS(const Eigen::Ref<const Matrix>& X, const Eigen::VectorXd& y)
 {
     const Eigen::Index N = X.rows();
     const Eigen::Index F = X.cols();
+    const Eigen::Index extra = _ridge > 0.0 ? F : 0;
 
     // Build augmented matrix X_aug = [X  ones_column]
-    Eigen::MatrixXd Xaug(N, F + 1);
-    Xaug.leftCols(F) = X;
-    Xaug.col(F).setOnes();
+    Eigen::MatrixXd Xaug = Eigen::MatrixXd::Zero(N + extra, F + 1);
+    Xaug.topLeftCorner(N, F) = X;
+    Xaug.col(F).head(N).setOnes();
+    Eigen::VectorXd yaug = Eigen::VectorXd::Zero(N + extra);
+    yaug.head(N) = y;
+    if (extra)
+        Xaug.bottomLeftCorner(F, F).diagonal().setConstant(std::sqrt(_ridge));
 
     // Solve via column-pivoting QR (numerically stable, handles rank-deficient cases)
-    Eigen::VectorXd w_aug = Xaug.colPivHouseholderQr().solve(y);
+    Eigen::VectorXd w_aug = Xaug.colPivHouseholderQr().solve(yaug);
 
     _w = w_aug.head(F);
     _b = w_aug(F);
@@ -67,7 +160,7 @@ void LinearRegression::_fitOLS(const Eigen::MatrixXd& X, const Eigen::VectorXd&
 
 // ── Gradient Descent fit ────────────────────────────────────────────────────
 
-void LinearRegression::_fitGD(const Eigen::MatrixXd& X, const Eigen::VectorXd& y)
+void LinearRegression::_fitGD(const Eigen::Ref<const Matrix>& X, const Eigen::VectorXd& y)
 {
     const Eigen::Index N = X.rows();
     const Eigen::Index F = X.cols();
@@ -79,7 +172,7 @@ void LinearRegression::_fitGD(const Eigen::MatrixXd& X, const Eigen::VectorXd& y
         // Residuals: r = X*w + b*ones - y
         Eigen::VectorXd r = X * _w + Eigen::VectorXd::Constant(N, _b) - y;
 
-        Eigen::VectorXd grad_w = (X.transpose() * r) / N;
+        Eigen::VectorXd grad_w = (X.transpose() * r + _ridge * _w) / N;
         double grad_b = r.mean();
 
         Eigen::VectorXd delta_w = _lr * grad_w;
@@ -92,6 +185,84 @@ void LinearRegression::_fitGD(const Eigen::MatrixXd& X, const Eigen::VectorXd& y
     _cacheValid = false;
 }
 
+// ── Normal equations fit ────────────────────────────────────────────────────
+
+void LinearRegression::_fitNormal(
+    const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y)
+{
+    // One accumulator per row range; merged in range order, so the result is
+    // the same for a given thread count.
+    const size_t N = size_t(X.rows());
+    const size_t nt = resolveThreads(_threads, N, MIN_ROWS_PER_THREAD);
+    std::vector<Accumulator> part(nt);
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t t) {
+        const Eigen::Index n = Eigen::Index(e - b);
+        part[t].add(X.middleRows(Eigen::Index(b), n), y.segment(Eigen::Index(b), n));
+    });
+    for (size_t t = 1; t < nt; ++t)
+        part[0].merge(part[t]);
+    _stats = std::move(part[0]);
+    _solve(_stats);
+}
+
+// Centred ridge system (Sxx + ridge I) w = Sxy, b = my - mx^T w; collinear
+// features without a ridge get the minimum-norm solution.
+void LinearRegression::_solve(const Accumulator& stats)
+{
+    const Eigen::Index F = stats._meanX.size();
+    Eigen::MatrixXd A = stats._sxx.selfadjointView<Eigen::Lower>();
+    A.diagonal().array() += _ridge;
+
+    _w = solveSpdOrMinNorm(A, stats._sxy);
+    _b = stats._meanY - stats._meanX.dot(_w);
+    _inputSize = size_t(F);
+    _fitted = true;
+    _cacheValid = false;
+}
+
+// ── Mini-batch SGD fit ──────────────────────────────────────────────────────
+
+void LinearRegression::_fitSGD(
+    const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y)
+{
+    const Eigen::Index N = X.rows();
+    const Eigen::Index F = X.cols();
+    const Eigen::Index B = std::min<Eigen::Index>(Eigen::Index(_batchSize), N);
+
+    _w.setZero(F);
+    _b = 0.0;
+
+    std::vector<Eigen::Index> order(static_cast<size_t>(N));
+    std::iota(order.begin(), order.end(), Eigen::Index(0));
+    std::mt19937 rng(_seed);
+
+    Matrix Xb(B, F);
+    Eigen::VectorXd yb(B), r(B);
+    for (size_t epoch = 0; epoch < _maxIter; ++epoch) {
+        std::shuffle(order.begin(), order.end(), rng);
+        const Eigen::VectorXd w0 = _w;
+
+        for (Eigen::Index start = 0; start < N; start += B) {
+            const Eigen::Index n = std::min(B, N - start);
+            for (Eigen::Index i = 0; i < n; ++i) {
+                const Eigen::Index row = order[size_t(start + i)];
+                Xb.row(i) = X.row(row);
+                yb(i) = y(row);
+            }
+            auto Xn = Xb.topRows(n);
+            r.head(n).noalias() = Xn * _w;
+            r.head(n).array() += _b - yb.head(n).array();
+
+            // Ridge is spread over the epoch: ridge / N per sample.
+            _w -= _lr * ((Xn.transpose() * r.head(n)) / double(n) + (_ridge / double(N)) * _w);
+            _b -= _lr * r.head(n).mean();
+        }
+        if ((_w - w0).norm() < _tol)
+            break;
+    }
+    _cacheValid = false;
+}
+
 // ── Public interface ─────────────────────────────────────────────────────────
 
 void LinearRegression::fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y)
@@ -109,18 +280,64 @@ void LinearRegression::fit(const std::vector<std::vector<double>>& X, const std:
             throw SizeMismatchException(
                 "LinearRegression::fit: all rows of X must have the same length");
 
-    const Eigen::MatrixXd Xm = toEigenMatrix(X);
-    const Eigen::VectorXd yv = toEigenVector(y);
+    fit(toEigenMatrix(X), toEigenVector(y));
+}
 
-    if (_method == Method::OLS)
-        _fitOLS(Xm, yv);
-    else
-        _fitGD(Xm, yv);
+void LinearRegression::fit(
+    const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y)
+{
+    if (X.rows() == 0 || y.size() == 0)
+        throw SizeMismatchException("LinearRegression::fit: empty dataset");
+    if (X.rows() != y.size())
+        throw SizeMismatchException(
+            "LinearRegression::fit: X and y must have the same number of rows");
+    if (X.cols() == 0)
+        throw SizeMismatchException("LinearRegression::fit: feature dimension must be > 0");
 
-    _inputSize = F;
+    _stats = Accumulator();
+    switch (_method) {
+    case Method::OLS:
+        _fitOLS(X, y);
+        break;
+    case Method::GradientDescent:
+        _fitGD(X, y);
+        break;
+    case Method::NormalEquations:
+        _fitNormal(X, y);
+        break;
+    case Method::MiniBatchSGD:
+        _fitSGD(X, y);
+        break;
+    }
+
+    _inputSize = size_t(X.cols());
     _fitted = true;
 }
 
+void LinearRegression::fit(const Accumulator& stats)
+{
+    if (stats.count() == 0)
+        throw SizeMismatchException("LinearRegression::fit: accumulator is empty");
+    _stats = stats;
+    _solve(_stats);
+}
+
+void LinearRegression::partialFit(
+    const Eigen::Ref<const Matrix>& X, const Eigen::Ref<const Eigen::VectorXd>& y)
+{
+    if (X.rows() == 0)
+        return;
+    _stats.add(X, y);
+    _solve(_stats);
+}
+
+void LinearRegression::setRidge(double lambda)
+{
+    if (!(lambda >= 0.0))
+        throw std::invalid_argument("LinearRegression::setRidge: lambda must be >= 0");
+    _ridge = lambda;
+}
+
 double LinearRegression::predict(const std::vector<double>& x) const
 {
     if (!_fitted)
@@ -141,6 +358,17 @@ std::vector<double> LinearRegression::predict(const std::vector<std::vector<doub
     return out;
 }
 
+Eigen::VectorXd LinearRegression::predict(const Eigen::Ref<const Matrix>& X) const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    if (size_t(X.cols()) != _inputSize)
+        throw SizeMismatchException("LinearRegression::predict: input size mismatch");
+    Eigen::VectorXd out = X * _w;
+    out.array() += _b;
+    return out;
+}
+
 double LinearRegression::mse(
     const std::vector<std::vector<double>>& X, const std::vector<double>& y) const
 {
@@ -15,7 +15,9 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <new>
 #include <stdexcept>
+#include <string>
 
 // ── ArrayFire activation helpers (compiled only when NUNN_HAS_ARRAYFIRE) ──────
 
@@ -78,12 +80,12 @@ MlpMatrixNN::MlpMatrixNN(const std::vector<LayerConfig>& layers, double learning
     _input = Eigen::VectorXd::Zero(static_cast<Eigen::Index>(_inputSize));
     _layers.reserve(layers.size() - 1);
 
+    Eigen::Index numParams = 0;
     for (size_t i = 1; i < layers.size(); ++i) {
         const auto inSz = static_cast<Eigen::Index>(layers[i - 1].size);
         const auto outSz = static_cast<Eigen::Index>(layers[i].size);
+        numParams += outSz * inSz + outSz;
         Layer l;
-        l.W = Eigen::MatrixXd::Zero(outSz, inSz);
-        l.b = Eigen::VectorXd::Zero(outSz);
         l.a = Eigen::VectorXd::Zero(outSz);
         l.delta = Eigen::VectorXd::Zero(outSz);
         l.dW = Eigen::MatrixXd::Zero(outSz, inSz);
@@ -95,6 +97,8 @@ MlpMatrixNN::MlpMatrixNN(const std::vector<LayerConfig>& layers, double learning
         l.act = layers[i].activation;
         _layers.push_back(std::move(l));
     }
+    _params = Eigen::VectorXd::Zero(numParams);
+    _bindParams();
 
     _validateCostFunction(cf, _layers.back().act);
 
@@ -107,6 +111,31 @@ MlpMatrixNN::MlpMatrixNN(const std::vector<LayerConfig>& layers, double learning
     reshuffleWeights();
 }
 
+MlpMatrixNN::MlpMatrixNN(const MlpMatrixNN& other)
+    : _layers(other._layers)
+    , _params(other._params)
+    , _input(other._input)
+    , _inputSize(other._inputSize)
+    , _lr(other._lr)
+    , _momentum(other._momentum)
+    , _cf(other._cf)
+    , _backend(other._backend)
+    , _optimizer(other._optimizer)
+    , _beta1(other._beta1)
+    , _beta2(other._beta2)
+    , _adamEps(other._adamEps)
+    , _adamT(other._adamT)
+{
+    _bindParams();
+}
+
+MlpMatrixNN& MlpMatrixNN::operator=(const MlpMatrixNN& other)
+{
+    if (this != &other)
+        *this = MlpMatrixNN(other);
+    return *this;
+}
+
 // ── reshuffleWeights ──────────────────────────────────────────────────────────
 
 void MlpMatrixNN::reshuffleWeights()
@@ -201,6 +230,86 @@ void MlpMatrixNN::feedForward()
 #endif
 }
 
+// ── feedForwardBatch ──────────────────────────────────────────────────────────
+
+Eigen::MatrixXd MlpMatrixNN::feedForwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    Eigen::MatrixXd out;
+    feedForwardBatch(X, out);
+    return out;
+}
+
+void MlpMatrixNN::feedForwardBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& out) const
+{
+    if (X.rows() != static_cast<Eigen::Index>(_inputSize))
+        throw std::invalid_argument("feedForwardBatch: X must be [inputSize × B]");
+
+    if (_backend != ComputeBackend::Eigen) {
+        out = feedForwardBatch(X, 0, _layers.size());
+        return;
+    }
+
+    // Hidden activations ping-pong between two locals; the output layer's
+    // GEMM writes straight into out.
+    const size_t last = _layers.size() - 1;
+    Eigen::MatrixXd A, Z;
+    for (size_t l = 0; l < last; ++l) {
+        if (l == 0)
+            Z.noalias() = _layers[0].W * X;
+        else
+            Z.noalias() = _layers[l].W * A;
+        Z.colwise() += _layers[l].b;
+        Z = Z.unaryExpr([a = _layers[l].act](double x) { return act::forward(a, x); });
+        A.swap(Z);
+    }
+    const auto& lay = _layers[last];
+    out.resize(lay.W.rows(), X.cols());
+    if (last == 0)
+        out.noalias() = lay.W * X;
+    else
+        out.noalias() = lay.W * A;
+    out.colwise() += lay.b;
+    out = out.unaryExpr([a = lay.act](double x) { return act::forward(a, x); });
+}
+
+Eigen::MatrixXd MlpMatrixNN::feedForwardBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, size_t firstLayer, size_t lastLayer) const
+{
+    if (firstLayer >= lastLayer || lastLayer > _layers.size())
+        throw std::out_of_range("feedForwardBatch: invalid layer range");
+    if (X.rows() != _layers[firstLayer].W.cols())
+        throw std::invalid_argument("feedForwardBatch: X rows must match the first layer input");
+
+    if (_backend == ComputeBackend::Eigen) {
+        Eigen::MatrixXd A = _layers[firstLayer].W * X;
+        A.colwise() += _layers[firstLayer].b;
+        A = A.unaryExpr([a = _layers[firstLayer].act](double x) { return act::forward(a, x); });
+        for (size_t l = firstLayer + 1; l < lastLayer; ++l) {
+            Eigen::MatrixXd Z = _layers[l].W * A;
+            Z.colwise() += _layers[l].b;
+            A = Z.unaryExpr([a = _layers[l].act](double x) { return act::forward(a, x); });
+        }
+        return A;
+    }
+
+#ifdef NUNN_HAS_ARRAYFIRE
+    {
+        const dim_t B = static_cast<dim_t>(X.cols());
+        Eigen::MatrixXd X_host = X;
+        af::array x = af::array(static_cast<dim_t>(X.rows()), B, X_host.data(), afHost);
+        for (size_t l = firstLayer; l < lastLayer; ++l)
+            x = af_activate(_layers[l].act,
+                af::matmul(*_layers[l].W_af, x)
+                    + af::tile(*_layers[l].b_af, 1, static_cast<unsigned>(B)));
+        Eigen::MatrixXd out(static_cast<Eigen::Index>(_layers[lastLayer - 1].b.size()), B);
+        x.host(out.data());
+        return out;
+    }
+#endif
+    return Eigen::MatrixXd();
+}
+
 // ── backPropagate ─────────────────────────────────────────────────────────────
 
 void MlpMatrixNN::backPropagate(const std::vector<double>& target)
@@ -329,35 +438,45 @@ void MlpMatrixNN::backPropagate(const std::vector<double>& target)
 
 // ── trainBatch ────────────────────────────────────────────────────────────────
 
-void MlpMatrixNN::trainBatch(
+double MlpMatrixNN::trainBatch(
     const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets)
 {
     if (inputs.empty() || inputs.size() != targets.size())
         throw std::invalid_argument(
             "trainBatch: batch must be non-empty and inputs/targets must have the same size");
 
+    const auto B = static_cast<Eigen::Index>(inputs.size());
+    const auto inSz = static_cast<Eigen::Index>(_inputSize);
+    const auto ouSz = static_cast<Eigen::Index>(_layers.back().a.size());
+
+    Eigen::MatrixXd X(inSz, B);
+    Eigen::MatrixXd T(ouSz, B);
+    for (Eigen::Index j = 0; j < B; ++j) {
+        X.col(j) = Eigen::Map<const Eigen::VectorXd>(inputs[j].data(), inSz);
+        T.col(j) = Eigen::Map<const Eigen::VectorXd>(targets[j].data(), ouSz);
+    }
+    return trainBatch(X, T);
+}
+
+double MlpMatrixNN::trainBatch(const Eigen::Ref<const Eigen::MatrixXd>& X,
+    const Eigen::Ref<const Eigen::MatrixXd>& T, Eigen::MatrixXd* inputGrad)
+{
+    if (X.cols() == 0 || X.cols() != T.cols()
+        || X.rows() != static_cast<Eigen::Index>(_inputSize)
+        || T.rows() != static_cast<Eigen::Index>(getOutputSize()))
+        throw std::invalid_argument(
+            "trainBatch: X must be [inputSize × B], T [outputSize × B], with B > 0");
+
     if (_backend == ComputeBackend::Eigen) {
-        const auto B = static_cast<Eigen::Index>(inputs.size());
-        const auto inSz = static_cast<Eigen::Index>(_inputSize);
-        const auto ouSz = static_cast<Eigen::Index>(_layers.back().a.size());
-
-        Eigen::MatrixXd X(inSz, B);
-        Eigen::MatrixXd T(ouSz, B);
-        for (Eigen::Index j = 0; j < B; ++j) {
-            X.col(j) = Eigen::Map<const Eigen::VectorXd>(inputs[j].data(), inSz);
-            T.col(j) = Eigen::Map<const Eigen::VectorXd>(targets[j].data(), ouSz);
-        }
+        const Eigen::Index B = X.cols();
 
         // Forward: Z[l] = W[l] * A[l-1] + b[l] (broadcast)  [out_l × B]
         std::vector<Eigen::MatrixXd> A(_layers.size());
-        {
-            const Eigen::MatrixXd* prev = &X;
-            for (size_t l = 0; l < _layers.size(); ++l) {
-                Eigen::MatrixXd Z = _layers[l].W * (*prev);
-                Z.colwise() += _layers[l].b;
-                A[l] = Z.unaryExpr([a = _layers[l].act](double x) { return act::forward(a, x); });
-                prev = &A[l];
-            }
+        for (size_t l = 0; l < _layers.size(); ++l) {
+            Eigen::MatrixXd Z = (l == 0) ? Eigen::MatrixXd(_layers[0].W * X)
+                                         : Eigen::MatrixXd(_layers[l].W * A[l - 1]);
+            Z.colwise() += _layers[l].b;
+            A[l] = Z.unaryExpr([a = _layers[l].act](double x) { return act::forward(a, x); });
         }
 
         // Backward (standard batch order: all deltas use original weights).
@@ -380,16 +499,23 @@ void MlpMatrixNN::trainBatch(
             D[lu] = prop.cwiseProduct(actD);
         }
 
+        const double loss
+            = (A.back() - T).squaredNorm() / static_cast<double>(A.back().rows() * B);
+        if (inputGrad)
+            inputGrad->noalias() = _layers[0].W.transpose() * D[0];
+
         // Weight update: mean gradient over batch.
         const double invB = 1.0 / static_cast<double>(B);
+        auto prevA = [&](size_t l) -> Eigen::Ref<const Eigen::MatrixXd> {
+            return (l == 0) ? X : Eigen::Ref<const Eigen::MatrixXd>(A[l - 1]);
+        };
         if (_optimizer == Optimizer::Adam) {
             ++_adamT;
             const double bc1 = 1.0 - std::pow(_beta1, static_cast<double>(_adamT));
             const double bc2 = 1.0 - std::pow(_beta2, static_cast<double>(_adamT));
             for (size_t l = 0; l < _layers.size(); ++l) {
-                const Eigen::MatrixXd& prevA = (l == 0) ? X : A[l - 1];
                 auto& lay = _layers[l];
-                const Eigen::MatrixXd gW = invB * D[l] * prevA.transpose();
+                const Eigen::MatrixXd gW = invB * D[l] * prevA(l).transpose();
                 const Eigen::VectorXd gb = invB * D[l].rowwise().sum();
                 lay.mW = _beta1 * lay.mW + (1.0 - _beta1) * gW;
                 lay.vW = _beta2 * lay.vW + (1.0 - _beta2) * gW.cwiseProduct(gW);
@@ -409,30 +535,25 @@ void MlpMatrixNN::trainBatch(
         } else {
             const double lrB = _lr * invB;
             for (size_t l = 0; l < _layers.size(); ++l) {
-                const Eigen::MatrixXd& prevA = (l == 0) ? X : A[l - 1];
-                _layers[l].dW = lrB * D[l] * prevA.transpose() + _momentum * _layers[l].dW;
+                _layers[l].dW = lrB * D[l] * prevA(l).transpose() + _momentum * _layers[l].dW;
                 _layers[l].db = lrB * D[l].rowwise().sum() + _momentum * _layers[l].db;
                 _layers[l].W += _layers[l].dW;
                 _layers[l].b += _layers[l].db;
             }
         }
-        return;
+        return loss;
     }
 
 #ifdef NUNN_HAS_ARRAYFIRE
     {
-        const dim_t B = static_cast<dim_t>(inputs.size());
+        const dim_t B = static_cast<dim_t>(X.cols());
         const dim_t inSz = static_cast<dim_t>(_inputSize);
         const dim_t ouSz = static_cast<dim_t>(_layers.back().a.size());
 
-        // Pack inputs and targets into column-major Eigen matrices, then upload.
-        // Eigen MatrixXd is column-major, so .data() is contiguous and AF-compatible.
-        Eigen::MatrixXd X_host(inSz, B);
-        Eigen::MatrixXd T_host(ouSz, B);
-        for (dim_t j = 0; j < B; ++j) {
-            X_host.col(j) = Eigen::Map<const Eigen::VectorXd>(inputs[j].data(), inSz);
-            T_host.col(j) = Eigen::Map<const Eigen::VectorXd>(targets[j].data(), ouSz);
-        }
+        // Copy into plain column-major matrices (a Ref may carry an outer stride),
+        // then upload; Eigen MatrixXd .data() is contiguous and AF-compatible.
+        Eigen::MatrixXd X_host = X;
+        Eigen::MatrixXd T_host = T;
         af::array X_af = af::array(inSz, B, X_host.data(), afHost);
         af::array T_af = af::array(ouSz, B, T_host.data(), afHost);
 
@@ -464,6 +585,15 @@ void MlpMatrixNN::trainBatch(
             D_af[lu] = prop * af_activate_backward(_layers[lu].act, A_af[lu]);
         }
 
+        Eigen::MatrixXd A_last(ouSz, B);
+        A_af.back().host(A_last.data());
+        const double loss = (A_last - T_host).squaredNorm() / static_cast<double>(ouSz * B);
+        if (inputGrad) {
+            const af::array g = af::matmul(*_layers[0].W_af, D_af[0], AF_MAT_TRANS, AF_MAT_NONE);
+            inputGrad->resize(inSz, B);
+            g.host(inputGrad->data());
+        }
+
         // Weight update: mean gradient over batch + momentum.
         const double lrB = _lr / static_cast<double>(B);
         for (size_t l = 0; l < _layers.size(); ++l) {
@@ -477,8 +607,10 @@ void MlpMatrixNN::trainBatch(
 
         // Sync last sample's output to host for metrics called after trainBatch.
         A_af.back()(af::span, B - 1).host(_layers.back().a.data());
+        return loss;
     }
 #endif
+    return 0.0;
 }
 
 // ── copyOutputVector ──────────────────────────────────────────────────────────
@@ -515,19 +647,79 @@ Eigen::VectorXd MlpMatrixNN::getLayerB(size_t layer) const
 
 void MlpMatrixNN::setLayerW(size_t layer, const Eigen::MatrixXd& W)
 {
-    _layers.at(layer).W = W;
+    auto& l = _layers.at(layer);
+    if (W.rows() != l.W.rows() || W.cols() != l.W.cols())
+        throw std::invalid_argument("MlpMatrixNN::setLayerW: shape does not match the layer");
+    l.W = W;
+    _uploadParams();
 }
 
 void MlpMatrixNN::setLayerB(size_t layer, const Eigen::VectorXd& b)
 {
-    _layers.at(layer).b = b;
+    auto& l = _layers.at(layer);
+    if (b.size() != l.b.size())
+        throw std::invalid_argument("MlpMatrixNN::setLayerB: size does not match the layer");
+    l.b = b;
+    _uploadParams();
+}
+
+// ── Parameter buffer ──────────────────────────────────────────────────────────
+
+void MlpMatrixNN::copyParameters(const MlpMatrixNN& other)
+{
+    _checkSameTopology(other, "MlpMatrixNN::copyParameters");
+    _params = other._params; // same size: copied in place, no allocation
+    _uploadParams();
+}
+
+void MlpMatrixNN::blendParameters(const MlpMatrixNN& other, double tau)
+{
+    _checkSameTopology(other, "MlpMatrixNN::blendParameters");
+    if (!(tau >= 0.0 && tau <= 1.0))
+        throw std::invalid_argument("MlpMatrixNN::blendParameters: tau must be in [0, 1]");
+    _params = tau * other._params + (1.0 - tau) * _params;
+    _uploadParams();
+}
+
+void MlpMatrixNN::_bindParams() noexcept
+{
+    // Rebinding a Map is done by placement new (see Eigen's Map documentation).
+    double* p = _params.data();
+    for (auto& l : _layers) {
+        new (&l.W) Eigen::Map<Eigen::MatrixXd>(p, l.dW.rows(), l.dW.cols());
+        p += l.dW.size();
+        new (&l.b) Eigen::Map<Eigen::VectorXd>(p, l.db.size());
+        p += l.db.size();
+    }
+}
+
+void MlpMatrixNN::_checkSameTopology(const MlpMatrixNN& other, const char* what) const
+{
+    bool same = _layers.size() == other._layers.size();
+    for (size_t i = 0; same && i < _layers.size(); ++i)
+        same = _layers[i].W.rows() == other._layers[i].W.rows()
+            && _layers[i].W.cols() == other._layers[i].W.cols();
+    if (!same)
+        throw std::invalid_argument(std::string(what) + ": networks have different topologies");
+}
+
+void MlpMatrixNN::_uploadParams()
+{
+#ifdef NUNN_HAS_ARRAYFIRE
+    if (_backend == ComputeBackend::OpenCL) {
+        for (auto& l : _layers) {
+            l.W_af = af::array(l.W.rows(), l.W.cols(), l.W.data(), afHost);
+            l.b_af = af::array(static_cast<dim_t>(l.b.size()), (dim_t)1, l.b.data(), afHost);
+        }
+    }
+#endif
 }
 
 // ── getInputGradient ──────────────────────────────────────────────────────────
 
 Eigen::VectorXd MlpMatrixNN::getInputGradient() const
 {
-    // dL/d_input = W[0]^T * delta[0], valid after backPropagate() (Eigen path).
+    // -dL/d_input = W[0]^T * delta[0], valid after backPropagate() (Eigen path).
     return _layers[0].W.transpose() * _layers[0].delta;
 }
 
@@ -103,6 +103,30 @@ void MlpNN::feedForward() noexcept
     }
 }
 
+Eigen::MatrixXd MlpNN::feedForwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (static_cast<size_t>(X.rows()) != getInputSize())
+        throw SizeMismatchException();
+
+    Eigen::MatrixXd A = X;
+    for (size_t layerIdx = 0; layerIdx < _neuronLayers.size(); ++layerIdx) {
+        const auto& nlayer = _neuronLayers[layerIdx];
+        Eigen::MatrixXd W(static_cast<Eigen::Index>(nlayer.size()), A.rows());
+        Eigen::VectorXd b(W.rows());
+        for (Eigen::Index r = 0; r < W.rows(); ++r) {
+            const auto& neuron = nlayer[static_cast<size_t>(r)];
+            W.row(r) = Eigen::Map<const Eigen::RowVectorXd>(
+                neuron.weights.to_stdvec().data(), W.cols());
+            b(r) = neuron.bias;
+        }
+        Eigen::MatrixXd Z = W * A;
+        Z.colwise() += b;
+        A = Z.unaryExpr(
+            [a = _layerActivations[layerIdx]](double x) { return act::forward(a, x); });
+    }
+    return A;
+}
+
 void MlpNN::copyOutputVector(FpVector& outputs) noexcept
 {
     const auto& last = _neuronLayers.back();
@@ -7,79 +7,367 @@
 //
 
 #include "nu_pca.h"
+#include "nu_parallel.h"
+
+#include <Eigen/QR>
 
 #include <algorithm>
+#include <cmath>
+#include <random>
 
 namespace nu {
 
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+namespace {
+
+using RowMatrix = Pca::Matrix;
+using Eigen::Index;
+
+constexpr size_t MIN_ROWS_PER_THREAD = 2048;
+constexpr size_t TRANSFORM_BLOCK = 256;
+
+void checkMatrix(const Eigen::Ref<const RowMatrix>& X, const char* emptyMsg, const char* dimMsg)
+{
+    if (X.rows() == 0)
+        throw Pca::SizeMismatchException(emptyMsg);
+    if (X.cols() == 0)
+        throw Pca::SizeMismatchException(dimMsg);
+}
+
+RowMatrix toMatrix(const std::vector<std::vector<double>>& X, const char* emptyMsg,
+    const char* dimMsg, const char* raggedMsg)
+{
+    if (X.empty())
+        throw Pca::SizeMismatchException(emptyMsg);
+    const size_t D = X[0].size();
+    if (D == 0)
+        throw Pca::SizeMismatchException(dimMsg);
+    RowMatrix M(static_cast<Index>(X.size()), static_cast<Index>(D));
+    for (size_t i = 0; i < X.size(); ++i) {
+        if (X[i].size() != D)
+            throw Pca::SizeMismatchException(raggedMsg);
+        M.row(static_cast<Index>(i)) = Eigen::Map<const Eigen::RowVectorXd>(X[i].data(), Index(D));
+    }
+    return M;
+}
+
+// Column mean and Σ |x - mean|^2 of X, two passes with per-thread partials.
+double meanAndSumSquares(const Eigen::Ref<const RowMatrix>& X, size_t nt, Eigen::VectorXd& mean)
+{
+    const Index N = X.rows(), D = X.cols();
+    std::vector<Eigen::VectorXd> part(nt, Eigen::VectorXd::Zero(D));
+    parallelFor(size_t(N), nt, [&](size_t b, size_t e, size_t t) {
+        part[t] = X.middleRows(Index(b), Index(e - b)).colwise().sum().transpose();
+    });
+    mean = part[0];
+    for (size_t t = 1; t < nt; ++t)
+        mean += part[t];
+    mean /= static_cast<double>(N);
+
+    std::vector<double> ss(nt, 0.0);
+    parallelFor(size_t(N), nt, [&](size_t b, size_t e, size_t t) {
+        ss[t] = (X.middleRows(Index(b), Index(e - b)).rowwise() - mean.transpose())
+                    .squaredNorm();
+    });
+    double total = 0.0;
+    for (double v : ss)
+        total += v;
+    return total;
+}
+
+// Both products centre X one TRANSFORM_BLOCK of rows at a time rather than
+// subtracting mean^T M afterwards, which cancels when |mean| dwarfs the data.
+
+// (X - 1 mean^T) * M   [N × l], row blocks of X in parallel.
+Eigen::MatrixXd centredTimes(const Eigen::Ref<const RowMatrix>& X, const Eigen::VectorXd& mean,
+    const Eigen::MatrixXd& M, size_t nt)
+{
+    Eigen::MatrixXd Y(X.rows(), M.cols());
+    parallelFor(size_t(X.rows()), nt, [&](size_t b, size_t e, size_t) {
+        RowMatrix xc;
+        for (size_t r = b; r < e; r += TRANSFORM_BLOCK) {
+            const Index n = Index(std::min(TRANSFORM_BLOCK, e - r));
+            xc = X.middleRows(Index(r), n).rowwise() - mean.transpose();
+            Y.middleRows(Index(r), n).noalias() = xc * M;
+        }
+    });
+    return Y;
+}
+
+// (X - 1 mean^T)^T * Q   [D × l], per-thread partial products summed.
+Eigen::MatrixXd centredTransposeTimes(const Eigen::Ref<const RowMatrix>& X,
+    const Eigen::VectorXd& mean, const Eigen::MatrixXd& Q, size_t nt)
+{
+    std::vector<Eigen::MatrixXd> part(nt);
+    parallelFor(size_t(X.rows()), nt, [&](size_t b, size_t e, size_t t) {
+        RowMatrix xc;
+        part[t] = Eigen::MatrixXd::Zero(X.cols(), Q.cols());
+        for (size_t r = b; r < e; r += TRANSFORM_BLOCK) {
+            const Index n = Index(std::min(TRANSFORM_BLOCK, e - r));
+            xc = X.middleRows(Index(r), n).rowwise() - mean.transpose();
+            part[t].noalias() += xc.transpose() * Q.middleRows(Index(r), n);
+        }
+    });
+    Eigen::MatrixXd R = std::move(part[0]);
+    for (size_t t = 1; t < part.size(); ++t)
+        if (part[t].size())
+            R += part[t];
+    return R;
+}
+
+// Orthonormal basis of the column space of Y (thin Q of a Householder QR).
+Eigen::MatrixXd orthonormalize(const Eigen::MatrixXd& Y)
+{
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(Y);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(Y.rows(), Y.cols());
+}
+
+} // namespace
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
-Pca::Pca(size_t nComponents) noexcept
+Pca::Pca(size_t nComponents, unsigned seed) noexcept
     : _nComp(nComponents)
+    , _seed(seed)
 {
 }
 
+void Pca::reset() noexcept
+{
+    _dim = 0;
+    _fitted = false;
+    _mean.resize(0);
+    _components.resize(0, 0);
+    _S.resize(0);
+    _explVar.clear();
+    _totalExplVar = 0.0;
+    _nSeen = 0;
+    _totalSS = 0.0;
+}
+
 // ── fit ───────────────────────────────────────────────────────────────────────
 
 void Pca::fit(const std::vector<std::vector<double>>& X)
 {
-    if (X.empty())
-        throw SizeMismatchException("Pca::fit: dataset is empty");
-    const size_t N = X.size();
-    const size_t D = X[0].size();
-    if (D == 0)
-        throw SizeMismatchException("Pca::fit: samples have zero features");
-    for (const auto& x : X)
-        if (x.size() != D)
-            throw SizeMismatchException("Pca::fit: inconsistent sample sizes");
+    fit(toMatrix(X, "Pca::fit: dataset is empty", "Pca::fit: samples have zero features",
+        "Pca::fit: inconsistent sample sizes"));
+}
+
+void Pca::fit(const Eigen::Ref<const Matrix>& X)
+{
+    checkMatrix(X, "Pca::fit: dataset is empty", "Pca::fit: samples have zero features");
+    const size_t N = size_t(X.rows());
+    const size_t D = size_t(X.cols());
     if (_nComp == 0 || _nComp > std::min(N, D))
         throw SizeMismatchException(
             "Pca::fit: nComponents must be in [1, min(nSamples, nFeatures)]");
 
-    const Eigen::Index iN = static_cast<Eigen::Index>(N);
-    const Eigen::Index iD = static_cast<Eigen::Index>(D);
-
-    // Build data matrix [N x D]
-    Eigen::MatrixXd Xm(iN, iD);
-    for (Eigen::Index i = 0; i < iN; ++i)
-        for (Eigen::Index j = 0; j < iD; ++j)
-            Xm(i, j) = X[static_cast<size_t>(i)][static_cast<size_t>(j)];
-
-    // Centre
-    _mean = Xm.colwise().mean(); // [D]
-    Xm.rowwise() -= _mean.transpose();
-
-    // Thin SVD: Xm = U * S * V^T
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(Xm, Eigen::ComputeThinU | Eigen::ComputeThinV);
-    const Eigen::VectorXd& S = svd.singularValues(); // descending
-
-    // Components = first nComp columns of V (stored as rows)
-    const Eigen::Index nc = static_cast<Eigen::Index>(_nComp);
-    _components = svd.matrixV().leftCols(nc).transpose(); // [nComp x D]
-
-    // Explained variance: var_i = S_i^2 / (N-1)
-    const double denom = (N > 1) ? static_cast<double>(N - 1) : 1.0;
-    double totalVar = 0.0;
-    for (Eigen::Index i = 0; i < S.size(); ++i)
-        totalVar += S(i) * S(i);
-    totalVar /= denom;
+    const size_t m = std::min(N, D);
+    const bool randomized = _solver == Solver::Randomized
+        || (_solver == Solver::Auto && m > 500 && double(_nComp) < 0.8 * double(m));
+
+    const size_t nt = resolveThreads(_threads, N, MIN_ROWS_PER_THREAD);
+    _totalSS = meanAndSumSquares(X, nt, _mean);
+    _nSeen = N;
+
+    if (randomized)
+        _fitRandomized(X);
+    else
+        _fitFull(X);
+}
+
+void Pca::_fitFull(const Eigen::Ref<const Matrix>& X)
+{
+    // Centre a column-major copy; only V is needed.
+    Eigen::MatrixXd Xc = X;
+    Xc.rowwise() -= _mean.transpose();
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(Xc, Eigen::ComputeThinV);
+    _setModel(svd.singularValues(), svd.matrixV());
+}
+
+void Pca::_fitRandomized(const Eigen::Ref<const Matrix>& X)
+{
+    const Index N = X.rows(), D = X.cols();
+    const Index l = std::min<Index>(Index(_nComp + _oversampling), std::min(N, D));
+    const size_t nt = resolveThreads(_threads, size_t(N), MIN_ROWS_PER_THREAD);
+
+    std::mt19937 rng(_seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    Eigen::MatrixXd omega(D, l);
+    for (Index j = 0; j < l; ++j)
+        for (Index i = 0; i < D; ++i)
+            omega(i, j) = gauss(rng);
+
+    // Range finder with power iterations, re-orthonormalised at every step so
+    // that the small singular directions are not lost to rounding.
+    Eigen::MatrixXd Q = orthonormalize(centredTimes(X, _mean, omega, nt));
+    for (size_t it = 0; it < _powerIters; ++it) {
+        const Eigen::MatrixXd P = orthonormalize(centredTransposeTimes(X, _mean, Q, nt));
+        Q = orthonormalize(centredTimes(X, _mean, P, nt));
+    }
+
+    // B^T = Xc^T Q  [D × l]; Xc ≈ Q B, so the right singular vectors of B are
+    // the left singular vectors of B^T.
+    const Eigen::MatrixXd Bt = centredTransposeTimes(X, _mean, Q, nt);
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(Bt, Eigen::ComputeThinU);
+    _setModel(svd.singularValues(), svd.matrixU());
+}
+
+// ── partialFit ────────────────────────────────────────────────────────────────
+
+void Pca::partialFit(const std::vector<std::vector<double>>& batch)
+{
+    partialFit(toMatrix(batch, "Pca::partialFit: batch is empty",
+        "Pca::partialFit: samples have zero features",
+        "Pca::partialFit: inconsistent sample sizes"));
+}
+
+void Pca::partialFit(const Eigen::Ref<const Matrix>& batch)
+{
+    checkMatrix(
+        batch, "Pca::partialFit: batch is empty", "Pca::partialFit: samples have zero features");
+
+    // A model from fit() seeds the stream: its S, V, mean and sample count are
+    // exactly the state the update below consumes.
+    const Index nb = batch.rows(), D = batch.cols();
+    const Index k = static_cast<Index>(_nComp);
+    if (_nSeen == 0) {
+        if (_nComp == 0 || _nComp > size_t(std::min(nb, D)))
+            throw SizeMismatchException(
+                "Pca::partialFit: first batch needs nComponents <= min(rows, nFeatures)");
+    } else if (size_t(D) != _dim) {
+        throw SizeMismatchException("Pca::partialFit: feature count differs from earlier batches");
+    }
+
+    Eigen::VectorXd batchMean;
+    const size_t nt = resolveThreads(_threads, size_t(nb), MIN_ROWS_PER_THREAD);
+    const double batchSS = meanAndSumSquares(batch, nt, batchMean);
+
+    // Stack the current model, the centred batch and the mean-shift row.
+    const bool first = _nSeen == 0;
+    const Index rows = first ? nb : k + nb + 1;
+    Eigen::MatrixXd Z(rows, D);
+    Index r = 0;
+    if (!first) {
+        Z.topRows(k) = _S.asDiagonal() * _components;
+        r = k;
+    }
+    Z.middleRows(r, nb) = batch.rowwise() - batchMean.transpose();
+
+    const double n = static_cast<double>(_nSeen), m = static_cast<double>(nb);
+    if (!first) {
+        const Eigen::VectorXd delta = _mean - batchMean;
+        const double w = n * m / (n + m);
+        Z.row(rows - 1) = std::sqrt(w) * delta.transpose();
+        _totalSS += batchSS + w * delta.squaredNorm();
+        _mean = (n * _mean + m * batchMean) / (n + m);
+    } else {
+        _totalSS = batchSS;
+        _mean = batchMean;
+    }
+    _nSeen += size_t(nb);
+
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(Z, Eigen::ComputeThinV);
+    _setModel(svd.singularValues(), svd.matrixV());
+}
+
+// ── Model ─────────────────────────────────────────────────────────────────────
+
+void Pca::_setModel(const Eigen::VectorXd& S, const Eigen::MatrixXd& V)
+{
+    const Index nc = static_cast<Index>(_nComp);
+    _S = S.head(nc);
+    _components = V.leftCols(nc).transpose(); // [nComp x D]
+
+    // Sign convention: largest-magnitude entry of each component is positive.
+    for (Index c = 0; c < nc; ++c) {
+        Index arg = 0;
+        _components.row(c).cwiseAbs().maxCoeff(&arg);
+        if (_components(c, arg) < 0.0)
+            _components.row(c) *= -1.0;
+    }
+
+    // Explained variance: var_i = S_i^2 / (N-1); the total comes from the
+    // data itself, so truncated solvers report the same ratios as the full SVD.
+    const double denom = (_nSeen > 1) ? static_cast<double>(_nSeen - 1) : 1.0;
+    double totalVar = _totalSS / denom;
     if (totalVar < 1e-15)
         totalVar = 1.0; // constant data guard
 
     _explVar.resize(_nComp);
     double cumul = 0.0;
     for (size_t i = 0; i < _nComp; ++i) {
-        const double v = S(static_cast<Eigen::Index>(i));
+        const double v = _S(static_cast<Index>(i));
         _explVar[i] = (v * v / denom) / totalVar;
         cumul += _explVar[i];
     }
     _totalExplVar = cumul;
-    _dim = D;
+    _dim = size_t(V.rows());
     _fitted = true;
+    _updateProjection();
+}
+
+const Eigen::VectorXd& Pca::mean() const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    return _mean;
+}
+
+const Eigen::MatrixXd& Pca::components() const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    return _components;
+}
+
+const Eigen::VectorXd& Pca::singularValues() const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    return _S;
 }
 
 // ── transform ─────────────────────────────────────────────────────────────────
 
+void Pca::setWhiten(bool whiten)
+{
+    _whiten = whiten;
+    if (_fitted)
+        _updateProjection();
+}
+
+void Pca::_updateProjection()
+{
+    // scale_i = 1 / sigma_i with sigma_i = S_i / sqrt(N-1), or 1 unwhitened.
+    const Index nc = static_cast<Index>(_nComp);
+    const double denom = (_nSeen > 1) ? static_cast<double>(_nSeen - 1) : 1.0;
+    Eigen::VectorXd scale = Eigen::VectorXd::Ones(nc);
+    Eigen::VectorXd unscale = Eigen::VectorXd::Ones(nc);
+    if (_whiten) {
+        for (Index i = 0; i < nc; ++i) {
+            const double sigma = _S(i) / std::sqrt(denom);
+            if (sigma > 1e-12) {
+                scale(i) = 1.0 / sigma;
+                unscale(i) = sigma;
+            }
+        }
+    }
+    _projT = _components.transpose() * scale.asDiagonal();
+    _unproj = unscale.asDiagonal() * _components;
+}
+
+void Pca::_checkTransform(Index rows, Index cols, Index outRows, Index outCols) const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    if (size_t(cols) != _dim)
+        throw SizeMismatchException("Pca::transform: input size mismatch");
+    if (outRows != rows || size_t(outCols) != _nComp)
+        throw SizeMismatchException("Pca::transform: output must be [N x nComponents]");
+}
+
 std::vector<double> Pca::transform(const std::vector<double>& x) const
 {
     if (!_fitted)
@@ -87,24 +375,83 @@ std::vector<double> Pca::transform(const std::vector<double>& x) const
     if (x.size() != _dim)
         throw SizeMismatchException("Pca::transform: input size mismatch");
 
-    const Eigen::Map<const Eigen::VectorXd> xe(x.data(), static_cast<Eigen::Index>(_dim));
-    const Eigen::VectorXd z = _components * (xe - _mean); // [nComp]
-
+    const Eigen::Map<const Eigen::RowVectorXd> xe(x.data(), static_cast<Index>(_dim));
     std::vector<double> out(_nComp);
-    for (size_t i = 0; i < _nComp; ++i)
-        out[i] = z(static_cast<Eigen::Index>(i));
+    Eigen::Map<Eigen::RowVectorXd> z(out.data(), static_cast<Index>(_nComp));
+    z.noalias() = (xe - _mean.transpose()) * _projT;
     return out;
 }
 
 std::vector<std::vector<double>> Pca::transform(const std::vector<std::vector<double>>& X) const
 {
-    std::vector<std::vector<double>> out;
-    out.reserve(X.size());
+    std::vector<std::vector<double>> out(X.size());
+    if (X.empty())
+        return out;
+    if (!_fitted)
+        throw NotFittedException();
     for (const auto& x : X)
-        out.push_back(transform(x));
+        if (x.size() != _dim)
+            throw SizeMismatchException("Pca::transform: input size mismatch");
+
+    // Pack TRANSFORM_BLOCK centred samples at a time so each block is one
+    // GEMM without copying the whole dataset.
+    const size_t N = X.size();
+    const size_t nt = resolveThreads(_threads, N, MIN_ROWS_PER_THREAD);
+    parallelFor(N, nt, [&](size_t b, size_t e, size_t) {
+        Matrix xb, zb;
+        for (size_t r = b; r < e; r += TRANSFORM_BLOCK) {
+            const size_t n = std::min(TRANSFORM_BLOCK, e - r);
+            xb.resize(Index(n), Index(_dim));
+            for (size_t i = 0; i < n; ++i)
+                xb.row(Index(i))
+                    = Eigen::Map<const Eigen::RowVectorXd>(X[r + i].data(), Index(_dim))
+                    - _mean.transpose();
+            zb.noalias() = xb * _projT;
+            for (size_t i = 0; i < n; ++i)
+                out[r + i].assign(zb.row(Index(i)).data(), zb.row(Index(i)).data() + _nComp);
+        }
+    });
     return out;
 }
 
+Pca::Matrix Pca::transform(const Eigen::Ref<const Matrix>& X) const
+{
+    Matrix Z(X.rows(), static_cast<Index>(_nComp));
+    transform(X, Z);
+    return Z;
+}
+
+void Pca::transform(const Eigen::Ref<const Matrix>& X, Eigen::Ref<Matrix> Z) const
+{
+    _checkTransform(X.rows(), X.cols(), Z.rows(), Z.cols());
+    const size_t nt = resolveThreads(_threads, size_t(X.rows()), MIN_ROWS_PER_THREAD);
+    parallelFor(size_t(X.rows()), nt, [&](size_t b, size_t e, size_t) {
+        // Centre one cache-sized row block at a time, then project it.
+        Matrix xc;
+        for (size_t r = b; r < e; r += TRANSFORM_BLOCK) {
+            const Index n = Index(std::min(TRANSFORM_BLOCK, e - r));
+            xc = X.middleRows(Index(r), n).rowwise() - _mean.transpose();
+            Z.middleRows(Index(r), n).noalias() = xc * _projT;
+        }
+    });
+}
+
+void Pca::transform(const Eigen::Ref<const Matrix>& X, Eigen::Ref<MatrixF> Z) const
+{
+    _checkTransform(X.rows(), X.cols(), Z.rows(), Z.cols());
+    const size_t nt = resolveThreads(_threads, size_t(X.rows()), MIN_ROWS_PER_THREAD);
+    parallelFor(size_t(X.rows()), nt, [&](size_t b, size_t e, size_t) {
+        // Row blocks keep the centred input and double intermediate in cache.
+        Matrix xc, tmp;
+        for (size_t r = b; r < e; r += TRANSFORM_BLOCK) {
+            const Index n = Index(std::min(TRANSFORM_BLOCK, e - r));
+            xc = X.middleRows(Index(r), n).rowwise() - _mean.transpose();
+            tmp.noalias() = xc * _projT;
+            Z.middleRows(Index(r), n) = tmp.cast<float>();
+        }
+    });
+}
+
 // ── inverseTransform ──────────────────────────────────────────────────────────
 
 std::vector<double> Pca::inverseTransform(const std::vector<double>& z) const
@@ -114,15 +461,34 @@ std::vector<double> Pca::inverseTransform(const std::vector<double>& z) const
     if (z.size() != _nComp)
         throw SizeMismatchException("Pca::inverseTransform: z size != nComponents");
 
-    const Eigen::Map<const Eigen::VectorXd> ze(z.data(), static_cast<Eigen::Index>(_nComp));
-    const Eigen::VectorXd xhat = _components.transpose() * ze + _mean; // [D]
+    const Eigen::Map<const Eigen::VectorXd> ze(z.data(), static_cast<Index>(_nComp));
+    const Eigen::VectorXd xhat = _unproj.transpose() * ze + _mean; // [D]
 
     std::vector<double> out(_dim);
     for (size_t i = 0; i < _dim; ++i)
-        out[i] = xhat(static_cast<Eigen::Index>(i));
+        out[i] = xhat(static_cast<Index>(i));
     return out;
 }
 
+Pca::Matrix Pca::inverseTransform(const Eigen::Ref<const Matrix>& Z) const
+{
+    if (!_fitted)
+        throw NotFittedException();
+    if (size_t(Z.cols()) != _nComp)
+        throw SizeMismatchException("Pca::inverseTransform: z size != nComponents");
+
+    Matrix X(Z.rows(), static_cast<Index>(_dim));
+    const Eigen::RowVectorXd mu = _mean.transpose();
+    const size_t nt = resolveThreads(_threads, size_t(Z.rows()), MIN_ROWS_PER_THREAD);
+    parallelFor(size_t(Z.rows()), nt, [&](size_t b, size_t e, size_t) {
+        const Index n = Index(e - b);
+        auto Xb = X.middleRows(Index(b), n);
+        Xb.noalias() = Z.middleRows(Index(b), n) * _unproj;
+        Xb.rowwise() += mu;
+    });
+    return X;
+}
+
 // ── explainedVarianceRatio ────────────────────────────────────────────────────
 
 const std::vector<double>& Pca::explainedVarianceRatio() const
@@ -7,12 +7,22 @@
 //
 
 #include "nu_rbf.h"
+#include "nu_kmeans.h"
+#include "nu_linalg.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
 namespace nu {
 
+namespace {
+
+// Columns per block when accumulating the least-squares system.
+constexpr Eigen::Index LS_BLOCK = 4096;
+
+} // namespace
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
 Rbf::Rbf(size_t inputSize, size_t numCenters, size_t outputSize, double lr, RnnOutput outMode)
@@ -45,29 +55,45 @@ void Rbf::_initOutputWeights()
 
 // ── Center fitting ────────────────────────────────────────────────────────────
 
-void Rbf::fitCenters(const std::vector<std::vector<double>>& data)
+void Rbf::fitCenters(const std::vector<std::vector<double>>& data, CenterInit init)
 {
     if (data.empty())
         throw std::invalid_argument("Rbf::fitCenters: dataset is empty");
-    if (data[0].size() != _ni)
-        throw std::invalid_argument("Rbf::fitCenters: input size mismatch");
+    for (const auto& x : data)
+        if (x.size() != _ni)
+            throw std::invalid_argument("Rbf::fitCenters: input size mismatch");
 
-    std::uniform_int_distribution<size_t> pick(0, data.size() - 1);
-    for (int j = 0; j < static_cast<int>(_nc); ++j) {
-        const auto& s = data[pick(_rng)];
-        for (int k = 0; k < static_cast<int>(_ni); ++k)
-            _C(j, k) = s[static_cast<size_t>(k)];
+    if (init == CenterInit::KMeans) {
+        if (data.size() < _nc)
+            throw std::invalid_argument(
+                "Rbf::fitCenters: k-means needs at least numCenters samples");
+        KMeans km(_nc, 100, 1e-4, static_cast<unsigned>(_rng()));
+        km.fit(data);
+        _C = km.centroidMatrix();
+    } else {
+        std::uniform_int_distribution<size_t> pick(0, data.size() - 1);
+        for (int j = 0; j < static_cast<int>(_nc); ++j) {
+            const auto& s = data[pick(_rng)];
+            for (int k = 0; k < static_cast<int>(_ni); ++k)
+                _C(j, k) = s[static_cast<size_t>(k)];
+        }
     }
 
-    // Heuristic width: d_max / sqrt(2 * nc), where d_max = max pairwise center distance.
-    double dmax = 0.0;
-    for (int a = 0; a < static_cast<int>(_nc); ++a)
-        for (int b = a + 1; b < static_cast<int>(_nc); ++b)
-            dmax = std::max(dmax, (_C.row(a) - _C.row(b)).norm());
+    _setWidths();
+    _fitted = true;
+}
+
+void Rbf::_setWidths()
+{
+    // Heuristic width: d_max / sqrt(2 * nc), where d_max = max pairwise center
+    // distance, read off the Gram matrix: |a - b|^2 = |a|^2 + |b|^2 - 2 a.b
+    const Eigen::MatrixXd G = _C * _C.transpose();
+    const Eigen::VectorXd n2 = G.diagonal();
+    const Eigen::MatrixXd d2 = ((-2.0 * G).colwise() + n2).rowwise() + n2.transpose();
+    const double dmax = std::sqrt(std::max(0.0, d2.maxCoeff()));
 
     const double sig = (dmax > 0.0) ? dmax / std::sqrt(2.0 * static_cast<double>(_nc)) : 1.0;
     _sigma.setConstant(sig);
-    _fitted = true;
 }
 
 // ── Forward ───────────────────────────────────────────────────────────────────
@@ -106,6 +132,122 @@ std::vector<double> Rbf::forward(const std::vector<double>& x) const
     return std::vector<double>(y.data(), y.data() + y.size());
 }
 
+Eigen::MatrixXd Rbf::hiddenBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (!_fitted)
+        throw std::runtime_error("Rbf::hiddenBatch: call fitCenters() before forward()");
+    if (size_t(X.rows()) != _ni)
+        throw std::invalid_argument("Rbf::hiddenBatch: input size mismatch");
+
+    // D2 = |c|^2 - 2 C X + |x|^2, clamped against rounding below zero.
+    Eigen::MatrixXd D2 = -2.0 * _C * X; // [nc x B]
+    D2.colwise() += _C.rowwise().squaredNorm();
+    D2.rowwise() += X.colwise().squaredNorm();
+
+    // h = exp(-D2 / (2 sigma^2)), evaluated in place.
+    const Eigen::ArrayXd negInv = (2.0 * _sigma.array().square()).unaryExpr([](double d) {
+        return -1.0 / (d > 0.0 ? d : 1e-12);
+    });
+    D2.array() = (D2.array().max(0.0).colwise() * negInv).exp();
+    return D2;
+}
+
+Eigen::MatrixXd Rbf::forwardBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    Eigen::MatrixXd Y = _Wout * hiddenBatch(X);
+    Y.colwise() += _bout;
+    if (_outMode == RnnOutput::Softmax) {
+        Y.rowwise() -= Y.colwise().maxCoeff();
+        Y = Y.array().exp().matrix();
+        Y.array().rowwise() /= Y.colwise().sum().array();
+    }
+    return Y;
+}
+
+std::vector<std::vector<double>> Rbf::forwardBatch(
+    const std::vector<std::vector<double>>& inputs) const
+{
+    Eigen::MatrixXd X(Eigen::Index(_ni), Eigen::Index(inputs.size()));
+    for (size_t j = 0; j < inputs.size(); ++j) {
+        if (inputs[j].size() != _ni)
+            throw std::invalid_argument("Rbf::forwardBatch: input size mismatch");
+        X.col(Eigen::Index(j)) = Eigen::Map<const Eigen::VectorXd>(inputs[j].data(), X.rows());
+    }
+    const Eigen::MatrixXd Y = forwardBatch(X);
+    std::vector<std::vector<double>> out(inputs.size());
+    for (size_t j = 0; j < out.size(); ++j)
+        out[j].assign(Y.col(Eigen::Index(j)).data(), Y.col(Eigen::Index(j)).data() + _no);
+    return out;
+}
+
+// ── Closed-form output layer ──────────────────────────────────────────────────
+
+double Rbf::_loss(const Eigen::MatrixXd& Y, const Eigen::Ref<const Eigen::MatrixXd>& T) const
+{
+    // Summed over columns; same per-sample measures as train().
+    if (_outMode == RnnOutput::Softmax)
+        return -(T.array() * (Y.array() + 1e-12).log()).sum();
+    return (Y - T).squaredNorm() / static_cast<double>(_no);
+}
+
+double Rbf::fitLeastSquares(const Eigen::Ref<const Eigen::MatrixXd>& X,
+    const Eigen::Ref<const Eigen::MatrixXd>& T, double lambda)
+{
+    if (!_fitted)
+        throw std::runtime_error("Rbf::fitLeastSquares: call fitCenters() before training");
+    if (!(lambda >= 0.0))
+        throw std::invalid_argument("Rbf::fitLeastSquares: lambda must be >= 0");
+    if (X.cols() == 0 || X.cols() != T.cols())
+        throw std::invalid_argument("Rbf::fitLeastSquares: inputs/targets size mismatch or empty");
+    if (size_t(X.rows()) != _ni || size_t(T.rows()) != _no)
+        throw std::invalid_argument("Rbf::fitLeastSquares: input or target size mismatch");
+
+    // Normal equations of the bias-augmented hidden matrix, block by block.
+    const Eigen::Index nc = Eigen::Index(_nc), m = nc + 1;
+    Eigen::MatrixXd G = Eigen::MatrixXd::Zero(m, m);
+    Eigen::MatrixXd R = Eigen::MatrixXd::Zero(Eigen::Index(_no), m);
+    Eigen::MatrixXd H1;
+    for (Eigen::Index c = 0; c < X.cols(); c += LS_BLOCK) {
+        const Eigen::Index n = std::min(LS_BLOCK, X.cols() - c);
+        H1.resize(m, n);
+        H1.topRows(nc) = hiddenBatch(X.middleCols(c, n));
+        H1.row(nc).setOnes();
+        G.selfadjointView<Eigen::Lower>().rankUpdate(H1);
+        R.noalias() += T.middleCols(c, n) * H1.transpose();
+    }
+    G = G.selfadjointView<Eigen::Lower>();
+    G.diagonal().head(nc).array() += lambda;
+
+    // Gaussian kernel systems are often numerically singular without a
+    // ridge; those get the minimum-norm solution.
+    const Eigen::MatrixXd W = solveSpdOrMinNorm(G, R.transpose()); // [m x no]
+    _Wout = W.topRows(nc).transpose();
+    _bout = W.row(nc).transpose();
+
+    double total = 0.0;
+    for (Eigen::Index c = 0; c < X.cols(); c += LS_BLOCK) {
+        const Eigen::Index n = std::min(LS_BLOCK, X.cols() - c);
+        total += _loss(forwardBatch(X.middleCols(c, n)), T.middleCols(c, n));
+    }
+    return total / static_cast<double>(X.cols());
+}
+
+double Rbf::fitLeastSquares(const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets, double lambda)
+{
+    if (inputs.size() != targets.size() || inputs.empty())
+        throw std::invalid_argument("Rbf::fitLeastSquares: inputs/targets size mismatch or empty");
+    Eigen::MatrixXd X(Eigen::Index(_ni), Eigen::Index(inputs.size()));
+    Eigen::MatrixXd T(Eigen::Index(_no), Eigen::Index(targets.size()));
+    for (size_t j = 0; j < inputs.size(); ++j) {
+        if (inputs[j].size() != _ni || targets[j].size() != _no)
+            throw std::invalid_argument("Rbf::fitLeastSquares: input or target size mismatch");
+        X.col(Eigen::Index(j)) = Eigen::Map<const Eigen::VectorXd>(inputs[j].data(), X.rows());
+        T.col(Eigen::Index(j)) = Eigen::Map<const Eigen::VectorXd>(targets[j].data(), T.rows());
+    }
+    return fitLeastSquares(X, T, lambda);
+}
+
 // ── Training ──────────────────────────────────────────────────────────────────
 
 double Rbf::train(const std::vector<std::vector<double>>& inputs,
@@ -7,6 +7,7 @@
 //
 
 #include "nu_rbm.h"
+#include "nu_parallel.h"
 
 #include <algorithm>
 #include <cmath>
@@ -15,6 +16,27 @@
 
 namespace nu {
 
+namespace {
+
+constexpr size_t MIN_COLS_PER_THREAD = 16;
+
+// Element-wise logistic over a whole matrix (vectorised exp).
+template <class Derived> Eigen::MatrixXd sigmoidMatrix(const Eigen::MatrixBase<Derived>& x)
+{
+    return (1.0 + (-x.derived().array()).exp()).inverse().matrix();
+}
+
+// Bernoulli draws for P [rows × n], which is columns [col0, col0 + n) of a
+// batch draw: positions are the column-major element indices of the batch.
+Eigen::MatrixXd bernoulli(const Eigen::MatrixXd& P, const CounterRng& rng, size_t col0)
+{
+    Eigen::MatrixXd U(P.rows(), P.cols());
+    rng.uniform(uint64_t(col0) * uint64_t(P.rows()), U.data(), size_t(U.size()));
+    return (U.array() < P.array()).cast<double>().matrix();
+}
+
+} // namespace
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
 Rbm::Rbm(size_t nVisible, size_t nHidden, double lr, unsigned seed)
@@ -25,7 +47,8 @@ Rbm::Rbm(size_t nVisible, size_t nHidden, double lr, unsigned seed)
     , _b(Eigen::VectorXd::Zero(nVisible))
     , _c(Eigen::VectorXd::Zero(nHidden))
     , _rng(seed)
-    , _udist(0.0, 1.0)
+    , _seed(seed)
+    , _sampler(seed, 0)
 {
     if (nVisible == 0 || nHidden == 0)
         throw std::invalid_argument("Rbm: nVisible and nHidden must be > 0");
@@ -45,10 +68,9 @@ Eigen::VectorXd Rbm::_sigmoid(const Eigen::VectorXd& x)
 
 Eigen::VectorXd Rbm::_sample(const Eigen::VectorXd& probs)
 {
-    Eigen::VectorXd s(probs.size());
-    for (Eigen::Index i = 0; i < probs.size(); ++i)
-        s(i) = (_udist(_rng) < probs(i)) ? 1.0 : 0.0;
-    return s;
+    Eigen::VectorXd u(probs.size());
+    _sampler.uniform(u.data(), size_t(u.size()));
+    return (u.array() < probs.array()).cast<double>().matrix();
 }
 
 Eigen::VectorXd Rbm::_toEigen(const std::vector<double>& v) const
@@ -124,6 +146,130 @@ void Rbm::train(const std::vector<std::vector<double>>& dataset, size_t epochs,
     }
 }
 
+// ── Mini-batch CD-k / PCD-k ───────────────────────────────────────────────────
+
+void Rbm::setPersistent(bool persistent) noexcept
+{
+    _persistent = persistent;
+    _chainH.resize(0, 0);
+}
+
+Eigen::MatrixXd Rbm::hiddenProbsBatch(const Eigen::Ref<const Eigen::MatrixXd>& V) const
+{
+    if (size_t(V.rows()) != _nv)
+        throw std::invalid_argument("Rbm::hiddenProbsBatch: input size mismatch");
+    return sigmoidMatrix((_W * V).colwise() + _c);
+}
+
+Eigen::MatrixXd Rbm::visibleProbsBatch(const Eigen::Ref<const Eigen::MatrixXd>& H) const
+{
+    if (size_t(H.rows()) != _nh)
+        throw std::invalid_argument("Rbm::visibleProbsBatch: input size mismatch");
+    return sigmoidMatrix((_W.transpose() * H).colwise() + _b);
+}
+
+void Rbm::trainBatch(const Eigen::Ref<const Eigen::MatrixXd>& V, size_t k)
+{
+    if (size_t(V.rows()) != _nv)
+        throw std::invalid_argument("Rbm::trainBatch: input size mismatch");
+    if (V.cols() == 0)
+        throw std::invalid_argument("Rbm::trainBatch: empty batch");
+    if (k == 0)
+        k = 1;
+
+    const size_t B = size_t(V.cols());
+    const bool chainReady = _persistent && size_t(_chainH.cols()) == B;
+    if (_persistent && !chainReady)
+        _chainH.resize(Eigen::Index(_nh), Eigen::Index(B));
+
+    // Draw streams for this update: 0 = h0, 1 + 2s = v_s, 2 + 2s = h_s,
+    // 2k = persistent chain.
+    const uint64_t base = 1 + _draws;
+    _draws += 2 * k + 1;
+    auto stream = [&](uint64_t i) { return CounterRng(_seed, base + i); };
+
+    const size_t nt = resolveThreads(_threads, B, MIN_COLS_PER_THREAD);
+    std::vector<Eigen::MatrixXd> dW(nt);
+    std::vector<Eigen::VectorXd> db(nt), dc(nt);
+
+    parallelFor(B, nt, [&](size_t b, size_t e, size_t t) {
+        const Eigen::Index c0 = Eigen::Index(b), n = Eigen::Index(e - b);
+        const auto V0 = V.middleCols(c0, n);
+
+        // Positive phase
+        const Eigen::MatrixXd H0p = sigmoidMatrix((_W * V0).colwise() + _c);
+        Eigen::MatrixXd Hs = chainReady ? Eigen::MatrixXd(_chainH.middleCols(c0, n))
+                                        : bernoulli(H0p, stream(0), b);
+
+        // Negative phase: k Gibbs steps, last hidden step keeps probabilities
+        Eigen::MatrixXd Vk, Hkp;
+        for (size_t step = 0; step < k; ++step) {
+            const Eigen::MatrixXd Vp = sigmoidMatrix((_W.transpose() * Hs).colwise() + _b);
+            Vk = bernoulli(Vp, stream(1 + 2 * step), b);
+            Hkp = sigmoidMatrix((_W * Vk).colwise() + _c);
+            if (step + 1 < k)
+                Hs = bernoulli(Hkp, stream(2 + 2 * step), b);
+        }
+        if (_persistent)
+            _chainH.middleCols(c0, n) = bernoulli(Hkp, stream(2 * k), b);
+
+        dW[t].noalias() = H0p * V0.transpose();
+        dW[t].noalias() -= Hkp * Vk.transpose();
+        db[t] = (V0 - Vk).rowwise().sum();
+        dc[t] = (H0p - Hkp).rowwise().sum();
+    });
+
+    for (size_t t = 1; t < nt; ++t) {
+        dW[0] += dW[t];
+        db[0] += db[t];
+        dc[0] += dc[t];
+    }
+    const double step = _lr / static_cast<double>(B);
+    _W += step * dW[0];
+    _b += step * db[0];
+    _c += step * dc[0];
+}
+
+void Rbm::trainMiniBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs, size_t batchSize, size_t cdK)
+{
+    if (X.cols() == 0)
+        throw std::invalid_argument("Rbm::trainMiniBatch: dataset is empty");
+    if (size_t(X.rows()) != _nv)
+        throw std::invalid_argument("Rbm::trainMiniBatch: input size mismatch");
+
+    const size_t N = size_t(X.cols());
+    const size_t B = std::max<size_t>(1, std::min(batchSize, N));
+    std::vector<Eigen::Index> order(N);
+    std::iota(order.begin(), order.end(), Eigen::Index(0));
+
+    Eigen::MatrixXd batch(X.rows(), Eigen::Index(B));
+    for (size_t ep = 0; ep < epochs; ++ep) {
+        std::shuffle(order.begin(), order.end(), _rng);
+        // Full batches only, so PCD keeps one chain per column; the tail
+        // columns land in other batches on later epochs.
+        for (size_t start = 0; start + B <= N; start += B) {
+            for (size_t j = 0; j < B; ++j)
+                batch.col(Eigen::Index(j)) = X.col(order[start + j]);
+            trainBatch(batch, cdK);
+        }
+    }
+}
+
+void Rbm::trainMiniBatch(const std::vector<std::vector<double>>& dataset, size_t epochs,
+    size_t batchSize, size_t cdK)
+{
+    if (dataset.empty())
+        throw std::invalid_argument("Rbm::trainMiniBatch: dataset is empty");
+    Eigen::MatrixXd X(Eigen::Index(_nv), Eigen::Index(dataset.size()));
+    for (size_t j = 0; j < dataset.size(); ++j) {
+        if (dataset[j].size() != _nv)
+            throw std::invalid_argument("Rbm::trainMiniBatch: input size mismatch");
+        X.col(Eigen::Index(j)) = Eigen::Map<const Eigen::VectorXd>(dataset[j].data(), X.rows());
+    }
+    trainMiniBatch(X, epochs, batchSize, cdK);
+}
+
 // ── Inference ─────────────────────────────────────────────────────────────────
 
 std::vector<double> Rbm::reconstruct(const std::vector<double>& v) const
@@ -159,4 +305,12 @@ double Rbm::reconstructionError(const std::vector<std::vector<double>>& dataset)
     return total / static_cast<double>(dataset.size());
 }
 
+double Rbm::reconstructionError(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (X.cols() == 0)
+        return 0.0;
+    const Eigen::MatrixXd R = visibleProbsBatch(hiddenProbsBatch(X));
+    return (X - R).squaredNorm() / static_cast<double>(X.size());
+}
+
 } // namespace nu
@@ -7,6 +7,7 @@
 //
 
 #include "nu_som.h"
+#include "nu_parallel.h"
 
 #include <algorithm>
 #include <cmath>
@@ -15,6 +16,27 @@
 
 namespace nu {
 
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr Eigen::Index BMU_BLOCK = 256; // samples per GEMM block
+constexpr size_t MIN_ROWS_PER_THREAD = 1024;
+
+// BMU of every row of Xb: argmin_i ||w_i||^2 - 2 w_i . x, one GEMM per block.
+void assignBlock(const Eigen::Ref<const Som::Matrix>& Xb, const Eigen::MatrixXd& W,
+    const Eigen::VectorXd& wNorm2, Som::Matrix& G, size_t* out)
+{
+    G.noalias() = Xb * W.transpose(); // [n x neurons]
+    for (Eigen::Index i = 0; i < Xb.rows(); ++i) {
+        Eigen::Index best;
+        (wNorm2.transpose() - 2.0 * G.row(i)).minCoeff(&best);
+        out[i] = static_cast<size_t>(best);
+    }
+}
+
+} // namespace
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
 Som::Som(size_t rows, size_t cols, size_t inputDim, double lr, double initRadius, unsigned seed)
@@ -49,20 +71,61 @@ void Som::reshuffleWeights()
     for (Eigen::Index i = 0; i < _W.rows(); ++i)
         for (Eigen::Index j = 0; j < _W.cols(); ++j)
             _W(i, j) = dist(_rng);
+    _wNorm2 = _W.rowwise().squaredNorm();
+}
+
+void Som::setNeighborhoodTruncation(double sigmas)
+{
+    if (!(sigmas >= 0.0))
+        throw std::invalid_argument("Som::setNeighborhoodTruncation: sigmas must be >= 0");
+    _truncate = sigmas;
+}
+
+// ── Neighbourhood ─────────────────────────────────────────────────────────────
+
+std::vector<double> Som::_kernel(double radius) const
+{
+    // h(i, j) = g[|dr|] * g[|dc|] with g[k] = exp(-k^2 / (2 sigma^2)).
+    const double maxR = static_cast<double>(std::max(_rows, _cols) - 1);
+    const double R = _truncate > 0.0 ? std::min(maxR, std::floor(_truncate * radius)) : maxR;
+    const double two_r2 = 2.0 * radius * radius;
+
+    std::vector<double> g(static_cast<size_t>(std::max(R, 0.0)) + 1);
+    g[0] = 1.0;
+    for (size_t k = 1; k < g.size(); ++k)
+        g[k] = two_r2 > 0.0 ? std::exp(-double(k * k) / two_r2) : 0.0;
+    return g;
 }
 
 // ── BMU ───────────────────────────────────────────────────────────────────────
 
-size_t Som::_bmuFlat(const Eigen::VectorXd& x) const
+size_t Som::_bmuFlat(const Eigen::Ref<const Eigen::VectorXd>& x) const
 {
-    // Squared distances from x to every neuron weight vector
-    const Eigen::MatrixXd diff = _W.rowwise() - x.transpose(); // [N x d]
-    const Eigen::VectorXd sq = diff.rowwise().squaredNorm(); // [N]
+    // ||x - w_i||^2 = ||w_i||^2 - 2 w_i . x + ||x||^2; the last term is common.
+    Eigen::VectorXd score = _wNorm2;
+    score.noalias() -= 2.0 * (_W * x);
     Eigen::Index idx;
-    sq.minCoeff(&idx);
+    score.minCoeff(&idx);
     return static_cast<size_t>(idx);
 }
 
+std::vector<size_t> Som::bmuBatch(const Eigen::Ref<const Matrix>& X) const
+{
+    if (size_t(X.cols()) != _dim)
+        throw std::invalid_argument("Som::bmuBatch: input size mismatch");
+
+    std::vector<size_t> out(size_t(X.rows()));
+    const size_t nt = resolveThreads(_threads, out.size(), MIN_ROWS_PER_THREAD);
+    parallelFor(out.size(), nt, [&](size_t b, size_t e, size_t) {
+        Matrix G;
+        for (size_t r = b; r < e; r += BMU_BLOCK) {
+            const Eigen::Index n = Eigen::Index(std::min<size_t>(BMU_BLOCK, e - r));
+            assignBlock(X.middleRows(Eigen::Index(r), n), _W, _wNorm2, G, out.data() + r);
+        }
+    });
+    return out;
+}
+
 std::pair<size_t, size_t> Som::bmu(const std::vector<double>& x) const
 {
     if (x.size() != _dim)
@@ -80,17 +143,24 @@ void Som::update(const std::vector<double>& x, double lr, double radius)
     if (x.size() != _dim)
         throw std::invalid_argument("Som::update: input size mismatch");
 
-    const Eigen::VectorXd xe
-        = Eigen::Map<const Eigen::VectorXd>(x.data(), static_cast<Eigen::Index>(_dim));
+    const Eigen::Map<const Eigen::VectorXd> xe(x.data(), static_cast<Eigen::Index>(_dim));
     const size_t bmu_i = _bmuFlat(xe);
+    const size_t br = bmu_i / _cols, bc = bmu_i % _cols;
 
-    const Eigen::VectorXd bmu_pos = _pos.row(bmu_i); // [2]
-    const double two_r2 = 2.0 * radius * radius;
+    // Only neurons inside the truncated window move.
+    const std::vector<double> g = _kernel(radius);
+    const size_t R = g.size() - 1;
+    const size_t r0 = br > R ? br - R : 0, r1 = std::min(_rows - 1, br + R);
+    const size_t c0 = bc > R ? bc - R : 0, c1 = std::min(_cols - 1, bc + R);
 
-    for (Eigen::Index i = 0; i < static_cast<Eigen::Index>(_rows * _cols); ++i) {
-        const double d2 = (_pos.row(i) - bmu_pos.transpose()).squaredNorm();
-        const double h = std::exp(-d2 / two_r2);
-        _W.row(i) += lr * h * (xe.transpose() - _W.row(i));
+    for (size_t r = r0; r <= r1; ++r) {
+        const double gr = g[r > br ? r - br : br - r];
+        for (size_t c = c0; c <= c1; ++c) {
+            const double h = gr * g[c > bc ? c - bc : bc - c];
+            const Eigen::Index i = static_cast<Eigen::Index>(_idx(r, c));
+            _W.row(i) += lr * h * (xe.transpose() - _W.row(i));
+            _wNorm2(i) = _W.row(i).squaredNorm();
+        }
     }
 }
 
@@ -132,6 +202,117 @@ void Som::train(const std::vector<std::vector<double>>& dataset, size_t epochs,
     }
 }
 
+// ── Batch training ────────────────────────────────────────────────────────────
+
+void Som::_batchEpoch(const Eigen::Ref<const Matrix>& X, double radius)
+{
+    const Eigen::Index N = static_cast<Eigen::Index>(_rows * _cols);
+    const Eigen::Index d = static_cast<Eigen::Index>(_dim);
+
+    // Per-thread BMU sums S_j and counts n_j.
+    const size_t M = size_t(X.rows());
+    const size_t nt = resolveThreads(_threads, M, MIN_ROWS_PER_THREAD);
+    std::vector<Matrix> sums(nt);
+    std::vector<Eigen::VectorXd> counts(nt);
+    parallelFor(M, nt, [&](size_t b, size_t e, size_t t) {
+        sums[t].setZero(N, d);
+        counts[t].setZero(N);
+        Matrix G;
+        std::vector<size_t> bmus(static_cast<size_t>(BMU_BLOCK));
+        for (size_t r = b; r < e; r += BMU_BLOCK) {
+            const Eigen::Index n = Eigen::Index(std::min<size_t>(BMU_BLOCK, e - r));
+            assignBlock(X.middleRows(Eigen::Index(r), n), _W, _wNorm2, G, bmus.data());
+            for (Eigen::Index i = 0; i < n; ++i) {
+                const Eigen::Index j = Eigen::Index(bmus[size_t(i)]);
+                sums[t].row(j) += X.row(Eigen::Index(r) + i);
+                counts[t](j) += 1.0;
+            }
+        }
+    });
+    for (size_t t = 1; t < sums.size(); ++t) {
+        sums[0] += sums[t];
+        counts[0] += counts[t];
+    }
+
+    // Separable smoothing: along each grid row, then along each grid column.
+    const std::vector<double> g = _kernel(radius);
+    const size_t R = g.size() - 1;
+    const size_t gnt = resolveThreads(_threads, _rows, 1);
+
+    Matrix T = Matrix::Zero(N, d);
+    Eigen::VectorXd tc = Eigen::VectorXd::Zero(N);
+    parallelFor(_rows, gnt, [&](size_t b, size_t e, size_t) {
+        for (size_t r = b; r < e; ++r)
+            for (size_t c = 0; c < _cols; ++c) {
+                const Eigen::Index i = Eigen::Index(_idx(r, c));
+                const size_t c1 = std::min(_cols - 1, c + R);
+                for (size_t k = c > R ? c - R : 0; k <= c1; ++k) {
+                    const Eigen::Index j = Eigen::Index(_idx(r, k));
+                    if (counts[0](j) == 0.0)
+                        continue;
+                    const double h = g[k > c ? k - c : c - k];
+                    T.row(i) += h * sums[0].row(j);
+                    tc(i) += h * counts[0](j);
+                }
+            }
+    });
+
+    parallelFor(_rows, gnt, [&](size_t b, size_t e, size_t) {
+        Eigen::RowVectorXd num(d);
+        for (size_t r = b; r < e; ++r)
+            for (size_t c = 0; c < _cols; ++c) {
+                num.setZero();
+                double den = 0.0;
+                const size_t r1 = std::min(_rows - 1, r + R);
+                for (size_t k = r > R ? r - R : 0; k <= r1; ++k) {
+                    const Eigen::Index j = Eigen::Index(_idx(k, c));
+                    const double h = g[k > r ? k - r : r - k];
+                    num += h * T.row(j);
+                    den += h * tc(j);
+                }
+                // Neurons with no data in their window keep their weights.
+                if (den > 0.0)
+                    _W.row(Eigen::Index(_idx(r, c))) = num / den;
+            }
+    });
+    _wNorm2 = _W.rowwise().squaredNorm();
+}
+
+void Som::trainBatch(const Eigen::Ref<const Matrix>& X, size_t epochs, double finalRadius)
+{
+    if (X.rows() == 0)
+        throw std::invalid_argument("Som::trainBatch: dataset is empty");
+    if (size_t(X.cols()) != _dim)
+        throw std::invalid_argument("Som::trainBatch: input size mismatch");
+    if (epochs == 0)
+        return;
+
+    // Same radius schedule as train().
+    const double eps = 1e-12;
+    const double T = static_cast<double>(epochs);
+    const double rLambda = (epochs > 1)
+        ? -std::log(std::max(finalRadius, eps) / std::max(_r0, eps)) / (T - 1.0)
+        : 0.0;
+
+    for (size_t ep = 0; ep < epochs; ++ep)
+        _batchEpoch(X, _r0 * std::exp(-rLambda * static_cast<double>(ep)));
+}
+
+void Som::trainBatch(
+    const std::vector<std::vector<double>>& dataset, size_t epochs, double finalRadius)
+{
+    if (dataset.empty())
+        throw std::invalid_argument("Som::trainBatch: dataset is empty");
+    Matrix X(static_cast<Eigen::Index>(dataset.size()), static_cast<Eigen::Index>(_dim));
+    for (size_t i = 0; i < dataset.size(); ++i) {
+        if (dataset[i].size() != _dim)
+            throw std::invalid_argument("Som::trainBatch: input size mismatch");
+        X.row(Eigen::Index(i))
+            = Eigen::Map<const Eigen::RowVectorXd>(dataset[i].data(), Eigen::Index(_dim));
+    }
+    trainBatch(X, epochs, finalRadius);
+}
+
 // ── Quantization error ────────────────────────────────────────────────────────
 
 double Som::quantizationError(const std::vector<std::vector<double>>& dataset) const
@@ -149,6 +330,17 @@ double Som::quantizationError(const std::vector<std::vector<double>>& dataset) c
     return total / static_cast<double>(dataset.size());
 }
 
+double Som::quantizationError(const Eigen::Ref<const Matrix>& X) const
+{
+    if (X.rows() == 0)
+        return 0.0;
+    const std::vector<size_t> b = bmuBatch(X);
+    double total = 0.0;
+    for (Eigen::Index i = 0; i < X.rows(); ++i)
+        total += (X.row(i) - _W.row(Eigen::Index(b[size_t(i)]))).norm();
+    return total / static_cast<double>(X.rows());
+}
+
 // ── Weight access ─────────────────────────────────────────────────────────────
 
 std::vector<double> Som::getWeights(size_t r, size_t c) const
@@ -33,7 +33,7 @@ Vae::Vae(size_t inputDim, size_t hiddenDim, size_t latentDim, double lr, unsigne
     , _W_out(Eigen::MatrixXd::Zero(inputDim, hiddenDim))
     , _b_out(Eigen::VectorXd::Zero(inputDim))
     , _rng(seed)
-    , _ndist(0.0, 1.0)
+    , _noise(seed, 1)
 {
     if (inputDim == 0 || hiddenDim == 0 || latentDim == 0)
         throw std::invalid_argument("Vae: all dimensions must be > 0");
@@ -54,24 +54,33 @@ Vae::Vae(size_t inputDim, size_t hiddenDim, size_t latentDim, double lr, unsigne
 
 // ── Static helpers ────────────────────────────────────────────────────────────
 
-Eigen::VectorXd Vae::_relu(const Eigen::VectorXd& x)
+Eigen::MatrixXd Vae::_relu(const Eigen::MatrixXd& x)
 {
     return x.cwiseMax(0.0);
 }
 
-Eigen::VectorXd Vae::_sigmoid(const Eigen::VectorXd& x)
+Eigen::MatrixXd Vae::_sigmoid(const Eigen::MatrixXd& x)
 {
-    return x.unaryExpr([](double v) { return 1.0 / (1.0 + std::exp(-v)); });
+    return (1.0 + (-x.array()).exp()).inverse().matrix();
 }
 
-Eigen::VectorXd Vae::_sampleNormal(size_t n)
+Eigen::MatrixXd Vae::_sampleNormal(size_t rows, size_t cols)
 {
-    Eigen::VectorXd s(static_cast<Eigen::Index>(n));
-    for (Eigen::Index i = 0; i < s.size(); ++i)
-        s(i) = _ndist(_rng);
+    Eigen::MatrixXd s(static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols));
+    _noise.normal(s.data(), static_cast<size_t>(s.size()));
     return s;
 }
 
+// D A^T. A single-column batch goes through the outer-product kernel, which
+// is much cheaper than a depth-1 GEMM.
+Eigen::MatrixXd Vae::_outer(
+    const Eigen::Ref<const Eigen::MatrixXd>& D, const Eigen::Ref<const Eigen::MatrixXd>& A)
+{
+    if (D.cols() == 1)
+        return D.col(0) * A.col(0).transpose();
+    return D * A.transpose();
+}
+
 Eigen::VectorXd Vae::_toEigen(const std::vector<double>& v, size_t expected) const
 {
     if (v.size() != expected)
@@ -79,122 +88,212 @@ Eigen::VectorXd Vae::_toEigen(const std::vector<double>& v, size_t expected) con
     return Eigen::Map<const Eigen::VectorXd>(v.data(), static_cast<Eigen::Index>(expected));
 }
 
-// ── Decoder (shared) ──────────────────────────────────────────────────────────
+void Vae::setOptimizer(Optimizer opt, double beta1, double beta2, double eps) noexcept
+{
+    _optimizer = opt;
+    _beta1 = beta1;
+    _beta2 = beta2;
+    _adamEps = eps;
+    _adamT = 0;
+    for (auto& m : _adamM)
+        m.resize(0, 0);
+    for (auto& v : _adamV)
+        v.resize(0, 0);
+}
+
+// ── Batched inference ─────────────────────────────────────────────────────────
 
-Eigen::VectorXd Vae::_decodeEigen(const Eigen::VectorXd& z) const
+Eigen::MatrixXd Vae::_encodeHidden(const Eigen::Ref<const Eigen::MatrixXd>& X) const
 {
-    return _sigmoid(_W_out * _relu(_W_dec * z + _b_dec) + _b_out);
+    Eigen::MatrixXd H = _W_enc * X;
+    H.colwise() += _b_enc;
+    return _relu(H);
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd> Vae::encodeBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (static_cast<size_t>(X.rows()) != _nx)
+        throw std::invalid_argument("Vae: input size mismatch");
+
+    const Eigen::MatrixXd H = _encodeHidden(X);
+    Eigen::MatrixXd Mu = _W_mu * H;
+    Mu.colwise() += _b_mu;
+    Eigen::MatrixXd Lv = _W_lv * H;
+    Lv.colwise() += _b_lv;
+    Lv = Lv.cwiseMax(-10.0).cwiseMin(10.0);
+    return { std::move(Mu), std::move(Lv) };
+}
+
+Eigen::MatrixXd Vae::decodeBatch(const Eigen::Ref<const Eigen::MatrixXd>& Z) const
+{
+    if (static_cast<size_t>(Z.rows()) != _nz)
+        throw std::invalid_argument("Vae: input size mismatch");
+
+    Eigen::MatrixXd H = _W_dec * Z;
+    H.colwise() += _b_dec;
+    Eigen::MatrixXd Out = _W_out * _relu(H);
+    Out.colwise() += _b_out;
+    return _sigmoid(Out);
+}
+
+Eigen::MatrixXd Vae::reconstructBatch(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    return decodeBatch(encodeBatch(X).first);
+}
+
+Eigen::MatrixXd Vae::generateBatch(size_t n)
+{
+    return decodeBatch(_sampleNormal(_nz, n));
 }
 
 // ── Public inference ──────────────────────────────────────────────────────────
 
 std::pair<std::vector<double>, std::vector<double>> Vae::encode(const std::vector<double>& x) const
 {
-    const Eigen::VectorXd xe = _toEigen(x, _nx);
-    const Eigen::VectorXd h = _relu(_W_enc * xe + _b_enc);
-    const Eigen::VectorXd mu = _W_mu * h + _b_mu;
-    const Eigen::VectorXd lv = (_W_lv * h + _b_lv).cwiseMax(-10.0).cwiseMin(10.0);
+    const auto [mu, lv] = encodeBatch(_toEigen(x, _nx));
     return { std::vector<double>(mu.data(), mu.data() + _nz),
         std::vector<double>(lv.data(), lv.data() + _nz) };
 }
 
 std::vector<double> Vae::decode(const std::vector<double>& z) const
 {
-    const Eigen::VectorXd ze = _toEigen(z, _nz);
-    const Eigen::VectorXd r = _decodeEigen(ze);
+    const Eigen::MatrixXd r = decodeBatch(_toEigen(z, _nz));
     return std::vector<double>(r.data(), r.data() + _nx);
 }
 
 std::vector<double> Vae::reconstruct(const std::vector<double>& x) const
 {
-    const Eigen::VectorXd xe = _toEigen(x, _nx);
-    const Eigen::VectorXd h = _relu(_W_enc * xe + _b_enc);
-    const Eigen::VectorXd mu = _W_mu * h + _b_mu;
-    const Eigen::VectorXd r = _decodeEigen(mu);
+    const Eigen::MatrixXd r = reconstructBatch(_toEigen(x, _nx));
     return std::vector<double>(r.data(), r.data() + _nx);
 }
 
 std::vector<double> Vae::generate()
 {
-    const Eigen::VectorXd z = _sampleNormal(_nz);
-    const Eigen::VectorXd r = _decodeEigen(z);
+    const Eigen::MatrixXd r = generateBatch(1);
     return std::vector<double>(r.data(), r.data() + _nx);
 }
 
 // ── Training ──────────────────────────────────────────────────────────────────
 
+template <class Param, class Grad> void Vae::_step(Param& p, const Grad& g, size_t k)
+{
+    if (_optimizer == Optimizer::SGD) {
+        p -= _lr * g;
+        return;
+    }
+
+    Eigen::MatrixXd& m = _adamM[k];
+    Eigen::MatrixXd& v = _adamV[k];
+    if (m.size() != p.size()) {
+        m = Eigen::MatrixXd::Zero(p.rows(), p.cols());
+        v = Eigen::MatrixXd::Zero(p.rows(), p.cols());
+    }
+
+    m = _beta1 * m + (1.0 - _beta1) * g;
+    v = _beta2 * v + (1.0 - _beta2) * g.cwiseAbs2();
+
+    const double bc1 = 1.0 - std::pow(_beta1, static_cast<double>(_adamT));
+    const double bc2 = 1.0 - std::pow(_beta2, static_cast<double>(_adamT));
+    p.array() -= _lr * (m.array() / bc1) / ((v.array() / bc2).sqrt() + _adamEps);
+}
+
 std::pair<double, double> Vae::trainStep(const std::vector<double>& x, double klWeight)
 {
-    const Eigen::VectorXd xe = _toEigen(x, _nx);
+    return trainBatch(_toEigen(x, _nx), klWeight);
+}
+
+std::pair<double, double> Vae::trainBatch(
+    const Eigen::Ref<const Eigen::MatrixXd>& X, double klWeight)
+{
+    if (static_cast<size_t>(X.rows()) != _nx)
+        throw std::invalid_argument("Vae: input size mismatch");
+    if (X.cols() == 0)
+        throw std::invalid_argument("Vae::trainBatch: empty batch");
+
+    const auto B = static_cast<size_t>(X.cols());
+    const double bd = static_cast<double>(B);
     const double nxd = static_cast<double>(_nx);
     const double nzd = static_cast<double>(_nz);
 
     // ── Forward pass ──────────────────────────────────────────────────────────
-    const Eigen::VectorXd pre_enc = _W_enc * xe + _b_enc;
-    const Eigen::VectorXd h_enc = _relu(pre_enc);
-
-    const Eigen::VectorXd mu = _W_mu * h_enc + _b_mu;
-    const Eigen::VectorXd lv = (_W_lv * h_enc + _b_lv).cwiseMax(-10.0).cwiseMin(10.0);
-    const Eigen::VectorXd sigma = (0.5 * lv.array()).exp();
-    const Eigen::VectorXd eps = _sampleNormal(_nz);
-    const Eigen::VectorXd z = mu + sigma.cwiseProduct(eps);
-
-    const Eigen::VectorXd pre_dec = _W_dec * z + _b_dec;
-    const Eigen::VectorXd h_dec = _relu(pre_dec);
-    const Eigen::VectorXd pre_out = _W_out * h_dec + _b_out;
-    const Eigen::VectorXd recon = _sigmoid(pre_out);
-
-    // ── Losses ────────────────────────────────────────────────────────────────
+    Eigen::MatrixXd pre_enc = _W_enc * X;
+    pre_enc.colwise() += _b_enc;
+    const Eigen::MatrixXd h_enc = _relu(pre_enc);
+
+    Eigen::MatrixXd mu = _W_mu * h_enc;
+    mu.colwise() += _b_mu;
+    Eigen::MatrixXd lv = _W_lv * h_enc;
+    lv.colwise() += _b_lv;
+    lv = lv.cwiseMax(-10.0).cwiseMin(10.0);
+
+    // Reparameterization: z = mu + exp(0.5*lv) * eps, the whole batch at once
+    const Eigen::MatrixXd eps = _sampleNormal(_nz, B);
+    const Eigen::MatrixXd z = mu.array() + (0.5 * lv.array()).exp() * eps.array();
+
+    Eigen::MatrixXd pre_dec = _W_dec * z;
+    pre_dec.colwise() += _b_dec;
+    const Eigen::MatrixXd h_dec = _relu(pre_dec);
+    Eigen::MatrixXd pre_out = _W_out * h_dec;
+    pre_out.colwise() += _b_out;
+    const Eigen::MatrixXd recon = _sigmoid(pre_out);
+
+    // ── Losses (means over the batch) ─────────────────────────────────────────
     // Binary cross-entropy: L_recon = -mean_i(x*log(r) + (1-x)*log(1-r))
     constexpr double kEps = 1e-7;
-    const double L_recon = -(xe.array() * (recon.array() + kEps).log()
-        + (1.0 - xe.array()) * (1.0 - recon.array() + kEps).log())
+    const double L_recon = -(X.array() * (recon.array() + kEps).log()
+        + (1.0 - X.array()) * (1.0 - recon.array() + kEps).log())
                                 .mean();
     const double L_kl = -0.5 * (1.0 + lv.array() - mu.array().square() - lv.array().exp()).mean();
 
     // ── Backward pass (all gradients computed before any update) ──────────────
+    // Per-sample gradients divided by B, so the products below are batch means.
     // BCE + sigmoid simplification: dL/d(pre_out_i) = recon_i - x_i  (no saturation)
-    const Eigen::VectorXd dL_dpre_out = (recon - xe) / nxd;
-    const Eigen::MatrixXd dW_out = dL_dpre_out * h_dec.transpose();
-    const Eigen::VectorXd db_out = dL_dpre_out;
-    const Eigen::VectorXd dL_dh_dec = _W_out.transpose() * dL_dpre_out;
+    const Eigen::MatrixXd dL_dpre_out = (recon - X) / (nxd * bd);
+    const Eigen::MatrixXd dW_out = _outer(dL_dpre_out, h_dec);
+    const Eigen::VectorXd db_out = dL_dpre_out.rowwise().sum();
+    const Eigen::MatrixXd dL_dh_dec = _W_out.transpose() * dL_dpre_out;
 
     // Decoder hidden (ReLU)
-    const Eigen::VectorXd dL_dpre_dec = dL_dh_dec.array() * (pre_dec.array() > 0.0).cast<double>();
-    const Eigen::MatrixXd dW_dec = dL_dpre_dec * z.transpose();
-    const Eigen::VectorXd db_dec = dL_dpre_dec;
-    const Eigen::VectorXd dL_dz = _W_dec.transpose() * dL_dpre_dec;
+    const Eigen::MatrixXd dL_dpre_dec
+        = dL_dh_dec.array() * (pre_dec.array() > 0.0).cast<double>();
+    const Eigen::MatrixXd dW_dec = _outer(dL_dpre_dec, z);
+    const Eigen::VectorXd db_dec = dL_dpre_dec.rowwise().sum();
+    const Eigen::MatrixXd dL_dz = _W_dec.transpose() * dL_dpre_dec;
 
     // Reparameterization + KL gradients (KL scaled by klWeight)
     // dL/dmu_j  = dL/dz_j  +  klWeight * mu_j / nz
     // dL/dlv_j  = dL/dz_j * 0.5*(z_j - mu_j)  +  klWeight * 0.5*(exp(lv_j)-1) / nz
-    const Eigen::VectorXd dL_dmu = dL_dz.array() + klWeight * mu.array() / nzd;
-    const Eigen::VectorXd dL_dlv = dL_dz.array() * (0.5 * (z - mu)).array()
-        + klWeight * 0.5 * (lv.array().exp() - 1.0) / nzd;
+    const double klScale = klWeight / (nzd * bd);
+    const Eigen::MatrixXd dL_dmu = dL_dz.array() + klScale * mu.array();
+    const Eigen::MatrixXd dL_dlv = dL_dz.array() * (0.5 * (z - mu)).array()
+        + klScale * 0.5 * (lv.array().exp() - 1.0);
 
     // mu and logvar projection layers
-    const Eigen::MatrixXd dW_mu = dL_dmu * h_enc.transpose();
-    const Eigen::VectorXd db_mu = dL_dmu;
-    const Eigen::MatrixXd dW_lv = dL_dlv * h_enc.transpose();
-    const Eigen::VectorXd db_lv = dL_dlv;
+    const Eigen::MatrixXd dW_mu = _outer(dL_dmu, h_enc);
+    const Eigen::VectorXd db_mu = dL_dmu.rowwise().sum();
+    const Eigen::MatrixXd dW_lv = _outer(dL_dlv, h_enc);
+    const Eigen::VectorXd db_lv = dL_dlv.rowwise().sum();
 
     // Encoder hidden (ReLU)
-    const Eigen::VectorXd dL_dh_enc = _W_mu.transpose() * dL_dmu + _W_lv.transpose() * dL_dlv;
-    const Eigen::VectorXd dL_dpre_enc = dL_dh_enc.array() * (pre_enc.array() > 0.0).cast<double>();
-    const Eigen::MatrixXd dW_enc = dL_dpre_enc * xe.transpose();
-    const Eigen::VectorXd db_enc = dL_dpre_enc;
+    const Eigen::MatrixXd dL_dh_enc = _W_mu.transpose() * dL_dmu + _W_lv.transpose() * dL_dlv;
+    const Eigen::MatrixXd dL_dpre_enc
+        = dL_dh_enc.array() * (pre_enc.array() > 0.0).cast<double>();
+    const Eigen::MatrixXd dW_enc = _outer(dL_dpre_enc, X);
+    const Eigen::VectorXd db_enc = dL_dpre_enc.rowwise().sum();
 
     // ── Parameter updates ─────────────────────────────────────────────────────
-    _W_out -= _lr * dW_out;
-    _b_out -= _lr * db_out;
-    _W_dec -= _lr * dW_dec;
-    _b_dec -= _lr * db_dec;
-    _W_mu -= _lr * dW_mu;
-    _b_mu -= _lr * db_mu;
-    _W_lv -= _lr * dW_lv;
-    _b_lv -= _lr * db_lv;
-    _W_enc -= _lr * dW_enc;
-    _b_enc -= _lr * db_enc;
+    ++_adamT;
+    _step(_W_enc, dW_enc, 0);
+    _step(_b_enc, db_enc, 1);
+    _step(_W_mu, dW_mu, 2);
+    _step(_b_mu, db_mu, 3);
+    _step(_W_lv, dW_lv, 4);
+    _step(_b_lv, db_lv, 5);
+    _step(_W_dec, dW_dec, 6);
+    _step(_b_dec, db_dec, 7);
+    _step(_W_out, dW_out, 8);
+    _step(_b_out, db_out, 9);
 
     return { L_recon, klWeight * L_kl };
 }
@@ -220,20 +319,64 @@ void Vae::train(const std::vector<std::vector<double>>& dataset, size_t epochs,
     }
 }
 
+void Vae::trainMiniBatch(const Eigen::Ref<const Eigen::MatrixXd>& X, size_t epochs,
+    size_t batchSize, double warmupFrac)
+{
+    if (X.cols() == 0)
+        throw std::invalid_argument("Vae::trainMiniBatch: dataset is empty");
+    if (static_cast<size_t>(X.rows()) != _nx)
+        throw std::invalid_argument("Vae::trainMiniBatch: input size mismatch");
+
+    const auto N = static_cast<size_t>(X.cols());
+    const size_t B = std::max<size_t>(1, std::min(batchSize, N));
+    std::vector<Eigen::Index> order(N);
+    std::iota(order.begin(), order.end(), Eigen::Index(0));
+
+    Eigen::MatrixXd batch(X.rows(), Eigen::Index(B));
+    for (size_t ep = 0; ep < epochs; ++ep) {
+        const double beta = (warmupFrac > 0.0 && epochs > 1)
+            ? std::min(1.0, static_cast<double>(ep) / (warmupFrac * (epochs - 1)))
+            : 1.0;
+        std::shuffle(order.begin(), order.end(), _rng);
+        for (size_t start = 0; start < N; start += B) {
+            const size_t len = std::min(B, N - start);
+            for (size_t j = 0; j < len; ++j)
+                batch.col(Eigen::Index(j)) = X.col(order[start + j]);
+            trainBatch(batch.leftCols(Eigen::Index(len)), beta);
+        }
+    }
+}
+
+void Vae::trainMiniBatch(const std::vector<std::vector<double>>& dataset, size_t epochs,
+    size_t batchSize, double warmupFrac)
+{
+    if (dataset.empty())
+        throw std::invalid_argument("Vae::trainMiniBatch: dataset is empty");
+    Eigen::MatrixXd X(Eigen::Index(_nx), Eigen::Index(dataset.size()));
+    for (size_t j = 0; j < dataset.size(); ++j)
+        X.col(Eigen::Index(j)) = _toEigen(dataset[j], _nx);
+    trainMiniBatch(X, epochs, batchSize, warmupFrac);
+}
+
 double Vae::reconstructionError(const std::vector<std::vector<double>>& dataset) const
 {
     if (dataset.empty())
         return 0.0;
+    Eigen::MatrixXd X(Eigen::Index(_nx), Eigen::Index(dataset.size()));
+    for (size_t j = 0; j < dataset.size(); ++j)
+        X.col(Eigen::Index(j)) = _toEigen(dataset[j], _nx);
+    return reconstructionError(X);
+}
+
+double Vae::reconstructionError(const Eigen::Ref<const Eigen::MatrixXd>& X) const
+{
+    if (X.cols() == 0)
+        return 0.0;
     constexpr double kEps = 1e-7;
-    double total = 0.0;
-    for (const auto& x : dataset) {
-        const auto r = reconstruct(x);
-        double bce = 0.0;
-        for (size_t i = 0; i < _nx; ++i)
-            bce -= x[i] * std::log(r[i] + kEps) + (1.0 - x[i]) * std::log(1.0 - r[i] + kEps);
-        total += bce / static_cast<double>(_nx);
-    }
-    return total / static_cast<double>(dataset.size());
+    const Eigen::MatrixXd R = reconstructBatch(X);
+    return -(X.array() * (R.array() + kEps).log()
+        + (1.0 - X.array()) * (1.0 - R.array() + kEps).log())
+                .mean();
 }
 
 } // namespace nu
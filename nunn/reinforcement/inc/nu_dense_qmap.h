@@ -0,0 +1,181 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Dense Q-map for enumerable states and actions.
+//
+// DenseQMap can replace the default nested std::unordered_map QMap of QLearn
+// and Sarsa. Q-values live in one contiguous row-major [states x NumActions]
+// buffer, and Index maps a State or Action to its row or column. So
+// q[state][action] costs two index computations and a load, with no hashing
+// and no node allocation.
+//
+// Like the map it replaces, q[state] on a non-const table grows it to cover
+// the state (new rows are zero). Growth moves the buffer, so a Row must not
+// be kept across another q[state] lookup.
+//
+// maxQ() / argmaxQ() take the best value over a list of valid actions from
+// either kind of row. On a dense row where every action is valid, the max is
+// a vectorised scan of the contiguous row.
+//
+// Usage:
+//   using QMap = nu::DenseQMap<int, int, 4>;      // int states, 4 actions
+//   nu::QLearn<int, int, Agent, Policy, void, QMap> ql(QMap(nStates));
+//
+
+#pragma once
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nu {
+
+// Default Index: integral or enum states and actions index themselves.
+template <class State, class Action> struct DenseQIndex {
+    size_t state(const State& s) const noexcept { return static_cast<size_t>(s); }
+    size_t action(const Action& a) const noexcept { return static_cast<size_t>(a); }
+};
+
+template <class State, class Action, size_t NumActions,
+    class Index = DenseQIndex<State, Action>>
+class DenseQMap {
+    static_assert(NumActions > 0, "DenseQMap: NumActions must be > 0");
+
+public:
+    static constexpr size_t numActions = NumActions;
+
+    // View of the NumActions Q-values of one state.
+    template <class T> class RowRef {
+    public:
+        RowRef(T* q, const Index* index) noexcept
+            : _q(q)
+            , _index(index)
+        {
+        }
+
+        T& operator[](const Action& a) const noexcept { return _q[_index->action(a)]; }
+        T& at(size_t i) const noexcept { return _q[i]; }
+
+        T* data() const noexcept { return _q; }
+        static constexpr size_t size() noexcept { return NumActions; }
+
+        double max() const noexcept { return _map().maxCoeff(); }
+
+        // Column of the first maximum.
+        size_t argmax() const noexcept
+        {
+            Eigen::Index i = 0;
+            _map().maxCoeff(&i);
+            return static_cast<size_t>(i);
+        }
+
+    private:
+        using Vec = Eigen::Matrix<double, static_cast<int>(NumActions), 1>;
+
+        Eigen::Map<const Vec> _map() const noexcept { return Eigen::Map<const Vec>(_q); }
+
+        T* _q;
+        const Index* _index;
+    };
+
+    using Row = RowRef<double>;
+    using ConstRow = RowRef<const double>;
+
+    explicit DenseQMap(size_t numStates = 0, Index index = Index())
+        : _q(numStates * NumActions, 0.0)
+        , _index(std::move(index))
+    {
+    }
+
+    // Row of s, growing the table to cover it.
+    Row operator[](const State& s)
+    {
+        const size_t i = _index.state(s);
+        if (i >= numStates())
+            _q.resize((i + 1) * NumActions, 0.0);
+        return Row(&_q[i * NumActions], &_index);
+    }
+
+    // Row of s. Throws std::out_of_range if s is not covered.
+    ConstRow operator[](const State& s) const
+    {
+        const size_t i = _index.state(s);
+        if (i >= numStates())
+            throw std::out_of_range("DenseQMap: state index out of range");
+        return ConstRow(&_q[i * NumActions], &_index);
+    }
+
+    Row row(size_t i) noexcept { return Row(&_q[i * NumActions], &_index); }
+    ConstRow row(size_t i) const noexcept { return ConstRow(&_q[i * NumActions], &_index); }
+
+    size_t numStates() const noexcept { return _q.size() / NumActions; }
+
+    // True if s has a row (a lookup of s does not grow the table).
+    bool covers(const State& s) const noexcept { return _index.state(s) < numStates(); }
+
+    // Sets the number of rows; new rows are zero.
+    void resize(size_t numStates) { _q.resize(numStates * NumActions, 0.0); }
+    void reserve(size_t numStates) { _q.reserve(numStates * NumActions); }
+
+    void fill(double value) noexcept { std::fill(_q.begin(), _q.end(), value); }
+
+    double* data() noexcept { return _q.data(); }
+    const double* data() const noexcept { return _q.data(); }
+
+    const Index& index() const noexcept { return _index; }
+
+private:
+    std::vector<double> _q; // row-major [numStates x NumActions]
+    Index _index;
+};
+
+template <class T> inline constexpr bool isDenseQMap = false;
+
+template <class State, class Action, size_t NumActions, class Index>
+inline constexpr bool isDenseQMap<DenseQMap<State, Action, NumActions, Index>> = true;
+
+// ── Row helpers ───────────────────────────────────────────────────────────────
+
+// True for dense rows, which expose a vectorised max().
+template <class Row>
+inline constexpr bool isDenseQRow = requires(const std::remove_cvref_t<Row>& r) { r.max(); };
+
+// Max of row[a] over validActions (non-empty). A dense row whose actions are
+// all valid is reduced with Row::max().
+template <class Row, class Actions> double maxQ(Row&& row, const Actions& validActions)
+{
+    if constexpr (isDenseQRow<Row>) {
+        if (validActions.size() == row.size())
+            return row.max();
+    }
+    auto it = validActions.begin();
+    double best = row[*it];
+    for (++it; it != validActions.end(); ++it) {
+        const double v = row[*it];
+        if (v > best)
+            best = v;
+    }
+    return best;
+}
+
+// First action of validActions (non-empty) holding the max of row[a];
+// best receives that max.
+template <class Row, class Actions>
+auto argmaxQ(Row&& row, const Actions& validActions, double& best)
+{
+    best = maxQ(row, validActions);
+    for (const auto& a : validActions)
+        if (row[a] == best)
+            return a;
+    return validActions.front(); // unreachable unless best is NaN
+}
+
+} // namespace nu
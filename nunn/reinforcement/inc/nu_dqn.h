@@ -8,11 +8,32 @@
 // Deep Q-Network (DQN) with experience replay and a frozen target network.
 //
 // Algorithm outline:
-//   1. Every env step: store (s, a, r, s', done) in replay buffer.
-//   2. Once buffer has >= batchSize transitions: sample a mini-batch,
+//   1. Every env step: store (s, a, r, s', done) in replay memory.
+//   2. Once memory has >= batchSize transitions: sample a mini-batch,
 //      compute Bellman targets via the TARGET network (frozen), update
-//      MAIN network weights via trainBatch().
-//   3. Every targetUpdateFreq learn steps: copy main → target weights.
+//      MAIN network weights via trainBatch(). The replay memory returns the
+//      batch as [stateDim x B] matrices, so the online and target Q-values
+//      take one batched forward pass each.
+//   3. Every targetUpdateFreq learn steps: copy main → target weights
+//      (one block copy of the parameter buffer), or, with
+//      setSoftTargetUpdate(tau), move the target towards main after every
+//      learn step: target = tau * main + (1 - tau) * target.
+//
+// With setPrioritizedReplay() the mini-batch is drawn in proportion to the
+// last TD error of each transition (see nu_prioritized_replay.h); the TD
+// error of each sample is scaled by its importance-sampling weight, and the
+// priorities of the batch are updated from the errors of every learn step.
+//
+// Optional extensions, all off by default:
+//   - Double DQN (setDoubleDqn): the online network picks the next action,
+//     the target network values it;
+//   - n-step returns (setNStep): transitions are accumulated into n-step
+//     ones before they reach replay memory (NStepAccumulator);
+//   - Huber loss (setHuberLoss): the TD error is clipped before it drives
+//     the gradient;
+//   - dueling head (setDueling): Q = V + A - mean(A) from one output layer.
+// Targets are computed for the whole mini-batch in matrix form; each variant
+// only changes how the output targets passed to trainBatch() are built.
 //
 // State is std::vector<double>; Action is int (0-based action index).
 //
@@ -20,7 +41,8 @@
 #pragma once
 
 #include "nu_mlpmatrixnn.h"
-#include "nu_replay_buffer.h"
+#include "nu_prioritized_replay.h"
+#include "nu_replay_memory.h"
 
 #include <memory>
 #include <random>
@@ -34,7 +56,8 @@ public:
     //   The output layer must have Activation::Linear (Q-values are unbounded).
     //   Example: {{2}, {32, Activation::Tanh}, {32, Activation::Tanh}, {4, Activation::Linear}}
     // lr:               learning rate for the main Q-network
-    // bufferCapacity:   maximum transitions stored in the replay buffer
+    // bufferCapacity:   maximum transitions stored in the replay memory
+    //                   (allocated up front: 2 x bufferCapacity x stateDim doubles)
     // batchSize:        transitions sampled per gradient step
     // gamma:            discount factor
     // targetUpdateFreq: copy main→target every N learn steps
@@ -48,30 +71,134 @@ public:
     // epsilon == 0 → always greedy; epsilon == 1 → always random.
     int selectAction(const std::vector<double>& state, double epsilon);
 
-    // Store transition and, if buffer is ready, run one mini-batch gradient step.
-    // Returns the pre-update batch MSE loss when training happened, 0.0 otherwise.
+    // Store transition and, if memory is ready, run one mini-batch gradient step.
+    // Returns the pre-update batch MSE loss (mean Huber loss with setHuberLoss)
+    // when training happened, 0.0 otherwise. With setNStep(n > 1) the
+    // transition reaches memory once its n-step window completes.
+    // Throws std::invalid_argument if a state size differs from the input layer
+    // and std::out_of_range if action is not in [0, numActions).
     double learn(const std::vector<double>& state, int action, double reward,
         const std::vector<double>& nextState, bool done);
 
+    // ── Vectorized environments (see nu_vec_env.h) ──
+
+    // epsilon-greedy actions for the columns of states [stateDim x N]; the
+    // greedy ones come from a single batched forward pass.
+    void selectActions(
+        const Eigen::Ref<const Eigen::MatrixXd>& states, double epsilon, std::vector<int>& actions);
+
+    // Stores the N transitions of one lockstep step (column j of states and
+    // nextStates, actions[j], rewards(j), done[j]) and, once memory is ready,
+    // runs `updates` mini-batch gradient steps. Returns their mean pre-update
+    // loss, 0.0 if none ran. Throws std::invalid_argument on a size mismatch
+    // and std::out_of_range if an action is not in [0, numActions).
+    double learnBatch(const Eigen::Ref<const Eigen::MatrixXd>& states,
+        const std::vector<int>& actions, const Eigen::Ref<const Eigen::VectorXd>& rewards,
+        const Eigen::Ref<const Eigen::MatrixXd>& nextStates, const std::vector<uint8_t>& done,
+        size_t updates = 1);
+
+    // Switches to prioritized experience replay. alpha: priority exponent;
+    // beta is annealed linearly from beta0 to 1 over betaSteps learn steps;
+    // epsilon is added to |TD error|. Transitions already stored get priority 1.
+    // Throws std::invalid_argument if alpha < 0, epsilon <= 0 or beta0 is not in [0, 1].
+    void setPrioritizedReplay(double alpha = 0.6, double beta0 = 0.4, size_t betaSteps = 100000,
+        double epsilon = 0.01);
+    bool prioritizedReplay() const noexcept { return _per != nullptr; }
+
+    // Soft (Polyak) target updates: after every learn step the target
+    // network moves to tau * main + (1 - tau) * target, in place, and
+    // targetUpdateFreq is ignored. tau == 0 restores periodic hard copies.
+    // Throws std::invalid_argument if tau is not in [0, 1].
+    void setSoftTargetUpdate(double tau);
+    double softTargetTau() const noexcept { return _tau; }
+
+    // ── Extensions ──
+
+    // Double DQN (van Hasselt et al., 2016): the next action is the argmax of
+    // the online network, valued by the target network.
+    void setDoubleDqn(bool enable) noexcept { _doubleDqn = enable; }
+    bool doubleDqn() const noexcept { return _doubleDqn; }
+
+    // n-step returns: targets become R_t..t+n + gamma^n max Q(s_t+n). n == 1
+    // is plain DQN. Transitions still being accumulated are dropped.
+    // Throws std::invalid_argument if n == 0.
+    void setNStep(size_t n);
+    size_t nStep() const noexcept { return _nStep; }
+
+    // Huber loss with threshold delta: each TD error is clipped to
+    // [-delta, delta] before it drives the gradient, and the reported loss is
+    // the mean Huber loss. delta == 0 restores the squared error.
+    // Throws std::invalid_argument if delta < 0.
+    void setHuberLoss(double delta);
+    double huberDelta() const noexcept { return _huberDelta; }
+
+    // Dueling head (Wang et al., 2016): the output layer yields a state value
+    // V and one advantage A(a) per action, and Q = V + A - mean(A).
+    // MlpMatrixNN has no branches, so both share every hidden layer. Rebuilds
+    // both networks with fresh weights.
+    void setDueling(bool enable);
+    bool dueling() const noexcept { return _dueling; }
+
     // Q-values for state from the main network.
     std::vector<double> qValues(const std::vector<double>& state);
 
     size_t getNumActions() const noexcept { return _numActions; }
+    size_t getStateSize() const noexcept { return _memory.stateDim(); }
     size_t getLearnStepCount() const noexcept { return _learnStep; }
 
 private:
-    using Buffer = ExperienceReplayBuffer<std::vector<double>, int>;
-
+    std::vector<MlpMatrixNN::LayerConfig> _netLayers;
+    double _lr;
     std::unique_ptr<MlpMatrixNN> _qNet;
     std::unique_ptr<MlpMatrixNN> _targetNet;
-    Buffer _buffer;
+    ReplayMemory _memory;
     size_t _batchSize;
     double _gamma;
     size_t _targetUpdateFreq;
+    double _tau = 0.0; // soft target update rate (0 = hard copies)
     size_t _learnStep = 0;
     size_t _numActions;
     std::mt19937 _rng;
 
+    // Prioritized replay (null when sampling uniformly).
+    std::unique_ptr<PrioritizedSampler> _per;
+    double _beta0 = 0.4;
+    size_t _betaSteps = 1;
+    std::vector<size_t> _perSlots;
+    Eigen::VectorXd _perWeights;
+
+    // Extensions.
+    bool _doubleDqn = false;
+    bool _dueling = false;
+    double _huberDelta = 0.0;
+    size_t _nStep = 1;
+    double _gammaN; // gamma^nStep
+    std::unique_ptr<NStepAccumulator> _nstep;
+
+    // Batch buffers, sized on the first learn step and evaluated in place
+    // afterwards (feedForwardBatch(X, out)): online outputs for s, turned into
+    // the training targets [outputs x B]; online outputs for [s | s'] (Double
+    // DQN) and target-network outputs for s'; dLoss/dQ [numActions x B] and
+    // TD errors [B].
+    Eigen::MatrixXd _batchTargets;
+    Eigen::MatrixXd _onlineOut;
+    Eigen::MatrixXd _targetOut;
+    Eigen::MatrixXd _qGrad;
+    Eigen::MatrixXd _stacked; // [s | s'] for the Double DQN forward pass
+    Eigen::VectorXd _tdErrors;
+    Eigen::MatrixXd _actOut; // online outputs for selectActions()
+
+    // Q(a) and greedy action of output column j, read in place: without a
+    // dueling head the outputs are the Q-values; with one, row 0 is V, rows
+    // 1..numActions are A and Q(a) = V + A(a) - mean(A).
+    double _qAt(const Eigen::MatrixXd& out, Eigen::Index a, Eigen::Index j) const;
+    Eigen::Index _greedy(const Eigen::MatrixXd& out, Eigen::Index j) const;
+    void _buildNets();
+    void _addPriorities(size_t first, size_t count);
+    NStepAccumulator& _nstepFor(size_t streams);
+    // caller names the public method in the error message.
+    void _checkAction(int action, const char* caller) const;
+    double _update();
     void _syncTarget();
     double _trainBatch();
 };
@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include "nu_dense_qmap.h"
 #include "nu_random_gen.h"
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 
 namespace nu {
 
@@ -20,6 +22,9 @@ public:
 
     double getEpsilon() const noexcept { return _epsilon; }
 
+    // Reseeds the random generator (e.g. per worker thread).
+    void seed(std::uint32_t s) { _rndGen.seed(s); }
+
     template <class QMap>
     Action selectAction(const Agent& agent, QMap& qMap, bool dontExplore = false) const
     {
@@ -32,18 +37,9 @@ public:
         double reward = 0;
 
         if (dontExplore || _rndGen() > getEpsilon()) {
-            // get current agent state
-            const auto& agentState = agent.getCurrentState();
-
-            reward = qMap[agentState][action];
-
-            for (const auto& anAction : validActions) {
-                const auto& val = qMap[agentState][anAction];
-                if (val > reward) {
-                    reward = val;
-                    action = anAction;
-                }
-            }
+            // One lookup of the current state's row, no copy; ties go to the
+            // first valid action.
+            action = argmaxQ(qMap[agent.getCurrentState()], validActions, reward);
         }
 
         // TODO(v3.0): the exact == 0.0 test conflates "best Q value is zero"
@@ -0,0 +1,556 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Game-tree search for small two-player board games, with a neural network
+// as the position evaluator.
+//
+// A Game is a cheap-to-copy position providing:
+//   static constexpr size_t numMoves;     // moves are 0 .. numMoves-1 (<= 64)
+//   static constexpr size_t inputSize;    // size of the network input
+//   std::uint64_t hash() const;           // Zobrist key (side to move included)
+//   std::uint64_t legalMoves() const;     // bit m set if move m is legal, 0 when over
+//   void play(int move);                  // plays move for the side to move
+//   bool over() const;
+//   double result() const;                // final score for the side to move, in [-1, 1]
+//   void encode(Eigen::Ref<Eigen::VectorXd> input) const;
+// nu::TicTacToe (nu_tictactoe.h) is one.
+//
+// Components:
+//   ZobristKeys         random 64-bit keys per (square, piece) and side to move
+//   TranspositionTable  fixed-size table indexed by the low bits of the key
+//   NetEvaluator        network scores (one per move) cached by position; the
+//                       uncached children of a position go through the
+//                       network in one batched call
+//   Negamax             exact alpha-beta search with a transposition table
+//   Mcts                PUCT Monte Carlo tree search, network scores as priors
+//
+// Usage:
+//   nu::NetEvaluator<nu::TicTacToe> eval(nu::batchFn(net));   // net: MlpNN or MlpMatrixNN
+//   nu::Mcts<nu::TicTacToe> mcts(eval, { 400 });
+//   board.play(mcts.search(board));
+//
+
+#pragma once
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace nu {
+
+// ── Zobrist keys ──────────────────────────────────────────────────────────────
+
+// Keys from a splitmix64 sequence, so they are the same on every run. A
+// position's hash is the XOR of the keys of its pieces (and side() when the
+// second player is to move); play() updates it with one XOR per change.
+template <size_t Squares, size_t Pieces> class ZobristKeys {
+public:
+    explicit constexpr ZobristKeys(std::uint64_t seed = 0x2545F4914F6CDD1Dull) noexcept
+    {
+        for (auto& key : _keys)
+            key = _next(seed);
+        _side = _next(seed);
+    }
+
+    constexpr std::uint64_t piece(size_t square, size_t piece) const noexcept
+    {
+        return _keys[square * Pieces + piece];
+    }
+    constexpr std::uint64_t side() const noexcept { return _side; }
+
+private:
+    static constexpr std::uint64_t _next(std::uint64_t& state) noexcept
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::array<std::uint64_t, Squares * Pieces> _keys {};
+    std::uint64_t _side = 0;
+};
+
+// ── Transposition table ───────────────────────────────────────────────────────
+
+// One entry per slot, always replaced on insert. Lookups compare the full key.
+template <class Value> class TranspositionTable {
+public:
+    // capacity is rounded up to a power of two.
+    // Throws std::invalid_argument if capacity is 0.
+    explicit TranspositionTable(size_t capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("TranspositionTable: capacity must be > 0");
+        _entries.resize(std::bit_ceil(capacity));
+        _mask = _entries.size() - 1;
+    }
+
+    // Value stored for key, or nullptr. Valid until the next insert().
+    const Value* find(std::uint64_t key) noexcept
+    {
+        const Entry& e = _entries[key & _mask];
+        if (e.used && e.key == key) {
+            ++_hits;
+            return &e.value;
+        }
+        ++_misses;
+        return nullptr;
+    }
+
+    // Stores value for key, replacing the entry that shared its slot.
+    void insert(std::uint64_t key, const Value& value) noexcept
+    {
+        Entry& e = _entries[key & _mask];
+        e.key = key;
+        e.used = true;
+        e.value = value;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(_entries.begin(), _entries.end(), Entry());
+        _hits = _misses = 0;
+    }
+
+    size_t capacity() const noexcept { return _entries.size(); }
+    size_t hits() const noexcept { return _hits; }
+    size_t misses() const noexcept { return _misses; }
+
+private:
+    struct Entry {
+        std::uint64_t key = 0;
+        bool used = false;
+        Value value {};
+    };
+
+    std::vector<Entry> _entries;
+    size_t _mask = 0;
+    size_t _hits = 0;
+    size_t _misses = 0;
+};
+
+// ── Network evaluator ─────────────────────────────────────────────────────────
+
+// Batch function over a network with feedForwardBatch(X) (MlpNN,
+// MlpMatrixNN). The network must outlive the evaluator.
+template <class Net> auto batchFn(const Net& net)
+{
+    return [&net](const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& Y) {
+        Y = net.feedForwardBatch(X);
+    };
+}
+
+template <class Game> class NetEvaluator {
+public:
+    using Scores = std::array<double, Game::numMoves>;
+
+    // Evaluates the columns of inputs [inputSize x N] into outputs
+    // [numMoves x N].
+    using BatchFn = std::function<void(
+        const Eigen::Ref<const Eigen::MatrixXd>& inputs, Eigen::MatrixXd& outputs)>;
+
+    explicit NetEvaluator(BatchFn net, size_t cacheCapacity = size_t(1) << 16)
+        : _net(std::move(net))
+        , _cache(cacheCapacity)
+        , _inputs(static_cast<Eigen::Index>(Game::inputSize),
+              static_cast<Eigen::Index>(Game::numMoves))
+    {
+    }
+
+    // Network scores of g, from the cache when g was seen before.
+    // Throws std::invalid_argument if the network output is not [numMoves x N].
+    Scores evaluate(const Game& g)
+    {
+        if (const Scores* cached = _cache.find(g.hash()))
+            return *cached;
+        g.encode(_inputs.col(0));
+        _run(1);
+        return _store(g.hash(), 0);
+    }
+
+    // Scores of the positions after each legal move of g, in move order:
+    // moves receives the moves and scores [numMoves x moves] their scores.
+    // The positions not in the cache go through the network in one call.
+    void evaluateChildren(const Game& g, std::vector<int>& moves, Eigen::MatrixXd& scores)
+    {
+        moves.clear();
+        for (std::uint64_t mask = g.legalMoves(); mask != 0; mask &= mask - 1)
+            moves.push_back(std::countr_zero(mask));
+        scores.resize(
+            static_cast<Eigen::Index>(Game::numMoves), static_cast<Eigen::Index>(moves.size()));
+
+        _pending.clear();
+        for (size_t i = 0; i < moves.size(); ++i) {
+            Game child = g;
+            child.play(moves[i]);
+            if (const Scores* cached = _cache.find(child.hash())) {
+                _copy(*cached, scores, i);
+            } else {
+                child.encode(_inputs.col(static_cast<Eigen::Index>(_pending.size())));
+                _pending.push_back({ child.hash(), i });
+            }
+        }
+        if (_pending.empty())
+            return;
+
+        _run(_pending.size());
+        for (size_t k = 0; k < _pending.size(); ++k)
+            _copy(_store(_pending[k].key, k), scores, _pending[k].column);
+    }
+
+    // Drops every cached evaluation (call it after the network changes).
+    void clear() noexcept { _cache.clear(); }
+
+    // Calls of the batch function, and positions they evaluated.
+    size_t networkCalls() const noexcept { return _calls; }
+    size_t positionsEvaluated() const noexcept { return _evaluated; }
+    const TranspositionTable<Scores>& cache() const noexcept { return _cache; }
+
+private:
+    struct Pending {
+        std::uint64_t key;
+        size_t column;
+    };
+
+    void _run(size_t n)
+    {
+        _net(_inputs.leftCols(static_cast<Eigen::Index>(n)), _outputs);
+        if (_outputs.rows() != static_cast<Eigen::Index>(Game::numMoves)
+            || _outputs.cols() != static_cast<Eigen::Index>(n))
+            throw std::invalid_argument("NetEvaluator: network output must be [numMoves x N]");
+        ++_calls;
+        _evaluated += n;
+    }
+
+    Scores _store(std::uint64_t key, size_t column)
+    {
+        Scores s;
+        for (size_t m = 0; m < Game::numMoves; ++m)
+            s[m] = _outputs(static_cast<Eigen::Index>(m), static_cast<Eigen::Index>(column));
+        _cache.insert(key, s);
+        return s;
+    }
+
+    static void _copy(const Scores& s, Eigen::MatrixXd& scores, size_t column)
+    {
+        scores.col(static_cast<Eigen::Index>(column))
+            = Eigen::Map<const Eigen::VectorXd>(s.data(), static_cast<Eigen::Index>(s.size()));
+    }
+
+    BatchFn _net;
+    TranspositionTable<Scores> _cache;
+    Eigen::MatrixXd _inputs; // [inputSize x numMoves] batch
+    Eigen::MatrixXd _outputs;
+    std::vector<Pending> _pending;
+    size_t _calls = 0;
+    size_t _evaluated = 0;
+};
+
+// ── Negamax ───────────────────────────────────────────────────────────────────
+
+// Exact alpha-beta negamax. Values of searched positions are kept in a
+// transposition table as exact values or bounds, so transpositions are
+// searched once. With an evaluator, moves are tried in decreasing order of
+// the network's scores, which tightens the bounds sooner.
+template <class Game> class Negamax {
+public:
+    explicit Negamax(size_t ttCapacity = size_t(1) << 16, NetEvaluator<Game>* ordering = nullptr)
+        : _tt(ttCapacity)
+        , _ordering(ordering)
+    {
+    }
+
+    // Value of g for the side to move with best play from both sides;
+    // bestMove receives a move achieving it (-1 if g is over).
+    double solve(const Game& g, int* bestMove = nullptr)
+    {
+        int best = -1;
+        const double value = _search(g, -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity(), best);
+        if (bestMove)
+            *bestMove = best;
+        return value;
+    }
+
+    // Positions visited by solve() since construction or clear().
+    size_t nodes() const noexcept { return _nodes; }
+
+    void clear() noexcept
+    {
+        _tt.clear();
+        _nodes = 0;
+    }
+
+private:
+    enum class Bound : std::uint8_t { Exact, Lower, Upper };
+
+    struct Entry {
+        double value = 0.0;
+        Bound bound = Bound::Exact;
+        int move = -1;
+    };
+
+    double _search(const Game& g, double alpha, double beta, int& best)
+    {
+        ++_nodes;
+        best = -1;
+        if (g.over())
+            return g.result();
+
+        const double alphaOrig = alpha;
+        int ttMove = -1;
+        if (const Entry* e = _tt.find(g.hash())) {
+            if (e->bound == Bound::Exact) {
+                best = e->move;
+                return e->value;
+            }
+            if (e->bound == Bound::Lower)
+                alpha = std::max(alpha, e->value);
+            else
+                beta = std::min(beta, e->value);
+            if (alpha >= beta) {
+                best = e->move;
+                return e->value;
+            }
+            ttMove = e->move;
+        }
+
+        std::array<int, Game::numMoves> moves;
+        const size_t n = _orderMoves(g, ttMove, moves);
+
+        double value = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            Game child = g;
+            child.play(moves[i]);
+            int reply = -1;
+            const double v = -_search(child, -beta, -alpha, reply);
+            if (v > value) {
+                value = v;
+                best = moves[i];
+            }
+            alpha = std::max(alpha, v);
+            if (alpha >= beta)
+                break;
+        }
+
+        const Bound bound = value <= alphaOrig ? Bound::Upper
+            : value >= beta                    ? Bound::Lower
+                                               : Bound::Exact;
+        _tt.insert(g.hash(), { value, bound, best });
+        return value;
+    }
+
+    // Legal moves: the table's move first, then by decreasing network score
+    // (with an evaluator) or in move order.
+    size_t _orderMoves(const Game& g, int ttMove, std::array<int, Game::numMoves>& moves)
+    {
+        size_t n = 0;
+        for (std::uint64_t mask = g.legalMoves(); mask != 0; mask &= mask - 1)
+            moves[n++] = std::countr_zero(mask);
+
+        if (_ordering) {
+            const auto scores = _ordering->evaluate(g);
+            std::stable_sort(moves.begin(), moves.begin() + static_cast<std::ptrdiff_t>(n),
+                [&](int a, int b) { return scores[size_t(a)] > scores[size_t(b)]; });
+        }
+        if (ttMove >= 0) {
+            const auto end = moves.begin() + static_cast<std::ptrdiff_t>(n);
+            const auto it = std::find(moves.begin(), end, ttMove);
+            if (it != end)
+                std::rotate(moves.begin(), it, it + 1);
+        }
+        return n;
+    }
+
+    TranspositionTable<Entry> _tt;
+    NetEvaluator<Game>* _ordering;
+    size_t _nodes = 0;
+};
+
+// ── Monte Carlo tree search ───────────────────────────────────────────────────
+
+struct MctsConfig {
+    size_t simulations = 400;
+    double cPuct = 1.5; // weight of the prior in the exploration term
+    std::uint32_t seed = 0; // 0 = seeded from std::random_device
+};
+
+// PUCT search (as in AlphaZero): a child is selected by
+//   Q + cPuct * P * sqrt(N_parent) / (1 + N_child)
+// where P is the network score of the move, normalised over the legal moves.
+// A new leaf is valued by a uniformly random playout. On expansion, the
+// children of the leaf are scored in one batched network call, so their own
+// expansions find their priors in the evaluator's cache.
+template <class Game> class Mcts {
+public:
+    explicit Mcts(NetEvaluator<Game>& evaluator, MctsConfig config = {})
+        : _eval(evaluator)
+        , _cfg(config)
+        , _rng(config.seed != 0 ? config.seed : std::random_device {}())
+    {
+    }
+
+    // Runs the configured simulations from root and returns the most visited
+    // move. Throws std::invalid_argument if root is over.
+    int search(const Game& root)
+    {
+        if (root.over())
+            throw std::invalid_argument("Mcts::search: the game is over");
+
+        _nodes.clear();
+        _nodes.push_back(Node());
+        for (size_t s = 0; s < std::max<size_t>(_cfg.simulations, 1); ++s)
+            _simulate(root);
+
+        _policy.fill(0.0);
+        const Node& r = _nodes[0];
+        int best = -1;
+        std::uint32_t bestVisits = 0;
+        double total = 0.0;
+        for (std::uint32_t c = r.first; c < r.first + r.count; ++c) {
+            const Node& child = _nodes[c];
+            _policy[size_t(child.move)] = child.visits;
+            total += child.visits;
+            if (best < 0 || child.visits > bestVisits) {
+                best = child.move;
+                bestVisits = child.visits;
+            }
+        }
+        if (total > 0.0)
+            for (auto& p : _policy)
+                p /= total;
+        return best;
+    }
+
+    // Share of the root's visits per move after the last search() (a
+    // self-play training target).
+    const std::array<double, Game::numMoves>& policy() const noexcept { return _policy; }
+
+    // Nodes of the last search's tree.
+    size_t treeSize() const noexcept { return _nodes.size(); }
+
+private:
+    struct Node {
+        int move = -1;
+        double prior = 0.0;
+        std::uint32_t visits = 0;
+        double value = 0.0; // sum, for the player who made `move`
+        std::uint32_t first = 0; // children: _nodes[first, first + count)
+        std::uint32_t count = 0;
+        bool expanded = false;
+    };
+
+    void _simulate(const Game& root)
+    {
+        Game g = root;
+        _path.clear();
+        std::uint32_t idx = 0;
+        _path.push_back(idx);
+
+        while (_nodes[idx].expanded && !g.over()) {
+            idx = _select(idx);
+            g.play(_nodes[idx].move);
+            _path.push_back(idx);
+        }
+
+        // Value for the side to move at the leaf.
+        double value = 0.0;
+        if (g.over()) {
+            value = g.result();
+        } else {
+            _expand(idx, g);
+            value = _rollout(g);
+        }
+
+        // Each node's value belongs to the player who moved into it, the
+        // opponent of the side to move there.
+        for (auto it = _path.rbegin(); it != _path.rend(); ++it) {
+            value = -value;
+            Node& n = _nodes[*it];
+            ++n.visits;
+            n.value += value;
+        }
+    }
+
+    std::uint32_t _select(std::uint32_t idx) const
+    {
+        const Node& parent = _nodes[idx];
+        const double sqrtN = std::sqrt(double(parent.visits));
+        std::uint32_t best = parent.first;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (std::uint32_t c = parent.first; c < parent.first + parent.count; ++c) {
+            const Node& child = _nodes[c];
+            const double q = child.visits ? child.value / double(child.visits) : 0.0;
+            const double score = q + _cfg.cPuct * child.prior * sqrtN / (1.0 + child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    void _expand(std::uint32_t idx, const Game& g)
+    {
+        const auto scores = _eval.evaluate(g);
+        _eval.evaluateChildren(g, _moves, _childScores); // warms the cache for the children
+
+        double sum = 0.0;
+        for (const int m : _moves)
+            sum += std::max(scores[size_t(m)], 0.0);
+
+        const auto first = static_cast<std::uint32_t>(_nodes.size());
+        for (const int m : _moves) {
+            Node child;
+            child.move = m;
+            child.prior = sum > 0.0 ? std::max(scores[size_t(m)], 0.0) / sum
+                                    : 1.0 / double(_moves.size());
+            _nodes.push_back(child);
+        }
+        Node& n = _nodes[idx];
+        n.first = first;
+        n.count = static_cast<std::uint32_t>(_moves.size());
+        n.expanded = true;
+    }
+
+    double _rollout(Game g)
+    {
+        size_t plies = 0;
+        while (!g.over()) {
+            std::uint64_t mask = g.legalMoves();
+            std::uniform_int_distribution<int> pick(0, std::popcount(mask) - 1);
+            for (int k = pick(_rng); k > 0; --k)
+                mask &= mask - 1;
+            g.play(std::countr_zero(mask));
+            ++plies;
+        }
+        // result() is for the side to move at the end; flip it back to the
+        // side to move at the leaf for every ply played.
+        return plies % 2 == 0 ? g.result() : -g.result();
+    }
+
+    NetEvaluator<Game>& _eval;
+    MctsConfig _cfg;
+    std::mt19937 _rng;
+    std::vector<Node> _nodes;
+    std::vector<std::uint32_t> _path;
+    std::vector<int> _moves;
+    Eigen::MatrixXd _childScores;
+    std::array<double, Game::numMoves> _policy {};
+};
+
+} // namespace nu
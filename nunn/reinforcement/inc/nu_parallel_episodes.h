@@ -0,0 +1,239 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Parallel episode execution for the tabular learners (QLGraph, QLearn,
+// Sarsa).
+//
+// Episodes run in rounds of threads x roundEpisodes; each worker runs a
+// contiguous block of the round's episodes. Q-values are shared in one of two
+// ways:
+//
+//   Hogwild  every worker updates the learner's table in place, without
+//            locks (Niu et al., "Hogwild!", NIPS 2011). Every load and store
+//            of the table, the policy's included (see SharedTableView), goes
+//            through std::atomic_ref with relaxed order; results depend on
+//            scheduling.
+//   Deltas   every worker learns on a private copy of the table taken at the
+//            start of the round. At the end of the round every entry moves
+//            by the mean change of the copies that changed it, merged in
+//            worker order. With a non-zero seed, a run is reproducible for a
+//            given thread count. Averaging keeps the step size stable but
+//            learns less per episode than Hogwild, so it needs more episodes.
+//
+// Workers draw from their own generators, seeded from (seed, round, worker),
+// and own a copy of the policy (reseeded the same way when it has a
+// seed(std::uint32_t) member).
+//
+
+#pragma once
+
+#include "nu_dense_qmap.h"
+#include "nu_parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace nu {
+
+enum class ParallelUpdate {
+    Hogwild, // lock-free updates of the shared table
+    Deltas, // per-worker tables merged at the end of each round
+};
+
+struct ParallelLearnConfig {
+    size_t threads = 0; // 0 = hardware concurrency
+    ParallelUpdate update = ParallelUpdate::Hogwild;
+    size_t roundEpisodes = 16; // episodes per worker between merges
+    std::uint32_t seed = 0; // 0 = seeded from std::random_device
+    size_t maxSteps = 0; // per-episode step limit (0 = until the goal)
+};
+
+// How a learner step reaches its Q-table.
+enum class TableAccess {
+    Serial, // the learner's own table, single thread
+    Private, // a worker's private copy
+    Shared, // the learner's table, updated by every worker (Hogwild)
+};
+
+// Relaxed atomic access to a Q-value updated by concurrent workers.
+inline double loadShared(double& q) noexcept
+{
+    return std::atomic_ref<double>(q).load(std::memory_order_relaxed);
+}
+
+inline void storeShared(double& q, double value) noexcept
+{
+    std::atomic_ref<double>(q).store(value, std::memory_order_relaxed);
+}
+
+// What a policy sees of a DenseQMap shared by Hogwild workers: view[state]
+// copies the state's row with loadShared() and returns a read-only row over
+// the copy, so the policy never reads a Q-value with a plain load while
+// another worker stores it. The row is valid until the next lookup.
+template <class Table> class SharedTableView {
+public:
+    static constexpr size_t numActions = Table::numActions;
+
+    explicit SharedTableView(Table& table) noexcept
+        : _table(table)
+    {
+    }
+
+    // Throws std::out_of_range if s is not covered: growing the shared table
+    // would move it under the other workers.
+    template <class State> typename Table::ConstRow operator[](const State& s)
+    {
+        if (!_table.covers(s))
+            throw std::out_of_range("SharedTableView: state not covered by the Q-map");
+        auto row = _table.row(_table.index().state(s));
+        for (size_t a = 0; a < numActions; ++a)
+            _row[a] = loadShared(row.at(a));
+        return typename Table::ConstRow(_row.data(), &_table.index());
+    }
+
+private:
+    Table& _table;
+    std::array<double, numActions> _row {};
+};
+
+// Action chosen by policy from q: through a SharedTableView when q is shared
+// by Hogwild workers, directly otherwise.
+template <class Action, class Table, class Agent, class Policy>
+Action selectActionFrom(Table& q, const Agent& agent, const Policy& policy, TableAccess access)
+{
+    if constexpr (isDenseQMap<Table>) {
+        if (access == TableAccess::Shared) {
+            SharedTableView<Table> view(q);
+            return policy.template selectAction<SharedTableView<Table>>(agent, view);
+        }
+    }
+    return policy.template selectAction<Table>(agent, q);
+}
+
+// Seed of worker `tid` in `round`, derived from the base seed.
+inline std::uint32_t workerSeed(std::uint32_t base, size_t round, size_t tid)
+{
+    std::seed_seq seq{ base, static_cast<std::uint32_t>(round), static_cast<std::uint32_t>(tid) };
+    std::uint32_t seed = 0;
+    seq.generate(&seed, &seed + 1);
+    return seed;
+}
+
+// Reseeds policy if it supports it; otherwise leaves it as copied.
+template <class Policy> void seedPolicy(Policy& policy, std::uint32_t seed)
+{
+    if constexpr (requires { policy.seed(seed); })
+        policy.seed(seed);
+}
+
+// Merges the workers' copies of a table: entry i of global moves by the mean
+// change (local[i] - base[i]) over the copies that changed it. Summing the
+// changes instead would scale the step size by the number of workers, and
+// diverge with the usual learning rates. Copies are visited in order.
+inline void mergeDeltas(
+    double* global, const std::vector<const double*>& locals, const double* base, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        double sum = 0.0;
+        size_t changed = 0;
+        for (const double* local : locals) {
+            const double delta = local[i] - base[i];
+            if (delta != 0.0) {
+                sum += delta;
+                ++changed;
+            }
+        }
+        if (changed > 0)
+            global[i] += sum / static_cast<double>(changed);
+    }
+}
+
+// Runs nOfEpisodes episodes in rounds. For every round of `count` episodes
+// starting at `first`, beginRound(first, count) runs on the calling thread,
+// then runRange(b, e, tid, seed) runs episodes [b, e) on worker tid, then
+// endRound(first, count) runs on the calling thread. Either round callback
+// returns false to stop; the function then returns false.
+template <class BeginRound, class RunRange, class EndRound>
+bool runEpisodeRounds(size_t nOfEpisodes, const ParallelLearnConfig& cfg, size_t threads,
+    BeginRound&& beginRound, RunRange&& runRange, EndRound&& endRound)
+{
+    const std::uint32_t base = cfg.seed != 0 ? cfg.seed : std::random_device {}();
+    const size_t perRound = threads * std::max<size_t>(1, cfg.roundEpisodes);
+
+    for (size_t first = 0, round = 0; first < nOfEpisodes; first += perRound, ++round) {
+        const size_t count = std::min(perRound, nOfEpisodes - first);
+        if (!beginRound(first, count))
+            return false;
+        parallelFor(count, threads, [&](size_t b, size_t e, size_t tid) {
+            runRange(first + b, first + e, tid, workerSeed(base, round, tid));
+        });
+        if (!endRound(first, count))
+            return false;
+    }
+    return true;
+}
+
+// Parallel driver of QLearn / Sarsa over a DenseQMap table. For every
+// episode, a worker calls episode(q, index, policy, access) with its own
+// policy copy, where q is the table (Shared) or its private copy (Private);
+// it returns the episode's reward. After each round, notify(roundReward,
+// episodesRun) runs on the calling thread and returns false to stop. Returns
+// the reward of all the episodes run.
+template <class Table, class Policy, class Episode, class Notify>
+double learnTableParallel(Table& table, size_t nOfEpisodes, const ParallelLearnConfig& cfg,
+    const Policy& policy, Episode&& episode, Notify&& notify)
+{
+    const size_t threads = resolveThreads(cfg.threads, nOfEpisodes);
+    const bool hogwild = cfg.update == ParallelUpdate::Hogwild;
+    const size_t n = table.numStates() * Table::numActions;
+
+    Table base = hogwild ? Table() : table;
+    std::vector<Table> local(hogwild ? 0 : threads, table);
+    std::vector<const double*> copies;
+    for (const auto& q : local)
+        copies.push_back(q.data());
+    std::vector<double> rewards(threads, 0.0);
+    double total = 0.0;
+
+    runEpisodeRounds(
+        nOfEpisodes, cfg, threads, [](size_t, size_t) { return true; },
+        [&](size_t b, size_t e, size_t tid, std::uint32_t seed) {
+            Policy workerPolicy = policy;
+            seedPolicy(workerPolicy, seed);
+            double reward = 0.0;
+            for (size_t i = b; i < e; ++i) {
+                reward += hogwild ? episode(table, i, workerPolicy, TableAccess::Shared)
+                                  : episode(local[tid], i, workerPolicy, TableAccess::Private);
+            }
+            rewards[tid] = reward;
+        },
+        [&](size_t first, size_t count) {
+            double roundReward = 0.0;
+            for (auto& r : rewards) {
+                roundReward += r;
+                r = 0.0;
+            }
+            total += roundReward;
+            if (!hogwild) {
+                mergeDeltas(table.data(), copies, base.data(), n);
+                std::copy_n(table.data(), n, base.data());
+                for (auto& q : local)
+                    std::copy_n(table.data(), n, q.data());
+            }
+            return notify(roundReward, first + count);
+        });
+
+    return total;
+}
+
+} // namespace nu
@@ -0,0 +1,103 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Prioritized experience replay (Schaul et al., "Prioritized Experience
+// Replay", ICLR 2016), proportional variant.
+//
+// Slot i of a replay memory is drawn with probability
+//   P(i) = p_i^alpha / sum_k p_k^alpha,   p_i = |delta_i| + epsilon
+// where delta_i is the last TD error measured for it; new transitions get the
+// largest priority seen so far, so each is replayed at least once soon. The
+// bias this introduces is corrected with importance-sampling weights
+//   w_i = (N P(i))^-beta / max_k (N P(k))^-beta,
+// with beta annealed towards 1 over training.
+//
+// PrioritizedSampler keeps only the priorities, indexed by slot; the
+// transitions stay in a ReplayMemory (or any ring indexed the same way).
+// Priorities live in a SumTree, so add(), update() and each drawn sample cost
+// O(log capacity).
+//
+
+#pragma once
+
+#include <Eigen/Core>
+#include <random>
+#include <vector>
+
+namespace nu {
+
+// Binary tree over `capacity` non-negative leaf values keeping the sum and
+// the minimum of every subtree. Leaves are stored after the internal nodes
+// (heap layout), padded to a power of two with zeros.
+class SumTree {
+public:
+    explicit SumTree(size_t capacity);
+
+    // Sets leaf i (< capacity) to value >= 0.
+    void set(size_t i, double value);
+    double get(size_t i) const noexcept { return _sum[_leaves + i]; }
+
+    double total() const noexcept { return _sum[1]; }
+
+    // Smallest positive leaf value; +infinity if all leaves are zero.
+    double minPositive() const noexcept { return _min[1]; }
+
+    // Leaf i such that the prefix sum of leaves [0, i) <= u < that of [0, i].
+    // u is clamped to [0, total()); leaves of value zero are never returned
+    // while total() > 0.
+    size_t find(double u) const noexcept;
+
+    size_t capacity() const noexcept { return _capacity; }
+
+private:
+    size_t _capacity;
+    size_t _leaves;
+    std::vector<double> _sum;
+    std::vector<double> _min;
+};
+
+class PrioritizedSampler {
+public:
+    // alpha: 0 gives uniform sampling, 1 fully proportional.
+    // epsilon: added to |delta| so no transition becomes unreachable. Keep it
+    // near the TD-error scale: the weights are normalised by that of the
+    // least likely slot, so a tiny epsilon shrinks every update.
+    // Throws std::invalid_argument if capacity == 0, alpha < 0 or epsilon <= 0.
+    explicit PrioritizedSampler(size_t capacity, double alpha = 0.6, double epsilon = 0.01);
+
+    // Gives slot the maximum priority seen so far (1 initially). Call it for
+    // every slot written to the memory.
+    void add(size_t slot);
+
+    // Draws batchSize slots (with replacement), one from each of batchSize
+    // equal slices of the total priority, and their importance-sampling
+    // weights, normalised so the largest possible weight is 1.
+    // Throws std::invalid_argument if no slot has been added.
+    void sample(size_t batchSize, double beta, std::mt19937& rng, std::vector<size_t>& slots,
+        Eigen::VectorXd& weights) const;
+
+    // Sets the priorities of slots from their TD errors.
+    void update(
+        const std::vector<size_t>& slots, const Eigen::Ref<const Eigen::VectorXd>& tdErrors);
+
+    // Sampling priority p_i^alpha of slot.
+    double priority(size_t slot) const noexcept { return _tree.get(slot); }
+
+    // Number of slots that have been added.
+    size_t size() const noexcept { return _size; }
+
+    double alpha() const noexcept { return _alpha; }
+
+private:
+    SumTree _tree;
+    double _alpha;
+    double _epsilon;
+    double _maxPriority = 1.0; // largest |delta| + epsilon, before ^alpha
+    size_t _size = 0;
+};
+
+} // namespace nu
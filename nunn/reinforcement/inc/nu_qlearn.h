@@ -8,9 +8,13 @@
 
 #pragma once
 
+#include "nu_dense_qmap.h"
 #include "nu_learner_listener.h"
+#include "nu_parallel_episodes.h"
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace nu {
@@ -31,6 +35,13 @@ public:
     {
     }
 
+    // Starts from a given Q-map, e.g. a DenseQMap sized for the state space.
+    explicit QLearn(QMap qMap, std::shared_ptr<Listener> listener = nullptr)
+        : _qMap(std::move(qMap))
+        , _listener(listener)
+    {
+    }
+
     QLearn(const QLearn&) = default;
     QLearn& operator=(const QLearn&) = default;
 
@@ -65,6 +76,37 @@ public:
         return reward;
     }
 
+    // Runs nOfEpisodes episodes on cfg.threads workers (see
+    // nu_parallel_episodes.h); makeAgent(episode) returns the agent of each
+    // episode and is called concurrently. QMap must be a DenseQMap covering
+    // every reachable state: reaching another one throws std::out_of_range.
+    // The listener, if any, is notified after each round with the reward of
+    // the round and the number of episodes run. Returns the total reward.
+    template <class MakeAgent>
+    double learnParallel(size_t nOfEpisodes, MakeAgent&& makeAgent,
+        const ParallelLearnConfig& cfg = ParallelLearnConfig(), const Policy& policy = Policy())
+    {
+        static_assert(isDenseQMap<QMap>, "QLearn::learnParallel requires a DenseQMap");
+
+        const auto episode = [&](QMap& q, size_t i, const Policy& p, TableAccess access) {
+            Agent agent = makeAgent(i);
+            double reward = 0;
+            for (size_t step = 0; !agent.goal() && (cfg.maxSteps == 0 || step < cfg.maxSteps);
+                 ++step) {
+                reward += access == TableAccess::Shared
+                    ? _updateQ<TableAccess::Shared>(q, agent, p)
+                    : _updateQ<TableAccess::Private>(q, agent, p);
+            }
+            return reward;
+        };
+
+        return learnTableParallel(_qMap, nOfEpisodes, cfg, policy, episode,
+            [&](double reward, size_t episodes) {
+                auto listener = _listener.lock();
+                return !listener || listener->notify(reward, episodes);
+            });
+    }
+
     const QMap& getQMap() const noexcept { return _qMap; }
 
 protected:
@@ -72,9 +114,21 @@ protected:
 
     double updateQ(Agent& agent, const Policy& policy)
     {
-        Action action = policy.template selectAction<QMap>(agent, getQMap());
+        return _updateQ<TableAccess::Serial>(getQMap(), agent, policy);
+    }
+
+private:
+    template <TableAccess Access> double _updateQ(QMap& q, Agent& agent, const Policy& policy)
+    {
+        if constexpr (Access != TableAccess::Serial)
+            _checkCovered(q, agent.getCurrentState());
+
+        // Shared: the policy reads the table through a SharedTableView.
+        Action action = selectActionFrom<Action>(q, agent, policy, Access);
 
-        auto& qsa = getQMap()[agent.getCurrentState()][action];
+        // Copied: with a DenseQMap a Q-value reference does not survive the
+        // lookups below, so Q(s, a) is read and written once they are done.
+        const State state = agent.getCurrentState();
 
         // update agent state
         agent.doAction(action);
@@ -82,6 +136,9 @@ protected:
         // get current agent state
         const auto& agentState = agent.getCurrentState();
 
+        if constexpr (Access != TableAccess::Serial)
+            _checkCovered(q, agentState);
+
         // get a reward for current state
         const auto reward = agent.reward();
 
@@ -90,27 +147,40 @@ protected:
 
         // A terminal/dead-end state may expose no valid actions; its
         // estimated future value is then 0. Otherwise take the best Q over
-        // the valid actions (seeded with the first one so negative Q values
-        // are handled correctly).
+        // the valid actions (negative Q values included).
         double max = 0.0;
 
         if (!validActions.empty()) {
-            max = getQMap()[agentState][validActions[0]];
-
-            for (const auto& anAction : validActions) {
-                auto val = getQMap()[agentState][anAction];
-                if (val > max) {
-                    max = val;
-                }
+            if constexpr (Access == TableAccess::Shared) {
+                auto&& row = q[agentState];
+                max = loadShared(row[validActions[0]]);
+                for (const auto& anAction : validActions)
+                    max = std::max(max, loadShared(row[anAction]));
+            } else {
+                max = maxQ(q[agentState], validActions);
             }
         }
 
-        qsa += getLearningRate() * (reward + getDiscountRate() * max - qsa);
+        auto& qsa = q[state][action];
+
+        if constexpr (Access == TableAccess::Shared) {
+            const double old = loadShared(qsa);
+            const double updated
+                = old + getLearningRate() * (reward + getDiscountRate() * max - old);
+            storeShared(qsa, updated);
+            return updated;
+        } else {
+            qsa += getLearningRate() * (reward + getDiscountRate() * max - qsa);
+            return qsa;
+        }
+    }
 
-        return qsa;
+    static void _checkCovered(const QMap& q, const State& state)
+    {
+        if (!q.covers(state))
+            throw std::out_of_range("QLearn::learnParallel: state not covered by the Q-map");
     }
 
-private:
     double _learningRate{ 0.1 };
     double _discountRate{ 0.9 };
 
@@ -8,12 +8,14 @@
 
 #pragma once
 
+#include "nu_parallel_episodes.h"
 #include "nu_qmatrix.h"
 #include "nu_random_gen.h"
 
 #include <cassert>
 #include <list>
 #include <memory>
+#include <random>
 #include <unordered_map>
 #include <vector>
 
@@ -41,6 +43,7 @@ public:
         , _q_mtx(reward_mtx.size())
     {
         assert(_nOfStates > 0);
+        _buildValidActions();
     }
 
     void setLearningRate(const double& lr) noexcept { _learningRate = lr; }
@@ -74,6 +77,19 @@ public:
     // Function to start the learning process over a specified number of episodes.
     bool learn(const size_t& nOfEpisodes, const Helper& helper = Helper());
 
+    // Runs the episodes on cfg.threads workers (see nu_parallel_episodes.h).
+    // Workers draw from their own generators instead of helper.rnd(). The
+    // helper runs on the calling thread around each round: beginEpisode()
+    // gets the round's first episode, endEpisode() its last.
+    bool learn(
+        const size_t& nOfEpisodes, const ParallelLearnConfig& cfg, const Helper& helper = Helper());
+
+    // Computes Q by value iteration instead of episodes: Bellman sweeps
+    // (QMatrix::bellmanSweep) with the discount rate until no entry changes
+    // by more than tolerance, or maxSweeps sweeps. Normalizes Q as learn()
+    // does. Returns the number of sweeps run.
+    size_t valueIteration(double tolerance = 1e-9, size_t maxSweeps = 10000);
+
     // Returns the learned Q-Matrix.
     const QMatrix& get_q_mtx() const noexcept { return _q_mtx; }
 
@@ -84,6 +100,13 @@ private:
     // Retrieves a list of valid actions for a given state.
     static valid_actions_t retrieveValidActions(const QMatrix& r, size_t state);
 
+    // Caches the valid actions of every state; the reward matrix is fixed.
+    void _buildValidActions();
+
+    // One episode from a random state, updating q. Shared: q is updated
+    // concurrently by other workers.
+    template <bool Shared> void _runEpisode(QMatrix& q, std::mt19937& rng, size_t maxSteps) const;
+
     // Selects a random action from a list of valid actions.
     size_t rand_of(const valid_actions_t& va)
     {
@@ -96,6 +119,7 @@ private:
 
     QMatrix _rewardMtx; // Matrix representing the rewards for state transitions.
     QMatrix _q_mtx; // Q-Matrix representing the learned state-action values.
+    std::vector<valid_actions_t> _validActions; // per state, from _rewardMtx
 
     double _learningRate{ 0.8 }; // Learning rate in the Q-Learning algorithm.
     double _discountRate{ 0.8 }; // Discount rate for future rewards.
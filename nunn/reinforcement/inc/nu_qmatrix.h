@@ -5,11 +5,19 @@
 // Licensed under the MIT License.
 // See COPYING file in the project root for full license information.
 //
+// Square [states x states] matrix of Q-values (or rewards) of a QLGraph:
+// entry (s, a) refers to the move from state s to state a.
+//
+// Entries live in one contiguous row-major buffer, so row reductions (max,
+// maxarg) and whole-matrix sweeps (maxAll, bellmanSweep) are vectorised
+// streams over memory rather than one allocation per row.
+//
 
 #pragma once
 
 #include "nu_vector.h"
 
+#include <Eigen/Core>
 #include <iostream>
 #include <stdexcept>
 
@@ -20,6 +28,10 @@ public:
     using vect_t = Vector;
     using data_t = std::vector<vect_t>;
 
+    // Views of one row; valid until the matrix is resized or destroyed.
+    using Row = Eigen::Map<Eigen::RowVectorXd>;
+    using ConstRow = Eigen::Map<const Eigen::RowVectorXd>;
+
     class InvalidIndexException : public std::runtime_error {
     public:
         InvalidIndexException()
@@ -28,10 +40,9 @@ public:
         }
     };
 
-    explicit QMatrix(const data_t& m)
-        : _data(m)
-    {
-    }
+    // Copies m into contiguous storage. Throws std::invalid_argument if m is
+    // not square.
+    explicit QMatrix(const data_t& m);
 
     QMatrix() = delete;
     QMatrix(size_t size);
@@ -43,7 +54,7 @@ public:
 
     void fill(const double& value) noexcept;
 
-    size_t size() const noexcept { return data().size(); }
+    size_t size() const noexcept { return static_cast<size_t>(_m.rows()); }
 
     friend std::ostream& operator<<(std::ostream& os, const QMatrix& m)
     {
@@ -51,23 +62,38 @@ public:
         return os;
     }
 
+    // Max of row rowidx and the column of its first occurrence.
     double max(size_t rowidx) const;
     size_t maxarg(size_t rowidx) const;
 
-    vect_t& operator[](const size_t& rowidx);
-    const vect_t& operator[](const size_t& rowidx) const;
+    // Max of every row, in one pass over the matrix.
+    Eigen::VectorXd maxAll() const;
+
+    // One synchronous Bellman sweep over the transitions allowed by reward
+    // (same size, entries < 0 forbidden):
+    //   Q(s, a) = reward(s, a) + discount * max_a' Q(a, a')
+    // with the row maxima taken before the sweep. Forbidden entries are left
+    // unchanged. Returns the largest change of an entry.
+    // Throws std::invalid_argument if reward has a different size.
+    double bellmanSweep(const QMatrix& reward, double discount);
+
+    Row operator[](const size_t& rowidx);
+    ConstRow operator[](const size_t& rowidx) const;
 
     void normalize();
 
+    // Row-major buffer of size() * size() entries.
+    double* data() noexcept { return _m.data(); }
+    const double* data() const noexcept { return _m.data(); }
+
 protected:
-    data_t& data() noexcept { return _data; }
-    const data_t& data() const noexcept { return _data; }
     void show(std::ostream& os, size_t width = 3) const;
 
 private:
+    void _checkRow(size_t rowidx) const;
     void _max(size_t rowidx, size_t& idx, double& max) const;
 
-    data_t _data;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _m;
 };
 
 }
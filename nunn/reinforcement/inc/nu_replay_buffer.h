@@ -8,17 +8,40 @@
 // Fixed-capacity circular experience replay buffer used by DQN training.
 // Header-only template: State and Action are user-supplied types.
 //
+// Transitions live in a ring: once the buffer is full, push() overwrites the
+// oldest slot. sample() draws batchSize distinct slots in O(batchSize) time
+// (Floyd's algorithm), independently of the number of stored transitions.
+// For vector states of fixed size see ReplayMemory (nu_replay_memory.h),
+// which stores them contiguously and returns batches as matrices.
+//
 
 #pragma once
 
-#include <deque>
-#include <numeric>
+#include <cstdint>
 #include <random>
 #include <stdexcept>
 #include <vector>
 
 namespace nu {
 
+// Draws k distinct indices from [0, n) into out (Floyd's algorithm): k random
+// draws, no pass over [0, n). mark must hold n zero bytes; it is used to test
+// membership and is left zeroed on return. The set is uniform; the order of
+// out is not a uniform permutation, which does not matter for a mini-batch.
+inline void sampleDistinct(
+    size_t n, size_t k, std::mt19937& rng, std::vector<size_t>& out, std::vector<uint8_t>& mark)
+{
+    out.clear();
+    for (size_t j = n - k; j < n; ++j) {
+        const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+        const size_t pick = mark[t] ? j : t;
+        mark[pick] = 1;
+        out.push_back(pick);
+    }
+    for (const size_t i : out)
+        mark[i] = 0;
+}
+
 template <class State, class Action> class ExperienceReplayBuffer {
 public:
     struct Transition {
@@ -38,31 +61,40 @@ public:
 
     void push(State s, Action a, double r, State s_next, bool done)
     {
-        if (_buf.size() == _capacity)
-            _buf.pop_front();
-        _buf.push_back({ std::move(s), std::move(a), r, std::move(s_next), done });
+        Transition tr{ std::move(s), std::move(a), r, std::move(s_next), done };
+        if (_buf.size() < _capacity) {
+            _buf.push_back(std::move(tr));
+            _mark.push_back(0);
+        } else {
+            _buf[_next] = std::move(tr);
+        }
+        _next = (_next + 1) % _capacity;
     }
 
     std::vector<Transition> sample(size_t batchSize, std::mt19937& rng) const
     {
         if (batchSize > _buf.size())
             throw std::invalid_argument("ExperienceReplayBuffer::sample: not enough transitions");
-        std::vector<size_t> idx(_buf.size());
-        std::iota(idx.begin(), idx.end(), 0);
-        std::shuffle(idx.begin(), idx.end(), rng);
+        sampleDistinct(_buf.size(), batchSize, rng, _idx, _mark);
         std::vector<Transition> batch;
         batch.reserve(batchSize);
-        for (size_t i = 0; i < batchSize; ++i)
-            batch.push_back(_buf[idx[i]]);
+        for (const size_t i : _idx)
+            batch.push_back(_buf[i]);
         return batch;
     }
 
     size_t size() const noexcept { return _buf.size(); }
+    size_t capacity() const noexcept { return _capacity; }
     bool ready(size_t minSize) const noexcept { return _buf.size() >= minSize; }
 
 private:
-    std::deque<Transition> _buf;
+    std::vector<Transition> _buf;
     size_t _capacity;
+    size_t _next = 0; // slot written by the next push()
+
+    // Sampling scratch, reused across calls.
+    mutable std::vector<size_t> _idx;
+    mutable std::vector<uint8_t> _mark;
 };
 
 } // namespace nu
@@ -0,0 +1,146 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Contiguous ring-buffer replay memory for vector states of fixed size.
+//
+// All storage is allocated once by the constructor: states and next states
+// are [stateDim × capacity] column-major matrices (one transition per
+// column, i.e. a row-major [capacity × stateDim] array), actions, rewards
+// and done flags are parallel arrays. push() writes one slot in place and,
+// when the memory is full, overwrites the oldest transition.
+//
+// sample() draws batchSize distinct slots in O(batchSize) (see
+// sampleDistinct()) and gathers them into batch matrices owned by the
+// memory. The returned Batch is a reference to those buffers: it can be
+// passed to MlpMatrixNN::feedForwardBatch() / trainBatch() as is, and stays
+// valid until the next sample() call.
+//
+// Usage:
+//   nu::ReplayMemory mem(100000, stateDim);
+//   mem.push(s, a, r, sNext, done);
+//   const auto& b = mem.sample(64, rng);
+//   auto q = net.feedForwardBatch(b.states);
+//
+
+#pragma once
+
+#include "nu_replay_buffer.h"
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace nu {
+
+class ReplayMemory {
+public:
+    struct Batch {
+        Eigen::MatrixXd states;     // [stateDim × B]
+        Eigen::MatrixXd nextStates; // [stateDim × B]
+        std::vector<int> actions;
+        Eigen::VectorXd rewards;
+        std::vector<uint8_t> done;
+        std::vector<size_t> slots; // memory slot of each column
+    };
+
+    // Throws std::invalid_argument if capacity or stateDim is 0.
+    ReplayMemory(size_t capacity, size_t stateDim);
+
+    // Stores a transition. Throws std::invalid_argument if a state does not
+    // have stateDim elements.
+    void push(const std::vector<double>& s, int a, double r, const std::vector<double>& sNext,
+        bool done);
+    void push(const Eigen::Ref<const Eigen::VectorXd>& s, int a, double r,
+        const Eigen::Ref<const Eigen::VectorXd>& sNext, bool done);
+
+    // Stores the N transitions held in the columns of states / nextStates
+    // [stateDim x N] (one block copy per contiguous run of slots). N must not
+    // exceed capacity. Throws std::invalid_argument on any size mismatch.
+    void pushBatch(const Eigen::Ref<const Eigen::MatrixXd>& states, const std::vector<int>& actions,
+        const Eigen::Ref<const Eigen::VectorXd>& rewards,
+        const Eigen::Ref<const Eigen::MatrixXd>& nextStates, const std::vector<uint8_t>& done);
+
+    // Gathers batchSize distinct transitions, drawn uniformly.
+    // Throws std::invalid_argument if fewer than batchSize are stored.
+    const Batch& sample(size_t batchSize, std::mt19937& rng);
+
+    // Gathers the given slots (each < size()) into the batch buffers.
+    const Batch& gather(const std::vector<size_t>& slots);
+
+    size_t size() const noexcept { return _size; }
+    size_t capacity() const noexcept { return _capacity; }
+    size_t stateDim() const noexcept { return _stateDim; }
+    bool ready(size_t minSize) const noexcept { return _size >= minSize; }
+
+    // Slot written by the next push().
+    size_t nextSlot() const noexcept { return _next; }
+
+    void clear() noexcept { _size = _next = 0; }
+
+private:
+    size_t _capacity;
+    size_t _stateDim;
+    size_t _size = 0;
+    size_t _next = 0;
+
+    Eigen::MatrixXd _s;     // [stateDim × capacity]
+    Eigen::MatrixXd _sNext; // [stateDim × capacity]
+    std::vector<int> _a;
+    std::vector<double> _r;
+    std::vector<uint8_t> _done;
+
+    Batch _batch;
+    std::vector<uint8_t> _mark; // sampleDistinct() scratch
+};
+
+// Turns the 1-step transitions of `streams` independent episode streams
+// (e.g. one per environment) into n-step ones before they reach a
+// ReplayMemory:
+//   (s_t, a_t, r_t + g r_t+1 + ... + g^(k-1) r_t+k-1, s_t+k, done)
+// where g is gamma. k = n, so the learner bootstraps with g^n, unless the
+// episode ends first: done then closes every open window of the stream as a
+// terminal transition. A transition whose state differs from the previous
+// next state of its stream starts a new episode (one cut without done); the
+// windows left open are dropped, since they cannot be completed.
+class NStepAccumulator {
+public:
+    // Throws std::invalid_argument if n, stateDim or streams is 0.
+    NStepAccumulator(size_t n, double gamma, size_t stateDim, size_t streams = 1);
+
+    // Adds a transition of stream and pushes the n-step transitions it
+    // completes into memory. Returns how many were pushed (to consecutive
+    // ring slots from memory.nextSlot()).
+    size_t push(size_t stream, const Eigen::Ref<const Eigen::VectorXd>& s, int a, double r,
+        const Eigen::Ref<const Eigen::VectorXd>& sNext, bool done, ReplayMemory& memory);
+
+    // Drops every open window.
+    void clear() noexcept;
+
+    size_t n() const noexcept { return _n; }
+    size_t streams() const noexcept { return _streams.size(); }
+
+private:
+    struct Stream {
+        Eigen::MatrixXd states; // [stateDim x n] ring
+        std::vector<int> actions;
+        std::vector<double> rewards;
+        Eigen::VectorXd lastNext;
+        size_t head = 0;
+        size_t count = 0;
+    };
+
+    // Discounted sum of the rewards of the window starting `offset` entries
+    // after the oldest one.
+    double _return(const Stream& st, size_t offset) const noexcept;
+
+    size_t _n;
+    double _gamma;
+    std::vector<Stream> _streams;
+};
+
+} // namespace nu
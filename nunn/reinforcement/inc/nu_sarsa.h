@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include "nu_dense_qmap.h"
 #include "nu_learner_listener.h"
+#include "nu_parallel_episodes.h"
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace nu {
@@ -31,6 +34,13 @@ public:
     {
     }
 
+    // Starts from a given Q-map, e.g. a DenseQMap sized for the state space.
+    explicit Sarsa(QMap qMap, std::shared_ptr<Listener> listener = nullptr)
+        : _qMap(std::move(qMap))
+        , _listener(listener)
+    {
+    }
+
     Sarsa(const Sarsa&) = default;
     Sarsa& operator=(const Sarsa&) = default;
 
@@ -71,6 +81,37 @@ public:
         return reward;
     }
 
+    // Learns nOfEpisodes episodes on cfg.threads workers, as
+    // QLearn::learnParallel() does. QMap must be a DenseQMap covering every
+    // reachable state. Returns the total reward.
+    template <class MakeAgent>
+    double learnParallel(size_t nOfEpisodes, MakeAgent&& makeAgent,
+        const ParallelLearnConfig& cfg = ParallelLearnConfig(), const Policy& policy = Policy())
+    {
+        static_assert(isDenseQMap<QMap>, "Sarsa::learnParallel requires a DenseQMap");
+
+        const auto episode = [&](QMap& q, size_t i, const Policy& p, TableAccess access) {
+            Agent agent = makeAgent(i);
+            _checkCovered(q, agent.getCurrentState());
+            Action action = selectActionFrom<Action>(q, agent, p, access);
+            State state = agent.getCurrentState();
+            double reward = 0;
+            for (size_t step = 0; !agent.goal() && (cfg.maxSteps == 0 || step < cfg.maxSteps);
+                 ++step) {
+                reward += access == TableAccess::Shared
+                    ? _updateQ<TableAccess::Shared>(q, agent, p, state, action)
+                    : _updateQ<TableAccess::Private>(q, agent, p, state, action);
+            }
+            return reward;
+        };
+
+        return learnTableParallel(_qMap, nOfEpisodes, cfg, policy, episode,
+            [&](double reward, size_t episodes) {
+                auto listener = _listener.lock();
+                return !listener || listener->notify(reward, episodes);
+            });
+    }
+
     // Returns the current Q-map, which holds the state-action values.
     const QMap& getQMap() const noexcept { return _qMap; }
 
@@ -81,20 +122,49 @@ protected:
     // Updates the Q-value for the given state and action.
     double updateQ(Agent& agent, const Policy& policy, State& state, Action& action)
     {
-        auto& qsa = getQMap()[agent.getCurrentState()][action];
+        return _updateQ<TableAccess::Serial>(getQMap(), agent, policy, state, action);
+    }
+
+private:
+    template <TableAccess Access>
+    double _updateQ(QMap& q, Agent& agent, const Policy& policy, State& state, Action& action)
+    {
+        // Q(s, a) is looked up after the policy has run: with a DenseQMap a
+        // Q-value reference does not survive other lookups.
+        const State s0 = agent.getCurrentState();
         agent.doAction(action);
         const auto& state1 = agent.getCurrentState();
+        if constexpr (Access != TableAccess::Serial)
+            _checkCovered(q, state1);
         const auto reward = agent.reward();
-        auto action1 = policy.template selectAction<QMap>(agent, getQMap());
-
-        qsa += getLearningRate() * (reward + getDiscountRate() * getQMap()[state1][action1] - qsa);
+        // Shared: the policy reads the table through a SharedTableView.
+        Action action1 = selectActionFrom<Action>(q, agent, policy, Access);
+
+        double result = 0;
+        if constexpr (Access == TableAccess::Shared) {
+            const double q1 = loadShared(q[state1][action1]);
+            auto& qsa = q[s0][action];
+            const double old = loadShared(qsa);
+            result = old + getLearningRate() * (reward + getDiscountRate() * q1 - old);
+            storeShared(qsa, result);
+        } else {
+            const double q1 = q[state1][action1];
+            auto& qsa = q[s0][action];
+            qsa += getLearningRate() * (reward + getDiscountRate() * q1 - qsa);
+            result = qsa;
+        }
         state = state1;
         action = action1;
 
-        return qsa;
+        return result;
+    }
+
+    static void _checkCovered(const QMap& q, const State& state)
+    {
+        if (!q.covers(state))
+            throw std::out_of_range("Sarsa::learnParallel: state not covered by the Q-map");
     }
 
-private:
     double _learningRate{ 0.1 }; // Default learning rate
     double _discountRate{ 0.9 }; // Default discount rate
 
@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include "nu_dense_qmap.h"
 #include "nu_random_gen.h"
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace nu {
 
@@ -21,10 +24,11 @@ public:
 
     double getTemperature() const noexcept { return _temperature; }
 
+    // Reseeds the random generator (e.g. per worker thread).
+    void seed(std::uint32_t s) { _rndGen.seed(s); }
+
     template <class QMap> Action selectAction(const Agent& agent, QMap& qMap) const
     {
-        // Get agent to reward map
-        auto actionReward = qMap[agent.getCurrentState()];
         auto validActions = agent.getValidActions();
 
         assert(!validActions.empty());
@@ -34,12 +38,16 @@ public:
         const double temperature
             = getTemperature() > 0.0 ? getTemperature() : std::numeric_limits<double>::min();
 
-        decltype(actionReward) quasiProbs;
+        // The row of the current state is referenced, not copied; the weights
+        // follow the order of validActions.
+        auto&& actionReward = qMap[agent.getCurrentState()];
+        std::vector<double> quasiProbs;
+        quasiProbs.reserve(validActions.size());
         double sumReward = 0;
 
         for (const auto& item : validActions) {
             const auto numerator = std::exp(actionReward[item] / temperature);
-            quasiProbs[item] = numerator;
+            quasiProbs.push_back(numerator);
             sumReward += numerator;
         }
 
@@ -55,10 +63,10 @@ public:
         double sum = 0;
         Action selected = validActions.back();
 
-        for (const auto& item : validActions) {
-            sum += quasiProbs[item] / sumReward;
+        for (size_t i = 0; i < validActions.size(); ++i) {
+            sum += quasiProbs[i] / sumReward;
             if (sum > cutoff) {
-                selected = item;
+                selected = validActions[i];
                 break;
             }
         }
@@ -72,21 +80,8 @@ public:
 
         assert(!validActions.empty());
 
-        Action action = validActions[0];
-
         double reward = 0;
-
-        const auto& agentState = agent.getCurrentState();
-
-        reward = qMap[agentState][action];
-
-        for (const auto& anAction : validActions) {
-            const auto& val = qMap[agentState][anAction];
-            if (val > reward) {
-                reward = val;
-                action = anAction;
-            }
-        }
+        Action action = argmaxQ(qMap[agent.getCurrentState()], validActions, reward);
 
         // TODO(v3.0): the exact == 0.0 test conflates "best Q value is zero"
         // with "state never explored". Revisit together with a proper
@@ -0,0 +1,92 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Tic-tac-toe position as two 9-bit bitboards (one per symbol) plus the side
+// to move, with an incrementally updated Zobrist hash. Cell i is bit i,
+// numbered row by row from the top-left corner, as in the tictactoe and
+// winttt examples.
+//
+// TicTacToe is a Game for the searches of nu_game_search.h. encode() yields
+// the input of the examples' networks: 0.5 * symbol per cell, then 1.0 if O
+// is to move, 0.5 otherwise.
+//
+
+#pragma once
+
+#include "nu_game_search.h"
+
+#include <Eigen/Core>
+#include <cstdint>
+
+namespace nu {
+
+class TicTacToe {
+public:
+    // Same values as the examples' grid_t::symbol_t.
+    enum Symbol { Empty, X, O };
+
+    static constexpr size_t numMoves = 9;
+    static constexpr size_t inputSize = 10;
+
+    // Empty board. Throws std::invalid_argument if first is Empty.
+    explicit TicTacToe(Symbol first = X);
+
+    // Throws std::out_of_range if cell is not in [0, 9).
+    Symbol at(int cell) const;
+
+    // Puts s on cell (Empty clears it) without changing the side to move,
+    // to set up a position. Throws std::out_of_range if cell is not in [0, 9).
+    void set(int cell, Symbol s);
+
+    Symbol turn() const noexcept { return _turn; }
+    // Throws std::invalid_argument if s is Empty.
+    void setTurn(Symbol s);
+
+    // Plays cell for the side to move and passes the turn. Throws
+    // std::out_of_range if cell is not in [0, 9) and std::invalid_argument if
+    // it is taken or the game is over.
+    void play(int cell);
+
+    // Bit i set if cell i is free; 0 once the game is over.
+    std::uint64_t legalMoves() const noexcept { return over() ? 0 : ~(_x | _o) & fullMask; }
+
+    Symbol winner() const noexcept { return _wins(_x) ? X : _wins(_o) ? O : Empty; }
+    bool full() const noexcept { return (_x | _o) == fullMask; }
+    bool over() const noexcept { return full() || _wins(_x) || _wins(_o); }
+
+    // Final score for the side to move: 0 for a draw, otherwise
+    // +-(0.5 + 0.1 * free cells), so quicker wins (and slower losses) score
+    // higher.
+    double result() const noexcept;
+
+    std::uint64_t hash() const noexcept { return _hash; }
+
+    // Cells held by s.
+    std::uint16_t mask(Symbol s) const noexcept { return s == X ? _x : s == O ? _o : _free(); }
+
+    // Throws std::invalid_argument if input does not have inputSize entries.
+    void encode(Eigen::Ref<Eigen::VectorXd> input) const;
+
+    bool operator==(const TicTacToe& other) const noexcept
+    {
+        return _x == other._x && _o == other._o && _turn == other._turn;
+    }
+
+    static constexpr std::uint16_t fullMask = 0x1FF;
+
+private:
+    static bool _wins(std::uint16_t m) noexcept;
+    std::uint16_t _free() const noexcept { return ~(_x | _o) & fullMask; }
+    void _toggle(int cell, Symbol s) noexcept;
+
+    std::uint16_t _x = 0;
+    std::uint16_t _o = 0;
+    Symbol _turn = X;
+    std::uint64_t _hash = 0;
+};
+
+} // namespace nu
@@ -0,0 +1,189 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+// Vectorized rollout runner: steps N environment instances in lockstep for
+// a Dqn agent.
+//
+// Each lockstep step
+//   1. selects the N actions with Dqn::selectActions() (one batched forward
+//      pass over the [stateDim x N] state matrix);
+//   2. steps every environment, on up to `threads` threads of a WorkerPool
+//      (nu_parallel.h) kept for the runner's lifetime, so a step costs a
+//      wake-up and a barrier rather than creating and joining threads;
+//   3. stores the N transitions with Dqn::learnBatch(), which copies them
+//      into replay memory as one block and runs updatesPerStep gradient steps;
+//   4. resets the environments whose episode ended.
+//
+// Env is any type providing
+//   void reset(Eigen::Ref<Eigen::VectorXd> state);   // writes the start state
+//   double step(int action, Eigen::Ref<Eigen::VectorXd> nextState, bool& done);
+// where step() returns the reward. With threads > 1, step() and reset() of
+// different instances run concurrently, so instances must not share mutable
+// state (give each its own random generator).
+//
+// Usage:
+//   std::vector<MyEnv> envs(16);
+//   nu::VecEnvRunner<MyEnv> runner(agent, std::move(envs), 4);
+//   for (int it = 0; it < 1000; ++it)
+//       auto stats = runner.run(100, epsilon);
+//
+
+#pragma once
+
+#include "nu_dqn.h"
+#include "nu_parallel.h"
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace nu {
+
+template <class Env> class VecEnvRunner {
+public:
+    struct Stats {
+        size_t steps = 0;        // environment steps (lockstep steps x N)
+        size_t episodes = 0;     // episodes that ended (done or truncated)
+        double meanReturn = 0.0; // over those episodes
+        double meanLoss = 0.0;   // over the lockstep steps that trained
+    };
+
+    // threads: workers stepping the environments (0 = hardware concurrency).
+    // Resets every environment. Throws std::invalid_argument if envs is empty.
+    VecEnvRunner(Dqn& agent, std::vector<Env> envs, size_t threads = 1)
+        : _agent(agent)
+        , _envs(std::move(envs))
+    {
+        if (_envs.empty())
+            throw std::invalid_argument("VecEnvRunner: at least one environment is required");
+
+        const auto n = static_cast<Eigen::Index>(_envs.size());
+        const auto dim = static_cast<Eigen::Index>(agent.getStateSize());
+        _threads = resolveThreads(threads, _envs.size());
+        _pool = std::make_unique<WorkerPool>(_threads);
+        _states.resize(dim, n);
+        _nextStates.resize(dim, n);
+        _rewards.resize(n);
+        _done.resize(_envs.size());
+        _returns.assign(_envs.size(), 0.0);
+        _lengths.assign(_envs.size(), 0);
+        reset();
+    }
+
+    // Runs `steps` lockstep steps with exploration rate epsilon and
+    // updatesPerStep gradient steps after each (0 = collect only).
+    Stats run(size_t steps, double epsilon, size_t updatesPerStep = 1)
+    {
+        Stats stats;
+        double returns = 0.0;
+        size_t trained = 0;
+        _finished.clear();
+
+        for (size_t t = 0; t < steps; ++t) {
+            _agent.selectActions(_states, epsilon, _actions);
+
+            _pool->parallelFor(_envs.size(), [&](size_t b, size_t e, size_t) {
+                for (size_t j = b; j < e; ++j) {
+                    bool done = false;
+                    const auto col = static_cast<Eigen::Index>(j);
+                    _rewards(col) = _envs[j].step(_actions[j], _nextStates.col(col), done);
+                    _done[j] = done ? 1 : 0;
+                }
+            });
+
+            const size_t learnSteps = _agent.getLearnStepCount();
+            const double loss = _agent.learnBatch(
+                _states, _actions, _rewards, _nextStates, _done, updatesPerStep);
+            if (_agent.getLearnStepCount() != learnSteps) {
+                stats.meanLoss += loss;
+                ++trained;
+            }
+
+            // Ended episodes restart; truncation by maxEpisodeSteps is not a
+            // terminal transition (s' was stored with done == false).
+            _states.swap(_nextStates);
+            _pending.clear();
+            for (size_t j = 0; j < _envs.size(); ++j) {
+                _returns[j] += _rewards(static_cast<Eigen::Index>(j));
+                ++_lengths[j];
+                if (_done[j] || (_maxEpisodeSteps > 0 && _lengths[j] >= _maxEpisodeSteps)) {
+                    _finished.push_back(_returns[j]);
+                    returns += _returns[j];
+                    _returns[j] = 0.0;
+                    _lengths[j] = 0;
+                    _pending.push_back(j);
+                }
+            }
+            _resetPending();
+        }
+
+        stats.steps = steps * _envs.size();
+        stats.episodes = _finished.size();
+        if (stats.episodes > 0)
+            stats.meanReturn = returns / static_cast<double>(stats.episodes);
+        if (trained > 0)
+            stats.meanLoss /= static_cast<double>(trained);
+        return stats;
+    }
+
+    // Resets every environment and the running episode returns.
+    void reset()
+    {
+        _pending.resize(_envs.size());
+        for (size_t j = 0; j < _envs.size(); ++j)
+            _pending[j] = j;
+        _resetPending();
+        _returns.assign(_envs.size(), 0.0);
+        _lengths.assign(_envs.size(), 0);
+    }
+
+    // Episodes longer than n steps are cut and restarted (0 = no limit).
+    void setMaxEpisodeSteps(size_t n) noexcept { _maxEpisodeSteps = n; }
+    size_t getMaxEpisodeSteps() const noexcept { return _maxEpisodeSteps; }
+
+    size_t numEnvs() const noexcept { return _envs.size(); }
+    size_t numThreads() const noexcept { return _threads; }
+    std::vector<Env>& envs() noexcept { return _envs; }
+
+    // Current state of every environment, one per column.
+    const Eigen::MatrixXd& states() const noexcept { return _states; }
+
+    // Returns of the episodes that ended during the last run(), in order.
+    const std::vector<double>& episodeReturns() const noexcept { return _finished; }
+
+private:
+    void _resetPending()
+    {
+        _pool->parallelFor(_pending.size(), [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i) {
+                const size_t j = _pending[i];
+                _envs[j].reset(_states.col(static_cast<Eigen::Index>(j)));
+            }
+        });
+    }
+
+    Dqn& _agent;
+    std::vector<Env> _envs;
+    size_t _threads = 1;
+    std::unique_ptr<WorkerPool> _pool; // _threads threads, the caller included
+    size_t _maxEpisodeSteps = 0;
+
+    Eigen::MatrixXd _states;     // [stateDim x N]
+    Eigen::MatrixXd _nextStates; // [stateDim x N]
+    std::vector<int> _actions;
+    Eigen::VectorXd _rewards;
+    std::vector<uint8_t> _done;
+
+    std::vector<double> _returns; // running return of each episode
+    std::vector<size_t> _lengths; // running length of each episode
+    std::vector<double> _finished;
+    std::vector<size_t> _pending; // environments to reset
+};
+
+} // namespace nu
@@ -9,7 +9,23 @@
 #include "nu_dqn.h"
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <string>
+
+namespace {
+
+// Validated before the networks are built: MlpMatrixNN needs at least an
+// input and an output layer and would otherwise index an empty layer list.
+const std::vector<nu::MlpMatrixNN::LayerConfig>& checkedLayers(
+    const std::vector<nu::MlpMatrixNN::LayerConfig>& netLayers)
+{
+    if (netLayers.size() < 2)
+        throw std::invalid_argument("Dqn: netLayers must have at least input and output");
+    return netLayers;
+}
+
+} // anonymous namespace
 
 namespace nu {
 
@@ -17,17 +33,18 @@ namespace nu {
 
 Dqn::Dqn(const std::vector<MlpMatrixNN::LayerConfig>& netLayers, double lr, size_t bufferCapacity,
     size_t batchSize, double gamma, size_t targetUpdateFreq)
-    : _qNet(std::make_unique<MlpMatrixNN>(netLayers, lr))
+    : _netLayers(checkedLayers(netLayers))
+    , _lr(lr)
+    , _qNet(std::make_unique<MlpMatrixNN>(netLayers, lr))
     , _targetNet(std::make_unique<MlpMatrixNN>(netLayers, lr))
-    , _buffer(bufferCapacity)
+    , _memory(bufferCapacity, netLayers.front().size)
     , _batchSize(batchSize)
     , _gamma(gamma)
     , _targetUpdateFreq(targetUpdateFreq)
     , _numActions(netLayers.back().size)
     , _rng(std::random_device{}())
+    , _gammaN(gamma)
 {
-    if (netLayers.size() < 2)
-        throw std::invalid_argument("Dqn: netLayers must have at least input and output");
     if (batchSize == 0)
         throw std::invalid_argument("Dqn: batchSize must be > 0");
     _syncTarget();
@@ -51,17 +68,137 @@ int Dqn::selectAction(const std::vector<double>& state, double epsilon)
 double Dqn::learn(const std::vector<double>& state, int action, double reward,
     const std::vector<double>& nextState, bool done)
 {
-    _buffer.push(state, action, reward, nextState, done);
-    if (!_buffer.ready(_batchSize))
+    _checkAction(action, "Dqn::learn");
+
+    const size_t first = _memory.nextSlot();
+    if (_nStep > 1) {
+        using ConstMap = Eigen::Map<const Eigen::VectorXd>;
+        const auto dim = [](const std::vector<double>& v) {
+            return static_cast<Eigen::Index>(v.size());
+        };
+        const size_t pushed = _nstepFor(1).push(0, ConstMap(state.data(), dim(state)), action,
+            reward, ConstMap(nextState.data(), dim(nextState)), done, _memory);
+        _addPriorities(first, pushed);
+    } else {
+        _memory.push(state, action, reward, nextState, done);
+        _addPriorities(first, 1);
+    }
+    return _memory.ready(_batchSize) ? _update() : 0.0;
+}
+
+// ── Vectorized environments ───────────────────────────────────────────────────
+
+void Dqn::selectActions(
+    const Eigen::Ref<const Eigen::MatrixXd>& states, double epsilon, std::vector<int>& actions)
+{
+    if (states.rows() != static_cast<Eigen::Index>(_memory.stateDim()))
+        throw std::invalid_argument("Dqn::selectActions: state size does not match input layer");
+
+    const auto n = static_cast<size_t>(states.cols());
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(_numActions) - 1);
+
+    // -1 marks a greedy choice, resolved below by one forward pass.
+    actions.resize(n);
+    bool anyGreedy = false;
+    for (auto& a : actions) {
+        a = coin(_rng) < epsilon ? pick(_rng) : -1;
+        anyGreedy = anyGreedy || a < 0;
+    }
+    if (!anyGreedy)
+        return;
+
+    _qNet->feedForwardBatch(states, _actOut);
+    for (size_t j = 0; j < n; ++j)
+        if (actions[j] < 0)
+            actions[j] = static_cast<int>(_greedy(_actOut, static_cast<Eigen::Index>(j)));
+}
+
+double Dqn::learnBatch(const Eigen::Ref<const Eigen::MatrixXd>& states,
+    const std::vector<int>& actions, const Eigen::Ref<const Eigen::VectorXd>& rewards,
+    const Eigen::Ref<const Eigen::MatrixXd>& nextStates, const std::vector<uint8_t>& done,
+    size_t updates)
+{
+    for (const int a : actions)
+        _checkAction(a, "Dqn::learnBatch");
+
+    const size_t first = _memory.nextSlot();
+    if (_nStep > 1) {
+        // One accumulator stream per column (environment).
+        const auto n = static_cast<size_t>(states.cols());
+        if (states.rows() != static_cast<Eigen::Index>(_memory.stateDim())
+            || nextStates.rows() != states.rows() || nextStates.cols() != states.cols()
+            || actions.size() != n || static_cast<size_t>(rewards.size()) != n
+            || done.size() != n)
+            throw std::invalid_argument("Dqn::learnBatch: transition sizes do not match");
+
+        auto& acc = _nstepFor(n);
+        size_t pushed = 0;
+        for (size_t j = 0; j < n; ++j) {
+            const auto c = static_cast<Eigen::Index>(j);
+            pushed += acc.push(j, states.col(c), actions[j], rewards(c), nextStates.col(c),
+                done[j] != 0, _memory);
+        }
+        _addPriorities(first, pushed);
+    } else {
+        _memory.pushBatch(states, actions, rewards, nextStates, done);
+        _addPriorities(first, actions.size());
+    }
+
+    if (!_memory.ready(_batchSize) || updates == 0)
         return 0.0;
+    double loss = 0.0;
+    for (size_t u = 0; u < updates; ++u)
+        loss += _update();
+    return loss / static_cast<double>(updates);
+}
 
-    ++_learnStep;
-    const double loss = _trainBatch();
+// ── Prioritized replay ────────────────────────────────────────────────────────
 
-    if (_learnStep % _targetUpdateFreq == 0)
-        _syncTarget();
+void Dqn::setPrioritizedReplay(double alpha, double beta0, size_t betaSteps, double epsilon)
+{
+    if (!(beta0 >= 0.0 && beta0 <= 1.0))
+        throw std::invalid_argument("Dqn::setPrioritizedReplay: beta0 must be in [0, 1]");
+    _per = std::make_unique<PrioritizedSampler>(_memory.capacity(), alpha, epsilon);
+    for (size_t i = 0; i < _memory.size(); ++i)
+        _per->add(i);
+    _beta0 = beta0;
+    _betaSteps = std::max<size_t>(betaSteps, 1);
+}
 
-    return loss;
+// ── Target network ────────────────────────────────────────────────────────────
+
+void Dqn::setSoftTargetUpdate(double tau)
+{
+    if (!(tau >= 0.0 && tau <= 1.0))
+        throw std::invalid_argument("Dqn::setSoftTargetUpdate: tau must be in [0, 1]");
+    _tau = tau;
+}
+
+// ── Extensions ────────────────────────────────────────────────────────────────
+
+void Dqn::setNStep(size_t n)
+{
+    if (n == 0)
+        throw std::invalid_argument("Dqn::setNStep: n must be > 0");
+    _nStep = n;
+    _gammaN = std::pow(_gamma, static_cast<double>(n));
+    _nstep.reset();
+}
+
+void Dqn::setHuberLoss(double delta)
+{
+    if (delta < 0.0)
+        throw std::invalid_argument("Dqn::setHuberLoss: delta must be >= 0");
+    _huberDelta = delta;
+}
+
+void Dqn::setDueling(bool enable)
+{
+    if (enable == _dueling)
+        return;
+    _dueling = enable;
+    _buildNets();
 }
 
 // ── Q-values ──────────────────────────────────────────────────────────────────
@@ -72,51 +209,153 @@ std::vector<double> Dqn::qValues(const std::vector<double>& state)
     _qNet->feedForward();
     std::vector<double> out;
     _qNet->copyOutputVector(out);
+    if (!_dueling)
+        return out;
+
+    // Q(a) = V + A(a) - mean(A), shifted down over the V slot.
+    const Eigen::Map<Eigen::VectorXd> o(out.data(), static_cast<Eigen::Index>(out.size()));
+    const double shift = o(0) - o.tail(static_cast<Eigen::Index>(_numActions)).mean();
+    for (size_t a = 0; a < _numActions; ++a)
+        out[a] = out[a + 1] + shift;
+    out.pop_back();
     return out;
 }
 
 // ── Private ───────────────────────────────────────────────────────────────────
 
-void Dqn::_syncTarget()
+void Dqn::_checkAction(int action, const char* caller) const
 {
-    for (size_t i = 0; i < _qNet->numLayers(); ++i) {
-        _targetNet->setLayerW(i, _qNet->getLayerW(i));
-        _targetNet->setLayerB(i, _qNet->getLayerB(i));
-    }
+    if (action < 0 || static_cast<size_t>(action) >= _numActions)
+        throw std::out_of_range(std::string(caller) + ": action out of range");
 }
 
-double Dqn::_trainBatch()
+double Dqn::_qAt(const Eigen::MatrixXd& out, Eigen::Index a, Eigen::Index j) const
 {
-    const auto batch = _buffer.sample(_batchSize, _rng);
+    if (!_dueling)
+        return out(a, j);
+    const auto adv = out.col(j).tail(static_cast<Eigen::Index>(_numActions));
+    return out(0, j) + adv(a) - adv.mean();
+}
 
-    std::vector<std::vector<double>> states, targets;
-    states.reserve(_batchSize);
-    targets.reserve(_batchSize);
-    double loss = 0.0;
+// V and mean(A) are shared by every action, so the argmax is that of A.
+Eigen::Index Dqn::_greedy(const Eigen::MatrixXd& out, Eigen::Index j) const
+{
+    Eigen::Index best = 0;
+    out.col(j).tail(static_cast<Eigen::Index>(_numActions)).maxCoeff(&best);
+    return best;
+}
 
-    for (const auto& tr : batch) {
-        // Current Q from main network — used as baseline for non-taken actions.
-        auto q = qValues(tr.s);
+void Dqn::_buildNets()
+{
+    auto layers = _netLayers;
+    if (_dueling)
+        layers.back().size += 1;
+    _qNet = std::make_unique<MlpMatrixNN>(layers, _lr);
+    _targetNet = std::make_unique<MlpMatrixNN>(layers, _lr);
+    _syncTarget();
+}
 
-        // Max Q for s' from frozen target network.
-        _targetNet->setInputVector(tr.s_next);
-        _targetNet->feedForward();
-        std::vector<double> q_next;
-        _targetNet->copyOutputVector(q_next);
-        const double max_q_next = tr.done ? 0.0 : *std::max_element(q_next.begin(), q_next.end());
+void Dqn::_addPriorities(size_t first, size_t count)
+{
+    if (_per)
+        for (size_t j = 0; j < count; ++j)
+            _per->add((first + j) % _memory.capacity());
+}
 
-        const double bellman = tr.r + _gamma * max_q_next;
-        const double err = q[tr.a] - bellman;
-        loss += err * err;
+// The accumulator is rebuilt when the number of streams changes (learn()
+// feeds one stream, learnBatch() one per environment).
+NStepAccumulator& Dqn::_nstepFor(size_t streams)
+{
+    if (!_nstep || _nstep->streams() != streams)
+        _nstep = std::make_unique<NStepAccumulator>(_nStep, _gamma, _memory.stateDim(), streams);
+    return *_nstep;
+}
+
+// One gradient step on a sampled batch, then the soft or periodic target sync.
+double Dqn::_update()
+{
+    ++_learnStep;
+    const double loss = _trainBatch();
+    if (_tau > 0.0)
+        _targetNet->blendParameters(*_qNet, _tau);
+    else if (_learnStep % _targetUpdateFreq == 0)
+        _syncTarget();
+    return loss;
+}
 
-        // Only the taken action gets a non-zero gradient.
-        q[tr.a] = bellman;
+void Dqn::_syncTarget() { _targetNet->copyParameters(*_qNet); }
+
+double Dqn::_trainBatch()
+{
+    const auto B = static_cast<Eigen::Index>(_batchSize);
+
+    const ReplayMemory::Batch* sampled = nullptr;
+    if (_per) {
+        const double progress = std::min(1.0, double(_learnStep) / double(_betaSteps));
+        const double beta = _beta0 + (1.0 - _beta0) * progress;
+        _per->sample(_batchSize, beta, _rng, _perSlots, _perWeights);
+        sampled = &_memory.gather(_perSlots);
+    } else {
+        sampled = &_memory.sample(_batchSize, _rng);
+    }
+    const auto& batch = *sampled;
+    const auto A = static_cast<Eigen::Index>(_numActions);
+
+    // Online outputs for s (and, for Double DQN, s' in the same pass), and
+    // target-network outputs for s', all evaluated into member buffers.
+    if (_doubleDqn) {
+        _stacked.resize(batch.states.rows(), 2 * B);
+        _stacked.leftCols(B) = batch.states;
+        _stacked.rightCols(B) = batch.nextStates;
+        _qNet->feedForwardBatch(_stacked, _onlineOut);
+        _batchTargets = _onlineOut.leftCols(B);
+    } else {
+        _qNet->feedForwardBatch(batch.states, _batchTargets);
+    }
+    _targetNet->feedForwardBatch(batch.nextStates, _targetOut);
+
+    // dLoss/dQ is zero for the non-taken actions. The output delta is
+    // (target - output), so the gradient is applied as output + step: the
+    // (clipped) TD error, scaled by the importance-sampling weight.
+    _tdErrors.resize(B);
+    _qGrad.setZero(A, B);
+    double loss = 0.0;
+    for (Eigen::Index j = 0; j < B; ++j) {
+        const auto k = static_cast<size_t>(j);
+        // Value of s' from the frozen target network: at its own argmax, or
+        // at the online network's one (Double DQN).
+        const Eigen::Index next = _doubleDqn ? _greedy(_onlineOut, B + j) : _greedy(_targetOut, j);
+        const double vNext = _qAt(_targetOut, next, j);
+        const double bellman = batch.rewards(j) + (batch.done[k] ? 0.0 : _gammaN * vNext);
+        const double td = bellman - _qAt(_batchTargets, batch.actions[k], j);
+        _tdErrors(j) = td;
+
+        double step = td;
+        if (_huberDelta > 0.0) {
+            const double abs = std::abs(td);
+            if (abs > _huberDelta) {
+                step = std::copysign(_huberDelta, td);
+                loss += _huberDelta * (abs - 0.5 * _huberDelta);
+            } else {
+                loss += 0.5 * td * td;
+            }
+        } else {
+            loss += td * td;
+        }
+        _qGrad(batch.actions[k], j) = _per ? _perWeights(j) * step : step;
+    }
 
-        states.push_back(tr.s);
-        targets.push_back(std::move(q));
+    if (_dueling) {
+        // Q(a) = V + A(a) - mean(A): dV = sum_a dQ(a), dA(a) = dQ(a) - mean(dQ).
+        _batchTargets.row(0) += _qGrad.colwise().sum();
+        _batchTargets.bottomRows(A) += _qGrad.rowwise() - _qGrad.colwise().mean();
+    } else {
+        _batchTargets += _qGrad;
     }
 
-    _qNet->trainBatch(states, targets);
+    _qNet->trainBatch(batch.states, _batchTargets);
+    if (_per)
+        _per->update(batch.slots, _tdErrors);
     return loss / static_cast<double>(_batchSize);
 }
 
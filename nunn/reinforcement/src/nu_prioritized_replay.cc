@@ -0,0 +1,123 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_prioritized_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace nu {
+
+// ── SumTree ───────────────────────────────────────────────────────────────────
+
+SumTree::SumTree(size_t capacity)
+    : _capacity(capacity)
+    , _leaves(1)
+{
+    if (capacity == 0)
+        throw std::invalid_argument("SumTree: capacity must be > 0");
+    while (_leaves < capacity)
+        _leaves <<= 1;
+    _sum.assign(2 * _leaves, 0.0);
+    _min.assign(2 * _leaves, std::numeric_limits<double>::infinity());
+}
+
+void SumTree::set(size_t i, double value)
+{
+    if (i >= _capacity)
+        throw std::out_of_range("SumTree::set: index out of range");
+    if (!(value >= 0.0))
+        throw std::invalid_argument("SumTree::set: value must be >= 0");
+
+    size_t node = _leaves + i;
+    _sum[node] = value;
+    _min[node] = value > 0.0 ? value : std::numeric_limits<double>::infinity();
+    for (node >>= 1; node >= 1; node >>= 1) {
+        _sum[node] = _sum[2 * node] + _sum[2 * node + 1];
+        _min[node] = std::min(_min[2 * node], _min[2 * node + 1]);
+    }
+}
+
+size_t SumTree::find(double u) const noexcept
+{
+    u = std::clamp(u, 0.0, _sum[1]);
+    size_t node = 1;
+    while (node < _leaves) {
+        const size_t left = 2 * node;
+        // Rounding can leave u at or past the sum of the right subtree; never
+        // descend into an empty subtree.
+        if ((u < _sum[left] && _sum[left] > 0.0) || _sum[left + 1] <= 0.0) {
+            node = left;
+        } else {
+            u -= _sum[left];
+            node = left + 1;
+        }
+    }
+    return node - _leaves;
+}
+
+// ── PrioritizedSampler ────────────────────────────────────────────────────────
+
+PrioritizedSampler::PrioritizedSampler(size_t capacity, double alpha, double epsilon)
+    : _tree(capacity)
+    , _alpha(alpha)
+    , _epsilon(epsilon)
+{
+    if (!(alpha >= 0.0) || !(epsilon > 0.0))
+        throw std::invalid_argument("PrioritizedSampler: alpha must be >= 0 and epsilon > 0");
+}
+
+void PrioritizedSampler::add(size_t slot)
+{
+    if (slot < _tree.capacity() && _tree.get(slot) == 0.0)
+        ++_size;
+    _tree.set(slot, std::pow(_maxPriority, _alpha));
+}
+
+void PrioritizedSampler::sample(size_t batchSize, double beta, std::mt19937& rng,
+    std::vector<size_t>& slots, Eigen::VectorXd& weights) const
+{
+    const double total = _tree.total();
+    if (_size == 0 || !(total > 0.0))
+        throw std::invalid_argument("PrioritizedSampler::sample: no slot has been added");
+
+    slots.resize(batchSize);
+    weights.resize(static_cast<Eigen::Index>(batchSize));
+
+    // (N P_min)^-beta is the largest weight any slot can get.
+    const double n = static_cast<double>(_size);
+    const double maxWeight = std::pow(n * _tree.minPositive() / total, -beta);
+
+    const double segment = total / static_cast<double>(batchSize);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (size_t j = 0; j < batchSize; ++j) {
+        const size_t slot = _tree.find((static_cast<double>(j) + unit(rng)) * segment);
+        slots[j] = slot;
+        weights(static_cast<Eigen::Index>(j))
+            = std::pow(n * _tree.get(slot) / total, -beta) / maxWeight;
+    }
+}
+
+void PrioritizedSampler::update(
+    const std::vector<size_t>& slots, const Eigen::Ref<const Eigen::VectorXd>& tdErrors)
+{
+    if (static_cast<Eigen::Index>(slots.size()) != tdErrors.size())
+        throw std::invalid_argument("PrioritizedSampler::update: slots/tdErrors size mismatch");
+
+    for (size_t j = 0; j < slots.size(); ++j) {
+        const double p = std::abs(tdErrors(static_cast<Eigen::Index>(j))) + _epsilon;
+        _maxPriority = std::max(_maxPriority, p);
+        if (slots[j] < _tree.capacity() && _tree.get(slots[j]) == 0.0)
+            ++_size;
+        _tree.set(slots[j], std::pow(p, _alpha));
+    }
+}
+
+} // namespace nu
@@ -8,6 +8,8 @@
 
 #include "nu_qlgraph.h"
 
+#include <algorithm>
+
 namespace nu {
 
 QLGraph::QLGraph(const size_t& n_of_states, const size_t& goal_state, const Topology& topology)
@@ -26,6 +28,8 @@ QLGraph::QLGraph(const size_t& n_of_states, const size_t& goal_state, const Topo
             _rewardMtx[state.first][destination] = destination == _goalState ? REWARD : NO_REWARD;
         }
     }
+
+    _buildValidActions();
 }
 
 bool QLGraph::learn(const size_t& nOfEpisodes, const Helper& helper)
@@ -48,7 +52,7 @@ bool QLGraph::learn(const size_t& nOfEpisodes, const Helper& helper)
                 return false;
             }
 
-            auto validActions = retrieveValidActions(_rewardMtx, _curState);
+            const auto& validActions = _validActions[_curState];
             const auto nOfActions = validActions.size();
 
             auto nextState = validActions[size_t(helper.rnd() * double(nOfActions)) % nOfActions];
@@ -75,20 +79,122 @@ bool QLGraph::learn(const size_t& nOfEpisodes, const Helper& helper)
     return true;
 }
 
+bool QLGraph::learn(
+    const size_t& nOfEpisodes, const ParallelLearnConfig& cfg, const Helper& helper)
+{
+    const size_t threads = resolveThreads(cfg.threads, nOfEpisodes);
+    const bool hogwild = cfg.update == ParallelUpdate::Hogwild;
+
+    // Deltas: the table at the start of the round and one copy per worker.
+    QMatrix base = hogwild ? QMatrix(size_t(0)) : _q_mtx;
+    std::vector<QMatrix> local(hogwild ? 0 : threads, _q_mtx);
+
+    const auto beginRound = [&](size_t first, size_t) {
+        helper.beginEpisode(first, *this);
+        return !helper.quitRequestPending();
+    };
+
+    const auto runRange = [&](size_t b, size_t e, size_t tid, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        for (size_t episode = b; episode < e; ++episode) {
+            if (hogwild)
+                _runEpisode<true>(_q_mtx, rng, cfg.maxSteps);
+            else
+                _runEpisode<false>(local[tid], rng, cfg.maxSteps);
+        }
+    };
+
+    const auto endRound = [&](size_t first, size_t count) {
+        if (!hogwild) {
+            std::vector<const double*> copies;
+            for (const auto& q : local)
+                copies.push_back(q.data());
+            mergeDeltas(_q_mtx.data(), copies, base.data(), _nOfStates * _nOfStates);
+            base = _q_mtx;
+            for (auto& q : local)
+                q = _q_mtx;
+        }
+        helper.endEpisode(first + count - 1, *this);
+        return !helper.quitRequestPending();
+    };
+
+    if (!runEpisodeRounds(nOfEpisodes, cfg, threads, beginRound, runRange, endRound))
+        return false;
+
+    _q_mtx.normalize();
+
+    return true;
+}
+
+template <bool Shared>
+void QLGraph::_runEpisode(QMatrix& q, std::mt19937& rng, size_t maxSteps) const
+{
+    std::uniform_real_distribution<double> rnd(0.0, 1.0);
+
+    auto curState = size_t(rnd(rng) * double(_nOfStates)) % _nOfStates;
+
+    bool goal = false;
+
+    for (size_t step = 0; !goal && (maxSteps == 0 || step < maxSteps); ++step) {
+        const auto& validActions = _validActions[curState];
+        const auto nOfActions = validActions.size();
+
+        const auto nextState = validActions[size_t(rnd(rng) * double(nOfActions)) % nOfActions];
+
+        goal = _goalState == curState;
+
+        auto& qsa = q[curState][nextState];
+        const auto rsa = _rewardMtx[curState][nextState];
+
+        if constexpr (Shared) {
+            double* row = q.data() + nextState * _nOfStates;
+            double max = loadShared(row[0]);
+            for (size_t i = 1; i < _nOfStates; ++i)
+                max = std::max(max, loadShared(row[i]));
+
+            const double old = loadShared(qsa);
+            storeShared(qsa, old + _learningRate * (rsa + _discountRate * max - old));
+        } else {
+            qsa += _learningRate * (rsa + _discountRate * q.max(nextState) - qsa);
+        }
+
+        curState = nextState;
+    }
+}
+
+size_t QLGraph::valueIteration(double tolerance, size_t maxSweeps)
+{
+    size_t sweeps = 0;
+
+    while (sweeps < maxSweeps) {
+        ++sweeps;
+        if (_q_mtx.bellmanSweep(_rewardMtx, _discountRate) <= tolerance)
+            break;
+    }
+
+    _q_mtx.normalize();
+
+    return sweeps;
+}
+
+void QLGraph::_buildValidActions()
+{
+    _validActions.resize(_nOfStates);
+    for (size_t state = 0; state < _nOfStates; ++state)
+        _validActions[state] = retrieveValidActions(_rewardMtx, state);
+}
+
 QLGraph::valid_actions_t QLGraph::retrieveValidActions(const QMatrix& r, size_t state)
 {
     assert(state < r.size());
 
     valid_actions_t va;
-    const auto& actions = r[state].to_stdvec();
-
-    size_t idx = 0;
+    const auto actions = r[state];
 
-    for (const auto& action : actions) {
-        if (action >= 0) {
-            va.push_back(idx);
+    for (Eigen::Index idx = 0; idx < actions.size(); ++idx) {
+        if (actions[idx] >= 0) {
+            va.push_back(static_cast<size_t>(idx));
         }
-        ++idx;
     }
 
     return va;
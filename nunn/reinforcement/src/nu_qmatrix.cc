@@ -10,32 +10,34 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <exception>
 #include <vector>
 
 namespace nu {
 
-QMatrix::QMatrix(size_t n_of_states)
+QMatrix::QMatrix(const data_t& m)
+    : _m(m.size(), m.size())
 {
-    _data.resize(n_of_states);
-    for (auto& row : _data) {
-        row.resize(n_of_states);
+    for (size_t rowidx = 0; rowidx < m.size(); ++rowidx) {
+        if (m[rowidx].size() != m.size())
+            throw std::invalid_argument("QMatrix: rows must have size() entries");
+        for (size_t colidx = 0; colidx < m.size(); ++colidx)
+            _m(rowidx, colidx) = m[rowidx][colidx];
     }
 }
 
-void QMatrix::fill(const double& value) noexcept
+QMatrix::QMatrix(size_t n_of_states)
+    : _m(Eigen::MatrixXd::Zero(n_of_states, n_of_states))
 {
-    for (auto& row : data()) {
-        std::fill(row.begin(), row.end(), value);
-    }
 }
 
+void QMatrix::fill(const double& value) noexcept { _m.setConstant(value); }
+
 double QMatrix::max(size_t rowidx) const
 {
-    size_t maxidx = 0;
-    double maxvalue = 0;
-    _max(rowidx, maxidx, maxvalue);
-    return maxvalue;
+    _checkRow(rowidx);
+    return _m.row(rowidx).maxCoeff();
 }
 
 size_t QMatrix::maxarg(size_t rowidx) const
@@ -46,70 +48,104 @@ size_t QMatrix::maxarg(size_t rowidx) const
     return maxidx;
 }
 
-void QMatrix::normalize()
+Eigen::VectorXd QMatrix::maxAll() const
 {
-    double globalMax = std::numeric_limits<double>::lowest();
+    if (size() == 0)
+        return Eigen::VectorXd();
+    return _m.rowwise().maxCoeff();
+}
 
-    for (const auto& row : _data) {
-        auto rowMax = *std::max_element(row.cbegin(), row.cend());
-        globalMax = std::max(globalMax, rowMax);
+double QMatrix::bellmanSweep(const QMatrix& reward, double discount)
+{
+    if (reward.size() != size())
+        throw std::invalid_argument("QMatrix::bellmanSweep: reward matrix size mismatch");
+
+    const Eigen::VectorXd v = maxAll();
+    const Eigen::Index n = _m.rows();
+    double change = 0;
+
+    // One fused pass over both buffers: the loop is branch-free, so the
+    // compiler vectorises it.
+    const double* r = reward.data();
+    const double* vv = v.data();
+    double* q = _m.data();
+    const size_t cols = size();
+
+    for (Eigen::Index rowidx = 0; rowidx < n; ++rowidx) {
+        for (size_t colidx = 0; colidx < cols; ++colidx) {
+            const double old = q[colidx];
+            const double updated = r[colidx] >= 0 ? r[colidx] + discount * vv[colidx] : old;
+            change = std::max(change, std::abs(updated - old));
+            q[colidx] = updated;
+        }
+        q += cols;
+        r += cols;
     }
 
+    return change;
+}
+
+void QMatrix::normalize()
+{
+    if (size() == 0)
+        return;
+
+    const double globalMax = _m.maxCoeff();
+
     if (globalMax != 0) {
-        double scaleFactor = 100.0 / globalMax;
-        for (auto& row : _data) {
-            std::transform(row.begin(), row.end(), row.begin(),
-                [scaleFactor](double val) { return val * scaleFactor; });
-        }
+        _m *= 100.0 / globalMax;
     }
 }
 
-
-QMatrix::vect_t& QMatrix::operator[](const size_t& rowidx)
+QMatrix::Row QMatrix::operator[](const size_t& rowidx)
 {
     if (rowidx >= size()) {
         assert(0);
         throw InvalidIndexException();
     }
 
-    return data()[rowidx];
+    return Row(_m.data() + rowidx * size(), _m.cols());
 }
 
-const QMatrix::vect_t& QMatrix::operator[](const size_t& rowidx) const
+QMatrix::ConstRow QMatrix::operator[](const size_t& rowidx) const
 {
     if (rowidx >= size()) {
         assert(0);
         throw InvalidIndexException();
     }
 
-    return data()[rowidx];
+    return ConstRow(_m.data() + rowidx * size(), _m.cols());
 }
 
 void QMatrix::show(std::ostream& os, size_t width) const
 {
-    if (data().empty())
+    if (size() == 0)
         return;
 
     for (size_t rowidx = 0; rowidx < size(); ++rowidx) {
         for (size_t colidx = 0; colidx < size(); ++colidx) {
             os.width(width);
-            os << data()[rowidx][colidx] << " ";
+            os << _m(rowidx, colidx) << " ";
         }
         os << std::endl;
     }
 }
 
-void QMatrix::_max(size_t rowidx, size_t& maxIdx, double& maxValue) const
+void QMatrix::_checkRow(size_t rowidx) const
 {
     if (rowidx >= size()) {
         throw InvalidIndexException();
     }
+}
 
-    const auto& row = _data[rowidx];
-    auto maxElementIter = std::max_element(row.cbegin(), row.cend());
+void QMatrix::_max(size_t rowidx, size_t& maxIdx, double& maxValue) const
+{
+    _checkRow(rowidx);
 
-    maxValue = *maxElementIter;
-    maxIdx = static_cast<size_t>(std::distance(row.cbegin(), maxElementIter));
+    // Vectorised max, then the first column holding it (as std::max_element).
+    const double* row = _m.data() + rowidx * size();
+    maxValue = _m.row(rowidx).maxCoeff();
+    maxIdx = static_cast<size_t>(std::find(row, row + size(), maxValue) - row);
 }
 
 }
@@ -0,0 +1,210 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_replay_memory.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace nu {
+
+// ── Construction ──────────────────────────────────────────────────────────────
+
+ReplayMemory::ReplayMemory(size_t capacity, size_t stateDim)
+    : _capacity(capacity)
+    , _stateDim(stateDim)
+{
+    if (capacity == 0 || stateDim == 0)
+        throw std::invalid_argument("ReplayMemory: capacity and stateDim must be > 0");
+
+    const auto rows = static_cast<Eigen::Index>(stateDim);
+    const auto cols = static_cast<Eigen::Index>(capacity);
+    _s.resize(rows, cols);
+    _sNext.resize(rows, cols);
+    _a.resize(capacity);
+    _r.resize(capacity);
+    _done.resize(capacity);
+    _mark.assign(capacity, 0);
+}
+
+// ── Push ──────────────────────────────────────────────────────────────────────
+
+void ReplayMemory::push(const std::vector<double>& s, int a, double r,
+    const std::vector<double>& sNext, bool done)
+{
+    const auto n = static_cast<Eigen::Index>(_stateDim);
+    if (s.size() != _stateDim || sNext.size() != _stateDim)
+        throw std::invalid_argument("ReplayMemory::push: state size does not match stateDim");
+    push(Eigen::Map<const Eigen::VectorXd>(s.data(), n), a, r,
+        Eigen::Map<const Eigen::VectorXd>(sNext.data(), n), done);
+}
+
+void ReplayMemory::push(const Eigen::Ref<const Eigen::VectorXd>& s, int a, double r,
+    const Eigen::Ref<const Eigen::VectorXd>& sNext, bool done)
+{
+    const auto n = static_cast<Eigen::Index>(_stateDim);
+    if (s.size() != n || sNext.size() != n)
+        throw std::invalid_argument("ReplayMemory::push: state size does not match stateDim");
+
+    const auto slot = static_cast<Eigen::Index>(_next);
+    _s.col(slot) = s;
+    _sNext.col(slot) = sNext;
+    _a[_next] = a;
+    _r[_next] = r;
+    _done[_next] = done ? 1 : 0;
+
+    _next = (_next + 1) % _capacity;
+    if (_size < _capacity)
+        ++_size;
+}
+
+void ReplayMemory::pushBatch(const Eigen::Ref<const Eigen::MatrixXd>& states,
+    const std::vector<int>& actions, const Eigen::Ref<const Eigen::VectorXd>& rewards,
+    const Eigen::Ref<const Eigen::MatrixXd>& nextStates, const std::vector<uint8_t>& done)
+{
+    const Eigen::Index n = states.cols();
+    const auto count = static_cast<size_t>(n);
+    if (states.rows() != static_cast<Eigen::Index>(_stateDim) || nextStates.rows() != states.rows()
+        || nextStates.cols() != n || rewards.size() != n || actions.size() != count
+        || done.size() != count)
+        throw std::invalid_argument("ReplayMemory::pushBatch: size mismatch");
+    if (count > _capacity)
+        throw std::invalid_argument("ReplayMemory::pushBatch: more transitions than capacity");
+
+    // At most two runs: [_next, capacity) and, on wrap-around, [0, rest).
+    Eigen::Index src = 0;
+    while (src < n) {
+        const auto room = static_cast<Eigen::Index>(_capacity - _next);
+        const Eigen::Index len = std::min(n - src, room);
+        const auto dst = static_cast<Eigen::Index>(_next);
+        _s.middleCols(dst, len) = states.middleCols(src, len);
+        _sNext.middleCols(dst, len) = nextStates.middleCols(src, len);
+        for (Eigen::Index j = 0; j < len; ++j) {
+            const auto k = static_cast<size_t>(src + j);
+            _a[_next + static_cast<size_t>(j)] = actions[k];
+            _r[_next + static_cast<size_t>(j)] = rewards(src + j);
+            _done[_next + static_cast<size_t>(j)] = done[k] ? 1 : 0;
+        }
+        src += len;
+        _next = (_next + static_cast<size_t>(len)) % _capacity;
+    }
+    _size = std::min(_capacity, _size + count);
+}
+
+// ── Sampling ──────────────────────────────────────────────────────────────────
+
+const ReplayMemory::Batch& ReplayMemory::sample(size_t batchSize, std::mt19937& rng)
+{
+    if (batchSize == 0 || batchSize > _size)
+        throw std::invalid_argument("ReplayMemory::sample: not enough transitions");
+    sampleDistinct(_size, batchSize, rng, _batch.slots, _mark);
+    return gather(_batch.slots);
+}
+
+const ReplayMemory::Batch& ReplayMemory::gather(const std::vector<size_t>& slots)
+{
+    const auto B = static_cast<Eigen::Index>(slots.size());
+    const auto n = static_cast<Eigen::Index>(_stateDim);
+
+    _batch.states.resize(n, B);
+    _batch.nextStates.resize(n, B);
+    _batch.actions.resize(slots.size());
+    _batch.rewards.resize(B);
+    _batch.done.resize(slots.size());
+
+    for (Eigen::Index j = 0; j < B; ++j) {
+        const size_t i = slots[static_cast<size_t>(j)];
+        if (i >= _size)
+            throw std::out_of_range("ReplayMemory::gather: slot out of range");
+        const auto col = static_cast<Eigen::Index>(i);
+        _batch.states.col(j) = _s.col(col);
+        _batch.nextStates.col(j) = _sNext.col(col);
+        _batch.actions[static_cast<size_t>(j)] = _a[i];
+        _batch.rewards(j) = _r[i];
+        _batch.done[static_cast<size_t>(j)] = _done[i];
+    }
+    _batch.slots = slots; // no-op when called from sample()
+    return _batch;
+}
+
+// ── NStepAccumulator ──────────────────────────────────────────────────────────
+
+NStepAccumulator::NStepAccumulator(size_t n, double gamma, size_t stateDim, size_t streams)
+    : _n(n)
+    , _gamma(gamma)
+{
+    if (n == 0 || stateDim == 0 || streams == 0)
+        throw std::invalid_argument("NStepAccumulator: n, stateDim and streams must be > 0");
+
+    _streams.resize(streams);
+    for (auto& st : _streams) {
+        st.states.resize(static_cast<Eigen::Index>(stateDim), static_cast<Eigen::Index>(n));
+        st.actions.resize(n);
+        st.rewards.resize(n);
+        st.lastNext.resize(static_cast<Eigen::Index>(stateDim));
+    }
+}
+
+size_t NStepAccumulator::push(size_t stream, const Eigen::Ref<const Eigen::VectorXd>& s, int a,
+    double r, const Eigen::Ref<const Eigen::VectorXd>& sNext, bool done, ReplayMemory& memory)
+{
+    if (stream >= _streams.size())
+        throw std::out_of_range("NStepAccumulator::push: stream out of range");
+    auto& st = _streams[stream];
+    if (s.size() != st.lastNext.size() || sNext.size() != st.lastNext.size())
+        throw std::invalid_argument("NStepAccumulator::push: state size does not match stateDim");
+
+    if (st.count > 0 && s != st.lastNext)
+        st.count = 0; // new episode: the open windows cannot be completed
+
+    const size_t tail = (st.head + st.count) % _n;
+    st.states.col(static_cast<Eigen::Index>(tail)) = s;
+    st.actions[tail] = a;
+    st.rewards[tail] = r;
+    st.lastNext = sNext;
+    ++st.count;
+
+    size_t pushed = 0;
+    if (done) {
+        for (size_t i = 0; i < st.count; ++i) {
+            const size_t k = (st.head + i) % _n;
+            memory.push(st.states.col(static_cast<Eigen::Index>(k)), st.actions[k],
+                _return(st, i), sNext, true);
+        }
+        pushed = st.count;
+        st.count = 0;
+    } else if (st.count == _n) {
+        memory.push(st.states.col(static_cast<Eigen::Index>(st.head)), st.actions[st.head],
+            _return(st, 0), sNext, false);
+        pushed = 1;
+        st.head = (st.head + 1) % _n;
+        --st.count;
+    }
+    if (st.count == 0)
+        st.head = 0;
+    return pushed;
+}
+
+void NStepAccumulator::clear() noexcept
+{
+    for (auto& st : _streams)
+        st.head = st.count = 0;
+}
+
+double NStepAccumulator::_return(const Stream& st, size_t offset) const noexcept
+{
+    double ret = 0.0;
+    double discount = 1.0;
+    for (size_t i = offset; i < st.count; ++i) {
+        ret += discount * st.rewards[(st.head + i) % _n];
+        discount *= _gamma;
+    }
+    return ret;
+}
+
+} // namespace nu
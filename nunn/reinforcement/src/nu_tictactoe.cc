@@ -0,0 +1,108 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_tictactoe.h"
+
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+// Piece index 0 is X, 1 is O.
+constexpr nu::ZobristKeys<9, 2> keys;
+
+// Rows, columns and diagonals.
+constexpr std::uint16_t lines[] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054 };
+
+void checkCell(int cell)
+{
+    if (cell < 0 || cell >= 9)
+        throw std::out_of_range("TicTacToe: cell out of range");
+}
+
+} // anonymous namespace
+
+namespace nu {
+
+TicTacToe::TicTacToe(Symbol first) { setTurn(first); }
+
+TicTacToe::Symbol TicTacToe::at(int cell) const
+{
+    checkCell(cell);
+    const auto bit = static_cast<std::uint16_t>(1u << cell);
+    return (_x & bit) ? X : (_o & bit) ? O : Empty;
+}
+
+void TicTacToe::set(int cell, Symbol s)
+{
+    const Symbol old = at(cell);
+    if (old != Empty)
+        _toggle(cell, old);
+    if (s != Empty)
+        _toggle(cell, s);
+}
+
+void TicTacToe::setTurn(Symbol s)
+{
+    if (s == Empty)
+        throw std::invalid_argument("TicTacToe: the side to move must be X or O");
+    if ((s == O) != (_turn == O))
+        _hash ^= keys.side();
+    _turn = s;
+}
+
+void TicTacToe::play(int cell)
+{
+    checkCell(cell);
+    if (((_x | _o) >> cell) & 1u)
+        throw std::invalid_argument("TicTacToe::play: cell is taken");
+    if (over())
+        throw std::invalid_argument("TicTacToe::play: the game is over");
+
+    _toggle(cell, _turn);
+    _turn = _turn == X ? O : X;
+    _hash ^= keys.side();
+}
+
+double TicTacToe::result() const noexcept
+{
+    const Symbol w = winner();
+    if (w == Empty)
+        return 0.0;
+    const double score = 0.5 + 0.1 * std::popcount(_free());
+    return w == _turn ? score : -score;
+}
+
+void TicTacToe::encode(Eigen::Ref<Eigen::VectorXd> input) const
+{
+    if (input.size() != static_cast<Eigen::Index>(inputSize))
+        throw std::invalid_argument("TicTacToe::encode: input must have 10 entries");
+    for (int cell = 0; cell < 9; ++cell)
+        input(cell) = ((_x >> cell) & 1u) ? 0.5 : ((_o >> cell) & 1u) ? 1.0 : 0.0;
+    input(9) = _turn == O ? 1.0 : 0.5;
+}
+
+bool TicTacToe::_wins(std::uint16_t m) noexcept
+{
+    for (const auto line : lines)
+        if ((m & line) == line)
+            return true;
+    return false;
+}
+
+void TicTacToe::_toggle(int cell, Symbol s) noexcept
+{
+    const auto bit = static_cast<std::uint16_t>(1u << cell);
+    if (s == X)
+        _x ^= bit;
+    else
+        _o ^= bit;
+    _hash ^= keys.piece(static_cast<size_t>(cell), s == X ? 0 : 1);
+}
+
+} // namespace nu
@@ -74,7 +74,7 @@ TEST(AutoencoderTest, ReshuffleWeightsDoesNotCrash)
     EXPECT_EQ(ae.reconstruct(x).size(), 4u);
 }
 
-// ── encode + decode matches reconstruct after sync ───────────────────────────
+// ── encode + decode matches reconstruct ──────────────────────────────────────
 
 TEST(AutoencoderTest, EncodeDecodeMimicsReconstruct)
 {
@@ -85,7 +85,7 @@ TEST(AutoencoderTest, EncodeDecodeMimicsReconstruct)
         = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
     ae.train(ds, 50);
 
-    // After train(), decoder is synced: encode+decode should equal reconstruct
+    // Encoder and decoder share the trained weights: encode+decode == reconstruct
     const std::vector<double> x = ds[0];
     const auto z = ae.encode(x);
     const auto dec = ae.decode(z);
@@ -149,3 +149,65 @@ TEST(AutoencoderTest, TrainingReducesMSEOnSineData)
     }
     EXPECT_LT(bestRatio, 0.70);
 }
+
+// ── Batched interface ─────────────────────────────────────────────────────────
+
+static Eigen::MatrixXd sineBatch(size_t n, int count)
+{
+    Eigen::MatrixXd X(static_cast<Eigen::Index>(n), count);
+    for (int p = 0; p < count; ++p)
+        for (size_t t = 0; t < n; ++t)
+            X(static_cast<Eigen::Index>(t), p)
+                = 0.5 + 0.5 * std::sin(2.0 * M_PI * double(t) / double(n) + p * 0.3);
+    return X;
+}
+
+TEST(AutoencoderTest, BatchMatchesPerSample)
+{
+    nu::Autoencoder ae(8, { 6, 3 }, nu::Activation::Tanh, 0.01);
+    const Eigen::MatrixXd X = sineBatch(8, 5);
+
+    const Eigen::MatrixXd Z = ae.encodeBatch(X);
+    const Eigen::MatrixXd D = ae.decodeBatch(Z);
+    const Eigen::MatrixXd R = ae.reconstructBatch(X);
+    const Eigen::VectorXd err = ae.reconstructionErrors(X);
+    ASSERT_EQ(Z.rows(), 3);
+    ASSERT_EQ(err.size(), 5);
+
+    for (Eigen::Index j = 0; j < X.cols(); ++j) {
+        const std::vector<double> x(X.col(j).data(), X.col(j).data() + 8);
+        const auto z = ae.encode(x);
+        const auto r = ae.reconstruct(x);
+        for (Eigen::Index k = 0; k < 3; ++k)
+            EXPECT_NEAR(z[size_t(k)], Z(k, j), 1e-12);
+        for (Eigen::Index i = 0; i < 8; ++i) {
+            EXPECT_NEAR(r[size_t(i)], R(i, j), 1e-12);
+            EXPECT_NEAR(r[size_t(i)], D(i, j), 1e-12);
+        }
+        EXPECT_NEAR(ae.reconstructionMSE(x), err(j), 1e-12);
+    }
+}
+
+TEST(AutoencoderTest, BatchSizeMismatchThrows)
+{
+    nu::Autoencoder ae(8, { 3 });
+    EXPECT_THROW(ae.encodeBatch(Eigen::MatrixXd::Zero(7, 2)), std::invalid_argument);
+    EXPECT_THROW(ae.decodeBatch(Eigen::MatrixXd::Zero(2, 2)), std::invalid_argument);
+    EXPECT_THROW(ae.train(Eigen::MatrixXd::Zero(7, 2), 1), std::invalid_argument);
+    EXPECT_THROW(ae.train(Eigen::MatrixXd::Zero(8, 2), 1, 0), std::invalid_argument);
+}
+
+TEST(AutoencoderTest, MiniBatchTrainingReducesMSE)
+{
+    const Eigen::MatrixXd X = sineBatch(8, 64);
+
+    double bestRatio = 1.0;
+    for (int trial = 0; trial < 5; ++trial) {
+        nu::Autoencoder ae(8, { 4, 2 }, nu::Activation::Tanh, 0.05);
+        const double mseBefore = ae.reconstructionErrors(X).mean();
+        ae.train(X, 500, 8);
+        const double mseAfter = ae.reconstructionErrors(X).mean();
+        bestRatio = std::min(bestRatio, mseAfter / mseBefore);
+    }
+    EXPECT_LT(bestRatio, 0.70);
+}
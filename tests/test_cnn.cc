@@ -57,6 +57,102 @@ TEST(Conv1DLayerTest, ForwardBackwardDoesNotCrash)
     EXPECT_EQ(gradIn.size(), 8u);
 }
 
+TEST(Conv1DLayerTest, AutoAlgorithmBySize)
+{
+    // inCh*K = 5 → Direct; inCh*K = 4*3 = 12 → Im2Col
+    EXPECT_EQ(nu::Conv1DLayer(1, 16, 8, 5).getAlgorithm(), nu::ConvAlgorithm::Direct);
+    EXPECT_EQ(nu::Conv1DLayer(4, 16, 8, 3).getAlgorithm(), nu::ConvAlgorithm::Im2Col);
+}
+
+TEST(Conv1DLayerTest, Im2ColMatchesDirect)
+{
+    nu::Conv1DLayer a(3, 12, 4, 3, nu::Activation::Tanh, 0.1, nu::ConvAlgorithm::Im2Col);
+    nu::Conv1DLayer b(3, 12, 4, 3, nu::Activation::Tanh, 0.1, nu::ConvAlgorithm::Direct);
+    b.setWeights(a.getWeights());
+    b.setBias(a.getBias());
+
+    std::vector<double> in(3 * 12), grad(4 * 10);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = std::sin(0.7 * static_cast<double>(i));
+    for (size_t i = 0; i < grad.size(); ++i)
+        grad[i] = std::cos(0.3 * static_cast<double>(i));
+
+    const auto outA = a.forward(in);
+    const auto outB = b.forward(in);
+    for (size_t i = 0; i < outA.size(); ++i)
+        EXPECT_NEAR(outA[i], outB[i], 1e-12);
+
+    const auto gA = a.backward(grad, 0.1);
+    const auto gB = b.backward(grad, 0.1);
+    for (size_t i = 0; i < gA.size(); ++i)
+        EXPECT_NEAR(gA[i], gB[i], 1e-12);
+    EXPECT_TRUE(a.getWeights().isApprox(b.getWeights(), 1e-12));
+    EXPECT_TRUE(a.getBias().isApprox(b.getBias(), 1e-12));
+}
+
+TEST(Conv1DLayerTest, BatchMatchesPerSample)
+{
+    for (auto algo : { nu::ConvAlgorithm::Im2Col, nu::ConvAlgorithm::Direct }) {
+        nu::Conv1DLayer layer(2, 9, 3, 4, nu::Activation::Tanh, 0.1, algo);
+        const Eigen::MatrixXd X = Eigen::MatrixXd::Random(2 * 9, 5);
+        const Eigen::MatrixXd G = Eigen::MatrixXd::Random(3 * 6, 5);
+
+        // Per-sample reference with a negligible learning rate (weights stay fixed).
+        std::vector<std::vector<double>> refOut, refGrad;
+        for (Eigen::Index n = 0; n < X.cols(); ++n) {
+            std::vector<double> x(X.col(n).data(), X.col(n).data() + X.rows());
+            std::vector<double> g(G.col(n).data(), G.col(n).data() + G.rows());
+            refOut.push_back(layer.forward(x));
+            refGrad.push_back(layer.backward(g, 1e-300));
+        }
+
+        const Eigen::MatrixXd Y = layer.forwardBatch(X);
+        const Eigen::MatrixXd dX = layer.backwardBatch(G, 1e-300);
+        ASSERT_EQ(Y.rows(), 3 * 6);
+        ASSERT_EQ(dX.rows(), 2 * 9);
+        for (Eigen::Index n = 0; n < X.cols(); ++n) {
+            for (Eigen::Index i = 0; i < Y.rows(); ++i)
+                EXPECT_NEAR(Y(i, n), refOut[static_cast<size_t>(n)][static_cast<size_t>(i)], 1e-12);
+            for (Eigen::Index i = 0; i < dX.rows(); ++i)
+                EXPECT_NEAR(
+                    dX(i, n), refGrad[static_cast<size_t>(n)][static_cast<size_t>(i)], 1e-12);
+        }
+    }
+}
+
+TEST(Conv1DLayerTest, InputGradientMatchesNumeric)
+{
+    // Linear activation: L = Σ g ⊙ y, so dL/dx is exactly what backward() returns.
+    nu::Conv1DLayer layer(2, 7, 3, 3, nu::Activation::Linear, 0.1, nu::ConvAlgorithm::Im2Col);
+    std::vector<double> in(2 * 7), g(3 * 5);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = 0.1 * static_cast<double>(i) - 0.5;
+    for (size_t i = 0; i < g.size(); ++i)
+        g[i] = std::sin(static_cast<double>(i));
+
+    auto loss = [&](const std::vector<double>& x) {
+        const auto& y = layer.forward(x);
+        double l = 0.0;
+        for (size_t i = 0; i < y.size(); ++i)
+            l += g[i] * y[i];
+        return l;
+    };
+
+    std::vector<double> numeric(in.size());
+    constexpr double h = 1e-6;
+    for (size_t i = 0; i < in.size(); ++i) {
+        auto xp = in, xm = in;
+        xp[i] += h;
+        xm[i] -= h;
+        numeric[i] = (loss(xp) - loss(xm)) / (2.0 * h);
+    }
+
+    layer.forward(in);
+    const auto analytic = layer.backward(g, 1e-300);
+    for (size_t i = 0; i < in.size(); ++i)
+        EXPECT_NEAR(analytic[i], numeric[i], 1e-6);
+}
+
 // ── MaxPool1DLayer ────────────────────────────────────────────────────────────
 
 TEST(MaxPool1DLayerTest, OutputSize)
@@ -94,6 +190,182 @@ TEST(MaxPool1DLayerTest, BackwardRoutesGradient)
     EXPECT_DOUBLE_EQ(gradIn[3], 0.0); // pos 3 was not max
 }
 
+TEST(MaxPool1DLayerTest, BatchMatchesPerSample)
+{
+    nu::MaxPool1DLayer layer(2, 6, 3);
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(12, 3);
+    const Eigen::MatrixXd G = Eigen::MatrixXd::Random(4, 3);
+    const Eigen::MatrixXd Y = layer.forwardBatch(X);
+    const Eigen::MatrixXd dX = layer.backwardBatch(G, 0.0);
+    for (Eigen::Index n = 0; n < X.cols(); ++n) {
+        const auto& y = layer.forward(std::vector<double>(X.col(n).data(), X.col(n).data() + 12));
+        const auto& g
+            = layer.backward(std::vector<double>(G.col(n).data(), G.col(n).data() + 4), 0.0);
+        for (Eigen::Index i = 0; i < 4; ++i)
+            EXPECT_DOUBLE_EQ(Y(i, n), y[static_cast<size_t>(i)]);
+        for (Eigen::Index i = 0; i < 12; ++i)
+            EXPECT_DOUBLE_EQ(dX(i, n), g[static_cast<size_t>(i)]);
+    }
+}
+
+// ── Conv2DLayer ───────────────────────────────────────────────────────────────
+
+TEST(Conv2DLayerTest, OutputSize)
+{
+    // 2 × 6 × 5 input, 3 filters of 3 × 2 → 3 × 4 × 4
+    nu::Conv2DLayer layer(2, 6, 5, 3, 3, 2);
+    EXPECT_EQ(layer.outChannels(), 3u);
+    EXPECT_EQ(layer.outHeight(), 4u);
+    EXPECT_EQ(layer.outWidth(), 4u);
+    EXPECT_EQ(layer.outLength(), 16u);
+    EXPECT_EQ(layer.outputSize(), 48u);
+}
+
+TEST(Conv2DLayerTest, BadDimensionThrows)
+{
+    EXPECT_THROW(nu::Conv2DLayer(0, 6, 6, 2, 3, 3), std::invalid_argument);
+    EXPECT_THROW(nu::Conv2DLayer(1, 2, 6, 2, 3, 3), std::invalid_argument); // inH < kH
+    EXPECT_THROW(nu::Conv2DLayer(1, 6, 6, 2, 3, 3).setWeights(Eigen::MatrixXd::Zero(2, 8)),
+        std::invalid_argument);
+}
+
+TEST(Conv2DLayerTest, ForwardMatchesNaiveConvolution)
+{
+    constexpr size_t C = 2, H = 5, W = 6, F = 3, KH = 2, KW = 3, OH = 4, OW = 4;
+    nu::Conv2DLayer layer(C, H, W, F, KH, KW, nu::Activation::Linear);
+    std::vector<double> in(C * H * W);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = std::sin(0.37 * static_cast<double>(i));
+
+    const auto& out = layer.forward(in);
+    ASSERT_EQ(out.size(), F * OH * OW);
+    const auto& Wt = layer.getWeights();
+    for (size_t f = 0; f < F; ++f) {
+        for (size_t oh = 0; oh < OH; ++oh) {
+            for (size_t ow = 0; ow < OW; ++ow) {
+                double y = layer.getBias()(static_cast<Eigen::Index>(f));
+                for (size_t c = 0; c < C; ++c)
+                    for (size_t i = 0; i < KH; ++i)
+                        for (size_t j = 0; j < KW; ++j)
+                            y += Wt(static_cast<Eigen::Index>(f),
+                                     static_cast<Eigen::Index>((c * KH + i) * KW + j))
+                                * in[c * H * W + (oh + i) * W + ow + j];
+                EXPECT_NEAR(out[(f * OH + oh) * OW + ow], y, 1e-12);
+            }
+        }
+    }
+}
+
+TEST(Conv2DLayerTest, InputGradientMatchesNumeric)
+{
+    nu::Conv2DLayer layer(2, 5, 4, 3, 3, 2, nu::Activation::Linear, 0.1);
+    std::vector<double> in(2 * 5 * 4), g(3 * 3 * 3);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = 0.05 * static_cast<double>(i) - 0.5;
+    for (size_t i = 0; i < g.size(); ++i)
+        g[i] = std::sin(static_cast<double>(i));
+
+    auto loss = [&](const std::vector<double>& x) {
+        const auto& y = layer.forward(x);
+        double l = 0.0;
+        for (size_t i = 0; i < y.size(); ++i)
+            l += g[i] * y[i];
+        return l;
+    };
+
+    std::vector<double> numeric(in.size());
+    constexpr double h = 1e-6;
+    for (size_t i = 0; i < in.size(); ++i) {
+        auto xp = in, xm = in;
+        xp[i] += h;
+        xm[i] -= h;
+        numeric[i] = (loss(xp) - loss(xm)) / (2.0 * h);
+    }
+
+    layer.forward(in);
+    const auto analytic = layer.backward(g, 1e-300);
+    for (size_t i = 0; i < in.size(); ++i)
+        EXPECT_NEAR(analytic[i], numeric[i], 1e-6);
+}
+
+TEST(Conv2DLayerTest, BatchMatchesPerSample)
+{
+    nu::Conv2DLayer layer(2, 6, 5, 3, 3, 3, nu::Activation::Tanh, 0.1);
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(2 * 6 * 5, 4);
+    const Eigen::MatrixXd G = Eigen::MatrixXd::Random(3 * 4 * 3, 4);
+
+    std::vector<std::vector<double>> refOut, refGrad;
+    for (Eigen::Index n = 0; n < X.cols(); ++n) {
+        std::vector<double> x(X.col(n).data(), X.col(n).data() + X.rows());
+        std::vector<double> g(G.col(n).data(), G.col(n).data() + G.rows());
+        refOut.push_back(layer.forward(x));
+        refGrad.push_back(layer.backward(g, 1e-300));
+    }
+
+    const Eigen::MatrixXd Y = layer.forwardBatch(X);
+    const Eigen::MatrixXd dX = layer.backwardBatch(G, 1e-300);
+    ASSERT_EQ(Y.rows(), G.rows());
+    ASSERT_EQ(dX.rows(), X.rows());
+    for (Eigen::Index n = 0; n < X.cols(); ++n) {
+        for (Eigen::Index i = 0; i < Y.rows(); ++i)
+            EXPECT_NEAR(Y(i, n), refOut[static_cast<size_t>(n)][static_cast<size_t>(i)], 1e-12);
+        for (Eigen::Index i = 0; i < dX.rows(); ++i)
+            EXPECT_NEAR(dX(i, n), refGrad[static_cast<size_t>(n)][static_cast<size_t>(i)], 1e-12);
+    }
+}
+
+// ── MaxPool2DLayer ────────────────────────────────────────────────────────────
+
+TEST(MaxPool2DLayerTest, SelectsMaxAndRoutesGradient)
+{
+    // 1 channel, 4 × 5, pool 2 × 2 → 2 × 2 (last column discarded)
+    nu::MaxPool2DLayer layer(1, 4, 5, 2, 2);
+    EXPECT_EQ(layer.outHeight(), 2u);
+    EXPECT_EQ(layer.outWidth(), 2u);
+    // clang-format off
+    const std::vector<double> in{
+        1, 2, 0, 0, 9,
+        3, 4, 5, 1, 9,
+        0, 7, 1, 1, 9,
+        6, 0, 1, 8, 9 };
+    // clang-format on
+    const auto out = layer.forward(in);
+    ASSERT_EQ(out.size(), 4u);
+    EXPECT_DOUBLE_EQ(out[0], 4.0);
+    EXPECT_DOUBLE_EQ(out[1], 5.0);
+    EXPECT_DOUBLE_EQ(out[2], 7.0);
+    EXPECT_DOUBLE_EQ(out[3], 8.0);
+
+    const auto& gradIn = layer.backward({ 0.1, 0.2, 0.3, 0.4 }, 0.0);
+    ASSERT_EQ(gradIn.size(), in.size());
+    EXPECT_DOUBLE_EQ(gradIn[6], 0.1);
+    EXPECT_DOUBLE_EQ(gradIn[7], 0.2);
+    EXPECT_DOUBLE_EQ(gradIn[11], 0.3);
+    EXPECT_DOUBLE_EQ(gradIn[18], 0.4);
+    double sum = 0.0;
+    for (double g : gradIn)
+        sum += g;
+    EXPECT_NEAR(sum, 1.0, 1e-12);
+}
+
+TEST(MaxPool2DLayerTest, BatchMatchesPerSample)
+{
+    nu::MaxPool2DLayer layer(2, 4, 6, 2, 3);
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(48, 3);
+    const Eigen::MatrixXd G = Eigen::MatrixXd::Random(8, 3);
+    const Eigen::MatrixXd Y = layer.forwardBatch(X);
+    const Eigen::MatrixXd dX = layer.backwardBatch(G, 0.0);
+    for (Eigen::Index n = 0; n < X.cols(); ++n) {
+        const auto& y = layer.forward(std::vector<double>(X.col(n).data(), X.col(n).data() + 48));
+        const auto& g
+            = layer.backward(std::vector<double>(G.col(n).data(), G.col(n).data() + 8), 0.0);
+        for (Eigen::Index i = 0; i < 8; ++i)
+            EXPECT_DOUBLE_EQ(Y(i, n), y[static_cast<size_t>(i)]);
+        for (Eigen::Index i = 0; i < 48; ++i)
+            EXPECT_DOUBLE_EQ(dX(i, n), g[static_cast<size_t>(i)]);
+    }
+}
+
 // ── ConvNet ───────────────────────────────────────────────────────────────────
 
 TEST(ConvNetTest, FlatFeatureSize)
@@ -131,6 +403,32 @@ TEST(ConvNetTest, PredictOutputSize)
     EXPECT_EQ(out.size(), 2u);
 }
 
+TEST(ConvNetTest, TrainStepDescendsThroughConvLayers)
+{
+    // With the FC head frozen (lr = 0) only the conv layer moves, so the loss
+    // change between two train() calls on one sample is the conv step alone:
+    // a step against dL/dW lowers it, one along dL/dW raises it.
+    constexpr int T = 16;
+    std::vector<double> x(T);
+    for (int t = 0; t < T; ++t)
+        x[t] = std::sin(2.0 * M_PI * t / T) + 0.3 * std::cos(6.0 * M_PI * t / T);
+    const std::vector<double> target{ 1.0, 0.0, 0.5 };
+
+    for (int net = 0; net < 10; ++net) {
+        nu::ConvNet cnn(1, T);
+        cnn.addConv1D(4, 5, nu::Activation::Tanh, 1e-3);
+        cnn.addMaxPool1D(2);
+        cnn.setFCHead({ LC(cnn.flatFeatureSize()), LC(3, nu::Activation::Sigmoid) }, 0.0);
+
+        double prev = cnn.train(x, target); // loss before each step
+        for (int step = 0; step < 3; ++step) {
+            const double loss = cnn.train(x, target);
+            EXPECT_LT(loss, prev) << "net " << net << ", step " << step;
+            prev = loss;
+        }
+    }
+}
+
 TEST(ConvNetTest, TrainReducesLoss)
 {
     // Frequency-detection problem: class 0 = 1 cycle, class 1 = 2 cycles.
@@ -164,3 +462,119 @@ TEST(ConvNetTest, TrainReducesLoss)
 
     EXPECT_LT(lossF, loss0);
 }
+
+TEST(ConvNetTest, PredictBatchMatchesPredict)
+{
+    nu::ConvNet cnn(2, 12);
+    cnn.addConv1D(3, 3, nu::Activation::Tanh);
+    cnn.addMaxPool1D(2);
+    cnn.addConv1D(4, 2, nu::Activation::ReLU);
+    cnn.setFCHead(
+        { LC(cnn.flatFeatureSize()), LC(6, nu::Activation::Tanh), LC(2, nu::Activation::Sigmoid) });
+
+    std::vector<std::vector<double>> xs;
+    for (int n = 0; n < 4; ++n) {
+        std::vector<double> x(24);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = std::sin(0.3 * static_cast<double>(i) + n);
+        xs.push_back(x);
+    }
+    const auto batch = cnn.predictBatch(xs);
+    ASSERT_EQ(batch.size(), xs.size());
+    for (size_t n = 0; n < xs.size(); ++n) {
+        const auto single = cnn.predict(xs[n]);
+        ASSERT_EQ(batch[n].size(), single.size());
+        for (size_t i = 0; i < single.size(); ++i)
+            EXPECT_NEAR(batch[n][i], single[i], 1e-12);
+    }
+}
+
+TEST(ConvNetTest, TrainBatchBadInputThrows)
+{
+    nu::ConvNet cnn(1, 8);
+    cnn.addConv1D(2, 3);
+    EXPECT_THROW(cnn.trainBatch({ std::vector<double>(8) }, { { 1.0 } }), std::logic_error);
+    cnn.setFCHead({ LC(cnn.flatFeatureSize()), LC(1, nu::Activation::Sigmoid) });
+    EXPECT_THROW(cnn.trainBatch({}, {}), std::invalid_argument);
+    EXPECT_THROW(cnn.trainBatch({ std::vector<double>(7) }, { { 1.0 } }), std::invalid_argument);
+}
+
+TEST(ConvNetTest, TrainBatchReducesLoss)
+{
+    constexpr int T = 16;
+    std::vector<std::vector<double>> xs, ts;
+    for (int c = 1; c <= 2; ++c) {
+        for (int phase = 0; phase < 4; ++phase) {
+            std::vector<double> x(T);
+            for (int t = 0; t < T; ++t)
+                x[t] = std::sin(2.0 * M_PI * c * t / T + 0.2 * phase);
+            xs.push_back(x);
+            ts.push_back(
+                c == 1 ? std::vector<double>{ 1.0, 0.0 } : std::vector<double>{ 0.0, 1.0 });
+        }
+    }
+
+    nu::ConvNet cnn(1, T);
+    cnn.addConv1D(4, 5, nu::Activation::Tanh, 0.05);
+    cnn.addMaxPool1D(4);
+    cnn.setFCHead(
+        { LC(cnn.flatFeatureSize()), LC(8, nu::Activation::Tanh), LC(2, nu::Activation::Sigmoid) },
+        0.5);
+
+    const double loss0 = cnn.trainBatch(xs, ts);
+    double lossF = loss0;
+    for (int ep = 0; ep < 300; ++ep)
+        lossF = cnn.trainBatch(xs, ts);
+    EXPECT_LT(lossF, loss0);
+}
+
+TEST(ConvNetTest, Conv2DFlatFeatureSize)
+{
+    // 1 × 28 × 28 → Conv2D(8, 5×5) → 8 × 24 × 24 → MaxPool2D(2×2) → 8 × 12 × 12
+    nu::ConvNet cnn(1, 28, 28);
+    EXPECT_EQ(cnn.inputSize(), 784u);
+    cnn.addConv2D(8, 5, 5).addMaxPool2D(2, 2);
+    EXPECT_EQ(cnn.flatFeatureSize(), 8u * 12u * 12u);
+    cnn.addConv2D(16, 5, 5).addMaxPool2D(2, 2);
+    EXPECT_EQ(cnn.flatFeatureSize(), 16u * 4u * 4u);
+}
+
+TEST(ConvNetTest, Conv1DOn2DMapsThrows)
+{
+    nu::ConvNet cnn(1, 8, 8);
+    EXPECT_THROW(cnn.addConv1D(2, 3), std::logic_error);
+    EXPECT_THROW(cnn.addMaxPool1D(2), std::logic_error);
+}
+
+TEST(ConvNetTest, Conv2DTrainBatchLearnsStripes)
+{
+    // Horizontal vs vertical stripes on a 6 × 6 image.
+    constexpr size_t S = 6;
+    std::vector<std::vector<double>> xs, ts;
+    for (size_t phase = 0; phase < 2; ++phase) {
+        std::vector<double> h(S * S), v(S * S);
+        for (size_t r = 0; r < S; ++r)
+            for (size_t c = 0; c < S; ++c) {
+                h[r * S + c] = ((r + phase) % 2) ? 1.0 : -1.0;
+                v[r * S + c] = ((c + phase) % 2) ? 1.0 : -1.0;
+            }
+        xs.push_back(h);
+        ts.push_back({ 1.0, 0.0 });
+        xs.push_back(v);
+        ts.push_back({ 0.0, 1.0 });
+    }
+
+    nu::ConvNet cnn(1, S, S);
+    cnn.addConv2D(4, 3, 3, nu::Activation::Tanh, 0.05).addMaxPool2D(2, 2);
+    cnn.setFCHead({ LC(cnn.flatFeatureSize()), LC(2, nu::Activation::Sigmoid) }, 0.5);
+
+    const double loss0 = cnn.trainBatch(xs, ts);
+    double lossF = loss0;
+    for (int ep = 0; ep < 300; ++ep)
+        lossF = cnn.trainBatch(xs, ts);
+    EXPECT_LT(lossF, loss0);
+
+    const auto out = cnn.predictBatch(xs);
+    for (size_t n = 0; n < xs.size(); ++n)
+        EXPECT_EQ(out[n][0] > out[n][1], ts[n][0] > ts[n][1]);
+}
@@ -0,0 +1,85 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_counter_rng.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+// ── Philox known answers (Random123 kat_vectors) ──────────────────────────────
+
+TEST(CounterRngTest, PhiloxKnownAnswers)
+{
+    const auto a = nu::CounterRng(0, 0).block(0);
+    EXPECT_EQ(a[0], 0x6627e8d5u);
+    EXPECT_EQ(a[1], 0xe169c58du);
+    EXPECT_EQ(a[2], 0xbc57ac4cu);
+    EXPECT_EQ(a[3], 0x9b00dbd8u);
+
+    const auto b = nu::CounterRng(~0ull, ~0ull).block(~0ull);
+    EXPECT_EQ(b[0], 0x408f276du);
+    EXPECT_EQ(b[1], 0x41c83b0eu);
+    EXPECT_EQ(b[2], 0xa20bc7c6u);
+    EXPECT_EQ(b[3], 0x6d5451fdu);
+}
+
+// ── Positional access ─────────────────────────────────────────────────────────
+
+TEST(CounterRngTest, PositionalFillMatchesSequential)
+{
+    nu::CounterRng seq(11, 3);
+    std::vector<double> all(103), parts(103);
+    seq.uniform(all.data(), 60);
+    seq.uniform(all.data() + 60, 43);
+    EXPECT_EQ(seq.position(), 103u);
+
+    // Unaligned ranges, as filled by different threads.
+    const nu::CounterRng rng(11, 3);
+    rng.uniform(0, parts.data(), 7);
+    rng.uniform(7, parts.data() + 7, 50);
+    rng.uniform(57, parts.data() + 57, 46);
+    EXPECT_EQ(all, parts);
+
+    std::vector<double> n1(9), n2(9);
+    rng.normal(0, n1.data(), 9);
+    rng.normal(0, n2.data(), 3);
+    rng.normal(3, n2.data() + 3, 6);
+    EXPECT_EQ(n1, n2);
+}
+
+TEST(CounterRngTest, StreamsDiffer)
+{
+    std::vector<double> a(8), b(8);
+    nu::CounterRng(5, 0).uniform(0, a.data(), 8);
+    nu::CounterRng(5, 1).uniform(0, b.data(), 8);
+    EXPECT_NE(a, b);
+}
+
+// ── Distributions ─────────────────────────────────────────────────────────────
+
+TEST(CounterRngTest, UniformAndNormalMoments)
+{
+    nu::CounterRng rng(2024);
+    const size_t n = 200000;
+    std::vector<double> u(n), z(n);
+    rng.uniform(u.data(), n);
+    rng.normal(z.data(), n);
+
+    double su = 0.0, sz = 0.0, sz2 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_GT(u[i], 0.0);
+        ASSERT_LT(u[i], 1.0);
+        su += u[i];
+        sz += z[i];
+        sz2 += z[i] * z[i];
+    }
+    EXPECT_NEAR(su / n, 0.5, 0.005);
+    EXPECT_NEAR(sz / n, 0.0, 0.01);
+    EXPECT_NEAR(sz2 / n, 1.0, 0.01);
+}
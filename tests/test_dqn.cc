@@ -7,10 +7,14 @@
 //
 
 #include "nu_dqn.h"
+#include "nu_prioritized_replay.h"
 #include "nu_replay_buffer.h"
+#include "nu_replay_memory.h"
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cmath>
+#include <set>
 #include <vector>
 
 // ── ExperienceReplayBuffer ────────────────────────────────────────────────────
@@ -65,6 +69,214 @@ TEST(ReplayBufferTest, ReadyFlag)
     EXPECT_FALSE(buf.ready(2));
 }
 
+TEST(ReplayBufferTest, OverwritesOldestWhenFull)
+{
+    nu::ExperienceReplayBuffer<std::vector<double>, int> buf(4);
+    for (int i = 0; i < 10; ++i)
+        buf.push({ static_cast<double>(i) }, i, 0.0, { 0.0 }, false);
+    std::mt19937 rng(3);
+    std::set<int> actions;
+    for (const auto& tr : buf.sample(4, rng))
+        actions.insert(tr.a);
+    EXPECT_EQ(actions, (std::set<int>{ 6, 7, 8, 9 }));
+}
+
+TEST(ReplayBufferTest, SampleDistinctIsWithoutReplacement)
+{
+    std::mt19937 rng(5);
+    std::vector<size_t> out;
+    std::vector<uint8_t> mark(50, 0);
+    std::vector<int> hits(50, 0);
+    for (int trial = 0; trial < 2000; ++trial) {
+        nu::sampleDistinct(50, 10, rng, out, mark);
+        ASSERT_EQ(out.size(), 10u);
+        EXPECT_EQ(std::set<size_t>(out.begin(), out.end()).size(), 10u);
+        for (const size_t i : out)
+            ++hits[i];
+    }
+    EXPECT_EQ(std::count(mark.begin(), mark.end(), 0), 50);
+    // Each index is drawn with probability 10 / 50: 400 hits expected.
+    for (const int h : hits) {
+        EXPECT_GT(h, 300);
+        EXPECT_LT(h, 500);
+    }
+}
+
+// ── ReplayMemory ──────────────────────────────────────────────────────────────
+
+TEST(ReplayMemoryTest, InvalidSizesThrow)
+{
+    EXPECT_THROW(nu::ReplayMemory(0, 2), std::invalid_argument);
+    EXPECT_THROW(nu::ReplayMemory(10, 0), std::invalid_argument);
+
+    nu::ReplayMemory mem(10, 2);
+    EXPECT_THROW(mem.push({ 0.0 }, 0, 0.0, { 0.0, 0.0 }, false), std::invalid_argument);
+    EXPECT_THROW(mem.push({ 0.0, 0.0 }, 0, 0.0, { 0.0 }, false), std::invalid_argument);
+    mem.push({ 0.0, 0.0 }, 0, 0.0, { 0.0, 0.0 }, false);
+    std::mt19937 rng(0);
+    EXPECT_THROW(mem.sample(2, rng), std::invalid_argument);
+    EXPECT_THROW(mem.gather({ 1 }), std::out_of_range);
+}
+
+TEST(ReplayMemoryTest, BatchColumnsMatchStoredTransitions)
+{
+    nu::ReplayMemory mem(8, 3);
+    // Transition i: s = (i, 2i, 3i), s' = -s, a = i % 4, r = i / 10, done on odd i.
+    for (int i = 0; i < 13; ++i) {
+        const double d = i;
+        mem.push({ d, 2 * d, 3 * d }, i % 4, d / 10.0, { -d, -2 * d, -3 * d }, i % 2 == 1);
+    }
+    EXPECT_EQ(mem.size(), 8u);
+    EXPECT_EQ(mem.nextSlot(), 5u);
+
+    std::mt19937 rng(7);
+    const auto& b = mem.sample(8, rng);
+    ASSERT_EQ(b.states.rows(), 3);
+    ASSERT_EQ(b.states.cols(), 8);
+
+    std::set<int> seen;
+    for (Eigen::Index j = 0; j < 8; ++j) {
+        const int i = static_cast<int>(b.states(0, j));
+        seen.insert(i);
+        EXPECT_EQ(b.states(2, j), 3.0 * i);
+        EXPECT_EQ(b.nextStates(1, j), -2.0 * i);
+        EXPECT_EQ(b.actions[size_t(j)], i % 4);
+        EXPECT_DOUBLE_EQ(b.rewards(j), i / 10.0);
+        EXPECT_EQ(b.done[size_t(j)] != 0, i % 2 == 1);
+    }
+    // The five oldest transitions were overwritten.
+    EXPECT_EQ(seen, (std::set<int>{ 5, 6, 7, 8, 9, 10, 11, 12 }));
+}
+
+TEST(ReplayMemoryTest, SampleIsDistinct)
+{
+    nu::ReplayMemory mem(1000, 1);
+    for (int i = 0; i < 1000; ++i)
+        mem.push({ static_cast<double>(i) }, 0, 0.0, { 0.0 }, false);
+    std::mt19937 rng(11);
+    const auto& b = mem.sample(200, rng);
+    const std::set<double> values(b.states.data(), b.states.data() + b.states.size());
+    EXPECT_EQ(values.size(), 200u);
+    EXPECT_EQ(std::set<size_t>(b.slots.begin(), b.slots.end()).size(), 200u);
+}
+
+// ── NStepAccumulator ──────────────────────────────────────────────────────────
+
+TEST(NStepAccumulatorTest, EmitsWindowsFlushesOnDoneAndDropsCutEpisodes)
+{
+    EXPECT_THROW(nu::NStepAccumulator(0, 0.9, 1), std::invalid_argument);
+    EXPECT_THROW(nu::NStepAccumulator(2, 0.9, 1, 0), std::invalid_argument);
+
+    nu::ReplayMemory mem(10, 1);
+    nu::NStepAccumulator acc(2, 0.5, 1);
+    const auto v = [](double x) { return Eigen::VectorXd::Constant(1, x); };
+
+    EXPECT_EQ(acc.push(0, v(0), 0, 1.0, v(1), false, mem), 0u);
+    EXPECT_EQ(acc.push(0, v(1), 1, 2.0, v(2), false, mem), 1u); // (0, 0, 1 + 0.5 * 2, 2)
+    EXPECT_EQ(acc.push(0, v(2), 2, 4.0, v(3), true, mem), 2u); // (1, 1, 2 + 2, 3), (2, 2, 4, 3)
+    // A state that does not follow the last one drops the open window.
+    EXPECT_EQ(acc.push(0, v(5), 0, 8.0, v(6), false, mem), 0u);
+    EXPECT_EQ(acc.push(0, v(7), 1, 1.0, v(8), false, mem), 0u);
+    EXPECT_EQ(acc.push(0, v(8), 2, 1.0, v(9), false, mem), 1u); // (7, 1, 1.5, 9)
+    EXPECT_THROW(acc.push(1, v(0), 0, 0.0, v(0), false, mem), std::out_of_range);
+    EXPECT_THROW(acc.push(0, v(9), 0, 0.0, Eigen::VectorXd::Zero(2), false, mem),
+        std::invalid_argument);
+
+    ASSERT_EQ(mem.size(), 4u);
+    const auto& b = mem.gather({ 0, 1, 2, 3 });
+    EXPECT_EQ(b.states, (Eigen::RowVector4d(0, 1, 2, 7)).matrix());
+    EXPECT_EQ(b.nextStates, (Eigen::RowVector4d(2, 3, 3, 9)).matrix());
+    EXPECT_EQ(b.actions, (std::vector<int>{ 0, 1, 2, 1 }));
+    EXPECT_EQ(b.rewards, Eigen::Vector4d(2.0, 4.0, 4.0, 1.5));
+    EXPECT_EQ(b.done, (std::vector<uint8_t>{ 0, 1, 1, 0 }));
+}
+
+// ── Prioritized replay ────────────────────────────────────────────────────────
+
+TEST(SumTreeTest, TotalMinAndFind)
+{
+    nu::SumTree tree(5); // padded to 8 leaves
+    const double v[] = { 1.0, 0.0, 3.0, 0.5, 2.0 };
+    for (size_t i = 0; i < 5; ++i)
+        tree.set(i, v[i]);
+    EXPECT_DOUBLE_EQ(tree.total(), 6.5);
+    EXPECT_DOUBLE_EQ(tree.minPositive(), 0.5);
+
+    EXPECT_EQ(tree.find(0.0), 0u);
+    EXPECT_EQ(tree.find(0.99), 0u);
+    EXPECT_EQ(tree.find(1.0), 2u); // leaf 1 is empty
+    EXPECT_EQ(tree.find(3.99), 2u);
+    EXPECT_EQ(tree.find(4.2), 3u);
+    EXPECT_EQ(tree.find(4.5), 4u);
+    EXPECT_EQ(tree.find(6.5), 4u);
+    EXPECT_EQ(tree.find(100.0), 4u);
+
+    tree.set(3, 0.0);
+    EXPECT_DOUBLE_EQ(tree.total(), 6.0);
+    EXPECT_DOUBLE_EQ(tree.minPositive(), 1.0);
+
+    EXPECT_THROW(tree.set(5, 1.0), std::out_of_range);
+    EXPECT_THROW(tree.set(0, -1.0), std::invalid_argument);
+    EXPECT_THROW(nu::SumTree(0), std::invalid_argument);
+}
+
+TEST(PrioritizedSamplerTest, SamplesInProportionToPriority)
+{
+    nu::PrioritizedSampler per(4, 1.0, 1e-9);
+    for (size_t i = 0; i < 4; ++i)
+        per.add(i);
+    Eigen::VectorXd td(4);
+    td << 1.0, 2.0, 3.0, 4.0;
+    per.update({ 0, 1, 2, 3 }, td);
+
+    std::mt19937 rng(13);
+    std::vector<size_t> slots;
+    Eigen::VectorXd w;
+    std::vector<int> hits(4, 0);
+    for (int trial = 0; trial < 1000; ++trial) {
+        per.sample(10, 0.5, rng, slots, w);
+        for (const size_t i : slots)
+            ++hits[i];
+    }
+    // P(i) = (i + 1) / 10 over 10000 draws.
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_NEAR(hits[i], 1000.0 * double(i + 1), 150.0);
+
+    // w_i = (N P(i))^-beta / (N P_min)^-beta: 1 for slot 0, 4^-0.5 for slot 3.
+    per.sample(10, 0.5, rng, slots, w);
+    for (size_t j = 0; j < slots.size(); ++j)
+        EXPECT_NEAR(w(Eigen::Index(j)), std::pow(double(slots[j] + 1), -0.5), 1e-9);
+}
+
+TEST(PrioritizedSamplerTest, NewSlotsGetMaxPriority)
+{
+    nu::PrioritizedSampler per(8, 0.5, 1e-9);
+    EXPECT_EQ(per.size(), 0u);
+    per.add(0);
+    EXPECT_DOUBLE_EQ(per.priority(0), 1.0);
+
+    Eigen::VectorXd td(1);
+    td << 8.0;
+    per.update({ 0 }, td);
+    per.add(1);
+    EXPECT_EQ(per.size(), 2u);
+    EXPECT_NEAR(per.priority(1), std::sqrt(8.0), 1e-5);
+}
+
+TEST(PrioritizedSamplerTest, InvalidArgumentsThrow)
+{
+    EXPECT_THROW(nu::PrioritizedSampler(0), std::invalid_argument);
+    EXPECT_THROW(nu::PrioritizedSampler(4, -0.1), std::invalid_argument);
+    EXPECT_THROW(nu::PrioritizedSampler(4, 0.6, 0.0), std::invalid_argument);
+
+    nu::PrioritizedSampler per(4);
+    std::mt19937 rng(0);
+    std::vector<size_t> slots;
+    Eigen::VectorXd w;
+    EXPECT_THROW(per.sample(2, 0.4, rng, slots, w), std::invalid_argument);
+    EXPECT_THROW(per.update({ 0, 1 }, Eigen::VectorXd::Zero(1)), std::invalid_argument);
+}
+
 // ── Dqn construction ──────────────────────────────────────────────────────────
 
 static std::vector<nu::MlpMatrixNN::LayerConfig> makeLayers()
@@ -130,6 +342,135 @@ TEST(DqnTest, LearnStepCountIncrements)
     EXPECT_GT(dqn.getLearnStepCount(), 0u);
 }
 
+TEST(DqnTest, LearnRejectsInvalidTransition)
+{
+    nu::Dqn dqn(makeLayers(), 0.01, 200, 8, 0.99, 50);
+    EXPECT_THROW(dqn.learn({ 0.0 }, 0, 0.0, { 0.0, 0.0 }, false), std::invalid_argument);
+    EXPECT_THROW(dqn.learn({ 0.0, 0.0 }, 0, 0.0, { 0.0, 0.0, 0.0 }, false), std::invalid_argument);
+    EXPECT_THROW(dqn.learn({ 0.0, 0.0 }, 4, 0.0, { 0.0, 0.0 }, false), std::out_of_range);
+    EXPECT_THROW(dqn.learn({ 0.0, 0.0 }, -1, 0.0, { 0.0, 0.0 }, false), std::out_of_range);
+}
+
+// The first learn step samples the whole buffer (capacity == batchSize) and the
+// target network still equals the main one, so the returned loss must be the
+// mean squared TD error computed one transition at a time.
+TEST(DqnTest, BatchLossMatchesPerSampleTdError)
+{
+    const double gamma = 0.9;
+    nu::Dqn dqn(makeLayers(), 0.01, 4, 4, gamma, 50);
+
+    const std::vector<std::vector<double>> s{ { 0.1, -0.3 }, { 0.7, 0.2 }, { -0.5, 0.9 },
+        { 0.0, 0.4 } };
+    const std::vector<std::vector<double>> sn{ { 0.2, 0.5 }, { -0.1, -0.8 }, { 0.3, 0.3 },
+        { 0.6, -0.2 } };
+    const int a[] = { 0, 3, 1, 2 };
+    const double r[] = { 1.0, -0.5, 0.25, 2.0 };
+    const bool done[] = { false, true, false, false };
+
+    double expected = 0.0;
+    for (size_t i = 0; i < 4; ++i) {
+        const auto q = dqn.qValues(s[i]);
+        const auto qn = dqn.qValues(sn[i]);
+        const double maxQn = *std::max_element(qn.begin(), qn.end());
+        const double err = q[size_t(a[i])] - (r[i] + (done[i] ? 0.0 : gamma * maxQn));
+        expected += err * err / 4.0;
+    }
+
+    for (size_t i = 0; i < 3; ++i)
+        EXPECT_EQ(dqn.learn(s[i], a[i], r[i], sn[i], done[i]), 0.0);
+    EXPECT_NEAR(dqn.learn(s[3], a[3], r[3], sn[3], done[3]), expected, 1e-12);
+    EXPECT_EQ(dqn.getLearnStepCount(), 1u);
+}
+
+TEST(DqnTest, ExtensionSettersValidate)
+{
+    nu::Dqn dqn(makeLayers(), 0.01, 200, 16, 0.99, 50);
+    EXPECT_THROW(dqn.setNStep(0), std::invalid_argument);
+    EXPECT_THROW(dqn.setHuberLoss(-1.0), std::invalid_argument);
+
+    dqn.setDueling(true);
+    EXPECT_TRUE(dqn.dueling());
+    EXPECT_EQ(dqn.getNumActions(), 4u);
+    EXPECT_EQ(dqn.qValues({ 0.5, 0.5 }).size(), 4u);
+}
+
+// With tau == 1 a soft update copies the main network after every step, so the
+// second step bootstraps from the weights the first one produced.
+TEST(DqnTest, SoftTargetUpdateTracksMainNetwork)
+{
+    nu::Dqn dqn(makeLayers(), 0.05, 1, 1, 0.9, 1000);
+    EXPECT_THROW(dqn.setSoftTargetUpdate(-0.1), std::invalid_argument);
+    EXPECT_THROW(dqn.setSoftTargetUpdate(1.1), std::invalid_argument);
+    dqn.setSoftTargetUpdate(1.0);
+    EXPECT_EQ(dqn.softTargetTau(), 1.0);
+
+    const std::vector<double> s{ 0.1, -0.3 }, sn{ 0.7, 0.2 };
+    dqn.learn(s, 0, 1.0, sn, false);
+
+    const auto q = dqn.qValues(s);
+    const auto qn = dqn.qValues(sn);
+    const double err = q[1] - (0.5 + 0.9 * *std::max_element(qn.begin(), qn.end()));
+    EXPECT_NEAR(dqn.learn(s, 1, 0.5, sn, false), err * err, 1e-12);
+}
+
+// As BatchLossMatchesPerSampleTdError, for Double DQN with a Huber loss and a
+// dueling head. qValues() already combines V and A, and the online and target
+// networks are equal before the first step, so Double DQN picks the same
+// next action as the max.
+TEST(DqnTest, ExtendedBatchLossMatchesPerSampleTdError)
+{
+    const double gamma = 0.9;
+    const double delta = 0.5;
+    nu::Dqn dqn(makeLayers(), 0.01, 4, 4, gamma, 50);
+    dqn.setDoubleDqn(true);
+    dqn.setHuberLoss(delta);
+    dqn.setDueling(true);
+
+    const std::vector<std::vector<double>> s{ { 0.1, -0.3 }, { 0.7, 0.2 }, { -0.5, 0.9 },
+        { 0.0, 0.4 } };
+    const std::vector<std::vector<double>> sn{ { 0.2, 0.5 }, { -0.1, -0.8 }, { 0.3, 0.3 },
+        { 0.6, -0.2 } };
+    const int a[] = { 0, 3, 1, 2 };
+    const double r[] = { 1.0, -0.5, 0.25, 2.0 };
+    const bool done[] = { false, true, false, false };
+
+    double expected = 0.0;
+    for (size_t i = 0; i < 4; ++i) {
+        const auto q = dqn.qValues(s[i]);
+        const auto qn = dqn.qValues(sn[i]);
+        const double maxQn = *std::max_element(qn.begin(), qn.end());
+        const double err
+            = std::abs(q[size_t(a[i])] - (r[i] + (done[i] ? 0.0 : gamma * maxQn)));
+        expected += (err <= delta ? 0.5 * err * err : delta * (err - 0.5 * delta)) / 4.0;
+    }
+
+    for (size_t i = 0; i < 3; ++i)
+        EXPECT_EQ(dqn.learn(s[i], a[i], r[i], sn[i], done[i]), 0.0);
+    EXPECT_NEAR(dqn.learn(s[3], a[3], r[3], sn[3], done[3]), expected, 1e-12);
+}
+
+// With n = 2 the first transition waits for the second one; the stored
+// transition then bootstraps from the state two steps ahead with gamma^2.
+TEST(DqnTest, NStepLossBootstrapsFromNthState)
+{
+    const double gamma = 0.9;
+    nu::Dqn dqn(makeLayers(), 0.01, 1, 1, gamma, 50);
+    dqn.setNStep(2);
+    EXPECT_EQ(dqn.nStep(), 2u);
+
+    const std::vector<double> s0{ 0.1, -0.3 }, s1{ 0.7, 0.2 }, s2{ -0.5, 0.9 };
+    const auto q = dqn.qValues(s0);
+    const auto qn = dqn.qValues(s2);
+    const double bellman
+        = 1.0 + gamma * -0.5 + gamma * gamma * *std::max_element(qn.begin(), qn.end());
+    const double err = q[2] - bellman;
+
+    EXPECT_EQ(dqn.learn(s0, 2, 1.0, s1, false), 0.0);
+    EXPECT_EQ(dqn.getLearnStepCount(), 0u);
+    EXPECT_NEAR(dqn.learn(s1, 0, -0.5, s2, false), err * err, 1e-12);
+    EXPECT_EQ(dqn.getLearnStepCount(), 1u);
+}
+
 // ── Convergence: bandit problem ───────────────────────────────────────────────
 
 // State is always [0.5]; action 0 → reward 1.0 (good), action 1 → reward 0.0.
@@ -154,3 +495,52 @@ TEST(DqnTest, ConvergesOnBanditProblem)
 
     EXPECT_EQ(dqn.selectAction(s, 0.0), 0);
 }
+
+TEST(DqnTest, PrioritizedReplayConvergesOnBanditProblem)
+{
+    using LC = nu::MlpMatrixNN::LayerConfig;
+    const std::vector<nu::MlpMatrixNN::LayerConfig> layers{ LC(1), LC(16, nu::Activation::Tanh),
+        LC(2, nu::Activation::Linear) };
+    nu::Dqn dqn(layers, 0.01, 500, 32, 0.0, 1000);
+    EXPECT_THROW(dqn.setPrioritizedReplay(0.6, 1.5), std::invalid_argument);
+    EXPECT_FALSE(dqn.prioritizedReplay());
+
+    const std::vector<double> s{ 0.5 };
+    for (int step = 0; step < 50; ++step)
+        dqn.learn(s, step % 2, step % 2 == 0 ? 1.0 : 0.0, s, true);
+    dqn.setPrioritizedReplay(0.6, 0.4, 1000);
+    EXPECT_TRUE(dqn.prioritizedReplay());
+
+    for (int step = 0; step < 2000; ++step) {
+        const double eps = std::max(0.05, 1.0 - step / 1000.0);
+        const int a = dqn.selectAction(s, eps);
+        dqn.learn(s, a, a == 0 ? 1.0 : 0.0, s, true);
+    }
+
+    EXPECT_EQ(dqn.selectAction(s, 0.0), 0);
+    const auto q = dqn.qValues(s);
+    EXPECT_NEAR(q[0], 1.0, 0.1);
+}
+
+TEST(DqnTest, DuelingDoubleDqnConvergesOnBanditProblem)
+{
+    using LC = nu::MlpMatrixNN::LayerConfig;
+    const std::vector<nu::MlpMatrixNN::LayerConfig> layers{ LC(1), LC(16, nu::Activation::Tanh),
+        LC(2, nu::Activation::Linear) };
+    nu::Dqn dqn(layers, 0.01, 500, 32, 0.0, 1000);
+    dqn.setDoubleDqn(true);
+    dqn.setDueling(true);
+    dqn.setHuberLoss(1.0);
+
+    const std::vector<double> s{ 0.5 };
+    for (int step = 0; step < 2000; ++step) {
+        const double eps = std::max(0.05, 1.0 - step / 1000.0);
+        const int a = dqn.selectAction(s, eps);
+        dqn.learn(s, a, a == 0 ? 1.0 : 0.0, s, true);
+    }
+
+    EXPECT_EQ(dqn.selectAction(s, 0.0), 0);
+    const auto q = dqn.qValues(s);
+    EXPECT_NEAR(q[0], 1.0, 0.1);
+    EXPECT_NEAR(q[1], 0.0, 0.1);
+}
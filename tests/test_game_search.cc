@@ -0,0 +1,277 @@
+//
+// Unit tests for nu::TicTacToe (nu_tictactoe.h) and the searches of
+// nu_game_search.h.
+//
+
+#include "nu_game_search.h"
+#include "nu_mlpnn.h"
+#include "nu_tictactoe.h"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+
+using nu::TicTacToe;
+
+namespace {
+
+// Same score for every move; counts the positions it is asked about.
+struct UniformNet {
+    size_t calls = 0;
+    size_t positions = 0;
+
+    void operator()(const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& Y)
+    {
+        ++calls;
+        positions += static_cast<size_t>(X.cols());
+        Y = Eigen::MatrixXd::Constant(TicTacToe::numMoves, X.cols(), 0.5);
+    }
+};
+
+TicTacToe fromString(const char* cells, TicTacToe::Symbol turn)
+{
+    TicTacToe g;
+    for (int cell = 0; cell < 9; ++cell)
+        g.set(cell, cells[cell] == 'X' ? TicTacToe::X
+                : cells[cell] == 'O'   ? TicTacToe::O
+                                       : TicTacToe::Empty);
+    g.setTurn(turn);
+    return g;
+}
+
+} // anonymous namespace
+
+// ── TicTacToe ─────────────────────────────────────────────────────────────────
+
+TEST(TicTacToeTest, PlayUpdatesBoardTurnAndLegalMoves)
+{
+    TicTacToe g;
+    EXPECT_EQ(g.legalMoves(), 0x1FFu);
+
+    g.play(4);
+    EXPECT_EQ(g.at(4), TicTacToe::X);
+    EXPECT_EQ(g.turn(), TicTacToe::O);
+    EXPECT_EQ(g.legalMoves(), 0x1FFu & ~(1u << 4));
+
+    EXPECT_THROW(g.play(4), std::invalid_argument);
+    EXPECT_THROW(g.play(9), std::out_of_range);
+    EXPECT_THROW(g.at(-1), std::out_of_range);
+    EXPECT_THROW(TicTacToe(TicTacToe::Empty), std::invalid_argument);
+}
+
+TEST(TicTacToeTest, DetectsEveryWinningLine)
+{
+    const int lines[8][3] = { { 0, 1, 2 }, { 3, 4, 5 }, { 6, 7, 8 }, { 0, 3, 6 }, { 1, 4, 7 },
+        { 2, 5, 8 }, { 0, 4, 8 }, { 2, 4, 6 } };
+
+    for (const auto& line : lines) {
+        TicTacToe g;
+        for (const int cell : line)
+            g.set(cell, TicTacToe::O);
+        EXPECT_EQ(g.winner(), TicTacToe::O);
+        EXPECT_TRUE(g.over());
+        EXPECT_EQ(g.legalMoves(), 0u);
+        // X to move has lost with 6 free cells.
+        EXPECT_DOUBLE_EQ(g.result(), -(0.5 + 0.1 * 6));
+    }
+
+    const auto draw = fromString("XOXXOOOXX", TicTacToe::X);
+    EXPECT_EQ(draw.winner(), TicTacToe::Empty);
+    EXPECT_TRUE(draw.over());
+    EXPECT_DOUBLE_EQ(draw.result(), 0.0);
+}
+
+TEST(TicTacToeTest, IncrementalHashMatchesSetUpPosition)
+{
+    TicTacToe played;
+    for (const int cell : { 4, 0, 8, 2 })
+        played.play(cell);
+
+    const auto setUp = fromString("O.O.X...X", TicTacToe::X);
+    EXPECT_TRUE(played == setUp);
+    EXPECT_EQ(played.hash(), setUp.hash());
+
+    // Same cells, other side to move.
+    auto other = setUp;
+    other.setTurn(TicTacToe::O);
+    EXPECT_NE(other.hash(), setUp.hash());
+
+    // Clearing every cell returns to the empty board's key.
+    for (int cell = 0; cell < 9; ++cell)
+        other.set(cell, TicTacToe::Empty);
+    EXPECT_EQ(other.hash(), TicTacToe(TicTacToe::O).hash());
+}
+
+TEST(TicTacToeTest, EncodeMatchesExampleInputLayout)
+{
+    const auto g = fromString("X.O......", TicTacToe::O);
+    Eigen::VectorXd in(TicTacToe::inputSize);
+    g.encode(in);
+
+    EXPECT_DOUBLE_EQ(in(0), 0.5);
+    EXPECT_DOUBLE_EQ(in(1), 0.0);
+    EXPECT_DOUBLE_EQ(in(2), 1.0);
+    EXPECT_DOUBLE_EQ(in(9), 1.0);
+
+    Eigen::VectorXd wrong(9);
+    EXPECT_THROW(g.encode(wrong), std::invalid_argument);
+}
+
+// ── TranspositionTable ────────────────────────────────────────────────────────
+
+TEST(TranspositionTableTest, FindReplaceAndStatistics)
+{
+    EXPECT_THROW(nu::TranspositionTable<int>(0), std::invalid_argument);
+
+    nu::TranspositionTable<int> tt(5);
+    EXPECT_EQ(tt.capacity(), 8u);
+
+    EXPECT_EQ(tt.find(3), nullptr);
+    tt.insert(3, 30);
+    ASSERT_NE(tt.find(3), nullptr);
+    EXPECT_EQ(*tt.find(3), 30);
+
+    // Key 11 shares slot 3 and replaces its entry.
+    tt.insert(11, 110);
+    EXPECT_EQ(tt.find(3), nullptr);
+    EXPECT_EQ(*tt.find(11), 110);
+
+    EXPECT_EQ(tt.hits(), 3u);
+    EXPECT_EQ(tt.misses(), 2u);
+
+    tt.clear();
+    EXPECT_EQ(tt.find(11), nullptr);
+    EXPECT_EQ(tt.hits(), 0u);
+}
+
+// ── NetEvaluator ──────────────────────────────────────────────────────────────
+
+TEST(NetEvaluatorTest, BatchesUncachedChildrenInOneCall)
+{
+    UniformNet net;
+    nu::NetEvaluator<TicTacToe> eval(std::ref(net));
+
+    TicTacToe g;
+    std::vector<int> moves;
+    Eigen::MatrixXd scores;
+    eval.evaluateChildren(g, moves, scores);
+
+    EXPECT_EQ(moves.size(), 9u);
+    EXPECT_EQ(scores.rows(), 9);
+    EXPECT_EQ(scores.cols(), 9);
+    EXPECT_EQ(net.calls, 1u);
+    EXPECT_EQ(net.positions, 9u);
+
+    // The children are cached now: no further network call.
+    eval.evaluateChildren(g, moves, scores);
+    TicTacToe child = g;
+    child.play(4);
+    eval.evaluate(child);
+    EXPECT_EQ(net.calls, 1u);
+    EXPECT_EQ(eval.networkCalls(), 1u);
+    EXPECT_EQ(eval.positionsEvaluated(), 9u);
+
+    eval.clear();
+    eval.evaluate(child);
+    EXPECT_EQ(net.calls, 2u);
+}
+
+TEST(NetEvaluatorTest, RejectsWrongOutputShape)
+{
+    nu::NetEvaluator<TicTacToe> eval(
+        [](const Eigen::Ref<const Eigen::MatrixXd>& X, Eigen::MatrixXd& Y) {
+            Y = Eigen::MatrixXd::Zero(3, X.cols());
+        });
+    EXPECT_THROW(eval.evaluate(TicTacToe()), std::invalid_argument);
+}
+
+TEST(NetEvaluatorTest, BatchFnMatchesSingleFeedForward)
+{
+    nu::MlpNN net({ TicTacToe::inputSize, 12, TicTacToe::numMoves });
+    nu::NetEvaluator<TicTacToe> eval(nu::batchFn(net));
+
+    auto g = fromString("X...O....", TicTacToe::X);
+    const auto scores = eval.evaluate(g);
+
+    nu::Vector in(TicTacToe::inputSize);
+    Eigen::VectorXd encoded(TicTacToe::inputSize);
+    g.encode(encoded);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = encoded(static_cast<Eigen::Index>(i));
+    net.setInputVector(in);
+    net.feedForward();
+    nu::Vector out;
+    net.copyOutputVector(out);
+
+    for (size_t m = 0; m < TicTacToe::numMoves; ++m)
+        EXPECT_NEAR(scores[m], out[m], 1e-12);
+}
+
+// ── Negamax ───────────────────────────────────────────────────────────────────
+
+TEST(NegamaxTest, EmptyBoardIsADraw)
+{
+    nu::Negamax<TicTacToe> search;
+    int best = -1;
+    EXPECT_DOUBLE_EQ(search.solve(TicTacToe(), &best), 0.0);
+    EXPECT_GE(best, 0);
+    EXPECT_LT(best, 9);
+
+    // Without the table alpha-beta visits about 21000 positions; searching
+    // transpositions once keeps it to about 5500.
+    EXPECT_LT(search.nodes(), 10000u);
+}
+
+TEST(NegamaxTest, TakesTheWinAndBlocksTheThreat)
+{
+    // X: 0 1, O: 3 4, X to move wins on 2.
+    nu::Negamax<TicTacToe> search;
+    int best = -1;
+    const double v = search.solve(fromString("XX.OO....", TicTacToe::X), &best);
+    EXPECT_EQ(best, 2);
+    EXPECT_DOUBLE_EQ(v, 0.5 + 0.1 * 4);
+
+    // X on 0 and 1, O to move must block on 2.
+    search.clear();
+    search.solve(fromString("XX..O....", TicTacToe::O), &best);
+    EXPECT_EQ(best, 2);
+}
+
+TEST(NegamaxTest, OrderingByNetworkKeepsTheValue)
+{
+    UniformNet net;
+    nu::NetEvaluator<TicTacToe> eval(std::ref(net));
+    nu::Negamax<TicTacToe> ordered(size_t(1) << 16, &eval);
+    EXPECT_DOUBLE_EQ(ordered.solve(TicTacToe()), 0.0);
+    EXPECT_GT(net.calls, 0u);
+}
+
+// ── Mcts ──────────────────────────────────────────────────────────────────────
+
+TEST(MctsTest, FindsImmediateWinWithUniformPriors)
+{
+    UniformNet net;
+    nu::NetEvaluator<TicTacToe> eval(std::ref(net));
+    nu::Mcts<TicTacToe> mcts(eval, { 400, 1.5, 7 });
+
+    const auto g = fromString("XX.OO....", TicTacToe::X);
+    EXPECT_EQ(mcts.search(g), 2);
+
+    double total = 0.0;
+    for (const double p : mcts.policy())
+        total += p;
+    EXPECT_NEAR(total, 1.0, 1e-12);
+    EXPECT_GT(mcts.policy()[2], 0.5);
+    EXPECT_GT(mcts.treeSize(), 1u);
+
+    EXPECT_THROW(mcts.search(fromString("XXXOO....", TicTacToe::O)), std::invalid_argument);
+}
+
+TEST(MctsTest, BlocksTheOpponentsLine)
+{
+    UniformNet net;
+    nu::NetEvaluator<TicTacToe> eval(std::ref(net));
+    nu::Mcts<TicTacToe> mcts(eval, { 800, 1.5, 11 });
+
+    EXPECT_EQ(mcts.search(fromString("XX..O....", TicTacToe::O)), 2);
+}
@@ -0,0 +1,300 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_binary_hopfieldnn.h"
+#include "nu_hopfieldnn.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// m random +/-1 patterns of size n, one per column.
+Eigen::MatrixXd randomPatterns(Eigen::Index n, Eigen::Index m, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution coin(0.5);
+    Eigen::MatrixXd P(n, m);
+    for (Eigen::Index j = 0; j < m; ++j)
+        for (Eigen::Index i = 0; i < n; ++i)
+            P(i, j) = coin(rng) ? 1.0 : -1.0;
+    return P;
+}
+
+// Negate `flips` distinct entries of every column.
+Eigen::MatrixXd corrupt(const Eigen::MatrixXd& P, Eigen::Index flips, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<Eigen::Index> idx(static_cast<size_t>(P.rows()));
+    std::iota(idx.begin(), idx.end(), Eigen::Index(0));
+    Eigen::MatrixXd K = P;
+    for (Eigen::Index j = 0; j < K.cols(); ++j) {
+        std::shuffle(idx.begin(), idx.end(), rng);
+        for (Eigen::Index f = 0; f < flips; ++f)
+            K(idx[size_t(f)], j) = -K(idx[size_t(f)], j);
+    }
+    return K;
+}
+
+nu::Vector column(const Eigen::MatrixXd& P, Eigen::Index j)
+{
+    nu::Vector v(static_cast<size_t>(P.rows()));
+    for (Eigen::Index i = 0; i < P.rows(); ++i)
+        v[static_cast<size_t>(i)] = P(i, j);
+    return v;
+}
+
+Eigen::VectorXd toEigen(const nu::Vector& v)
+{
+    return Eigen::Map<const Eigen::VectorXd>(v.to_stdvec().data(), Eigen::Index(v.size()));
+}
+
+} // namespace
+
+// ── Storage ───────────────────────────────────────────────────────────────────
+
+TEST(HopfieldTest, AddPatternsMatchesAddPattern)
+{
+    const Eigen::MatrixXd P = randomPatterns(40, 5, 1);
+
+    nu::HopfieldNN one(40), batch(40);
+    for (Eigen::Index j = 0; j < P.cols(); ++j)
+        one.addPattern(column(P, j));
+    batch.addPatterns(P);
+
+    EXPECT_EQ(batch.getPatternsCount(), 5u);
+
+    std::stringstream a, b;
+    one.save(a);
+    batch.save(b);
+    EXPECT_EQ(a.str(), b.str());
+}
+
+TEST(HopfieldTest, AddPatternsSizeMismatchThrows)
+{
+    nu::HopfieldNN net(10);
+    using Mismatch = nu::HopfieldNN::SizeMismatchException;
+    EXPECT_THROW(net.addPatterns(Eigen::MatrixXd::Ones(9, 2)), Mismatch);
+    EXPECT_THROW(net.recall(Eigen::MatrixXd::Ones(9, 2)), Mismatch);
+}
+
+TEST(HopfieldTest, InvalidSettingsThrow)
+{
+    nu::HopfieldNN net(10);
+    EXPECT_THROW(net.setBlockSize(0), std::invalid_argument);
+    EXPECT_THROW(net.setMaxIterations(0), std::invalid_argument);
+}
+
+// ── Recall ────────────────────────────────────────────────────────────────────
+
+TEST(HopfieldTest, AsynchronousRecallRestoresPattern)
+{
+    const Eigen::MatrixXd P = randomPatterns(100, 3, 2);
+    nu::HopfieldNN net(100);
+    net.addPatterns(P);
+
+    nu::Vector out;
+    net.recall(column(corrupt(P, 10, 3), 1), out);
+    EXPECT_EQ(toEigen(out), P.col(1));
+}
+
+TEST(HopfieldTest, SynchronousRecallRestoresPatterns)
+{
+    const Eigen::MatrixXd P = randomPatterns(200, 5, 4);
+    nu::HopfieldNN net(200);
+    net.addPatterns(P);
+    net.setRecallMode(nu::HopfieldNN::RecallMode::Synchronous);
+
+    const Eigen::MatrixXd K = corrupt(P, 20, 5);
+    for (Eigen::Index j = 0; j < P.cols(); ++j) {
+        nu::Vector out;
+        net.recall(column(K, j), out);
+        EXPECT_EQ(toEigen(out), P.col(j));
+        EXPECT_TRUE(net.lastRecallConverged());
+    }
+}
+
+TEST(HopfieldTest, StoredPatternIsFixedPoint)
+{
+    const Eigen::MatrixXd P = randomPatterns(100, 3, 6);
+    nu::HopfieldNN net(100);
+    net.addPatterns(P);
+    net.setRecallMode(nu::HopfieldNN::RecallMode::Synchronous);
+
+    const Eigen::MatrixXd S = net.recall(P);
+    EXPECT_EQ(S, P);
+    EXPECT_EQ(net.getLastIterations(), 1u);
+    EXPECT_TRUE(net.lastRecallConverged());
+}
+
+TEST(HopfieldTest, BatchRecallMatchesSingleRecall)
+{
+    const Eigen::MatrixXd P = randomPatterns(120, 6, 7);
+    const Eigen::MatrixXd K = corrupt(randomPatterns(120, 1, 8).replicate(1, 3), 30, 9);
+    Eigen::MatrixXd keys(120, P.cols() + K.cols());
+    keys << corrupt(P, 25, 10), K;
+
+    for (auto mode : { nu::HopfieldNN::RecallMode::Synchronous,
+             nu::HopfieldNN::RecallMode::Blocked }) {
+        nu::HopfieldNN net(120);
+        net.addPatterns(P);
+        net.setRecallMode(mode);
+        net.setBlockSize(16);
+
+        const Eigen::MatrixXd S = net.recall(keys);
+        for (Eigen::Index j = 0; j < keys.cols(); ++j) {
+            nu::Vector out;
+            net.recall(column(keys, j), out);
+            EXPECT_EQ(toEigen(out), S.col(j)) << "column " << j;
+        }
+    }
+}
+
+TEST(HopfieldTest, BlockedRecallRestoresPatterns)
+{
+    const Eigen::MatrixXd P = randomPatterns(256, 8, 11);
+    nu::HopfieldNN net(256);
+    net.addPatterns(P);
+    net.setRecallMode(nu::HopfieldNN::RecallMode::Blocked);
+    net.setBlockSize(32);
+
+    const Eigen::MatrixXd S = net.recall(corrupt(P, 30, 12));
+    EXPECT_EQ(S, P);
+    EXPECT_TRUE(net.lastRecallConverged());
+}
+
+TEST(HopfieldTest, SynchronousRecallDetectsTwoCycle)
+{
+    // Two neurons coupled negatively: (1, 1) -> (-1, -1) -> (1, 1) ...
+    Eigen::MatrixXd P(2, 1);
+    P << 1.0, -1.0;
+    nu::HopfieldNN net(2);
+    net.addPatterns(P);
+    net.setRecallMode(nu::HopfieldNN::RecallMode::Synchronous);
+
+    Eigen::MatrixXd K(2, 1);
+    K << 1.0, 1.0;
+    net.recall(K);
+    EXPECT_FALSE(net.lastRecallConverged());
+    EXPECT_EQ(net.getLastIterations(), 2u);
+}
+
+TEST(HopfieldTest, SaveLoadRoundTrip)
+{
+    const Eigen::MatrixXd P = randomPatterns(30, 3, 13);
+    nu::HopfieldNN net(30);
+    net.addPatterns(P);
+
+    std::stringstream ss;
+    net.save(ss);
+    nu::HopfieldNN copy(ss);
+
+    std::stringstream a, b;
+    net.save(a);
+    copy.save(b);
+    EXPECT_EQ(a.str(), b.str());
+    EXPECT_EQ(copy.getPatternsCount(), 3u);
+}
+
+// ── BinaryHopfieldNN ──────────────────────────────────────────────────────────
+
+TEST(BinaryHopfieldTest, WeightsMatchHebbianRule)
+{
+    const Eigen::MatrixXd P = randomPatterns(70, 9, 14);
+    nu::BinaryHopfieldNN net(70);
+    for (Eigen::Index j = 0; j < P.cols(); ++j)
+        net.addPattern(column(P, j));
+
+    const Eigen::MatrixXd W = P * P.transpose();
+    for (size_t i = 0; i < 70; ++i)
+        for (size_t j = 0; j < 70; ++j)
+            EXPECT_EQ(net.weight(i, j), i == j ? 0 : int(W(Eigen::Index(i), Eigen::Index(j))));
+    EXPECT_EQ(net.getPatternsCount(), 9u);
+}
+
+TEST(BinaryHopfieldTest, WeightsSaturate)
+{
+    Eigen::MatrixXd P = Eigen::MatrixXd::Ones(4, 10);
+    nu::BinaryHopfieldNN net(4, 3);
+    net.addPatterns(P);
+    EXPECT_EQ(net.weight(0, 1), 3);
+    EXPECT_EQ(net.weight(1, 1), 0);
+    EXPECT_THROW(nu::BinaryHopfieldNN(4, 1), std::invalid_argument);
+    EXPECT_THROW(nu::BinaryHopfieldNN(4, 17), std::invalid_argument);
+}
+
+TEST(BinaryHopfieldTest, MatchesHopfieldRecall)
+{
+    const Eigen::MatrixXd P = randomPatterns(150, 8, 15);
+    const Eigen::MatrixXd K = corrupt(P, 35, 16);
+
+    for (auto mode : { nu::HopfieldNN::RecallMode::Synchronous,
+             nu::HopfieldNN::RecallMode::Blocked }) {
+        nu::HopfieldNN ref(150);
+        ref.addPatterns(P);
+        ref.setRecallMode(mode);
+        ref.setBlockSize(64);
+
+        nu::BinaryHopfieldNN bin(150);
+        bin.addPatterns(P);
+        bin.setRecallMode(mode);
+
+        EXPECT_EQ(bin.recall(K), ref.recall(K));
+        EXPECT_EQ(bin.lastRecallConverged(), ref.lastRecallConverged());
+    }
+}
+
+TEST(BinaryHopfieldTest, RecallRestoresPatterns)
+{
+    const Eigen::MatrixXd P = randomPatterns(256, 10, 17);
+    nu::BinaryHopfieldNN net(256);
+    net.addPatterns(P);
+
+    const Eigen::MatrixXd K = corrupt(P, 30, 18);
+    for (Eigen::Index j = 0; j < P.cols(); ++j) {
+        nu::Vector out;
+        net.recall(column(K, j), out);
+        EXPECT_EQ(toEigen(out), P.col(j));
+    }
+}
+
+TEST(BinaryHopfieldTest, LoadsHopfieldFormat)
+{
+    const Eigen::MatrixXd P = randomPatterns(90, 5, 19);
+    nu::HopfieldNN ref(90);
+    ref.addPatterns(P);
+
+    std::stringstream ss;
+    ref.save(ss);
+    nu::BinaryHopfieldNN bin(ss);
+    EXPECT_EQ(bin.getInputSize(), 90u);
+    EXPECT_EQ(bin.getPatternsCount(), 5u);
+
+    // Integer Hebbian weights convert exactly, and back.
+    std::stringstream a, b;
+    ref.save(a);
+    bin.save(b);
+    nu::HopfieldNN back(b);
+    std::stringstream c;
+    back.save(c);
+    EXPECT_EQ(
+        a.str().substr(a.str().find("Weights")), c.str().substr(c.str().find("Weights")));
+
+    std::stringstream bad("Perceptron 1");
+    EXPECT_THROW(nu::BinaryHopfieldNN{ bad }, nu::BinaryHopfieldNN::InvalidSStreamFormatException);
+}
+
+TEST(BinaryHopfieldTest, UsesAnEighthOfTheMemory)
+{
+    nu::BinaryHopfieldNN net(1024);
+    const size_t doubles = 1024 * 1024 * sizeof(double);
+    EXPECT_LE(net.getMemoryBytes(), doubles / 8 + 64 * 1024);
+}
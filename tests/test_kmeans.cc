@@ -7,6 +7,8 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <random>
 #include <set>
 #include <vector>
 
@@ -35,6 +37,24 @@ static std::vector<std::vector<double>> twoClusters()
     return X;
 }
 
+// n Gaussian blobs (sigma 1) around random centres in [-20, 20]^d
+static KMeans::Matrix blobs(size_t n, size_t d, size_t perBlob, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> centre(-20.0, 20.0);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    KMeans::Matrix X(static_cast<Eigen::Index>(n * perBlob), static_cast<Eigen::Index>(d));
+    for (size_t b = 0; b < n; ++b) {
+        Eigen::RowVectorXd c(static_cast<Eigen::Index>(d));
+        for (auto& v : c)
+            v = centre(rng);
+        for (size_t i = 0; i < perBlob; ++i)
+            for (Eigen::Index j = 0; j < X.cols(); ++j)
+                X(static_cast<Eigen::Index>(b * perBlob + i), j) = c(j) + noise(rng);
+    }
+    return X;
+}
+
 // ── Construction ──────────────────────────────────────────────────────────────
 
 TEST(KMeansTest, ConstructionStoresParams)
@@ -209,3 +229,133 @@ TEST(KMeansTest, NumIterationsBoundedByMaxIter)
     km.fit(twoClusters());
     EXPECT_LE(km.numIterations(), 5u);
 }
+
+// ── Accelerated / parallel engine ─────────────────────────────────────────────
+
+TEST(KMeansTest, BoundedAlgorithmsMatchLloyd)
+{
+    // Unclustered data: Lloyd needs many iterations to settle.
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    KMeans::Matrix X(3000, 8);
+    for (auto& v : X.reshaped())
+        v = unif(rng);
+
+    KMeans lloyd(12), hamerly(12), elkan(12);
+    lloyd.setAlgorithm(KMeans::Algorithm::Lloyd);
+    hamerly.setAlgorithm(KMeans::Algorithm::Hamerly);
+    elkan.setAlgorithm(KMeans::Algorithm::Elkan);
+    for (auto* km : { &lloyd, &hamerly, &elkan }) {
+        km->setThreads(1);
+        km->fit(X);
+    }
+
+    EXPECT_EQ(hamerly.predict(X), lloyd.predict(X));
+    EXPECT_EQ(elkan.predict(X), lloyd.predict(X));
+    EXPECT_TRUE(hamerly.centroidMatrix().isApprox(lloyd.centroidMatrix(), 1e-9));
+    EXPECT_TRUE(elkan.centroidMatrix().isApprox(lloyd.centroidMatrix(), 1e-9));
+    EXPECT_EQ(hamerly.numIterations(), lloyd.numIterations());
+
+    // The bounds must skip most of Lloyd's N*k distances per iteration.
+    EXPECT_LT(hamerly.distanceEvaluations(), lloyd.distanceEvaluations() / 2);
+    EXPECT_LT(elkan.distanceEvaluations(), lloyd.distanceEvaluations() / 2);
+}
+
+TEST(KMeansTest, ThreadedFitMatchesSerial)
+{
+    const auto X = blobs(5, 6, 1000, 11);
+    KMeans serial(5), threaded(5);
+    serial.setThreads(1);
+    threaded.setThreads(4);
+    serial.fit(X);
+    threaded.fit(X);
+    EXPECT_EQ(threaded.predict(X), serial.predict(X));
+    EXPECT_TRUE(threaded.centroidMatrix().isApprox(serial.centroidMatrix(), 1e-9));
+    EXPECT_NEAR(threaded.inertia(X), serial.inertia(X), 1e-6 * serial.inertia(X));
+}
+
+TEST(KMeansTest, ParallelInitFindsAllBlobs)
+{
+    const auto X = blobs(10, 4, 300, 3);
+    KMeans km(10);
+    km.setInit(KMeans::Init::Parallel);
+    km.fit(X);
+
+    // Every blob gets its own centroid: the inertia is close to N*d*sigma^2.
+    const double expected = static_cast<double>(X.rows() * X.cols());
+    EXPECT_LT(km.inertia(X), 1.2 * expected);
+    const auto labels = km.predict(X);
+    EXPECT_EQ(std::set<size_t>(labels.begin(), labels.end()).size(), 10u);
+}
+
+TEST(KMeansTest, MatrixFitMatchesVectorFit)
+{
+    const auto X = twoClusters();
+    KMeans::Matrix M(static_cast<Eigen::Index>(X.size()), 2);
+    for (size_t i = 0; i < X.size(); ++i)
+        M.row(static_cast<Eigen::Index>(i)) << X[i][0], X[i][1];
+
+    KMeans a(2), b(2);
+    a.fit(X);
+    b.fit(M);
+    EXPECT_EQ(a.predict(X), b.predict(M));
+    EXPECT_DOUBLE_EQ(a.inertia(X), b.inertia(M));
+    EXPECT_THROW(b.predict(KMeans::Matrix::Zero(3, 5)), KMeans::SizeMismatchException);
+}
+
+// ── Mini-batch / streaming ────────────────────────────────────────────────────
+
+TEST(KMeansTest, MiniBatchInertiaCloseToBatch)
+{
+    const auto X = blobs(10, 4, 1000, 5);
+    KMeans batch(10), mini(10);
+    batch.fit(X);
+    mini.fitMiniBatch(X, 256);
+    EXPECT_TRUE(mini.isFitted());
+    EXPECT_LT(mini.inertia(X), 1.05 * batch.inertia(X));
+}
+
+TEST(KMeansTest, PartialFitStreamsChunks)
+{
+    const auto X = blobs(6, 3, 500, 9);
+    KMeans batch(6), stream(6);
+    batch.fit(X);
+
+    // Rows are buffered until initSize() (3k = 18) have arrived.
+    stream.partialFit(X.topRows(10));
+    EXPECT_FALSE(stream.isFitted());
+    EXPECT_THROW(stream.predict(X), KMeans::NotFittedException);
+
+    // Chunks in a shuffled order, as they would come from disk.
+    std::vector<Eigen::Index> order(static_cast<size_t>(X.rows()));
+    std::iota(order.begin(), order.end(), Eigen::Index(0));
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    KMeans::Matrix chunk(100, X.cols());
+    for (size_t i = 0; i + 100 <= order.size(); i += 100) {
+        for (Eigen::Index r = 0; r < 100; ++r)
+            chunk.row(r) = X.row(order[i + static_cast<size_t>(r)]);
+        stream.partialFit(chunk);
+    }
+    ASSERT_TRUE(stream.isFitted());
+    EXPECT_LT(stream.inertia(X), 1.05 * batch.inertia(X));
+
+    double absorbed = 0.0;
+    for (double v : stream.clusterCounts())
+        absorbed += v;
+    EXPECT_DOUBLE_EQ(absorbed, 10.0 + static_cast<double>(X.rows()));
+    EXPECT_THROW(stream.partialFit(KMeans::Matrix::Zero(4, 5)), KMeans::SizeMismatchException);
+}
+
+TEST(KMeansTest, PartialFitDecayTracksDrift)
+{
+    KMeans km(1);
+    km.fit(std::vector<std::vector<double>> { { -1.0 }, { 0.0 }, { 1.0 } });
+    EXPECT_DOUBLE_EQ(km.clusterCounts()[0], 3.0);
+
+    EXPECT_THROW(km.setDecay(0.0), std::invalid_argument);
+    km.setDecay(0.5);
+    for (int i = 0; i < 20; ++i)
+        km.partialFit(std::vector<std::vector<double>> { { 9.5 }, { 10.5 } });
+    EXPECT_NEAR(km.centroids()[0][0], 10.0, 1e-3);
+    EXPECT_LT(km.clusterCounts()[0], 4.0 + 1e-9); // bounded by 2 / (1 - decay)
+}
@@ -0,0 +1,46 @@
+//
+// Unit tests for nu::solveSpdOrMinNorm (nu_linalg.h).
+//
+
+#include "nu_linalg.h"
+
+#include <gtest/gtest.h>
+
+TEST(SolveSpdOrMinNormTest, SolvesWellConditionedSystems)
+{
+    Eigen::MatrixXd M(3, 3);
+    M << 2.0, -1.0, 0.5, 0.3, 1.5, -0.2, -0.4, 0.1, 1.2;
+    const Eigen::MatrixXd A = M * M.transpose() + Eigen::MatrixXd::Identity(3, 3);
+    Eigen::MatrixXd X(3, 2);
+    X << 1.0, -2.0, 0.5, 3.0, -1.5, 0.25;
+
+    const Eigen::MatrixXd got = nu::solveSpdOrMinNorm(A, A * X);
+    EXPECT_LT((got - X).cwiseAbs().maxCoeff(), 1e-12);
+}
+
+TEST(SolveSpdOrMinNormTest, SingularSystemGetsMinimumNorm)
+{
+    // Rank 1: every x with x0 + x1 = 2 solves it; the minimum norm is (1, 1).
+    Eigen::MatrixXd A(2, 2);
+    A << 1.0, 1.0, 1.0, 1.0;
+    const Eigen::VectorXd b = Eigen::Vector2d(2.0, 2.0);
+
+    const Eigen::MatrixXd x = nu::solveSpdOrMinNorm(A, b);
+    ASSERT_EQ(x.rows(), 2);
+    ASSERT_EQ(x.cols(), 1);
+    EXPECT_NEAR(x(0, 0), 1.0, 1e-12);
+    EXPECT_NEAR(x(1, 0), 1.0, 1e-12);
+}
+
+TEST(SolveSpdOrMinNormTest, CollinearNormalEquationsGetMinimumNorm)
+{
+    // Columns 0 and 1 of X are identical, so X^T X is singular and only
+    // w0 + w1 is determined; the minimum-norm split gives w = (1, 1, 1).
+    Eigen::MatrixXd X(5, 3);
+    X << 1.0, 1.0, 0.5, 2.0, 2.0, -1.0, -1.0, -1.0, 3.0, 0.5, 0.5, 0.0, 4.0, 4.0, 1.5;
+    const Eigen::VectorXd y = 2.0 * X.col(0) + X.col(2);
+
+    const Eigen::MatrixXd w = nu::solveSpdOrMinNorm(X.transpose() * X, X.transpose() * y);
+    for (Eigen::Index j = 0; j < 3; ++j)
+        EXPECT_NEAR(w(j, 0), 1.0, 1e-9) << "w" << j;
+}
@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <random>
 #include <vector>
 
 using nu::LinearRegression;
@@ -236,3 +237,148 @@ TEST(LinearRegressionTest, SettersWork)
     EXPECT_EQ(lr.maxIterations(), 5000u);
     EXPECT_DOUBLE_EQ(lr.tolerance(), 1e-8);
 }
+
+// ── Scalable solvers ─────────────────────────────────────────────────────────
+
+// y = X w + b + noise with features offset far from the origin, so that
+// uncentred accumulation would lose precision.
+static void makeLarge(size_t N, size_t F, LinearRegression::Matrix& X, Eigen::VectorXd& y)
+{
+    std::mt19937 rng(5);
+    std::normal_distribution<double> g(0.0, 1.0);
+    X.resize(Eigen::Index(N), Eigen::Index(F));
+    y.resize(Eigen::Index(N));
+    for (Eigen::Index i = 0; i < X.rows(); ++i) {
+        double t = 0.5;
+        for (Eigen::Index j = 0; j < X.cols(); ++j) {
+            X(i, j) = 1000.0 + g(rng);
+            t += (j % 2 ? -1.0 : 1.0) * (1.0 + 0.1 * double(j)) * X(i, j);
+        }
+        y(i) = t + 0.01 * g(rng);
+    }
+}
+
+TEST(LinearRegressionTest, NormalEquationsMatchOLS)
+{
+    LinearRegression::Matrix X;
+    Eigen::VectorXd y;
+    makeLarge(5000, 6, X, y);
+
+    LinearRegression ols(Method::OLS), ne(Method::NormalEquations);
+    ne.setThreads(3);
+    ols.fit(X, y);
+    ne.fit(X, y);
+    for (size_t j = 0; j < 6; ++j)
+        EXPECT_NEAR(ne.coefficients()[j], ols.coefficients()[j], 1e-8);
+    EXPECT_NEAR(ne.intercept(), ols.intercept(), 1e-5);
+    EXPECT_LT((ne.predict(X) - ols.predict(X)).cwiseAbs().maxCoeff(), 1e-7);
+}
+
+TEST(LinearRegressionTest, AccumulatorChunksAndMergeMatchSinglePass)
+{
+    LinearRegression::Matrix X;
+    Eigen::VectorXd y;
+    makeLarge(3000, 4, X, y);
+
+    LinearRegression ref(Method::NormalEquations);
+    ref.setThreads(1);
+    ref.fit(X, y);
+
+    LinearRegression::Accumulator a, b;
+    a.add(X.topRows(1000), y.head(1000));
+    b.add(X.bottomRows(2000), y.tail(2000));
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3000u);
+    LinearRegression merged;
+    merged.fit(a);
+
+    LinearRegression stream;
+    for (Eigen::Index r = 0; r < X.rows(); r += 700) {
+        const Eigen::Index n = std::min<Eigen::Index>(700, X.rows() - r);
+        stream.partialFit(X.middleRows(r, n), y.segment(r, n));
+    }
+    EXPECT_EQ(stream.statistics().count(), 3000u);
+
+    for (size_t j = 0; j < 4; ++j) {
+        EXPECT_NEAR(merged.coefficients()[j], ref.coefficients()[j], 1e-9);
+        EXPECT_NEAR(stream.coefficients()[j], ref.coefficients()[j], 1e-9);
+    }
+    EXPECT_NEAR(merged.intercept(), ref.intercept(), 1e-6);
+    EXPECT_THROW(a.add(X.leftCols(3), y), LinearRegression::SizeMismatchException);
+}
+
+TEST(LinearRegressionTest, PartialFitContinuesFromNormalEquationsFit)
+{
+    LinearRegression::Matrix X;
+    Eigen::VectorXd y;
+    makeLarge(3000, 4, X, y);
+
+    LinearRegression ref(Method::NormalEquations);
+    ref.fit(X, y);
+
+    // fit(head) seeds the stream; partialFit(tail) extends it.
+    LinearRegression ne(Method::NormalEquations);
+    ne.fit(X.topRows(1000), y.head(1000));
+    EXPECT_EQ(ne.statistics().count(), 1000u);
+    ne.partialFit(X.bottomRows(2000), y.tail(2000));
+    EXPECT_EQ(ne.statistics().count(), 3000u);
+    for (size_t j = 0; j < 4; ++j)
+        EXPECT_NEAR(ne.coefficients()[j], ref.coefficients()[j], 1e-9);
+
+    // OLS keeps no statistics: partialFit() after it sees only the new chunk.
+    LinearRegression ols(Method::OLS);
+    ols.fit(X.topRows(1000), y.head(1000));
+    EXPECT_EQ(ols.statistics().count(), 0u);
+    ols.partialFit(X.bottomRows(2000), y.tail(2000));
+    EXPECT_EQ(ols.statistics().count(), 2000u);
+
+    // A later fit() replaces whatever the stream held.
+    ne.fit(X.topRows(500), y.head(500));
+    EXPECT_EQ(ne.statistics().count(), 500u);
+}
+
+TEST(LinearRegressionTest, RidgeSameSolutionAcrossMethods)
+{
+    auto [X, y] = linear2D();
+    LinearRegression ols(Method::OLS), ne(Method::NormalEquations),
+        gd(Method::GradientDescent, 0.1, 200000, 1e-13);
+    for (auto* m : { &ols, &ne, &gd }) {
+        m->setRidge(2.0);
+        m->fit(X, y);
+    }
+    // Shrinkage moves the weights away from the exact (2, -1).
+    EXPECT_LT(std::abs(ne.coefficients()[0]), 2.0 - 1e-3);
+    for (size_t j = 0; j < 2; ++j) {
+        EXPECT_NEAR(ne.coefficients()[j], ols.coefficients()[j], 1e-9);
+        EXPECT_NEAR(gd.coefficients()[j], ols.coefficients()[j], 1e-6);
+    }
+    EXPECT_NEAR(ne.intercept(), ols.intercept(), 1e-9);
+    EXPECT_THROW(ols.setRidge(-1.0), std::invalid_argument);
+}
+
+TEST(LinearRegressionTest, MiniBatchSGDConverges)
+{
+    auto [X, y] = linear2D();
+    LinearRegression sgd(Method::MiniBatchSGD, 0.05, 5000, 1e-12);
+    sgd.setBatchSize(4);
+    sgd.fit(X, y);
+    EXPECT_NEAR(sgd.coefficients()[0], 2.0, 1e-4);
+    EXPECT_NEAR(sgd.coefficients()[1], -1.0, 1e-4);
+    EXPECT_NEAR(sgd.intercept(), 5.0, 1e-4);
+}
+
+TEST(LinearRegressionTest, NormalEquationsCollinearFallsBack)
+{
+    // Second feature duplicates the first: singular Sxx, min-norm split.
+    std::vector<std::vector<double>> X;
+    std::vector<double> y;
+    for (int i = 0; i < 10; ++i) {
+        X.push_back({ double(i), double(i) });
+        y.push_back(4.0 * i + 1.0);
+    }
+    LinearRegression ne(Method::NormalEquations);
+    ne.fit(X, y);
+    EXPECT_NEAR(ne.coefficients()[0], 2.0, 1e-6);
+    EXPECT_NEAR(ne.coefficients()[1], 2.0, 1e-6);
+    EXPECT_NEAR(ne.intercept(), 1.0, 1e-6);
+}
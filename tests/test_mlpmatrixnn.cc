@@ -340,6 +340,86 @@ TEST(MatrixBatchTest, MismatchedBatchThrows)
     EXPECT_THROW(nn.trainBatch({ { 1.0, 0.0 }, { 0.0, 1.0 } }, { { 1.0 } }), std::invalid_argument);
 }
 
+TEST(MatrixBatchTest, FeedForwardBatchMatchesSingle)
+{
+    MlpMatrixNN nn({ LC{ 3 }, { 5, Activation::Tanh }, { 2, Activation::Sigmoid } });
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(3, 4);
+    const Eigen::MatrixXd Y = nn.feedForwardBatch(X);
+    ASSERT_EQ(Y.rows(), 2);
+    ASSERT_EQ(Y.cols(), 4);
+    for (Eigen::Index j = 0; j < X.cols(); ++j) {
+        nn.setInputVector(std::vector<double>(X.col(j).data(), X.col(j).data() + 3));
+        nn.feedForward();
+        std::vector<double> out;
+        nn.copyOutputVector(out);
+        EXPECT_NEAR(Y(0, j), out[0], 1e-12);
+        EXPECT_NEAR(Y(1, j), out[1], 1e-12);
+    }
+}
+
+TEST(MatrixBatchTest, FeedForwardBatchLayerRangeComposes)
+{
+    MlpMatrixNN nn({ LC{ 3 }, { 5, Activation::Tanh }, { 4, Activation::Tanh },
+        { 2, Activation::Sigmoid } });
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(3, 6);
+
+    const Eigen::MatrixXd H = nn.feedForwardBatch(X, 0, 2);
+    ASSERT_EQ(H.rows(), 4);
+    const Eigen::MatrixXd Y = nn.feedForwardBatch(H, 2, 3);
+    EXPECT_TRUE(Y.isApprox(nn.feedForwardBatch(X), 1e-12));
+
+    EXPECT_THROW((void)nn.feedForwardBatch(X, 1, 1), std::out_of_range);
+    EXPECT_THROW((void)nn.feedForwardBatch(X, 0, 4), std::out_of_range);
+    EXPECT_THROW((void)nn.feedForwardBatch(X, 1, 3), std::invalid_argument);
+}
+
+TEST(MatrixBatchTest, FeedForwardBatchIntoReusesOutput)
+{
+    MlpMatrixNN deep({ LC{ 3 }, { 5, Activation::Tanh }, { 4, Activation::ReLU },
+        { 2, Activation::Sigmoid } });
+    MlpMatrixNN shallow({ LC{ 3 }, { 2, Activation::Tanh } });
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(3, 6);
+
+    for (const MlpMatrixNN* nn : { &deep, &shallow }) {
+        Eigen::MatrixXd out;
+        nn->feedForwardBatch(X, out);
+        EXPECT_TRUE(out.isApprox(nn->feedForwardBatch(X, 0, nn->numLayers()), 1e-12));
+
+        // Same shape: evaluated in place, no reallocation.
+        const double* data = out.data();
+        nn->feedForwardBatch(2.0 * X, out);
+        EXPECT_EQ(out.data(), data);
+        EXPECT_TRUE(out.isApprox(nn->feedForwardBatch(2.0 * X), 1e-12));
+    }
+    Eigen::MatrixXd out;
+    EXPECT_THROW(deep.feedForwardBatch(Eigen::MatrixXd::Zero(4, 2), out), std::invalid_argument);
+}
+
+TEST(MatrixBatchTest, MatrixTrainBatchInputGradient)
+{
+    // lr = 0: weights stay fixed, so the batched W^T * delta must match the
+    // single-sample getInputGradient() column by column.
+    MlpMatrixNN nn({ LC{ 3 }, { 4, Activation::Tanh }, { 2, Activation::Sigmoid } }, 0.0);
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(3, 5);
+    const Eigen::MatrixXd T = (Eigen::MatrixXd::Random(2, 5).array() + 1.0) / 2.0;
+
+    Eigen::MatrixXd G;
+    const double loss = nn.trainBatch(X, T, &G);
+    ASSERT_EQ(G.rows(), 3);
+    ASSERT_EQ(G.cols(), 5);
+
+    double mse = 0.0;
+    for (Eigen::Index j = 0; j < X.cols(); ++j) {
+        const std::vector<double> t(T.col(j).data(), T.col(j).data() + 2);
+        nn.setInputVector(std::vector<double>(X.col(j).data(), X.col(j).data() + 3));
+        nn.feedForward();
+        mse += nn.calcMSE(t);
+        nn.backPropagate(t);
+        EXPECT_TRUE(G.col(j).isApprox(nn.getInputGradient(), 1e-12));
+    }
+    EXPECT_NEAR(loss, mse / 5.0, 1e-12);
+}
+
 TEST(MatrixBatchTest, LossDecreasesAfterOneBatch)
 {
     // A single batch step must move the output closer to the target.
@@ -492,3 +572,64 @@ TEST(AdamTest, ReshuffleResetsAdamState)
     net.feedForward();
     EXPECT_NO_THROW(net.backPropagate({ 0.0 }));
 }
+
+// ── Parameter buffer ──────────────────────────────────────────────────────────
+
+TEST(ParameterBufferTest, LayoutMatchesLayers)
+{
+    MlpMatrixNN nn({ LC{ 3 }, { 4, Activation::Tanh }, { 2, Activation::Linear } });
+    const Eigen::VectorXd& p = nn.parameters();
+    ASSERT_EQ(p.size(), 4 * 3 + 4 + 2 * 4 + 2);
+
+    Eigen::Index offset = 0;
+    for (size_t l = 0; l < nn.numLayers(); ++l) {
+        const Eigen::MatrixXd W = nn.getLayerW(l);
+        const Eigen::VectorXd b = nn.getLayerB(l);
+        EXPECT_EQ(p.segment(offset, W.size()), W.reshaped());
+        offset += W.size();
+        EXPECT_EQ(p.segment(offset, b.size()), b);
+        offset += b.size();
+    }
+
+    // Writes through setLayer*() land in the buffer.
+    nn.setLayerB(1, Eigen::Vector2d(7.0, 8.0));
+    EXPECT_EQ(p.tail(2), Eigen::Vector2d(7.0, 8.0));
+    EXPECT_THROW(nn.setLayerW(0, Eigen::MatrixXd::Zero(3, 4)), std::invalid_argument);
+    EXPECT_THROW(nn.setLayerB(0, Eigen::VectorXd::Zero(3)), std::invalid_argument);
+}
+
+TEST(ParameterBufferTest, CopiesOwnTheirParameters)
+{
+    MlpMatrixNN a({ LC{ 2 }, { 3, Activation::Tanh }, { 1, Activation::Linear } });
+    MlpMatrixNN b(a);
+    const Eigen::MatrixXd X = Eigen::MatrixXd::Random(2, 5);
+    EXPECT_EQ(b.feedForwardBatch(X), a.feedForwardBatch(X));
+
+    b.setLayerB(0, Eigen::Vector3d(1.0, 2.0, 3.0));
+    EXPECT_NE(a.getLayerB(0), b.getLayerB(0));
+
+    a = b;
+    EXPECT_EQ(a.parameters(), b.parameters());
+    EXPECT_NE(a.parameters().data(), b.parameters().data());
+    EXPECT_EQ(a.feedForwardBatch(X), b.feedForwardBatch(X));
+}
+
+TEST(ParameterBufferTest, CopyAndBlend)
+{
+    const std::vector<LC> layers{ LC{ 2 }, { 3, Activation::Tanh }, { 2, Activation::Linear } };
+    MlpMatrixNN online(layers), target(layers);
+    target.copyParameters(online);
+    EXPECT_EQ(target.parameters(), online.parameters());
+
+    online.reshuffleWeights();
+    const Eigen::VectorXd before = target.parameters();
+    target.blendParameters(online, 0.25);
+    EXPECT_TRUE(target.parameters().isApprox(0.25 * online.parameters() + 0.75 * before, 1e-15));
+    target.blendParameters(online, 1.0);
+    EXPECT_EQ(target.parameters(), online.parameters());
+
+    MlpMatrixNN other({ LC{ 2 }, { 4, Activation::Tanh }, { 2, Activation::Linear } });
+    EXPECT_THROW(target.copyParameters(other), std::invalid_argument);
+    EXPECT_THROW(target.blendParameters(other, 0.5), std::invalid_argument);
+    EXPECT_THROW(target.blendParameters(online, 1.5), std::invalid_argument);
+}
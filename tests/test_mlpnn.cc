@@ -131,3 +131,27 @@ TEST(MlpNNTest, LoadRejectsGarbageStream)
     MlpNN nn;
     EXPECT_THROW(nn.load(ss), MlpNN::InvalidSStreamFormatException);
 }
+
+TEST(MlpNNTest, FeedForwardBatchMatchesPerSampleFeedForward)
+{
+    MlpNN nn({ 3, 5, 2 });
+
+    Eigen::MatrixXd X(3, 4);
+    X << 0.0, 1.0, 0.5, -0.3, //
+        0.2, 0.0, 0.5, 0.9, //
+        1.0, 0.4, 0.5, 0.1;
+    const Eigen::MatrixXd Y = nn.feedForwardBatch(X);
+    ASSERT_EQ(Y.rows(), 2);
+    ASSERT_EQ(Y.cols(), 4);
+
+    for (Eigen::Index c = 0; c < X.cols(); ++c) {
+        nn.setInputVector(Vector{ X(0, c), X(1, c), X(2, c) });
+        nn.feedForward();
+        Vector out;
+        nn.copyOutputVector(out);
+        EXPECT_NEAR(Y(0, c), out[0], 1e-12);
+        EXPECT_NEAR(Y(1, c), out[1], 1e-12);
+    }
+
+    EXPECT_THROW((void)nn.feedForwardBatch(Eigen::MatrixXd(2, 1)), MlpNN::SizeMismatchException);
+}
@@ -0,0 +1,59 @@
+//
+// Unit tests for nu::parallelFor and nu::WorkerPool (nu_parallel.h).
+//
+
+#include "nu_parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(WorkerPoolTest, RangesCoverTheWorkLikeParallelFor)
+{
+    nu::WorkerPool pool(3);
+    EXPECT_EQ(pool.size(), 3u);
+
+    for (const size_t n : { size_t(0), size_t(1), size_t(2), size_t(10), size_t(1000) }) {
+        std::vector<int> hits(n, 0);
+        pool.parallelFor(n, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i)
+                ++hits[i];
+        });
+        EXPECT_EQ(hits, std::vector<int>(n, 1));
+    }
+}
+
+TEST(WorkerPoolTest, JobsReuseTheSameThreads)
+{
+    nu::WorkerPool pool(3);
+    std::mutex mtx;
+    std::set<std::thread::id> ids;
+
+    for (int job = 0; job < 50; ++job) {
+        pool.parallelFor(3, [&](size_t, size_t, size_t) {
+            std::lock_guard<std::mutex> lock(mtx);
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    EXPECT_LE(ids.size(), 3u);
+    EXPECT_TRUE(ids.count(std::this_thread::get_id()));
+}
+
+TEST(WorkerPoolTest, RethrowsAndStaysUsable)
+{
+    nu::WorkerPool pool(4);
+    EXPECT_THROW(pool.parallelFor(8,
+                     [](size_t b, size_t, size_t) {
+                         if (b > 0)
+                             throw std::runtime_error("worker");
+                     }),
+        std::runtime_error);
+
+    std::atomic<size_t> total { 0 };
+    pool.parallelFor(8, 2, [&](size_t b, size_t e, size_t) { total += e - b; });
+    EXPECT_EQ(total.load(), 8u);
+}
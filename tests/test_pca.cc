@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <random>
 #include <vector>
 
 using nu::Pca;
@@ -217,3 +218,219 @@ TEST(PcaTest, ConstantDataDoesNotThrow)
     EXPECT_NO_THROW(pca.fit(X));
     EXPECT_TRUE(pca.isFitted());
 }
+
+// ── solvers ───────────────────────────────────────────────────────────────────
+
+// N x D samples from a rank-r signal with decaying scales plus small noise,
+// offset from the origin so that centring matters.
+static Pca::Matrix lowRankData(size_t N, size_t D, size_t r, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> g(0.0, 1.0);
+    Eigen::MatrixXd basis(r, D);
+    for (Eigen::Index i = 0; i < basis.size(); ++i)
+        basis.data()[i] = g(rng);
+    Pca::Matrix X(N, D);
+    for (size_t i = 0; i < N; ++i) {
+        Eigen::RowVectorXd x = Eigen::RowVectorXd::Constant(D, 5.0);
+        for (size_t c = 0; c < r; ++c)
+            x += (10.0 / double(c + 1)) * g(rng) * basis.row(Eigen::Index(c));
+        for (size_t j = 0; j < D; ++j)
+            x(Eigen::Index(j)) += 0.05 * g(rng);
+        X.row(Eigen::Index(i)) = x;
+    }
+    return X;
+}
+
+static void expectSameModel(const Pca& a, const Pca& b, double tol)
+{
+    ASSERT_EQ(a.nComponents(), b.nComponents());
+    for (size_t c = 0; c < a.nComponents(); ++c) {
+        EXPECT_NEAR(a.explainedVarianceRatio()[c], b.explainedVarianceRatio()[c], tol);
+        const double dot = a.components().row(Eigen::Index(c)).dot(
+            b.components().row(Eigen::Index(c)));
+        EXPECT_NEAR(dot, 1.0, tol) << "component " << c;
+    }
+    EXPECT_LT((a.mean() - b.mean()).norm(), 1e-9);
+}
+
+TEST(PcaTest, MatrixFitMatchesVectorFit)
+{
+    const Pca::Matrix X = lowRankData(200, 12, 3, 1);
+    std::vector<std::vector<double>> V(200, std::vector<double>(12));
+    for (size_t i = 0; i < 200; ++i)
+        for (size_t j = 0; j < 12; ++j)
+            V[i][j] = X(Eigen::Index(i), Eigen::Index(j));
+
+    Pca a(3), b(3);
+    a.fit(X);
+    b.fit(V);
+    expectSameModel(a, b, 1e-12);
+}
+
+TEST(PcaTest, RandomizedSolverMatchesFull)
+{
+    const Pca::Matrix X = lowRankData(1500, 120, 8, 2);
+    Pca full(5), rnd(5);
+    full.setSolver(Pca::Solver::Full);
+    rnd.setSolver(Pca::Solver::Randomized);
+    rnd.setThreads(3);
+    full.fit(X);
+    rnd.fit(X);
+    expectSameModel(full, rnd, 1e-6);
+    EXPECT_NEAR(full.totalExplainedVariance(), rnd.totalExplainedVariance(), 1e-6);
+}
+
+TEST(PcaTest, RandomizedSolverMatchesFullForLargeMeans)
+{
+    // The range finder centres X block by block; projecting first and
+    // subtracting mean^T M would skew the singular values.
+    Pca::Matrix X = lowRankData(1500, 120, 8, 2);
+    X.array() += 1e10;
+    Pca full(5), rnd(5);
+    full.setSolver(Pca::Solver::Full);
+    rnd.setSolver(Pca::Solver::Randomized);
+    rnd.setThreads(3);
+    full.fit(X);
+    rnd.fit(X);
+    expectSameModel(full, rnd, 1e-12);
+}
+
+TEST(PcaTest, PartialFitMatchesFull)
+{
+    const Pca::Matrix X = lowRankData(1200, 40, 4, 3);
+    Pca full(4), inc(4);
+    full.setSolver(Pca::Solver::Full);
+    full.fit(X);
+    for (Eigen::Index b = 0; b < X.rows(); b += 150)
+        inc.partialFit(X.middleRows(b, 150));
+
+    EXPECT_EQ(inc.samplesSeen(), 1200u);
+    expectSameModel(full, inc, 1e-6);
+}
+
+TEST(PcaTest, PartialFitContinuesFromFit)
+{
+    const Pca::Matrix X = lowRankData(1200, 40, 4, 3);
+    Pca full(4), inc(4);
+    full.setSolver(Pca::Solver::Full);
+    inc.setSolver(Pca::Solver::Full);
+    full.fit(X);
+    inc.fit(X.topRows(600));
+    for (Eigen::Index b = 600; b < X.rows(); b += 150)
+        inc.partialFit(X.middleRows(b, 150));
+
+    EXPECT_EQ(inc.samplesSeen(), 1200u);
+    expectSameModel(full, inc, 1e-6);
+
+    // reset() drops the fitted model: the next batch starts a new stream.
+    inc.reset();
+    inc.partialFit(X.topRows(150));
+    EXPECT_EQ(inc.samplesSeen(), 150u);
+    EXPECT_LT((inc.mean() - X.topRows(150).colwise().mean().transpose()).norm(), 1e-9);
+}
+
+TEST(PcaTest, PartialFitFirstBatchTooSmallThrows)
+{
+    Pca pca(4);
+    EXPECT_THROW(pca.partialFit(lowRankData(3, 10, 2, 4)), Pca::SizeMismatchException);
+    pca.partialFit(lowRankData(8, 10, 2, 4));
+    EXPECT_NO_THROW(pca.partialFit(lowRankData(1, 10, 2, 5)));
+    EXPECT_THROW(pca.partialFit(lowRankData(8, 9, 2, 6)), Pca::SizeMismatchException);
+}
+
+// ── matrix transform ──────────────────────────────────────────────────────────
+
+TEST(PcaTest, MatrixTransformMatchesPerSample)
+{
+    const Pca::Matrix X = lowRankData(300, 16, 4, 7);
+    Pca pca(4);
+    pca.setThreads(3);
+    pca.fit(X);
+
+    const Pca::Matrix Z = pca.transform(X);
+    Pca::MatrixF Zf(X.rows(), 4);
+    pca.transform(X, Zf);
+    const Pca::Matrix Xhat = pca.inverseTransform(Z);
+    for (Eigen::Index i = 0; i < X.rows(); i += 37) {
+        const std::vector<double> x(X.row(i).data(), X.row(i).data() + X.cols());
+        const auto z = pca.transform(x);
+        const auto xh = pca.inverseTransform(z);
+        for (size_t c = 0; c < 4; ++c) {
+            EXPECT_NEAR(Z(i, Eigen::Index(c)), z[c], 1e-9);
+            EXPECT_NEAR(Zf(i, Eigen::Index(c)), z[c], 1e-4 * (1.0 + std::abs(z[c])));
+        }
+        for (size_t j = 0; j < xh.size(); ++j)
+            EXPECT_NEAR(Xhat(i, Eigen::Index(j)), xh[j], 1e-9);
+    }
+}
+
+TEST(PcaTest, TransformIsExactForLargeMeans)
+{
+    // Features around 1e8 with O(10) spread: projecting before centring would
+    // cancel |x P^T| ~ 1e9 down to O(10), losing about seven digits.
+    Pca::Matrix X = lowRankData(400, 40, 3, 10);
+    X.array() += 1e8;
+    Pca pca(3);
+    pca.setSolver(Pca::Solver::Full);
+    pca.fit(X);
+
+    Pca::Matrix ref(X.rows(), 3);
+    for (Eigen::Index i = 0; i < X.rows(); ++i)
+        ref.row(i) = (X.row(i) - pca.mean().transpose()) * pca.components().transpose();
+
+    const Pca::Matrix Z = pca.transform(X);
+    Pca::MatrixF Zf(X.rows(), 3);
+    pca.transform(X, Zf);
+    std::vector<std::vector<double>> V(size_t(X.rows()));
+    for (Eigen::Index i = 0; i < X.rows(); ++i)
+        V[size_t(i)].assign(X.row(i).data(), X.row(i).data() + X.cols());
+    const auto Zv = pca.transform(V);
+
+    EXPECT_LT((Z - ref).cwiseAbs().maxCoeff(), 1e-9);
+    EXPECT_LT((Zf.cast<double>() - ref).cwiseAbs().maxCoeff(), 1e-4);
+    for (Eigen::Index i = 0; i < X.rows(); i += 41) {
+        const auto z = pca.transform(V[size_t(i)]);
+        for (Eigen::Index c = 0; c < 3; ++c) {
+            EXPECT_NEAR(z[size_t(c)], ref(i, c), 1e-9);
+            EXPECT_NEAR(Zv[size_t(i)][size_t(c)], ref(i, c), 1e-9);
+        }
+    }
+}
+
+TEST(PcaTest, MatrixTransformWrongShapeThrows)
+{
+    Pca pca(2);
+    EXPECT_THROW(pca.transform(Pca::Matrix::Zero(3, 5)), Pca::NotFittedException);
+    pca.fit(lowRankData(50, 5, 2, 8));
+    EXPECT_THROW(pca.transform(Pca::Matrix::Zero(3, 4)), Pca::SizeMismatchException);
+    Pca::Matrix Z(2, 2);
+    EXPECT_THROW(pca.transform(Pca::Matrix::Zero(3, 5), Z), Pca::SizeMismatchException);
+    EXPECT_THROW(pca.inverseTransform(Pca::Matrix::Zero(3, 3)), Pca::SizeMismatchException);
+}
+
+TEST(PcaTest, WhitenGivesUnitVarianceAndInverts)
+{
+    const Pca::Matrix X = lowRankData(500, 10, 3, 9);
+    Pca pca(3);
+    pca.setWhiten(true);
+    pca.fit(X);
+
+    const Pca::Matrix Z = pca.transform(X);
+    for (Eigen::Index c = 0; c < 3; ++c) {
+        const double mean = Z.col(c).mean();
+        const double var = (Z.col(c).array() - mean).square().sum() / double(X.rows() - 1);
+        EXPECT_NEAR(mean, 0.0, 1e-9);
+        EXPECT_NEAR(var, 1.0, 1e-9);
+    }
+
+    // Whitening is undone by inverseTransform(): same reconstruction as plain PCA.
+    Pca plain(3);
+    plain.fit(X);
+    const Pca::Matrix a = pca.inverseTransform(Z);
+    const Pca::Matrix b = plain.inverseTransform(plain.transform(X));
+    EXPECT_LT((a - b).cwiseAbs().maxCoeff(), 1e-9);
+
+    const auto z = pca.transform(std::vector<double>(X.row(0).data(), X.row(0).data() + 10));
+    EXPECT_NEAR(z[0], Z(0, 0), 1e-9);
+}
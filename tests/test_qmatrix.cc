@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
+
 using nu::QMatrix;
 
 TEST(QMatrixTest, ConstructedSquareAndZeroFillable)
@@ -60,3 +62,56 @@ TEST(QMatrixTest, MaxOnInvalidRowThrows)
     QMatrix m(2);
     EXPECT_THROW(m.max(99), QMatrix::InvalidIndexException);
 }
+
+TEST(QMatrixTest, RowsAreContiguousRowMajor)
+{
+    QMatrix m(3);
+    m[1][2] = 4.0;
+    m[2][0] = -1.0;
+    EXPECT_EQ(m.data()[1 * 3 + 2], 4.0);
+    EXPECT_EQ(m.data()[2 * 3 + 0], -1.0);
+
+    QMatrix copy(QMatrix::data_t{ nu::Vector({ 1, 2 }), nu::Vector({ 3, 4 }) });
+    EXPECT_EQ(copy[1][0], 3.0);
+    EXPECT_THROW(QMatrix(QMatrix::data_t{ nu::Vector({ 1, 2 }) }), std::invalid_argument);
+}
+
+TEST(QMatrixTest, MaxargReturnsFirstMaxAndMaxAllEveryRow)
+{
+    QMatrix m(4);
+    m.fill(-2.0);
+    m[0][1] = 3.0;
+    m[0][3] = 3.0;
+    m[2][2] = 0.5;
+    EXPECT_EQ(m.maxarg(0), 1u);
+    EXPECT_EQ(m.maxarg(1), 0u);
+
+    const Eigen::VectorXd v = m.maxAll();
+    ASSERT_EQ(v.size(), 4);
+    EXPECT_EQ(v(0), 3.0);
+    EXPECT_EQ(v(1), -2.0);
+    EXPECT_EQ(v(2), 0.5);
+    EXPECT_EQ(v(3), -2.0);
+}
+
+TEST(QMatrixTest, BellmanSweepUpdatesAllowedEntriesOnly)
+{
+    // 0 -> 1 (reward 0), 1 -> 1 (reward 10); 0 -> 0 forbidden.
+    QMatrix r(2);
+    r.fill(-1.0);
+    r[0][1] = 0.0;
+    r[1][1] = 10.0;
+
+    QMatrix q(2);
+    q[1][1] = 5.0;
+    q[0][0] = 7.0;
+
+    // Row maxima before the sweep: V = (7, 5).
+    EXPECT_DOUBLE_EQ(q.bellmanSweep(r, 0.5), 7.5);
+    EXPECT_DOUBLE_EQ(q[0][1], 2.5);
+    EXPECT_DOUBLE_EQ(q[1][1], 12.5);
+    EXPECT_DOUBLE_EQ(q[0][0], 7.0); // forbidden, unchanged
+    EXPECT_DOUBLE_EQ(q[1][0], 0.0);
+
+    EXPECT_THROW(q.bellmanSweep(QMatrix(3), 0.5), std::invalid_argument);
+}
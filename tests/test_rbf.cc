@@ -187,3 +187,66 @@ TEST(RbfTest, ClassificationAccuracyOnLinearProblem)
     }
     EXPECT_GE(bestCorrect, static_cast<int>(N * 0.85));
 }
+
+// ── Closed-form and batched paths ────────────────────────────────────────────
+
+TEST(RbfTest, ForwardBatchMatchesForward)
+{
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < 40; ++i)
+        data.push_back({ std::cos(0.3 * i), std::sin(0.7 * i), 0.05 * i });
+
+    for (auto mode : { nu::RnnOutput::Linear, nu::RnnOutput::Softmax }) {
+        nu::Rbf rbf(3, 7, 2, 0.05, mode);
+        rbf.fitCenters(data);
+        const auto batch = rbf.forwardBatch(data);
+        ASSERT_EQ(batch.size(), data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            const auto y = rbf.forward(data[i]);
+            for (size_t k = 0; k < y.size(); ++k)
+                EXPECT_NEAR(batch[i][k], y[k], 1e-12);
+        }
+    }
+}
+
+TEST(RbfTest, LeastSquaresFitsSineWithoutEpochs)
+{
+    constexpr int N = 200;
+    const auto inputs = makeSineInputs(N);
+    const auto targets = makeSineTargets(N);
+
+    nu::Rbf rbf(1, 12, 1);
+    rbf.fitCenters(inputs, nu::Rbf::CenterInit::KMeans);
+    const double loss = rbf.fitLeastSquares(inputs, targets, 1e-10);
+    EXPECT_LT(loss, 1e-4);
+
+    // Ridge shrinks the weights and costs training error.
+    nu::Rbf ridge(1, 12, 1);
+    ridge.fitCenters(inputs, nu::Rbf::CenterInit::KMeans);
+    EXPECT_GT(ridge.fitLeastSquares(inputs, targets, 10.0), loss);
+    EXPECT_THROW(ridge.fitLeastSquares(inputs, targets, -1.0), std::invalid_argument);
+}
+
+TEST(RbfTest, LeastSquaresClassifiesLinearProblem)
+{
+    constexpr int N = 20;
+    std::vector<std::vector<double>> inputs, targets;
+    for (int i = 0; i < N; ++i) {
+        const double x = static_cast<double>(i) / (N - 1);
+        inputs.push_back({ x });
+        targets.push_back(x > 0.5 ? std::vector<double>{ 1, 0 } : std::vector<double>{ 0, 1 });
+    }
+    nu::Rbf rbf(1, 6, 2, 0.1, nu::RnnOutput::Softmax);
+    rbf.fitCenters(inputs, nu::Rbf::CenterInit::KMeans);
+    rbf.fitLeastSquares(inputs, targets, 1e-6);
+    const auto out = rbf.forwardBatch(inputs);
+    for (int i = 0; i < N; ++i)
+        EXPECT_EQ(out[size_t(i)][0] > out[size_t(i)][1], targets[size_t(i)][0] > 0.5) << i;
+}
+
+TEST(RbfTest, KMeansCentersNeedEnoughSamples)
+{
+    nu::Rbf rbf(1, 5, 1);
+    EXPECT_THROW(rbf.fitCenters({ { 0.0 }, { 1.0 } }, nu::Rbf::CenterInit::KMeans),
+        std::invalid_argument);
+}
@@ -168,3 +168,64 @@ TEST(RbmTest, TrainReducesReconstructionError)
     const double errAfter = rbm.reconstructionError(data);
     EXPECT_LT(errAfter, errBefore);
 }
+
+// ── mini-batch CD / PCD ───────────────────────────────────────────────────────
+
+// Noisy copies of 4 prototypes as columns of an [8 x 400] matrix.
+static Eigen::MatrixXd rbmPatterns()
+{
+    const double protos[4][8] = {
+        { 1, 1, 1, 1, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 1, 1, 1, 1 },
+        { 1, 0, 1, 0, 1, 0, 1, 0 },
+        { 0, 1, 0, 1, 0, 1, 0, 1 },
+    };
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> udist(0.0, 1.0);
+    Eigen::MatrixXd X(8, 400);
+    for (Eigen::Index j = 0; j < X.cols(); ++j)
+        for (Eigen::Index i = 0; i < 8; ++i) {
+            const double b = protos[j % 4][i];
+            X(i, j) = udist(rng) < 0.05 ? 1.0 - b : b;
+        }
+    return X;
+}
+
+TEST(RbmTest, BatchProbsMatchSingleSample)
+{
+    const Eigen::MatrixXd X = rbmPatterns().leftCols(10);
+    nu::Rbm rbm(8, 5);
+    const Eigen::MatrixXd H = rbm.hiddenProbsBatch(X);
+    const Eigen::MatrixXd V = rbm.visibleProbsBatch(H);
+    for (Eigen::Index j = 0; j < X.cols(); ++j) {
+        EXPECT_LT((H.col(j) - rbm.hiddenProbs(X.col(j))).norm(), 1e-12);
+        EXPECT_LT((V.col(j) - rbm.visibleProbs(H.col(j))).norm(), 1e-12);
+    }
+    EXPECT_THROW(rbm.hiddenProbsBatch(Eigen::MatrixXd::Zero(3, 2)), std::invalid_argument);
+}
+
+TEST(RbmTest, MiniBatchCdAndPcdReduceReconstructionError)
+{
+    const Eigen::MatrixXd X = rbmPatterns();
+    for (bool pcd : { false, true }) {
+        nu::Rbm rbm(8, 6, 0.1, 42);
+        rbm.setPersistent(pcd);
+        const double before = rbm.reconstructionError(X);
+        rbm.trainMiniBatch(X, 200, 20, 1);
+        EXPECT_LT(rbm.reconstructionError(X), 0.5 * before) << "pcd=" << pcd;
+    }
+}
+
+TEST(RbmTest, TrainBatchIndependentOfThreadCount)
+{
+    const Eigen::MatrixXd X = rbmPatterns().leftCols(64);
+    nu::Rbm a(8, 6, 0.1, 7), b(8, 6, 0.1, 7);
+    a.setThreads(1);
+    b.setThreads(4);
+    for (int i = 0; i < 5; ++i) {
+        a.trainBatch(X, 2);
+        b.trainBatch(X, 2);
+    }
+    const Eigen::MatrixXd probe = X.leftCols(4);
+    EXPECT_LT((a.hiddenProbsBatch(probe) - b.hiddenProbsBatch(probe)).cwiseAbs().maxCoeff(), 1e-12);
+}
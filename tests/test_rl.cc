@@ -3,11 +3,15 @@
 //   - nu::QLearn   (nu_qlearn.h)
 //   - nu::Sarsa    (nu_sarsa.h)
 //   - nu::EGreedyPolicy / nu::SoftmaxPolicy (policies)
+//   - nu::DenseQMap (nu_dense_qmap.h)
+//   - parallel episodes (nu_parallel_episodes.h): QLGraph, QLearn, Sarsa
 //
 
+#include "nu_dense_qmap.h"
 #include "nu_e_greedy_policy.h"
 #include "nu_learner_listener.h"
 #include "nu_qlearn.h"
+#include "nu_qlgraph.h"
 #include "nu_sarsa.h"
 #include "nu_softmax_policy.h"
 
@@ -15,6 +19,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -57,10 +62,47 @@ struct RecordingListener : nu::LearnerListener {
     }
 };
 
+// Chain 0..4: action 1 moves right, action 0 stays; -0.1 per step, +1 at 4.
+struct ChainAgent {
+    int pos = 0;
+
+    bool goal() const { return pos >= 4; }
+    int getCurrentState() const { return pos; }
+    void doAction(int action) { pos += action; }
+    double reward() const { return goal() ? 1.0 : -0.1; }
+    std::vector<int> getValidActions() const { return { 0, 1 }; }
+};
+
+// Deterministic policy: moves right every other call, so runs with different
+// Q-map types visit the same transitions.
+struct AlternatingPolicy {
+    mutable int calls = 0;
+
+    template <class QMap> int selectAction(const ChainAgent&, QMap&) const
+    {
+        return calls++ % 2;
+    }
+    template <class QMap> int getLearnedAction(const ChainAgent& agent, QMap& q) const
+    {
+        return selectAction(agent, q);
+    }
+};
+
+// Graph of examples/path_finder: goal 5, shortest paths 0-4-5, 1-5, 4-5.
+nu::QLGraph makePathFinderGraph()
+{
+    return nu::QLGraph(6, 5,
+        { { 0, { 4 } }, { 1, { 3, 5 } }, { 2, { 3 } }, { 3, { 1, 2, 4 } }, { 4, { 0, 3, 5 } },
+            { 5, { 1, 4, 5 } } });
+}
+
 using EGreedy = nu::EGreedyPolicy<int, LineAgent>;
 using EGreedyFixed = nu::EGreedyPolicy<int, FixedAgent>;
 using SoftmaxFixed = nu::SoftmaxPolicy<int, FixedAgent>;
 using QMap = std::unordered_map<int, std::unordered_map<int, double>>;
+using DenseQ = nu::DenseQMap<int, int, 3>;
+using ChainDenseQ = nu::DenseQMap<int, int, 2>;
+using EGreedyChain = nu::EGreedyPolicy<int, ChainAgent>;
 
 } // namespace
 
@@ -150,3 +192,286 @@ TEST(SarsaTest, ReportsConsecutiveMoveCounts)
     const std::vector<size_t> expected{ 0, 1, 2 };
     EXPECT_EQ(listener->moves, expected);
 }
+
+// --------------------------------- DenseQMap -------------------------------
+
+TEST(DenseQMapTest, IndexesAndGrowsOnLookup)
+{
+    DenseQ q(2);
+    EXPECT_EQ(q.numStates(), 2u);
+    q[1][2] = 4.0;
+    EXPECT_EQ(q.data()[1 * 3 + 2], 4.0);
+
+    q[5][0] = -1.0; // grows to 6 rows, new rows are zero
+    EXPECT_EQ(q.numStates(), 6u);
+    EXPECT_EQ(q[1][2], 4.0);
+    EXPECT_EQ(q[3][1], 0.0);
+
+    const DenseQ& cq = q;
+    EXPECT_EQ(cq[5][0], -1.0);
+    EXPECT_THROW(cq[6], std::out_of_range);
+}
+
+TEST(DenseQMapTest, RowMaxAndArgmax)
+{
+    DenseQ q(1);
+    q[0][0] = -3.0;
+    q[0][1] = 2.0;
+    q[0][2] = 2.0;
+    EXPECT_EQ(q[0].max(), 2.0);
+    EXPECT_EQ(q[0].argmax(), 1u); // first maximum
+
+    double best = 0;
+    EXPECT_EQ(nu::argmaxQ(q[0], std::vector<int>{ 0, 1, 2 }, best), 1);
+    EXPECT_EQ(best, 2.0);
+    EXPECT_EQ(nu::argmaxQ(q[0], std::vector<int>{ 2, 1 }, best), 2);
+    EXPECT_EQ(nu::maxQ(q[0], std::vector<int>{ 0 }), -3.0);
+
+    // Same answers from an unordered_map row.
+    QMap m;
+    m[0] = { { 0, -3.0 }, { 1, 2.0 }, { 2, 2.0 } };
+    EXPECT_EQ(nu::argmaxQ(m[0], std::vector<int>{ 0, 1, 2 }, best), 1);
+    EXPECT_EQ(nu::argmaxQ(m[0], std::vector<int>{ 2, 1 }, best), 2);
+    EXPECT_EQ(nu::maxQ(m[0], std::vector<int>{ 0 }), -3.0);
+}
+
+TEST(DenseQMapTest, PoliciesUseDenseRows)
+{
+    FixedAgent agent;
+    DenseQ q(1);
+    q[0][1] = 5.0;
+    EXPECT_EQ(EGreedyFixed().getLearnedAction(agent, q), 1);
+
+    q[0][2] = 9.0;
+    EXPECT_EQ(SoftmaxFixed().getLearnedAction(agent, q), 2);
+
+    SoftmaxFixed softmax;
+    for (int i = 0; i < 20; ++i) {
+        const int a = softmax.selectAction(agent, q);
+        EXPECT_GE(a, 0);
+        EXPECT_LE(a, 2);
+    }
+}
+
+TEST(DenseQMapTest, QLearnMatchesHashedQMap)
+{
+    nu::QLearn<int, int, ChainAgent, AlternatingPolicy> hashed;
+    nu::QLearn<int, int, ChainAgent, AlternatingPolicy, void, ChainDenseQ> dense(ChainDenseQ(5));
+
+    for (int episode = 0; episode < 10; ++episode) {
+        ChainAgent a, b;
+        EXPECT_DOUBLE_EQ(hashed.learn(a), dense.learn(b));
+    }
+    const auto& hq = std::as_const(hashed).getQMap();
+    const auto& dq = std::as_const(dense).getQMap();
+    for (int s = 0; s < 4; ++s)
+        for (int a = 0; a < 2; ++a)
+            EXPECT_DOUBLE_EQ(hq.at(s).at(a), dq[s][a]);
+}
+
+TEST(DenseQMapTest, SarsaMatchesHashedQMap)
+{
+    nu::Sarsa<int, int, ChainAgent, AlternatingPolicy> hashed;
+    nu::Sarsa<int, int, ChainAgent, AlternatingPolicy, void, ChainDenseQ> dense(ChainDenseQ(5));
+
+    for (int episode = 0; episode < 10; ++episode) {
+        ChainAgent a, b;
+        EXPECT_DOUBLE_EQ(hashed.learn(a), dense.learn(b));
+    }
+    const auto& hq = std::as_const(hashed).getQMap();
+    const auto& dq = std::as_const(dense).getQMap();
+    for (int s = 0; s < 4; ++s)
+        for (int a = 0; a < 2; ++a)
+            EXPECT_DOUBLE_EQ(hq.at(s).at(a), dq[s][a]);
+}
+
+// ----------------------------- Parallel episodes ---------------------------
+
+TEST(ParallelEpisodesTest, QLGraphLearnsShortestPathsInBothModes)
+{
+    for (const auto mode : { nu::ParallelUpdate::Deltas, nu::ParallelUpdate::Hogwild }) {
+        auto graph = makePathFinderGraph();
+        nu::ParallelLearnConfig cfg;
+        cfg.threads = 3;
+        cfg.update = mode;
+        cfg.roundEpisodes = 8;
+        ASSERT_TRUE(graph.learn(600, cfg));
+
+        EXPECT_EQ(graph.getNextStateFor(0), 4u);
+        EXPECT_EQ(graph.getNextStateFor(1), 5u);
+        EXPECT_EQ(graph.getNextStateFor(4), 5u);
+    }
+}
+
+TEST(ParallelEpisodesTest, QLGraphDeltasAreReproducible)
+{
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 4;
+    cfg.update = nu::ParallelUpdate::Deltas;
+    cfg.roundEpisodes = 5;
+    cfg.seed = 42;
+
+    auto a = makePathFinderGraph();
+    auto b = makePathFinderGraph();
+    a.learn(300, cfg);
+    b.learn(300, cfg);
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 6; ++j)
+            EXPECT_EQ(a.get_q_mtx()[i][j], b.get_q_mtx()[i][j]);
+}
+
+TEST(ParallelEpisodesTest, QLGraphHelperRunsPerRound)
+{
+    struct CountingHelper : nu::QLGraph::Helper {
+        mutable std::vector<size_t> begins, ends;
+        void beginEpisode(const size_t& e, nu::QLGraph&) const override { begins.push_back(e); }
+        void endEpisode(const size_t& e, nu::QLGraph&) const override { ends.push_back(e); }
+    } helper;
+
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 2;
+    cfg.roundEpisodes = 4;
+    auto graph = makePathFinderGraph();
+    graph.learn(20, cfg, helper);
+
+    EXPECT_EQ(helper.begins, (std::vector<size_t>{ 0, 8, 16 }));
+    EXPECT_EQ(helper.ends, (std::vector<size_t>{ 7, 15, 19 }));
+}
+
+TEST(ParallelEpisodesTest, QLearnDeltasAreReproducibleAndLearn)
+{
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 3;
+    cfg.update = nu::ParallelUpdate::Deltas;
+    cfg.seed = 7;
+    cfg.maxSteps = 50;
+    const auto makeAgent = [](size_t) { return ChainAgent(); };
+
+    using Learner = nu::QLearn<int, int, ChainAgent, EGreedyChain, void, ChainDenseQ>;
+    Learner a(ChainDenseQ(5)), b(ChainDenseQ(5));
+    EXPECT_DOUBLE_EQ(a.learnParallel(200, makeAgent, cfg), b.learnParallel(200, makeAgent, cfg));
+
+    const auto& qa = std::as_const(a).getQMap();
+    const auto& qb = std::as_const(b).getQMap();
+    for (int s = 0; s < 5; ++s)
+        for (int act = 0; act < 2; ++act)
+            EXPECT_EQ(qa[s][act], qb[s][act]);
+    for (int s = 0; s < 4; ++s)
+        EXPECT_GT(qa[s][1], qa[s][0]); // moving right is learned everywhere
+}
+
+TEST(ParallelEpisodesTest, HogwildQLearnAndSarsaLearn)
+{
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 4;
+    cfg.update = nu::ParallelUpdate::Hogwild;
+    cfg.maxSteps = 50;
+    const auto makeAgent = [](size_t) { return ChainAgent(); };
+
+    nu::QLearn<int, int, ChainAgent, EGreedyChain, void, ChainDenseQ> ql(ChainDenseQ(5));
+    ql.learnParallel(400, makeAgent, cfg);
+    nu::Sarsa<int, int, ChainAgent, EGreedyChain, void, ChainDenseQ> sarsa(ChainDenseQ(5));
+    sarsa.learnParallel(400, makeAgent, cfg);
+
+    for (int s = 0; s < 4; ++s) {
+        EXPECT_GT(std::as_const(ql).getQMap()[s][1], std::as_const(ql).getQMap()[s][0]);
+        EXPECT_GT(std::as_const(sarsa).getQMap()[s][1], std::as_const(sarsa).getQMap()[s][0]);
+    }
+}
+
+TEST(ParallelEpisodesTest, SharedTableViewSnapshotsRows)
+{
+    ChainDenseQ q(3);
+    q[1][0] = 0.25;
+    q[1][1] = 0.75;
+
+    nu::SharedTableView<ChainDenseQ> view(q);
+    const auto row = view[1];
+    q[1][1] = 2.0; // the snapshot does not follow the table
+    EXPECT_DOUBLE_EQ(row[0], 0.25);
+    EXPECT_DOUBLE_EQ(row[1], 0.75);
+    EXPECT_DOUBLE_EQ(row.max(), 0.75);
+    EXPECT_EQ(row.argmax(), 1u);
+
+    EXPECT_THROW(view[3], std::out_of_range);
+    EXPECT_EQ(q.numStates(), 3u);
+}
+
+// Run under -DNUNN_SANITIZE_THREAD=ON: every access to the shared table,
+// the policies' reads included, must be atomic.
+TEST(ParallelEpisodesTest, HogwildPoliciesReadTheTableAtomically)
+{
+    using SoftmaxChain = nu::SoftmaxPolicy<int, ChainAgent>;
+
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 4;
+    cfg.update = nu::ParallelUpdate::Hogwild;
+    cfg.roundEpisodes = 8;
+    cfg.maxSteps = 50;
+    const auto makeAgent = [](size_t) { return ChainAgent(); };
+
+    nu::QLearn<int, int, ChainAgent, EGreedyChain, void, ChainDenseQ> qlGreedy(ChainDenseQ(5));
+    qlGreedy.learnParallel(400, makeAgent, cfg);
+    nu::QLearn<int, int, ChainAgent, SoftmaxChain, void, ChainDenseQ> qlSoftmax(ChainDenseQ(5));
+    qlSoftmax.learnParallel(400, makeAgent, cfg);
+    nu::Sarsa<int, int, ChainAgent, SoftmaxChain, void, ChainDenseQ> sarsa(ChainDenseQ(5));
+    sarsa.learnParallel(400, makeAgent, cfg);
+
+    for (int s = 0; s < 4; ++s) {
+        EXPECT_GT(std::as_const(qlGreedy).getQMap()[s][1], std::as_const(qlGreedy).getQMap()[s][0]);
+        EXPECT_GT(
+            std::as_const(qlSoftmax).getQMap()[s][1], std::as_const(qlSoftmax).getQMap()[s][0]);
+        EXPECT_GT(std::as_const(sarsa).getQMap()[s][1], std::as_const(sarsa).getQMap()[s][0]);
+    }
+}
+
+TEST(ParallelEpisodesTest, ListenerSeesRoundsAndUncoveredStatesThrow)
+{
+    struct RoundListener : nu::LearnerListener {
+        std::vector<size_t> episodes;
+        bool notify(const double&, const size_t& n) override
+        {
+            episodes.push_back(n);
+            return n < 20; // stop after the round reaching 20 episodes
+        }
+    };
+    auto listener = std::make_shared<RoundListener>();
+
+    nu::ParallelLearnConfig cfg;
+    cfg.threads = 2;
+    cfg.roundEpisodes = 5;
+    const auto makeAgent = [](size_t) { return ChainAgent(); };
+
+    nu::QLearn<int, int, ChainAgent, AlternatingPolicy, void, ChainDenseQ> ql(
+        ChainDenseQ(5), listener);
+    ql.learnParallel(100, makeAgent, cfg);
+    EXPECT_EQ(listener->episodes, (std::vector<size_t>{ 10, 20 }));
+
+    nu::QLearn<int, int, ChainAgent, AlternatingPolicy, void, ChainDenseQ> small(ChainDenseQ(3));
+    EXPECT_THROW(small.learnParallel(4, makeAgent, cfg), std::out_of_range);
+    nu::Sarsa<int, int, ChainAgent, AlternatingPolicy, void, ChainDenseQ> smallSarsa(
+        ChainDenseQ(3));
+    EXPECT_THROW(smallSarsa.learnParallel(4, makeAgent, cfg), std::out_of_range);
+}
+
+// ----------------------------- Value iteration -----------------------------
+
+TEST(QLGraphTest, ValueIterationReachesTheFixedPoint)
+{
+    auto graph = makePathFinderGraph();
+    const size_t sweeps = graph.valueIteration();
+    EXPECT_GT(sweeps, 1u);
+    EXPECT_LT(sweeps, 10000u);
+
+    // Q(5,5) = 100 + 0.8 Q(5,5) = 500 is the global max, scaled to 100;
+    // one step away from the goal is worth 0.8 of a goal move.
+    const auto& q = graph.get_q_mtx();
+    EXPECT_NEAR(q[5][5], 100.0, 1e-6);
+    EXPECT_NEAR(q[4][5], 100.0, 1e-6);
+    EXPECT_NEAR(q[3][1], 80.0, 1e-6);
+    EXPECT_NEAR(q[2][3], 64.0, 1e-6);
+    EXPECT_EQ(q[0][1], 0.0); // forbidden move
+
+    EXPECT_EQ(graph.getNextStateFor(0), 4u);
+    EXPECT_EQ(graph.getNextStateFor(1), 5u);
+}
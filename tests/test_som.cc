@@ -145,3 +145,65 @@ TEST(SomTest, TrainReducesQuantizationError)
     const double qeAfter = som.quantizationError(data);
     EXPECT_LT(qeAfter, qeBefore);
 }
+
+// ── batch training ────────────────────────────────────────────────────────────
+
+static nu::Som::Matrix somClusters(size_t perCluster, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    const double centres[4][3]
+        = { { 0.1, 0.1, 0.5 }, { 0.1, 0.9, 0.2 }, { 0.9, 0.1, 0.8 }, { 0.9, 0.9, 0.4 } };
+    nu::Som::Matrix X(4 * perCluster, 3);
+    for (size_t i = 0; i < 4 * perCluster; ++i)
+        for (Eigen::Index j = 0; j < 3; ++j)
+            X(Eigen::Index(i), j) = centres[i % 4][j] + noise(rng);
+    return X;
+}
+
+TEST(SomTest, BmuBatchMatchesSingleBmu)
+{
+    const nu::Som::Matrix X = somClusters(100, 3);
+    nu::Som som(7, 5, 3, 0.5, 0.0, 9);
+    som.setThreads(3);
+    const std::vector<size_t> b = som.bmuBatch(X);
+    ASSERT_EQ(b.size(), size_t(X.rows()));
+    for (Eigen::Index i = 0; i < X.rows(); ++i) {
+        const auto p = som.bmu({ X(i, 0), X(i, 1), X(i, 2) });
+        EXPECT_EQ(b[size_t(i)], p.first * 5 + p.second);
+    }
+    EXPECT_THROW(som.bmuBatch(nu::Som::Matrix::Zero(2, 2)), std::invalid_argument);
+}
+
+TEST(SomTest, TrainBatchMatchesOnlineQuality)
+{
+    const nu::Som::Matrix X = somClusters(200, 4);
+    std::vector<std::vector<double>> data;
+    for (Eigen::Index i = 0; i < X.rows(); ++i)
+        data.push_back({ X(i, 0), X(i, 1), X(i, 2) });
+
+    nu::Som online(6, 6, 3, 0.5, 0.0, 1), batch(6, 6, 3, 0.5, 0.0, 1);
+    const double qe0 = batch.quantizationError(X);
+    online.train(data, 30);
+    batch.setThreads(2);
+    batch.trainBatch(X, 30);
+
+    EXPECT_NEAR(batch.quantizationError(X), batch.quantizationError(data), 1e-12);
+    EXPECT_LT(batch.quantizationError(X), 0.25 * qe0);
+    EXPECT_LT(batch.quantizationError(X), 1.5 * online.quantizationError(X));
+}
+
+TEST(SomTest, TruncatedUpdateLeavesFarNeuronsUntouched)
+{
+    nu::Som som(10, 10, 2, 0.5, 0.0, 5);
+    const auto far = som.getWeights(9, 9);
+    const std::vector<double> x = som.getWeights(0, 0);
+    som.update(x, 0.5, 2.0); // window: 8 grid steps
+    EXPECT_EQ(som.getWeights(9, 9), far);
+
+    nu::Som full(10, 10, 2, 0.5, 0.0, 5);
+    full.setNeighborhoodTruncation(0.0);
+    full.update(x, 0.5, 2.0);
+    EXPECT_NE(full.getWeights(9, 9), far);
+    EXPECT_THROW(full.setNeighborhoodTruncation(-1.0), std::invalid_argument);
+}
@@ -169,3 +169,121 @@ TEST(VaeTest, TrainReducesReconstructionError)
     const double errAfter = vae.reconstructionError(data);
     EXPECT_LT(errAfter, errBefore);
 }
+
+// ── Batched interface ─────────────────────────────────────────────────────────
+
+namespace {
+
+std::vector<std::vector<double>> noisyPrototypes(int copies, unsigned seed)
+{
+    const std::vector<std::vector<double>> protos = {
+        { 1, 1, 1, 1, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 1, 1, 1, 1 },
+        { 1, 0, 1, 0, 1, 0, 1, 0 },
+        { 0, 1, 0, 1, 0, 1, 0, 1 },
+    };
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> udist(0.0, 1.0);
+    std::vector<std::vector<double>> data;
+    for (const auto& p : protos)
+        for (int i = 0; i < copies; ++i) {
+            std::vector<double> x = p;
+            for (double& b : x)
+                if (udist(rng) < 0.1)
+                    b = 1.0 - b;
+            data.push_back(x);
+        }
+    return data;
+}
+
+Eigen::MatrixXd pack(const std::vector<std::vector<double>>& data)
+{
+    Eigen::MatrixXd X(Eigen::Index(data[0].size()), Eigen::Index(data.size()));
+    for (size_t j = 0; j < data.size(); ++j)
+        for (size_t i = 0; i < data[j].size(); ++i)
+            X(Eigen::Index(i), Eigen::Index(j)) = data[j][i];
+    return X;
+}
+
+} // namespace
+
+TEST(VaeTest, BatchInferenceMatchesPerSample)
+{
+    nu::Vae vae(8, 16, 4);
+    const auto data = noisyPrototypes(3, 1);
+    const Eigen::MatrixXd X = pack(data);
+
+    const auto [Mu, Lv] = vae.encodeBatch(X);
+    const Eigen::MatrixXd R = vae.reconstructBatch(X);
+    const Eigen::MatrixXd D = vae.decodeBatch(Mu);
+    ASSERT_EQ(Mu.rows(), 4);
+    ASSERT_EQ(R.cols(), X.cols());
+
+    for (size_t j = 0; j < data.size(); ++j) {
+        const auto [mu, lv] = vae.encode(data[j]);
+        const auto r = vae.reconstruct(data[j]);
+        for (size_t k = 0; k < 4; ++k) {
+            EXPECT_NEAR(mu[k], Mu(Eigen::Index(k), Eigen::Index(j)), 1e-12);
+            EXPECT_NEAR(lv[k], Lv(Eigen::Index(k), Eigen::Index(j)), 1e-12);
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            EXPECT_NEAR(r[i], R(Eigen::Index(i), Eigen::Index(j)), 1e-12);
+            EXPECT_NEAR(r[i], D(Eigen::Index(i), Eigen::Index(j)), 1e-12);
+        }
+    }
+    EXPECT_NEAR(vae.reconstructionError(X), vae.reconstructionError(data), 1e-12);
+}
+
+TEST(VaeTest, BatchSizeMismatchThrows)
+{
+    nu::Vae vae(8, 16, 4);
+    EXPECT_THROW(vae.encodeBatch(Eigen::MatrixXd::Zero(7, 2)), std::invalid_argument);
+    EXPECT_THROW(vae.decodeBatch(Eigen::MatrixXd::Zero(3, 2)), std::invalid_argument);
+    EXPECT_THROW(vae.trainBatch(Eigen::MatrixXd::Zero(7, 2)), std::invalid_argument);
+    EXPECT_THROW(vae.trainBatch(Eigen::MatrixXd::Zero(8, 0)), std::invalid_argument);
+}
+
+TEST(VaeTest, TrainStepIsSingleColumnBatch)
+{
+    const auto data = noisyPrototypes(1, 2);
+    nu::Vae a(8, 16, 4, 0.01, 7), b(8, 16, 4, 0.01, 7);
+
+    for (const auto& x : data) {
+        const auto la = a.trainStep(x, 0.5);
+        const auto lb = b.trainBatch(pack({ x }), 0.5);
+        EXPECT_DOUBLE_EQ(la.first, lb.first);
+        EXPECT_DOUBLE_EQ(la.second, lb.second);
+    }
+    EXPECT_EQ(a.reconstruct(data[0]), b.reconstruct(data[0]));
+}
+
+TEST(VaeTest, GenerateBatchInUnitInterval)
+{
+    nu::Vae vae(8, 16, 4);
+    const Eigen::MatrixXd G = vae.generateBatch(5);
+    EXPECT_EQ(G.rows(), 8);
+    EXPECT_EQ(G.cols(), 5);
+    EXPECT_GE(G.minCoeff(), 0.0);
+    EXPECT_LE(G.maxCoeff(), 1.0);
+}
+
+TEST(VaeTest, MiniBatchTrainingReducesReconstructionError)
+{
+    const auto data = noisyPrototypes(50, 0);
+    nu::Vae vae(8, 32, 4, 0.5, 42);
+    const double errBefore = vae.reconstructionError(data);
+    vae.trainMiniBatch(data, 300, 16, 0.4);
+    EXPECT_LT(vae.reconstructionError(data), 0.8 * errBefore);
+}
+
+TEST(VaeTest, AdamTrainingReducesReconstructionError)
+{
+    const auto data = noisyPrototypes(50, 3);
+    nu::Vae vae(8, 32, 4, 0.003, 42);
+    vae.setOptimizer(nu::Vae::Optimizer::Adam);
+    EXPECT_EQ(vae.optimizer(), nu::Vae::Optimizer::Adam);
+
+    const double errBefore = vae.reconstructionError(data);
+    vae.trainMiniBatch(pack(data), 200, 32, 0.4);
+    EXPECT_LT(vae.reconstructionError(data), 0.8 * errBefore);
+}
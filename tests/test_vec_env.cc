@@ -0,0 +1,243 @@
+//
+// This file is part of the nunn Library
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.
+// Licensed under the MIT License.
+// See COPYING file in the project root for full license information.
+//
+
+#include "nu_vec_env.h"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using LC = nu::MlpMatrixNN::LayerConfig;
+
+// Episodes last exactly `length` steps whatever the action; reward 1 per step.
+struct FixedLengthEnv {
+    int length = 5;
+    int t = 0;
+
+    void reset(Eigen::Ref<Eigen::VectorXd> s)
+    {
+        t = 0;
+        s.setZero();
+    }
+
+    double step(int, Eigen::Ref<Eigen::VectorXd> s, bool& done)
+    {
+        ++t;
+        s.setConstant(double(t) / length);
+        done = t == length;
+        return 1.0;
+    }
+};
+
+// Corridor of 4 cells: action 1 moves right (reward 1 and done at the end),
+// action 0 ends the episode with no reward.
+struct CorridorEnv {
+    int pos = 0;
+
+    void reset(Eigen::Ref<Eigen::VectorXd> s)
+    {
+        pos = 0;
+        encode(s);
+    }
+
+    double step(int a, Eigen::Ref<Eigen::VectorXd> s, bool& done)
+    {
+        if (a == 0) {
+            done = true;
+            encode(s);
+            return 0.0;
+        }
+        ++pos;
+        done = pos == 3;
+        encode(s);
+        return done ? 1.0 : 0.0;
+    }
+
+    void encode(Eigen::Ref<Eigen::VectorXd> s) const
+    {
+        s.setZero();
+        s(pos) = 1.0;
+    }
+};
+
+} // namespace
+
+// ── Dqn batched API ───────────────────────────────────────────────────────────
+
+TEST(VecEnvTest, SelectActionsMatchesGreedySelectAction)
+{
+    nu::Dqn dqn({ LC(2), LC(8, nu::Activation::Tanh), LC(3, nu::Activation::Linear) }, 0.01);
+    const Eigen::MatrixXd S = Eigen::MatrixXd::Random(2, 20);
+
+    std::vector<int> actions;
+    dqn.selectActions(S, 0.0, actions);
+    ASSERT_EQ(actions.size(), 20u);
+    for (Eigen::Index j = 0; j < S.cols(); ++j)
+        EXPECT_EQ(actions[size_t(j)], dqn.selectAction({ S(0, j), S(1, j) }, 0.0));
+
+    dqn.selectActions(S, 1.0, actions);
+    for (const int a : actions) {
+        EXPECT_GE(a, 0);
+        EXPECT_LT(a, 3);
+    }
+    EXPECT_THROW(dqn.selectActions(Eigen::MatrixXd::Zero(3, 2), 0.0, actions),
+        std::invalid_argument);
+}
+
+TEST(VecEnvTest, LearnBatchRunsRequestedUpdates)
+{
+    nu::Dqn dqn({ LC(2), LC(8, nu::Activation::Tanh), LC(2, nu::Activation::Linear) }, 0.01, 100,
+        8, 0.9, 1000);
+    const Eigen::MatrixXd S = Eigen::MatrixXd::Random(2, 6);
+    const Eigen::VectorXd r = Eigen::VectorXd::Ones(6);
+    const std::vector<int> a{ 0, 1, 0, 1, 0, 1 };
+    const std::vector<uint8_t> done{ 0, 0, 1, 0, 0, 1 };
+
+    EXPECT_EQ(dqn.learnBatch(S, a, r, S, done, 3), 0.0); // 6 < batchSize
+    EXPECT_EQ(dqn.getLearnStepCount(), 0u);
+    EXPECT_GT(dqn.learnBatch(S, a, r, S, done, 3), 0.0);
+    EXPECT_EQ(dqn.getLearnStepCount(), 3u);
+
+    EXPECT_THROW(dqn.learnBatch(S, { 0, 1 }, r, S, done), std::invalid_argument);
+    EXPECT_THROW(dqn.learnBatch(S, { 0, 1, 0, 1, 0, 2 }, r, S, done), std::out_of_range);
+    try {
+        dqn.learnBatch(S, { 0, 1, 0, 1, 0, 2 }, r, S, done);
+    } catch (const std::out_of_range& e) {
+        EXPECT_STREQ(e.what(), "Dqn::learnBatch: action out of range");
+    }
+}
+
+TEST(VecEnvTest, PushBatchWrapsAround)
+{
+    nu::ReplayMemory mem(5, 1);
+    Eigen::MatrixXd S(1, 4);
+    S << 0, 1, 2, 3;
+    const std::vector<int> a{ 0, 1, 2, 3 };
+    const std::vector<uint8_t> done(4, 0);
+    mem.pushBatch(S, a, Eigen::VectorXd::Zero(4), S, done);
+    mem.pushBatch(S.array() + 4.0, a, Eigen::VectorXd::Zero(4), S, done);
+    EXPECT_EQ(mem.size(), 5u);
+    EXPECT_EQ(mem.nextSlot(), 3u);
+
+    // Slots hold 5 6 7 3 4: the three oldest (0, 1, 2) were overwritten.
+    const auto& b = mem.gather({ 0, 1, 2, 3, 4 });
+    Eigen::RowVectorXd expected(5);
+    expected << 5, 6, 7, 3, 4;
+    EXPECT_EQ(b.states.row(0), expected);
+    EXPECT_EQ(b.actions, (std::vector<int>{ 1, 2, 3, 3, 0 }));
+
+    const Eigen::MatrixXd tooMany = Eigen::MatrixXd::Zero(1, 6);
+    EXPECT_THROW(mem.pushBatch(tooMany, std::vector<int>(6, 0), Eigen::VectorXd::Zero(6), tooMany,
+                     std::vector<uint8_t>(6)),
+        std::invalid_argument);
+}
+
+// ── Runner ────────────────────────────────────────────────────────────────────
+
+TEST(VecEnvTest, CountsStepsAndEpisodes)
+{
+    for (const size_t threads : { size_t(1), size_t(3) }) {
+        nu::Dqn dqn({ LC(1), LC(4, nu::Activation::Tanh), LC(2, nu::Activation::Linear) }, 0.01,
+            1000, 16);
+        nu::VecEnvRunner<FixedLengthEnv> runner(dqn, std::vector<FixedLengthEnv>(6), threads);
+        EXPECT_EQ(runner.numEnvs(), 6u);
+
+        const auto stats = runner.run(12, 1.0);
+        EXPECT_EQ(stats.steps, 72u);
+        EXPECT_EQ(stats.episodes, 12u); // two per environment
+        EXPECT_DOUBLE_EQ(stats.meanReturn, 5.0);
+        EXPECT_GT(stats.meanLoss, 0.0);
+        // Two steps into the third episode of every environment.
+        EXPECT_TRUE(runner.states().isConstant(0.4));
+        EXPECT_GT(dqn.getLearnStepCount(), 0u);
+    }
+}
+
+TEST(VecEnvTest, StepsOnPersistentWorkerThreads)
+{
+    // Records the threads that step or reset any environment.
+    struct ThreadRecordingEnv : FixedLengthEnv {
+        std::mutex* mtx = nullptr;
+        std::set<std::thread::id>* ids = nullptr;
+
+        void reset(Eigen::Ref<Eigen::VectorXd> s)
+        {
+            record();
+            FixedLengthEnv::reset(s);
+        }
+        double step(int a, Eigen::Ref<Eigen::VectorXd> s, bool& done)
+        {
+            record();
+            return FixedLengthEnv::step(a, s, done);
+        }
+        void record() const
+        {
+            std::lock_guard<std::mutex> lock(*mtx);
+            ids->insert(std::this_thread::get_id());
+        }
+    };
+
+    std::mutex mtx;
+    std::set<std::thread::id> ids;
+    std::vector<ThreadRecordingEnv> envs(6);
+    for (auto& env : envs) {
+        env.mtx = &mtx;
+        env.ids = &ids;
+    }
+
+    nu::Dqn dqn({ LC(1), LC(4, nu::Activation::Tanh), LC(2, nu::Activation::Linear) });
+    nu::VecEnvRunner<ThreadRecordingEnv> runner(dqn, std::move(envs), 3);
+    runner.run(20, 1.0, 0);
+    EXPECT_EQ(runner.numThreads(), 3u);
+    EXPECT_LE(ids.size(), 3u); // 40 forks, but only the runner's three threads
+}
+
+TEST(VecEnvTest, MaxEpisodeStepsTruncates)
+{
+    nu::Dqn dqn({ LC(1), LC(4, nu::Activation::Tanh), LC(2, nu::Activation::Linear) });
+    nu::VecEnvRunner<FixedLengthEnv> runner(dqn, std::vector<FixedLengthEnv>(2));
+    runner.setMaxEpisodeSteps(3);
+
+    const auto stats = runner.run(6, 1.0, 0);
+    EXPECT_EQ(stats.episodes, 4u);
+    EXPECT_EQ(runner.episodeReturns(), (std::vector<double>{ 3.0, 3.0, 3.0, 3.0 }));
+    EXPECT_EQ(dqn.getLearnStepCount(), 0u);
+    EXPECT_THROW(nu::VecEnvRunner<FixedLengthEnv>(dqn, {}), std::invalid_argument);
+}
+
+TEST(VecEnvTest, LearnsCorridor)
+{
+    nu::Dqn dqn({ LC(4), LC(16, nu::Activation::Tanh), LC(2, nu::Activation::Linear) }, 0.05,
+        5000, 32, 0.9, 20);
+    nu::VecEnvRunner<CorridorEnv> runner(dqn, std::vector<CorridorEnv>(8), 2);
+
+    for (int it = 0; it < 60; ++it)
+        runner.run(25, 1.0 - it / 60.0);
+
+    const auto stats = runner.run(20, 0.0, 0);
+    EXPECT_DOUBLE_EQ(stats.meanReturn, 1.0);
+}
+
+TEST(VecEnvTest, NStepDoubleDqnLearnsCorridor)
+{
+    nu::Dqn dqn({ LC(4), LC(16, nu::Activation::Tanh), LC(2, nu::Activation::Linear) }, 0.05,
+        5000, 32, 0.9, 20);
+    dqn.setNStep(3);
+    dqn.setDoubleDqn(true);
+    nu::VecEnvRunner<CorridorEnv> runner(dqn, std::vector<CorridorEnv>(8), 2);
+
+    for (int it = 0; it < 60; ++it)
+        runner.run(25, 1.0 - it / 60.0);
+
+    const auto stats = runner.run(20, 0.0, 0);
+    EXPECT_DOUBLE_EQ(stats.meanReturn, 1.0);
+}